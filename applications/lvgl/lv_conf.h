@@ -6,6 +6,13 @@
  * Change Logs:
  * Date           Author        Notes
  * 2022-6-1       Wayne Lin     First version
+ * 2026-10-19     RT-Thread     Add the GE2D text benchmark switch
+ * 2026-10-19     RT-Thread     Add the event-driven touch input switch
+ * 2026-10-19     RT-Thread     Add the OSD overlay switches
+ * 2026-10-19     RT-Thread     Add the flush thread switch
+ * 2026-10-19     RT-Thread     Allocate from the LVGL pool, add the stress demo switch
+ * 2026-10-19     RT-Thread     Add the tiled RLE image decoder switch
+ * 2026-10-19     RT-Thread     Add the GE2D coverage demo switch
  */
 
 #ifndef LV_CONF_H
@@ -15,6 +22,26 @@
 
 #define LV_USE_ANTI_TEARING      1
 #define LV_GPU_USE_N9H30_2DGE    1
+#define LV_USE_INDEV_EVENT_DRIVEN 1
+#define LV_USE_FLUSH_THREAD      1
+#define LV_USE_IMG_TRLE          1
+
+/* Allocate from the DDR pool of LVGL(BSP_USING_LVGL_MEMPOOL) instead of the system heap */
+#if defined(BSP_USING_LVGL_MEMPOOL)
+    #undef LV_MEM_CUSTOM
+    #undef LV_MEM_CUSTOM_INCLUDE
+    #undef LV_MEM_CUSTOM_ALLOC
+    #undef LV_MEM_CUSTOM_FREE
+    #undef LV_MEM_CUSTOM_REALLOC
+    #define LV_MEM_CUSTOM           1
+    #define LV_MEM_CUSTOM_INCLUDE   "lv_port_mem.h"
+    #define LV_MEM_CUSTOM_ALLOC     lv_port_mem_alloc
+    #define LV_MEM_CUSTOM_FREE      lv_port_mem_free
+    #define LV_MEM_CUSTOM_REALLOC   lv_port_mem_realloc
+#endif
+
+/* Put the OSD layer(BSP_USING_VPOST_OSD) under LVGL as a second display */
+//#define LV_USE_OSD_OVERLAY      1
 
 #define LV_COLOR_DEPTH                  BSP_LCD_BPP
 #define LV_HOR_RES_MAX                  BSP_LCD_WIDTH
@@ -37,5 +64,16 @@
 /* Please comment LV_USE_DEMO_RTT_MUSIC declaration before un-comment below */
 //#define LV_USE_DEMO_WIDGETS         1
 //#define LV_USE_DEMO_BENCHMARK       1
+//#define LV_USE_DEMO_GE2D_TEXT       1
+//#define LV_USE_DEMO_OSD_OVERLAY     1
+//#define LV_USE_DEMO_STRESS          1
+//#define LV_USE_DEMO_GE2D_COVERAGE   1
+#if LV_USE_DEMO_GE2D_TEXT
+    #define LV_FONT_UNSCII_16           1
+#endif
+#if LV_USE_DEMO_GE2D_COVERAGE
+    /* It runs the scenes of the benchmark one by one */
+    #define LV_USE_DEMO_BENCHMARK       1
+#endif
 
 #endif
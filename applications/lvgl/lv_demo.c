@@ -6,6 +6,10 @@
  * Change Logs:
  * Date           Author        Notes
  * 2022-6-1       Wayne         First version
+ * 2026-10-19     RT-Thread     Add the GE2D text benchmark
+ * 2026-10-19     RT-Thread     Add the OSD overlay benchmark
+ * 2026-10-19     RT-Thread     Add the stress demo
+ * 2026-10-19     RT-Thread     Add the GE2D coverage run of the benchmark
  */
 
 #include <lvgl.h>
@@ -14,7 +18,23 @@ RT_WEAK void lv_user_gui_init(void)
 {
     /* display demo; you may replace with your LVGL application at here and disable related definitions. */
 
-#if LV_USE_DEMO_BENCHMARK
+#if LV_USE_DEMO_OSD_OVERLAY
+    extern void lv_demo_osd(void);
+    lv_demo_osd();
+
+#elif LV_USE_DEMO_GE2D_TEXT
+    extern void lv_demo_ge2d_text(void);
+    lv_demo_ge2d_text();
+
+#elif LV_USE_DEMO_GE2D_COVERAGE
+    extern void lv_demo_ge2d_cov(void);
+    lv_demo_ge2d_cov();
+
+#elif LV_USE_DEMO_STRESS
+    extern void lv_demo_stress(void);
+    lv_demo_stress();
+
+#elif LV_USE_DEMO_BENCHMARK
     extern void lv_demo_benchmark(void);
     lv_demo_benchmark();
 
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ * 2026-10-19     RT-Thread    Key the scenes by a table, share it with the host test
+ */
+
+/*
+ * GE2D offload coverage of the benchmark scenes: the thresholds and the cost
+ * model are calibrated first, then every scene of lv_demo_benchmark runs on
+ * its own and a line with the pixels per frame of each path, the share of
+ * the engine and the blend time estimated by the cost model is printed.
+ * Comparing the log with the one of an earlier build shows the blends which
+ * fell back to the software.
+ */
+#include <rtthread.h>
+#include <lvgl.h>
+
+#if LV_USE_DEMO_GE2D_COVERAGE
+
+#include "lv_demo_benchmark.h"
+#include "lv_gpu_n9h30_2dge.h"
+#include "lv_demo_ge2d_cov.h"
+
+#define GE2D_COV_CALIB_DELAY_MS     100
+
+/* A scene of lv_demo_benchmark, opaque and translucent */
+#define GE2D_COV_SCENE(no, name)    { (no) * 2, name }, { (no) * 2 + 1, name " + opa" }
+
+/* The scenes of lv_demo_benchmark, in the order of its scene list */
+const lv_demo_ge2d_cov_scene_t lv_demo_ge2d_cov_scenes[] =
+{
+    GE2D_COV_SCENE(0, "Rectangle"),
+    GE2D_COV_SCENE(1, "Rectangle rounded"),
+    GE2D_COV_SCENE(2, "Circle"),
+    GE2D_COV_SCENE(3, "Border"),
+    GE2D_COV_SCENE(4, "Border rounded"),
+    GE2D_COV_SCENE(5, "Circle border"),
+    GE2D_COV_SCENE(6, "Border top"),
+    GE2D_COV_SCENE(7, "Border left"),
+    GE2D_COV_SCENE(8, "Border top + left"),
+    GE2D_COV_SCENE(9, "Border left + right"),
+    GE2D_COV_SCENE(10, "Border top + bottom"),
+    GE2D_COV_SCENE(11, "Shadow small"),
+    GE2D_COV_SCENE(12, "Shadow small offset"),
+    GE2D_COV_SCENE(13, "Shadow large"),
+    GE2D_COV_SCENE(14, "Shadow large offset"),
+    GE2D_COV_SCENE(15, "Image RGB"),
+    GE2D_COV_SCENE(16, "Image ARGB"),
+    GE2D_COV_SCENE(17, "Image chorma keyed"),
+    GE2D_COV_SCENE(18, "Image indexed"),
+    GE2D_COV_SCENE(19, "Image alpha only"),
+    GE2D_COV_SCENE(20, "Image RGB recolor"),
+    GE2D_COV_SCENE(21, "Image ARGB recolor"),
+    GE2D_COV_SCENE(22, "Image chorma keyed recolor"),
+    GE2D_COV_SCENE(23, "Image indexed recolor"),
+    GE2D_COV_SCENE(24, "Image RGB rotate"),
+    GE2D_COV_SCENE(25, "Image RGB rotate anti aliased"),
+    GE2D_COV_SCENE(26, "Image ARGB rotate"),
+    GE2D_COV_SCENE(27, "Image ARGB rotate anti aliased"),
+    GE2D_COV_SCENE(28, "Image RGB zoom"),
+    GE2D_COV_SCENE(29, "Image RGB zoom anti aliased"),
+    GE2D_COV_SCENE(30, "Image ARGB zoom"),
+    GE2D_COV_SCENE(31, "Image ARGB zoom anti aliased"),
+    GE2D_COV_SCENE(32, "Text small"),
+    GE2D_COV_SCENE(33, "Text medium"),
+    GE2D_COV_SCENE(34, "Text large"),
+    GE2D_COV_SCENE(35, "Text small compressed"),
+    GE2D_COV_SCENE(36, "Text medium compressed"),
+    GE2D_COV_SCENE(37, "Text large compressed"),
+    GE2D_COV_SCENE(38, "Line"),
+    GE2D_COV_SCENE(39, "Arc think"),
+    GE2D_COV_SCENE(40, "Arc thick"),
+    GE2D_COV_SCENE(41, "Substr. rectangle"),
+    GE2D_COV_SCENE(42, "Substr. border"),
+    GE2D_COV_SCENE(43, "Substr. shadow"),
+    GE2D_COV_SCENE(44, "Substr. image"),
+    GE2D_COV_SCENE(45, "Substr. line"),
+    GE2D_COV_SCENE(46, "Substr. arc"),
+    GE2D_COV_SCENE(47, "Substr. text"),
+};
+const uint32_t lv_demo_ge2d_cov_scene_num = sizeof(lv_demo_ge2d_cov_scenes) / sizeof(lv_demo_ge2d_cov_scenes[0]);
+
+static uint32_t s_scene;
+static uint64_t s_ge2d_px_sum;
+static uint64_t s_all_px_sum;
+static uint64_t s_est_us_sum;
+static uint32_t s_worst_cov = 101;
+static int32_t s_worst_scene = -1;
+
+static void ge2d_cov_next(lv_timer_t *timer);
+
+static void ge2d_cov_finished(void)
+{
+    lv_draw_n9h30_2dge_stat_t stat;
+    uint32_t frames, ge2d_px = 0, all_px = 0, cov, op;
+
+    lv_draw_n9h30_2dge_get_stat(&stat);
+    frames = stat.frames ? stat.frames : 1;
+
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        ge2d_px += stat.ge2d_px[op];
+        all_px += stat.ge2d_px[op] + stat.sw_px[op];
+    }
+    cov = all_px ? (uint32_t)((uint64_t)ge2d_px * 100 / all_px) : 100;
+
+    rt_kprintf("ge2d_cov,%d,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", lv_demo_ge2d_cov_scenes[s_scene].scene_no, lv_demo_ge2d_cov_scenes[s_scene].name, stat.frames,
+               stat.ge2d_px[GE2D_OP_FILL] / frames, stat.sw_px[GE2D_OP_FILL] / frames,
+               stat.ge2d_px[GE2D_OP_MAP] / frames, stat.sw_px[GE2D_OP_MAP] / frames,
+               stat.ge2d_px[GE2D_OP_MAP_OPA] / frames, stat.sw_px[GE2D_OP_MAP_OPA] / frames,
+               stat.letters_ge2d / frames, stat.letters_sw / frames,
+               cov, stat.est_us / frames);
+
+    s_ge2d_px_sum += ge2d_px;
+    s_all_px_sum += all_px;
+    s_est_us_sum += stat.est_us / frames;
+    if (all_px && (cov < s_worst_cov))
+    {
+        s_worst_cov = cov;
+        s_worst_scene = lv_demo_ge2d_cov_scenes[s_scene].scene_no;
+    }
+
+    /* The benchmark still uses the scene after this callback. */
+    s_scene++;
+    lv_timer_set_repeat_count(lv_timer_create(ge2d_cov_next, 1, NULL), 1);
+}
+
+static void ge2d_cov_next(lv_timer_t *timer)
+{
+    lv_obj_t *scr_old = lv_scr_act();
+    lv_obj_t *scr;
+
+    LV_UNUSED(timer);
+
+    if (s_scene >= lv_demo_ge2d_cov_scene_num)
+    {
+        rt_kprintf("ge2d_cov: %u scenes, engine share %u%%, lowest %u%% in scene %d, estimated blend time %u us per frame of all scenes\n",
+                   s_scene, s_all_px_sum ? (uint32_t)(s_ge2d_px_sum * 100 / s_all_px_sum) : 100,
+                   (s_worst_scene < 0) ? 100 : s_worst_cov, s_worst_scene, (uint32_t)s_est_us_sum);
+        return;
+    }
+
+    /* Every scene starts on an empty screen, the benchmark adds its labels to it. */
+    scr = lv_obj_create(NULL);
+    lv_scr_load(scr);
+    lv_obj_del(scr_old);
+
+    lv_draw_n9h30_2dge_reset_stat();
+    lv_demo_benchmark_run_scene(lv_demo_ge2d_cov_scenes[s_scene].scene_no);
+}
+
+void lv_demo_ge2d_cov(void)
+{
+    /* The cost model comes from the calibration, done at the end of the next frame. */
+    lv_draw_n9h30_2dge_calib_request();
+
+    rt_kprintf("ge2d_cov,scene,name,frames,fill_ge2d,fill_sw,map_ge2d,map_sw,map_opa_ge2d,map_opa_sw,letters_ge2d,letters_sw,ge2d_pct,est_us\n");
+
+    s_scene = 0;
+    lv_demo_benchmark_set_finished_cb(ge2d_cov_finished);
+    lv_timer_set_repeat_count(lv_timer_create(ge2d_cov_next, GE2D_COV_CALIB_DELAY_MS, NULL), 1);
+}
+
+#endif /* LV_USE_DEMO_GE2D_COVERAGE */
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef __LV_DEMO_GE2D_COV_H__
+#define __LV_DEMO_GE2D_COV_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    int16_t scene_no;       /* the argument of lv_demo_benchmark_run_scene() */
+    const char *name;
+} lv_demo_ge2d_cov_scene_t;
+
+/* The benchmark scenes of the coverage run, also run by tests/ on the host */
+extern const lv_demo_ge2d_cov_scene_t lv_demo_ge2d_cov_scenes[];
+extern const uint32_t lv_demo_ge2d_cov_scene_num;
+
+void lv_demo_ge2d_cov(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LV_DEMO_GE2D_COV_H__ */
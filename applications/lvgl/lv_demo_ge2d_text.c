@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * Text-heavy benchmark of the GE2D letter path: a screen filled with labels
+ * whose text changes every frame. Each phase renders for a fixed time with
+ * a 1bpp (unscii) or an anti-aliased (montserrat) font, and with the GE2D
+ * letters on or off; the average render time of the screen is printed.
+ */
+#include <rtthread.h>
+#include <lvgl.h>
+
+#if LV_USE_DEMO_GE2D_TEXT
+
+#include "lv_gpu_n9h30_2dge.h"
+
+#define TEXT_BENCH_PHASE_MS     5000
+#define TEXT_BENCH_LINES        24
+#define TEXT_BENCH_COLUMNS      2
+
+typedef struct
+{
+    const char *name;
+    const lv_font_t *font;
+    bool ge2d;
+} text_bench_phase_t;
+
+static const text_bench_phase_t s_phases[] =
+{
+    { "unscii_16, sw",        &lv_font_unscii_16,      false },
+    { "unscii_16, ge2d",      &lv_font_unscii_16,      true  },
+    { "montserrat_16, sw",    &lv_font_montserrat_16,  false },
+    { "montserrat_16, ge2d",  &lv_font_montserrat_16,  true  },
+};
+
+static lv_obj_t *s_labels[TEXT_BENCH_LINES * TEXT_BENCH_COLUMNS];
+static uint32_t s_phase;
+static uint32_t s_phase_start;
+static uint32_t s_render_start;
+static uint32_t s_render_time;
+static uint32_t s_frames;
+static uint32_t s_seed;
+
+static void text_bench_fill(void)
+{
+    char text[48];
+    int i;
+
+    for (i = 0; i < sizeof(s_labels) / sizeof(s_labels[0]); i++)
+    {
+        s_seed = s_seed * 1103515245 + 12345;
+        lv_snprintf(text, sizeof(text), "%02d: The quick brown fox %08x", i, s_seed);
+        lv_label_set_text(s_labels[i], text);
+    }
+}
+
+static void text_bench_phase_enter(uint32_t phase)
+{
+    int i;
+
+    s_phase = phase;
+    s_phase_start = lv_tick_get();
+    s_render_time = 0;
+    s_frames = 0;
+
+    lv_draw_n9h30_2dge_glyph_enable(s_phases[phase].ge2d);
+    for (i = 0; i < sizeof(s_labels) / sizeof(s_labels[0]); i++)
+        lv_obj_set_style_text_font(s_labels[i], s_phases[phase].font, 0);
+}
+
+static void text_bench_draw_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN_BEGIN)
+    {
+        s_render_start = lv_tick_get();
+    }
+    else
+    {
+        s_render_time += lv_tick_elaps(s_render_start);
+        s_frames++;
+    }
+}
+
+static void text_bench_timer_cb(lv_timer_t *timer)
+{
+    if (lv_tick_elaps(s_phase_start) >= TEXT_BENCH_PHASE_MS)
+    {
+        rt_kprintf("text bench: %-20s %4u frames, %4u ms/frame\n", s_phases[s_phase].name, s_frames,
+                   s_frames ? s_render_time / s_frames : 0);
+
+        if (s_phase + 1 >= sizeof(s_phases) / sizeof(s_phases[0]))
+        {
+            lv_draw_n9h30_2dge_glyph_enable(true);
+            lv_timer_del(timer);
+            return;
+        }
+        text_bench_phase_enter(s_phase + 1);
+    }
+
+    text_bench_fill();
+}
+
+void lv_demo_ge2d_text(void)
+{
+    lv_obj_t *scr = lv_scr_act();
+    lv_coord_t col_w = lv_disp_get_hor_res(NULL) / TEXT_BENCH_COLUMNS;
+    lv_coord_t line_h = lv_disp_get_ver_res(NULL) / TEXT_BENCH_LINES;
+    int i;
+
+    lv_obj_set_style_bg_color(scr, lv_color_white(), 0);
+    lv_obj_set_style_text_color(scr, lv_color_black(), 0);
+    lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
+
+    for (i = 0; i < sizeof(s_labels) / sizeof(s_labels[0]); i++)
+    {
+        s_labels[i] = lv_label_create(scr);
+        lv_obj_set_pos(s_labels[i], (i / TEXT_BENCH_LINES) * col_w, (i % TEXT_BENCH_LINES) * line_h);
+    }
+
+    lv_obj_add_event_cb(scr, text_bench_draw_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+    lv_obj_add_event_cb(scr, text_bench_draw_cb, LV_EVENT_DRAW_POST_END, NULL);
+
+    text_bench_phase_enter(0);
+    text_bench_fill();
+
+    lv_timer_create(text_bench_timer_cb, 0, NULL);
+}
+
+#endif /* LV_USE_DEMO_GE2D_TEXT */
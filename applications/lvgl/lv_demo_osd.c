@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ * 2026-10-19     RT-Thread    count the refreshes from monitor_cb
+ */
+
+/*
+ * Frame time of a screen with a constantly animating overlay: a static
+ * screen of buttons with a moving bar on top. The bar is animated on the
+ * rendering layer first, then on the OSD layer, and the average render
+ * time of each display is printed per phase.
+ */
+#include <rtthread.h>
+#include <lvgl.h>
+
+#if LV_USE_DEMO_OSD_OVERLAY
+
+#define OSD_BENCH_PHASE_MS      5000
+#define OSD_BENCH_BUTTONS       24
+
+extern lv_disp_t *lv_port_disp_get_osd(void);
+extern void lv_port_disp_get_render(lv_disp_t *disp, uint32_t *frames, uint32_t *ms);
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t render_ms;
+} osd_bench_stat_t;
+
+static osd_bench_stat_t s_start[2];     /* rendering layer, OSD layer */
+static lv_obj_t *s_bar;
+static uint32_t s_phase;
+static uint32_t s_phase_start;
+
+/*
+ * The OSD layer redraws the changed areas only, a refresh draws the screen in
+ * several parts. The port counts the refreshes and their render time from
+ * monitor_cb, once per refresh of each display.
+ */
+static void osd_bench_get(osd_bench_stat_t *stat)
+{
+    lv_disp_t *disp[2] = { lv_disp_get_default(), lv_port_disp_get_osd() };
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        stat[i].frames = stat[i].render_ms = 0;
+        if (disp[i])
+            lv_port_disp_get_render(disp[i], &stat[i].frames, &stat[i].render_ms);
+    }
+}
+
+static void osd_bench_anim_cb(void *var, int32_t v)
+{
+    lv_obj_set_x(var, v);
+}
+
+static void osd_bench_bar_create(lv_obj_t *parent)
+{
+    lv_anim_t a;
+
+    if (s_bar)
+        lv_obj_del(s_bar);
+
+    s_bar = lv_obj_create(parent);
+    lv_obj_add_flag(s_bar, LV_OBJ_FLAG_IGNORE_LAYOUT);
+    lv_obj_set_size(s_bar, 160, 48);
+    lv_obj_set_y(s_bar, 16);
+    lv_obj_set_style_bg_color(s_bar, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_set_style_radius(s_bar, 0, 0);
+    lv_obj_set_style_border_width(s_bar, 0, 0);
+
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, s_bar);
+    lv_anim_set_exec_cb(&a, osd_bench_anim_cb);
+    lv_anim_set_values(&a, 0, lv_disp_get_hor_res(NULL) - 160);
+    lv_anim_set_time(&a, 2000);
+    lv_anim_set_playback_time(&a, 2000);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+}
+
+static void osd_bench_phase_enter(uint32_t phase)
+{
+    lv_disp_t *osd = lv_port_disp_get_osd();
+
+    s_phase = phase;
+    s_phase_start = lv_tick_get();
+    osd_bench_get(s_start);
+
+    osd_bench_bar_create((phase == 0) ? lv_scr_act() : lv_disp_get_scr_act(osd));
+}
+
+static void osd_bench_timer_cb(lv_timer_t *timer)
+{
+    osd_bench_stat_t now[2];
+    uint32_t frames, render_ms;
+    int i;
+
+    if (lv_tick_elaps(s_phase_start) < OSD_BENCH_PHASE_MS)
+        return;
+
+    osd_bench_get(now);
+    rt_kprintf("osd bench: bar on %s\n", s_phase ? "osd" : "lcd");
+    for (i = 0; i < 2; i++)
+    {
+        frames = now[i].frames - s_start[i].frames;
+        render_ms = now[i].render_ms - s_start[i].render_ms;
+        rt_kprintf("  %s: %4u frames, %4u ms/frame\n", i ? "osd" : "lcd", frames,
+                   frames ? render_ms / frames : 0);
+    }
+
+    if ((s_phase == 0) && lv_port_disp_get_osd())
+        osd_bench_phase_enter(1);
+    else
+        lv_timer_del(timer);
+}
+
+void lv_demo_osd(void)
+{
+    lv_disp_t *osd = lv_port_disp_get_osd();
+    lv_obj_t *scr = lv_scr_act();
+    lv_obj_t *btn, *label;
+    int i;
+
+    lv_obj_set_flex_flow(scr, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_style_pad_top(scr, 80, 0);
+    for (i = 0; i < OSD_BENCH_BUTTONS; i++)
+    {
+        btn = lv_btn_create(scr);
+        lv_obj_set_size(btn, 180, 60);
+        label = lv_label_create(btn);
+        lv_label_set_text_fmt(label, "Button %d", i);
+        lv_obj_center(label);
+    }
+
+    if (osd == NULL)
+        rt_kprintf("osd bench: no OSD display, LV_USE_OSD_OVERLAY is off\n");
+
+    osd_bench_phase_enter(0);
+
+    lv_timer_create(osd_bench_timer_cb, 100, NULL);
+}
+
+#endif /* LV_USE_DEMO_OSD_OVERLAY */
@@ -6,6 +6,16 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-12-17     Wayne        The first version
+ * 2026-10-19     RT-Thread    Cover 32bpp, split unaligned 16bpp areas
+ * 2026-10-19     RT-Thread    Calibrated offload thresholds, path counters
+ * 2026-10-19     RT-Thread    Cache maintenance of the touched rectangles only
+ * 2026-10-19     RT-Thread    Glyph cache, 1bpp letters by colour expansion
+ * 2026-10-19     RT-Thread    Reset the clipper of the image blit
+ * 2026-10-19     RT-Thread    Cost model from the calibration, statistics API
+ * 2026-10-19     RT-Thread    Count the frames at the flush, not at wait_for_finish()
+ * 2026-10-19     RT-Thread    Word-align the body to the buffer, not the screen
+ * 2026-10-19     RT-Thread    Engine lock, frame buffer copy for the flush thread
+ * 2026-10-19     RT-Thread    Switch the engine off for the reference rendering
  */
 /**
  * @file lv_gpu_n9h30_2dge.c
@@ -15,6 +25,8 @@
 /*********************
  *      INCLUDES
  *********************/
+#include <stdlib.h>
+#include <rtthread.h>
 #include <lvgl.h>
 #include "nu_2d.h"
 #include "mmu.h"
@@ -33,9 +45,67 @@
     #error "Can't use GPU with other formats"
 #endif
 
+/* The engine accesses the buffers in words: a row must start and end on a word. */
+#define GE2D_PX_PER_WORD        (4 / sizeof(lv_color_t))
+#define GE2D_WORD_ALIGNED(x)    (((x) & (GE2D_PX_PER_WORD - 1)) == 0)
+
+/* Smallest area worth the engine setup and the cache maintenance, until calibrated. */
+#define GE2D_MIN_AREA_SIZE      7200
+
+/* Calibration: scratch buffer and time spent on every shape and path */
+#define GE2D_CALIB_WIDTH        256
+#define GE2D_CALIB_HEIGHT       128
+#define GE2D_CALIB_TICKS        (RT_TICK_PER_SECOND / 50)
+#define GE2D_CALIB_WAIT_MS      10000
+
+/*
+ * Glyph cache: the 1bpp glyphs are expanded by the engine from an atlas of
+ * fixed slots, in rows padded to 32 pixels. The slots are grouped in sets
+ * of GE2D_GLYPH_CACHE_WAYS, the least recently used one of a set is replaced.
+ */
+#ifndef GE2D_GLYPH_CACHE_NUM
+    #define GE2D_GLYPH_CACHE_NUM    128
+#endif
+#define GE2D_GLYPH_CACHE_WAYS   4
+#define GE2D_GLYPH_CACHE_SETS   (GE2D_GLYPH_CACHE_NUM / GE2D_GLYPH_CACHE_WAYS)
+#define GE2D_GLYPH_MAX_W        64
+#define GE2D_GLYPH_MAX_H        64
+#define GE2D_GLYPH_SLOT_SIZE    (GE2D_GLYPH_MAX_W / 8 * GE2D_GLYPH_MAX_H)
+#define GE2D_GLYPH_PITCH(w)     (((w) + 31) & ~31)
+
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    const char *name;
+    uint32_t threshold;     /* the engine takes the areas larger than this, in pixels */
+    uint32_t ge2d_px;
+    uint32_t ge2d_calls;
+    uint32_t sw_px;
+    uint32_t sw_calls;
+
+    /* Cost model, fitted by the calibration: time = calls * ns_call + px * ps_px / 1000 */
+    uint32_t ge2d_ns_call;  /* setup, ge2dInit() and cache maintenance of the short rows */
+    uint32_t ge2d_ps_px;
+    uint32_t sw_ns_call;
+    uint32_t sw_ps_px;
+} lv_draw_n9h30_2dge_op_t;
+
+typedef struct
+{
+    const lv_font_t *font;  /* resolved font, NULL for a free slot */
+    uint32_t letter;
+    uint32_t stamp;         /* last use */
+} lv_draw_n9h30_2dge_glyph_t;
+
+typedef struct
+{
+    uint32_t ge2d;          /* letters drawn by the engine */
+    uint32_t sw;            /* letters left to the software */
+    uint32_t hits;
+    uint32_t misses;
+} lv_draw_n9h30_2dge_glyph_stat_t;
 
 /**********************
  *  STATIC PROTOTYPES
@@ -43,11 +113,51 @@
 
 static bool lv_draw_n9h30_2dge_blend_fill(lv_color_t *dest_buf, lv_coord_t dest_stride, const lv_area_t *fill_area, lv_color_t color);
 
-static bool lv_draw_n9h30_2dge_blend_map(lv_color_t *dest_buf, const lv_area_t *dest_area, lv_coord_t dest_stride, const lv_color_t *src_buf, lv_coord_t src_stride, lv_opa_t opa);
+static bool lv_draw_n9h30_2dge_blend_map(lv_color_t *dest_buf, const lv_area_t *dest_area, lv_coord_t dest_stride, const lv_color_t *src_buf, lv_coord_t src_x, lv_coord_t src_stride, lv_opa_t opa);
+
+static void lv_draw_n9h30_2dge_blend_sw(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc, lv_coord_t x1, lv_coord_t x2, const lv_area_t *blend_area);
+
+static void lv_draw_n9h30_2dge_calibrate(void);
+
+static const uint8_t *lv_draw_n9h30_2dge_glyph_get(const lv_font_glyph_dsc_t *g, uint32_t letter);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_draw_n9h30_2dge_op_t s_ge2d_ops[GE2D_OP_NUM] =
+{
+    { "fill",    GE2D_MIN_AREA_SIZE },
+    { "map",     GE2D_MIN_AREA_SIZE },
+    { "map_opa", GE2D_MIN_AREA_SIZE },
+};
+
+/* The calibration runs in the LVGL thread, at the end of the next drawn frame. */
+#if defined(BSP_LVGL_GE2D_CALIBRATE)
+    static volatile int s_ge2d_calib_request = 1;
+#else
+    static volatile int s_ge2d_calib_request = 0;
+#endif
+
+static uint32_t s_ge2d_frames = 0;
+static bool s_ge2d_calibrated = false;
+
+/* The engine setup of a blit spans several calls, the flush thread copies between those of the LVGL thread. */
+static rt_mutex_t s_ge2d_lock = RT_NULL;
+
+/* Off: every blend, letter and copy goes to the software */
+static bool s_ge2d_enable = true;
+static bool s_ge2d_glyph_enable = true;
+static uint8_t *s_ge2d_glyph_atlas = NULL;
+static uint32_t s_ge2d_glyph_stamp = 0;
+static lv_draw_n9h30_2dge_glyph_t s_ge2d_glyphs[GE2D_GLYPH_CACHE_NUM];
+static lv_draw_n9h30_2dge_glyph_stat_t s_ge2d_glyph_stat;
+
+/* Shapes of the calibration, in growing pixel count */
+static const lv_point_t s_ge2d_calib_shapes[] =
+{
+    { 16, 8 }, { 32, 16 }, { 64, 16 }, { 16, 128 }, { 64, 64 }, { 256, 16 },
+    { 32, 128 }, { 128, 64 }, { 256, 64 }, { 128, 128 }, { 256, 128 }
+};
 
 /**********************
  *      MACROS
@@ -64,9 +174,14 @@ void lv_draw_n9h30_2dge_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
 {
     lv_draw_sw_init_ctx(drv, draw_ctx);
 
+    if (s_ge2d_lock == RT_NULL)
+        s_ge2d_lock = rt_mutex_create("ge2d", RT_IPC_FLAG_PRIO);
+    RT_ASSERT(s_ge2d_lock != RT_NULL);
+
     lv_draw_n9h30_2dge_ctx_t *ge2d_draw_ctx = (lv_draw_sw_ctx_t *)draw_ctx;
 
     ge2d_draw_ctx->blend = lv_draw_n9h30_2dge_blend;
+    ge2d_draw_ctx->base_draw.draw_letter = lv_draw_n9h30_2dge_letter;
     ge2d_draw_ctx->base_draw.wait_for_finish = lv_gpu_n9h30_2dge_wait_cb;
 }
 
@@ -78,60 +193,251 @@ void lv_draw_n9h30_2dge_ctx_deinit(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
 
 void lv_draw_n9h30_2dge_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
 {
-    lv_area_t blend_area;
-    bool bAlignedWord, done = false;
+    lv_area_t blend_area, body_area;
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    lv_draw_n9h30_2dge_op_t *op;
+    lv_coord_t buf_x1 = draw_ctx->buf_area->x1;
+    uint32_t blend_size, body_size;
+    bool done = false;
 
     if (!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) return;
 
-#if (LV_COLOR_DEPTH == 16)
-
-    uint32_t blend_area_stride = lv_area_get_width(&blend_area) * sizeof(lv_color_t);
-    /* Check Hardware constraint: The stride must be a word-alignment. */
-    bAlignedWord = ((blend_area_stride & 0x3) == 0) &&
-                   (((blend_area.x1 * sizeof(lv_color_t)) & 0x3) == 0) ? true : false;
-
-    LV_LOG_INFO("[%s] %d %d %d",     __func__, lv_area_get_size(&blend_area), (blend_area_stride & 0x3), (blend_area.x1 & 0x2));
-
-#else
-
-    bAlignedWord = false;
-
-#endif
+    /*
+     * The engine handles the body of the area whose columns start and end on
+     * a word of the buffer. The words count from the first column of the
+     * buffer, which is not on a word of the screen in partial mode. With
+     * 16bpp an odd first or even last column is left over, the software
+     * blends these edge columns after the engine is done.
+     */
+    body_area = blend_area;
+    body_area.x1 = buf_x1 + ((blend_area.x1 - buf_x1 + GE2D_PX_PER_WORD - 1) & ~(GE2D_PX_PER_WORD - 1));
+    body_area.x2 = buf_x1 + ((blend_area.x2 - buf_x1 + 1) & ~(GE2D_PX_PER_WORD - 1)) - 1;
+
+    blend_size = lv_area_get_size(&blend_area);
+    body_size = (body_area.x2 > body_area.x1) ? lv_area_get_size(&body_area) : 0;
+
+    if (dsc->src_buf)
+        op = &s_ge2d_ops[(dsc->opa >= LV_OPA_MAX) ? GE2D_OP_MAP : GE2D_OP_MAP_OPA];
+    else
+        op = &s_ge2d_ops[GE2D_OP_FILL];
 
+    LV_LOG_INFO("[%s] %s %d %d-%d body %d-%d", __func__, op->name, blend_size, blend_area.x1, blend_area.x2, body_area.x1, body_area.x2);
 
-    if ((lv_area_get_size(&blend_area) > 7200) &&
-            bAlignedWord &&
+    if (s_ge2d_enable && (body_size > op->threshold) &&
+            GE2D_WORD_ALIGNED(lv_area_get_width(draw_ctx->buf_area)) &&
             (dsc->mask_buf == NULL) &&
-            (dsc->blend_mode == LV_BLEND_MODE_NORMAL))
+            (dsc->blend_mode == LV_BLEND_MODE_NORMAL) &&
+            ((disp == NULL) || ((disp->driver->set_px_cb == NULL) && (disp->driver->screen_transp == 0))))
     {
         lv_coord_t dest_stride = lv_area_get_width(draw_ctx->buf_area);  /*Width of the destination buffer*/
+        lv_area_t dest_area = body_area;
+
+        lv_area_move(&dest_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
 
         /* Pointer to an image to blend. If set, color is ignored. If not set fill blend_area with color. */
         if (dsc->src_buf)
         {
-
             lv_coord_t src_stride = lv_area_get_width(dsc->blend_area);  /*Width of the source buffer*/
-            lv_color_t *src_buf = (lv_color_t *)dsc->src_buf + (src_stride * (blend_area.y1 - dsc->blend_area->y1) + (blend_area.x1 -  dsc->blend_area->x1));
-            lv_area_move(&blend_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
+            lv_coord_t src_x = body_area.x1 - dsc->blend_area->x1;
+            const lv_color_t *src_buf = (const lv_color_t *)dsc->src_buf + src_stride * (body_area.y1 - dsc->blend_area->y1);
 
-            if (src_stride == lv_area_get_width(&blend_area))
-                done = lv_draw_n9h30_2dge_blend_map(draw_ctx->buf, &blend_area, dest_stride, src_buf, src_stride, dsc->opa);
+            /* The source rows have to be word-aligned at the same columns. */
+            if (GE2D_WORD_ALIGNED(src_stride) && GE2D_WORD_ALIGNED(src_x) && GE2D_WORD_ALIGNED((uint32_t)src_buf / sizeof(lv_color_t)))
+                done = lv_draw_n9h30_2dge_blend_map(draw_ctx->buf, &dest_area, dest_stride, src_buf, src_x, src_stride, dsc->opa);
         }
         else if (dsc->opa >= LV_OPA_MAX)
         {
-            lv_area_move(&blend_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
-
-            done = lv_draw_n9h30_2dge_blend_fill(draw_ctx->buf, dest_stride, &blend_area, dsc->color);
+            done = lv_draw_n9h30_2dge_blend_fill(draw_ctx->buf, dest_stride, &dest_area, dsc->color);
         }
     }
 
-
     if (!done)
     {
         lv_draw_sw_blend_basic(draw_ctx, dsc);
+
+        op->sw_px += blend_size;
+        op->sw_calls++;
+    }
+    else
+    {
+        op->ge2d_px += body_size;
+        op->ge2d_calls++;
+        op->sw_px += blend_size - body_size;
+
+        /* The edge columns beside the body */
+        if (blend_area.x1 < body_area.x1)
+            lv_draw_n9h30_2dge_blend_sw(draw_ctx, dsc, blend_area.x1, body_area.x1 - 1, &blend_area);
+        if (blend_area.x2 > body_area.x2)
+            lv_draw_n9h30_2dge_blend_sw(draw_ctx, dsc, body_area.x2 + 1, blend_area.x2, &blend_area);
     }
 }
 
+/*
+ * Letters of 1bpp fonts are expanded by the engine from the glyph cache.
+ * Anti-aliased fonts, translucent text, masks and the letters on the
+ * buffer edges go to lv_draw_sw_letter().
+ */
+void lv_draw_n9h30_2dge_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p, uint32_t letter)
+{
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    lv_font_glyph_dsc_t g;
+    lv_area_t glyph_area, clip_area;
+    lv_coord_t dest_stride;
+    const uint8_t *bitmap;
+
+    if (!s_ge2d_enable || !s_ge2d_glyph_enable ||
+            (dsc->opa < LV_OPA_MAX) ||
+            (dsc->blend_mode != LV_BLEND_MODE_NORMAL) ||
+            (disp == NULL) || (disp->driver->set_px_cb != NULL) || (disp->driver->screen_transp != 0))
+        goto exit_lv_draw_n9h30_2dge_letter;
+
+    /* The software reports the missing glyphs and skips the empty ones. */
+    if (!lv_font_get_glyph_dsc(dsc->font, &g, letter, '\0') ||
+            (g.bpp != 1) || g.resolved_font->subpx ||
+            (g.box_w == 0) || (g.box_h == 0) ||
+            (g.box_w > GE2D_GLYPH_MAX_W) || (g.box_h > GE2D_GLYPH_MAX_H))
+        goto exit_lv_draw_n9h30_2dge_letter;
+
+    glyph_area.x1 = pos_p->x + g.ofs_x;
+    glyph_area.y1 = pos_p->y + (dsc->font->line_height - dsc->font->base_line) - g.box_h - g.ofs_y;
+    glyph_area.x2 = glyph_area.x1 + g.box_w - 1;
+    glyph_area.y2 = glyph_area.y1 + g.box_h - 1;
+
+    if (!_lv_area_intersect(&clip_area, &glyph_area, draw_ctx->clip_area))
+        return;
+
+    /* The clipper of the engine takes at least 2x2 pixels, the start point has to be in the buffer. */
+    if ((lv_area_get_width(&clip_area) < 2) || (lv_area_get_height(&clip_area) < 2) ||
+            (glyph_area.x1 < draw_ctx->buf_area->x1) || (glyph_area.y1 < draw_ctx->buf_area->y1) ||
+            lv_draw_mask_is_any(&clip_area))
+        goto exit_lv_draw_n9h30_2dge_letter;
+
+    bitmap = lv_draw_n9h30_2dge_glyph_get(&g, letter);
+    if (bitmap == NULL)
+        goto exit_lv_draw_n9h30_2dge_letter;
+
+    lv_area_move(&glyph_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
+    lv_area_move(&clip_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
+    dest_stride = lv_area_get_width(draw_ctx->buf_area);
+
+    mmu_clean_invalidated_dcache_rect((rt_uint32_t)((lv_color_t *)draw_ctx->buf + clip_area.y1 * dest_stride + clip_area.x1),
+                                      sizeof(lv_color_t) * dest_stride,
+                                      sizeof(lv_color_t) * lv_area_get_width(&clip_area), lv_area_get_height(&clip_area));
+
+    // Enter GE2D ->
+    rt_mutex_take(s_ge2d_lock, RT_WAITING_FOREVER);
+    ge2dInit(LV_COLOR_DEPTH, dest_stride, lv_area_get_height(draw_ctx->buf_area), draw_ctx->buf);
+
+    /* The padding of the rows is transparent, the clipper keeps the row end out. */
+    ge2dClip_SetClip(clip_area.x1, clip_area.y1, clip_area.x2, clip_area.y2);
+
+    ge2dColorExpansionBlt(glyph_area.x1, glyph_area.y1, GE2D_GLYPH_PITCH(g.box_w), g.box_h,
+                          lv_color_to32(dsc->color) & 0x00ffffff, 0, MODE_TRANSPARENT, (void *)bitmap);
+
+    ge2dClip_SetClip(-1, 0, 0, 0);
+    rt_mutex_release(s_ge2d_lock);
+    // -> Leave GE2D
+
+    s_ge2d_glyph_stat.ge2d++;
+
+    return;
+
+exit_lv_draw_n9h30_2dge_letter:
+
+    s_ge2d_glyph_stat.sw++;
+
+    lv_draw_sw_letter(draw_ctx, dsc, pos_p, letter);
+}
+
+/*
+ * Copy a rectangle of rows to the frame buffer by the engine, for the flush
+ * thread: no LVGL state is read or changed. False when the engine is not set
+ * up, the area is below the map threshold or a row is not word-aligned.
+ */
+bool lv_draw_n9h30_2dge_copy(lv_color_t *dest_buf, lv_coord_t dest_stride, const lv_area_t *dest_area, const lv_color_t *src_buf)
+{
+    lv_coord_t src_stride = lv_area_get_width(dest_area);
+
+    if (!s_ge2d_enable || (s_ge2d_lock == RT_NULL) ||
+            ((uint32_t)lv_area_get_size(dest_area) <= s_ge2d_ops[GE2D_OP_MAP].threshold) ||
+            !GE2D_WORD_ALIGNED(dest_stride) || !GE2D_WORD_ALIGNED(dest_area->x1) ||
+            !GE2D_WORD_ALIGNED(src_stride) || !GE2D_WORD_ALIGNED((uint32_t)src_buf / sizeof(lv_color_t)))
+        return false;
+
+    return lv_draw_n9h30_2dge_blend_map(dest_buf, dest_area, dest_stride, src_buf, 0, src_stride, LV_OPA_COVER);
+}
+
+void lv_draw_n9h30_2dge_enable(bool en)
+{
+    s_ge2d_enable = en;
+}
+
+void lv_draw_n9h30_2dge_glyph_enable(bool en)
+{
+    s_ge2d_glyph_enable = en;
+}
+
+void lv_draw_n9h30_2dge_calib_request(void)
+{
+    s_ge2d_calib_request = 1;
+}
+
+/* LVGL waits for the draw context before each software blend too, the flush marks the frames. */
+void lv_draw_n9h30_2dge_frame_done(void)
+{
+    s_ge2d_frames++;
+}
+
+void lv_draw_n9h30_2dge_reset_stat(void)
+{
+    int op;
+
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        s_ge2d_ops[op].ge2d_px = s_ge2d_ops[op].ge2d_calls = 0;
+        s_ge2d_ops[op].sw_px = s_ge2d_ops[op].sw_calls = 0;
+    }
+    lv_memset_00(&s_ge2d_glyph_stat, sizeof(s_ge2d_glyph_stat));
+    s_ge2d_frames = 0;
+}
+
+void lv_draw_n9h30_2dge_get_stat(lv_draw_n9h30_2dge_stat_t *stat)
+{
+    uint64_t est_ns = 0;
+    int op;
+
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        const lv_draw_n9h30_2dge_op_t *psOp = &s_ge2d_ops[op];
+
+        stat->ge2d_px[op] = psOp->ge2d_px;
+        stat->ge2d_calls[op] = psOp->ge2d_calls;
+        stat->sw_px[op] = psOp->sw_px;
+        stat->sw_calls[op] = psOp->sw_calls;
+
+        est_ns += (uint64_t)psOp->ge2d_calls * psOp->ge2d_ns_call + (uint64_t)psOp->ge2d_px * psOp->ge2d_ps_px / 1000;
+        est_ns += (uint64_t)psOp->sw_calls * psOp->sw_ns_call + (uint64_t)psOp->sw_px * psOp->sw_ps_px / 1000;
+    }
+
+    stat->letters_ge2d = s_ge2d_glyph_stat.ge2d;
+    stat->letters_sw = s_ge2d_glyph_stat.sw;
+    stat->frames = s_ge2d_frames;
+    stat->est_us = s_ge2d_calibrated ? (uint32_t)(est_ns / 1000) : 0;
+}
+
+/* Blend the columns x1..x2 of the blend area in software. */
+static void lv_draw_n9h30_2dge_blend_sw(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc, lv_coord_t x1, lv_coord_t x2, const lv_area_t *blend_area)
+{
+    lv_draw_ctx_t edge_ctx = *draw_ctx;
+    lv_area_t edge_area = *blend_area;
+
+    edge_area.x1 = x1;
+    edge_area.x2 = x2;
+    edge_ctx.clip_area = &edge_area;
+
+    lv_draw_sw_blend_basic(&edge_ctx, dsc);
+}
+
 static bool lv_draw_n9h30_2dge_blend_fill(lv_color_t *dest_buf, lv_coord_t dest_stride, const lv_area_t *fill_area, lv_color_t color)
 {
     int32_t fill_area_w = lv_area_get_width(fill_area);
@@ -140,10 +446,12 @@ static bool lv_draw_n9h30_2dge_blend_fill(lv_color_t *dest_buf, lv_coord_t dest_
 
     LV_LOG_INFO("[%s] %d %d %08x color=%08x@%08x %d %d %dx%d", __func__, dest_stride, lv_area_get_size(fill_area), lv_color_to32(color),  color, dest_buf, fill_area->x1, fill_area->y1, fill_area_w, fill_area_h);
 
-    mmu_clean_invalidated_dcache((rt_uint32_t)dest_buf_start, sizeof(lv_color_t) * dest_stride * fill_area_h);
+    mmu_clean_invalidated_dcache_rect((rt_uint32_t)(dest_buf_start + fill_area->x1), sizeof(lv_color_t) * dest_stride,
+                                      sizeof(lv_color_t) * fill_area_w, fill_area_h);
 
     /*Hardware filling*/
     // Enter GE2D ->
+    rt_mutex_take(s_ge2d_lock, RT_WAITING_FOREVER);
     ge2dInit(LV_COLOR_DEPTH, dest_stride, fill_area_h, (void *)dest_buf);
 
     ge2dClip_SetClip(fill_area->x1, fill_area->y1, fill_area->x2, fill_area->y2);
@@ -155,6 +463,7 @@ static bool lv_draw_n9h30_2dge_blend_fill(lv_color_t *dest_buf, lv_coord_t dest_
 #endif
 
     ge2dClip_SetClip(-1, 0, 0, 0);
+    rt_mutex_release(s_ge2d_lock);
     // -> Leave GE2D
 
     return true;
@@ -162,7 +471,7 @@ static bool lv_draw_n9h30_2dge_blend_fill(lv_color_t *dest_buf, lv_coord_t dest_
 
 
 static bool lv_draw_n9h30_2dge_blend_map(lv_color_t *dest_buf, const lv_area_t *dest_area, lv_coord_t dest_stride,
-        const lv_color_t *src_buf, lv_coord_t src_stride, lv_opa_t opa)
+        const lv_color_t *src_buf, lv_coord_t src_x, lv_coord_t src_stride, lv_opa_t opa)
 {
     int32_t dest_w = lv_area_get_width(dest_area);
     int32_t dest_h = lv_area_get_height(dest_area);
@@ -171,22 +480,30 @@ static bool lv_draw_n9h30_2dge_blend_map(lv_color_t *dest_buf, const lv_area_t *
     const lv_color_t *dest_start_buf = dest_buf + (dest_y * dest_stride);
 
     // Enter GE2D ->
+    rt_mutex_take(s_ge2d_lock, RT_WAITING_FOREVER);
     ge2dInit(LV_COLOR_DEPTH, dest_stride, dest_h, (void *)dest_buf);
 
+    /* ge2dInit() leaves the color-key transparency on and the clipper of the last user. */
+    ge2dBitblt_SetDrawMode(0, 0, 0);
+    ge2dClip_SetClip(-1, 0, 0, 0);
+
     if (opa >= LV_OPA_MAX)
     {
         ge2dBitblt_SetAlphaMode(0, 0, 0);
-        ge2dBitblt_SetDrawMode(0, 0, 0);
     }
     else
     {
-        ge2dBitblt_SetAlphaMode(1, opa, opa);
+        /* Ks + Kd is LV_OPA_COVER, within the limit of the engine. */
+        ge2dBitblt_SetAlphaMode(1, opa, LV_OPA_COVER - opa);
     }
 
-    mmu_clean_invalidated_dcache((rt_uint32_t)dest_start_buf, sizeof(lv_color_t) * dest_stride * dest_h);
-    mmu_clean_dcache((rt_uint32_t)src_buf, sizeof(lv_color_t) * (src_stride * dest_h + dest_w));
+    mmu_clean_invalidated_dcache_rect((rt_uint32_t)(dest_start_buf + dest_x), sizeof(lv_color_t) * dest_stride,
+                                      sizeof(lv_color_t) * dest_w, dest_h);
+    mmu_clean_dcache_rect((rt_uint32_t)(src_buf + src_x), sizeof(lv_color_t) * src_stride,
+                          sizeof(lv_color_t) * dest_w, dest_h);
 
-    ge2dSpriteBlt_Screen(dest_x, dest_y, dest_w, dest_h, (void *)src_buf);
+    ge2dSpriteBltx_Screen(dest_x, dest_y, src_x, 0, dest_w, dest_h, src_stride, dest_h, (void *)src_buf);
+    rt_mutex_release(s_ge2d_lock);
     // -> Leave GE2D
 
     return true;
@@ -197,8 +514,302 @@ static bool lv_draw_n9h30_2dge_blend_map(lv_color_t *dest_buf, const lv_area_t *
 void lv_gpu_n9h30_2dge_wait_cb(lv_draw_ctx_t *draw_ctx)
 {
     lv_draw_sw_wait_for_finish(draw_ctx);
+
+    /* The display is refreshing here, the software blend needs it. */
+    if (s_ge2d_calib_request)
+    {
+        lv_draw_n9h30_2dge_calibrate();
+        s_ge2d_calib_request = 0;
+    }
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+/* Expand the bit stream of a 1bpp glyph into rows of GE2D_GLYPH_PITCH() bits. */
+static void lv_draw_n9h30_2dge_glyph_expand(uint8_t *dst, const uint8_t *src, uint32_t box_w, uint32_t box_h)
+{
+    uint32_t pitch = GE2D_GLYPH_PITCH(box_w) / 8;
+    uint32_t bit = 0, row, col;
+
+    lv_memset_00(dst, pitch * box_h);
+
+    for (row = 0; row < box_h; row++)
+    {
+        for (col = 0; col < box_w; col++, bit++)
+        {
+            if (src[bit >> 3] & (0x80 >> (bit & 0x7)))
+                dst[col >> 3] |= 0x80 >> (col & 0x7);
+        }
+        dst += pitch;
+    }
+}
+
+/* Look the glyph up in its set of the cache, rasterize it into the LRU slot on a miss. */
+static const uint8_t *lv_draw_n9h30_2dge_glyph_get(const lv_font_glyph_dsc_t *g, uint32_t letter)
+{
+    uint32_t set = (letter ^ ((uint32_t)g->resolved_font >> 4)) % GE2D_GLYPH_CACHE_SETS;
+    lv_draw_n9h30_2dge_glyph_t *glyph = &s_ge2d_glyphs[set * GE2D_GLYPH_CACHE_WAYS];
+    lv_draw_n9h30_2dge_glyph_t *victim = glyph;
+    const uint8_t *map_p;
+    uint8_t *slot;
+    int way;
+
+    if (s_ge2d_glyph_atlas == NULL)
+    {
+        s_ge2d_glyph_atlas = rt_malloc_align(GE2D_GLYPH_CACHE_NUM * GE2D_GLYPH_SLOT_SIZE, CACHE_LINE_SIZE);
+        if (s_ge2d_glyph_atlas == NULL)
+        {
+            LV_LOG_WARN("[%s] no memory for the glyph atlas", __func__);
+            s_ge2d_glyph_enable = false;
+            return NULL;
+        }
+    }
+
+    s_ge2d_glyph_stamp++;
+
+    for (way = 0; way < GE2D_GLYPH_CACHE_WAYS; way++, glyph++)
+    {
+        if ((glyph->font == g->resolved_font) && (glyph->letter == letter))
+        {
+            glyph->stamp = s_ge2d_glyph_stamp;
+            s_ge2d_glyph_stat.hits++;
+            return s_ge2d_glyph_atlas + (glyph - s_ge2d_glyphs) * GE2D_GLYPH_SLOT_SIZE;
+        }
+
+        if ((glyph->font == NULL) || ((victim->font != NULL) && (glyph->stamp < victim->stamp)))
+            victim = glyph;
+    }
+
+    map_p = lv_font_get_glyph_bitmap(g->resolved_font, letter);
+    if (map_p == NULL)
+        return NULL;
+
+    slot = s_ge2d_glyph_atlas + (victim - s_ge2d_glyphs) * GE2D_GLYPH_SLOT_SIZE;
+    lv_draw_n9h30_2dge_glyph_expand(slot, map_p, g->box_w, g->box_h);
+    mmu_clean_dcache((rt_uint32_t)slot, GE2D_GLYPH_PITCH(g->box_w) / 8 * g->box_h);
+
+    victim->font = g->resolved_font;
+    victim->letter = letter;
+    victim->stamp = s_ge2d_glyph_stamp;
+    s_ge2d_glyph_stat.misses++;
+
+    return slot;
+}
+
+/* Time of one blend in ns, averaged over GE2D_CALIB_TICKS */
+static uint32_t lv_draw_n9h30_2dge_calib_time(lv_draw_n9h30_2dge_op_e op, bool use_ge2d, lv_draw_ctx_t *draw_ctx, lv_draw_sw_blend_dsc_t *dsc)
+{
+    lv_area_t dest_area = *dsc->blend_area;
+    lv_coord_t dest_stride = lv_area_get_width(draw_ctx->buf_area);
+    rt_tick_t start, elapsed;
+    uint32_t count = 0;
+
+    lv_area_move(&dest_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
+
+    start = rt_tick_get();
+    do
+    {
+        if (!use_ge2d)
+            lv_draw_sw_blend_basic(draw_ctx, dsc);
+        else if (op == GE2D_OP_FILL)
+            lv_draw_n9h30_2dge_blend_fill(draw_ctx->buf, dest_stride, &dest_area, dsc->color);
+        else if (!lv_draw_n9h30_2dge_blend_map(draw_ctx->buf, &dest_area, dest_stride, dsc->src_buf, 0, lv_area_get_width(dsc->blend_area), dsc->opa))
+            return UINT32_MAX;
+        count++;
+        elapsed = rt_tick_get() - start;
+    }
+    while (elapsed < GE2D_CALIB_TICKS);
+
+    return (uint32_t)((uint64_t)elapsed * (1000000000 / RT_TICK_PER_SECOND) / count);
+}
+
+/* Line through the times of the smallest and the largest shape: call cost and cost per pixel */
+static void lv_draw_n9h30_2dge_calib_fit(uint32_t px0, uint32_t ns0, uint32_t px1, uint32_t ns1, uint32_t *ns_call, uint32_t *ps_px)
+{
+    uint32_t px_ns;
+
+    *ps_px = (ns1 > ns0) ? (uint32_t)((uint64_t)(ns1 - ns0) * 1000 / (px1 - px0)) : 0;
+    px_ns = (uint32_t)((uint64_t)px0 * *ps_px / 1000);
+    *ns_call = (ns0 > px_ns) ? ns0 - px_ns : 0;
+}
+
+/*
+ * Time the software and the engine on every calibration shape and take the
+ * largest shape on which the software is not slower as threshold. The
+ * engine side includes ge2dInit() and the cache maintenance of the rows.
+ * The times of the first and the last shape give the cost model.
+ */
+static void lv_draw_n9h30_2dge_calibrate(void)
+{
+    uint32_t buf_size = GE2D_CALIB_WIDTH * GE2D_CALIB_HEIGHT * sizeof(lv_color_t);
+    lv_area_t buf_area = { 0, 0, GE2D_CALIB_WIDTH - 1, GE2D_CALIB_HEIGHT - 1 };
+    lv_color_t *dest_buf, *src_buf;
+    int op, i;
+
+    dest_buf = rt_malloc_align(buf_size, 32);
+    src_buf = rt_malloc_align(buf_size, 32);
+    if ((dest_buf == RT_NULL) || (src_buf == RT_NULL))
+    {
+        rt_kprintf("ge2d: no memory for the calibration\n");
+        goto exit_calibrate;
+    }
+    lv_memset_00(dest_buf, buf_size);
+    lv_memset_ff(src_buf, buf_size);
+
+    rt_kprintf("%-8s %-8s %8s %10s %10s\n", "op", "shape", "pixels", "sw(ns)", "ge2d(ns)");
+
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        uint32_t threshold = 0;
+        uint32_t px0 = 0, sw_ns0 = 0, ge2d_ns0 = 0;
+
+        for (i = 0; i < sizeof(s_ge2d_calib_shapes) / sizeof(s_ge2d_calib_shapes[0]); i++)
+        {
+            lv_area_t shape_area = { 0, 0, s_ge2d_calib_shapes[i].x - 1, s_ge2d_calib_shapes[i].y - 1 };
+            lv_draw_sw_blend_dsc_t dsc = { 0 };
+            lv_draw_ctx_t draw_ctx = { 0 };
+            uint32_t sw_ns, ge2d_ns;
+
+            dsc.blend_area = &shape_area;
+            dsc.src_buf = (op == GE2D_OP_FILL) ? NULL : src_buf;
+            dsc.color = lv_color_hex(0x808080);
+            dsc.opa = (op == GE2D_OP_MAP_OPA) ? LV_OPA_50 : LV_OPA_COVER;
+            dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+
+            draw_ctx.buf = dest_buf;
+            draw_ctx.buf_area = &buf_area;
+            draw_ctx.clip_area = &shape_area;
+
+            sw_ns = lv_draw_n9h30_2dge_calib_time(op, false, &draw_ctx, &dsc);
+            ge2d_ns = lv_draw_n9h30_2dge_calib_time(op, true, &draw_ctx, &dsc);
+
+            if ((ge2d_ns >= sw_ns) && (lv_area_get_size(&shape_area) > threshold))
+                threshold = lv_area_get_size(&shape_area);
+
+            if (i == 0)
+            {
+                px0 = lv_area_get_size(&shape_area);
+                sw_ns0 = sw_ns;
+                ge2d_ns0 = ge2d_ns;
+            }
+            else if ((i == sizeof(s_ge2d_calib_shapes) / sizeof(s_ge2d_calib_shapes[0]) - 1) && (ge2d_ns0 != UINT32_MAX) && (ge2d_ns != UINT32_MAX))
+            {
+                lv_draw_n9h30_2dge_calib_fit(px0, sw_ns0, lv_area_get_size(&shape_area), sw_ns, &s_ge2d_ops[op].sw_ns_call, &s_ge2d_ops[op].sw_ps_px);
+                lv_draw_n9h30_2dge_calib_fit(px0, ge2d_ns0, lv_area_get_size(&shape_area), ge2d_ns, &s_ge2d_ops[op].ge2d_ns_call, &s_ge2d_ops[op].ge2d_ps_px);
+            }
+
+            rt_kprintf("%-8s %3dx%-4d %8u %10u %10u\n", s_ge2d_ops[op].name, s_ge2d_calib_shapes[i].x, s_ge2d_calib_shapes[i].y,
+                       lv_area_get_size(&shape_area), sw_ns, ge2d_ns);
+        }
+
+        /* The engine lost on the largest shape, keep the software. */
+        if (threshold == GE2D_CALIB_WIDTH * GE2D_CALIB_HEIGHT)
+            threshold = UINT32_MAX;
+
+        s_ge2d_ops[op].threshold = threshold;
+    }
+
+    s_ge2d_calibrated = true;
+
+exit_calibrate:
+
+    if (dest_buf)
+        rt_free_align(dest_buf);
+    if (src_buf)
+        rt_free_align(src_buf);
+}
+
+static void ge2d_stat_dump(void)
+{
+    lv_draw_n9h30_2dge_stat_t stat;
+    int op;
+
+    rt_kprintf("%-8s %10s %10s %10s %10s %10s\n", "op", "threshold", "ge2d_px", "ge2d_calls", "sw_px", "sw_calls");
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        lv_draw_n9h30_2dge_op_t *psOp = &s_ge2d_ops[op];
+
+        if (psOp->threshold == UINT32_MAX)
+            rt_kprintf("%-8s %10s", psOp->name, "sw only");
+        else
+            rt_kprintf("%-8s %10u", psOp->name, psOp->threshold);
+        rt_kprintf(" %10u %10u %10u %10u\n", psOp->ge2d_px, psOp->ge2d_calls, psOp->sw_px, psOp->sw_calls);
+    }
+
+    rt_kprintf("letters: %s, ge2d %u, sw %u, glyph cache hits %u, misses %u\n", s_ge2d_glyph_enable ? "on" : "off",
+               s_ge2d_glyph_stat.ge2d, s_ge2d_glyph_stat.sw, s_ge2d_glyph_stat.hits, s_ge2d_glyph_stat.misses);
+
+    if (!s_ge2d_calibrated)
+        return;
+
+    rt_kprintf("%-8s %12s %12s %12s %12s\n", "model", "ge2d ns/call", "ge2d ps/px", "sw ns/call", "sw ps/px");
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        lv_draw_n9h30_2dge_op_t *psOp = &s_ge2d_ops[op];
+
+        rt_kprintf("%-8s %12u %12u %12u %12u\n", psOp->name, psOp->ge2d_ns_call, psOp->ge2d_ps_px, psOp->sw_ns_call, psOp->sw_ps_px);
+    }
+
+    lv_draw_n9h30_2dge_get_stat(&stat);
+    rt_kprintf("frames %u, estimated blend time %u us\n", stat.frames, stat.est_us);
+}
+
+static int ge2d_stat(int argc, char *argv[])
+{
+    int op, i;
+
+    if (argc < 2)
+    {
+        ge2d_stat_dump();
+    }
+    else if (!rt_strcmp(argv[1], "reset"))
+    {
+        lv_draw_n9h30_2dge_reset_stat();
+    }
+    else if (!rt_strcmp(argv[1], "calib"))
+    {
+        s_ge2d_calib_request = 1;
+
+        /* Served by the LVGL thread at the end of the next frame */
+        for (i = 0; s_ge2d_calib_request && (i < GE2D_CALIB_WAIT_MS / 10); i++)
+            rt_thread_mdelay(10);
+
+        if (s_ge2d_calib_request)
+        {
+            rt_kprintf("ge2d: no frame drawn, the calibration runs with the next one\n");
+            return -RT_ETIMEOUT;
+        }
+        ge2d_stat_dump();
+    }
+    else if (!rt_strcmp(argv[1], "engine") && (argc == 3))
+    {
+        lv_draw_n9h30_2dge_enable(!rt_strcmp(argv[2], "on"));
+    }
+    else if (!rt_strcmp(argv[1], "letter") && (argc == 3))
+    {
+        lv_draw_n9h30_2dge_glyph_enable(!rt_strcmp(argv[2], "on"));
+    }
+    else if (!rt_strcmp(argv[1], "set") && (argc == 4))
+    {
+        for (op = 0; op < GE2D_OP_NUM; op++)
+        {
+            if (!rt_strcmp(argv[2], s_ge2d_ops[op].name))
+            {
+                s_ge2d_ops[op].threshold = (uint32_t)atoi(argv[3]);
+                return 0;
+            }
+        }
+        rt_kprintf("ge2d: unknown op %s\n", argv[2]);
+        return -RT_EINVAL;
+    }
+    else
+    {
+        rt_kprintf("Usage: ge2d_stat [reset | calib | engine <on|off> | letter <on|off> | set <fill|map|map_opa> <pixels>]\n");
+        return -RT_EINVAL;
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(ge2d_stat, LVGL GE2D offload statistics and calibration);
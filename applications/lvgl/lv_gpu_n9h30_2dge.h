@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-3-29      Wayne        The first version
+ * 2026-10-19     RT-Thread    Add the GE2D letter drawing
+ * 2026-10-19     RT-Thread    Add the statistics and the cost model
  */
 #ifndef LV_GPU_N9H30_2DGE_H
 #define LV_GPU_N9H30_2DGE_H
@@ -31,6 +33,27 @@ extern "C" {
 struct _lv_disp_drv_t;
 typedef lv_draw_sw_ctx_t lv_draw_n9h30_2dge_ctx_t;
 
+typedef enum
+{
+    GE2D_OP_FILL = 0,       /* color fill */
+    GE2D_OP_MAP,            /* opaque image */
+    GE2D_OP_MAP_OPA,        /* translucent image */
+    GE2D_OP_NUM
+} lv_draw_n9h30_2dge_op_e;
+
+/* Blends and letters since the last reset */
+typedef struct
+{
+    uint32_t frames;                    /* lv_draw_n9h30_2dge_frame_done() calls */
+    uint32_t ge2d_px[GE2D_OP_NUM];
+    uint32_t ge2d_calls[GE2D_OP_NUM];
+    uint32_t sw_px[GE2D_OP_NUM];
+    uint32_t sw_calls[GE2D_OP_NUM];
+    uint32_t letters_ge2d;
+    uint32_t letters_sw;
+    uint32_t est_us;                    /* blend time by the calibrated cost model, 0 until calibrated */
+} lv_draw_n9h30_2dge_stat_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -46,8 +69,36 @@ void lv_draw_n9h30_2dge_ctx_deinit(struct _lv_disp_drv_t *drv, lv_draw_ctx_t *dr
 
 void lv_draw_n9h30_2dge_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
 
+bool lv_draw_n9h30_2dge_copy(lv_color_t *dest_buf, lv_coord_t dest_stride, const lv_area_t *dest_area, const lv_color_t *src_buf);
+
+void lv_draw_n9h30_2dge_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p, uint32_t letter);
+
+/**
+ * Blend, draw letters and copy by the GE2D, or do all of it in software
+ */
+void lv_draw_n9h30_2dge_enable(bool en);
+
+/**
+ * Draw the letters of 1bpp fonts by the GE2D colour expansion, or all of them in software
+ */
+void lv_draw_n9h30_2dge_glyph_enable(bool en);
+
 void lv_gpu_n9h30_2dge_wait_cb(lv_draw_ctx_t *draw_ctx);
 
+/**
+ * Calibrate the thresholds and the cost model at the end of the next frame
+ */
+void lv_draw_n9h30_2dge_calib_request(void);
+
+/**
+ * Count a frame in the statistics, called by the flush of the last area of a frame
+ */
+void lv_draw_n9h30_2dge_frame_done(void);
+
+void lv_draw_n9h30_2dge_reset_stat(void);
+
+void lv_draw_n9h30_2dge_get_stat(lv_draw_n9h30_2dge_stat_t *stat);
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#include <lvgl.h>
+
+#if (LV_USE_IMG_TRLE==1)
+
+#include <string.h>
+#include "lv_img_trle.h"
+
+/*
+ * TRLE file, little endian:
+ *   0 -  7  "_TRLE__" followed by '\0'
+ *   8 -  9  width
+ *  10 - 11  height
+ *  12 - 13  tile width
+ *  14 - 15  tile height
+ *  16       pixel format: 0 RGB565, 1 RGB565 followed by an alpha byte
+ *  17       flags: bit0 RGB565 in big endian(LV_COLOR_16_SWAP)
+ *  18 - 19  reserved
+ *  20 -     offsets of the tiles, row by row, and the end of the last one.
+ *           32 bits each, counted from the first tile.
+ *
+ * A tile is compressed as one line of its pixels, row after row. A control
+ * byte c < 0x80 is followed by c + 1 literal pixels, c >= 0x80 by a pixel to
+ * repeat (c & 0x7F) + 1 times.
+ *
+ * The decoder keeps the tile row of the last line read, and decodes only the
+ * tiles of it which the lines asked by the draw area cross. As the image
+ * cache keeps the decoder open, a partial redraw of a tile row already
+ * decoded costs the copy of its lines.
+ */
+#define TRLE_MAGIC              "_TRLE__"
+#define TRLE_HEADER_SIZE        20
+#define TRLE_PF_RGB565          0
+#define TRLE_PF_RGB565A8        1
+#define TRLE_FLAG_SWAP          0x01
+
+typedef struct
+{
+    lv_fs_file_t file;
+    bool is_file;
+    const uint8_t *tiles;       /* first tile of a C array */
+    uint32_t tiles_pos;         /* file position of the first tile */
+
+    uint16_t w;
+    uint16_t h;
+    uint16_t tile_w;
+    uint16_t tile_h;
+    uint16_t tiles_x;
+    uint8_t px_size;
+    uint32_t *offsets;
+
+    uint8_t *comp;              /* compressed tile read from the file */
+
+    uint8_t *strip;             /* decoded tile row, w x tile_h pixels */
+    int32_t strip_row;
+    uint8_t *decoded;           /* tile columns of the strip decoded */
+} trle_t;
+
+static uint16_t trle_get_u16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t trle_get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static lv_res_t trle_parse_header(const uint8_t *hdr, lv_img_header_t *header, trle_t *trle)
+{
+    uint16_t w, h, tile_w, tile_h;
+    uint8_t pf, swap;
+
+    if (memcmp(hdr, TRLE_MAGIC, sizeof(TRLE_MAGIC)) != 0)
+        return LV_RES_INV;
+
+    w = trle_get_u16(hdr + 8);
+    h = trle_get_u16(hdr + 10);
+    tile_w = trle_get_u16(hdr + 12);
+    tile_h = trle_get_u16(hdr + 14);
+    pf = hdr[16];
+    swap = (hdr[17] & TRLE_FLAG_SWAP) ? 1 : 0;
+
+    /* The pixels are copied as they are, they must be in the format of the display. */
+    if ((LV_COLOR_DEPTH != 16) || (swap != LV_COLOR_16_SWAP) ||
+            (pf > TRLE_PF_RGB565A8) || !w || !h || !tile_w || !tile_h)
+        return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->w = w;
+    header->h = h;
+    header->cf = (pf == TRLE_PF_RGB565A8) ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+
+    if (trle)
+    {
+        trle->w = w;
+        trle->h = h;
+        trle->tile_w = tile_w;
+        trle->tile_h = tile_h;
+        trle->tiles_x = (w + tile_w - 1) / tile_w;
+        trle->px_size = (pf == TRLE_PF_RGB565A8) ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    }
+
+    return LV_RES_OK;
+}
+
+static void trle_free(trle_t *trle)
+{
+    if (trle->is_file)
+        lv_fs_close(&trle->file);
+
+    if (trle->offsets)
+        lv_mem_free(trle->offsets);
+    if (trle->comp)
+        lv_mem_free(trle->comp);
+    if (trle->strip)
+        lv_mem_free(trle->strip);
+    if (trle->decoded)
+        lv_mem_free(trle->decoded);
+
+    lv_mem_free(trle);
+}
+
+static lv_res_t trle_info(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header)
+{
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+
+    LV_UNUSED(decoder);
+
+    if (src_type == LV_IMG_SRC_VARIABLE)
+    {
+        const lv_img_dsc_t *img_dsc = src;
+
+        if ((img_dsc->header.cf != LV_IMG_CF_RAW) || (img_dsc->data_size < TRLE_HEADER_SIZE))
+            return LV_RES_INV;
+
+        return trle_parse_header(img_dsc->data, header, NULL);
+    }
+    else if (src_type == LV_IMG_SRC_FILE)
+    {
+        uint8_t au8Hdr[TRLE_HEADER_SIZE];
+        lv_fs_file_t file;
+        uint32_t br = 0;
+
+        if (strcmp(lv_fs_get_ext(src), "trle") != 0)
+            return LV_RES_INV;
+
+        if (lv_fs_open(&file, src, LV_FS_MODE_RD) != LV_FS_RES_OK)
+            return LV_RES_INV;
+
+        lv_fs_read(&file, au8Hdr, sizeof(au8Hdr), &br);
+        lv_fs_close(&file);
+
+        if (br != sizeof(au8Hdr))
+            return LV_RES_INV;
+
+        return trle_parse_header(au8Hdr, header, NULL);
+    }
+
+    return LV_RES_INV;
+}
+
+static lv_res_t trle_open(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    uint8_t au8Hdr[TRLE_HEADER_SIZE];
+    lv_img_header_t header;
+    const uint8_t *table = NULL;
+    uint8_t *table_buf = NULL;
+    uint32_t tiles_num, table_size, comp_max = 0, i;
+    trle_t *trle;
+
+    LV_UNUSED(decoder);
+
+    trle = lv_mem_alloc(sizeof(trle_t));
+    if (trle == NULL)
+        return LV_RES_INV;
+    lv_memset_00(trle, sizeof(trle_t));
+
+    if (dsc->src_type == LV_IMG_SRC_VARIABLE)
+    {
+        const lv_img_dsc_t *img_dsc = dsc->src;
+
+        lv_memcpy(au8Hdr, img_dsc->data, TRLE_HEADER_SIZE);
+    }
+    else
+    {
+        uint32_t br = 0;
+
+        if (lv_fs_open(&trle->file, dsc->src, LV_FS_MODE_RD) != LV_FS_RES_OK)
+        {
+            lv_mem_free(trle);
+            return LV_RES_INV;
+        }
+        trle->is_file = true;
+
+        if ((lv_fs_read(&trle->file, au8Hdr, TRLE_HEADER_SIZE, &br) != LV_FS_RES_OK) || (br != TRLE_HEADER_SIZE))
+            goto exit_trle_open;
+    }
+
+    if (trle_parse_header(au8Hdr, &header, trle) != LV_RES_OK)
+        goto exit_trle_open;
+
+    tiles_num = trle->tiles_x * ((trle->h + trle->tile_h - 1) / trle->tile_h);
+    table_size = (tiles_num + 1) * sizeof(uint32_t);
+    trle->tiles_pos = TRLE_HEADER_SIZE + table_size;
+
+    trle->offsets = lv_mem_alloc(table_size);
+    if (trle->offsets == NULL)
+        goto exit_trle_open;
+
+    if (dsc->src_type == LV_IMG_SRC_VARIABLE)
+    {
+        const lv_img_dsc_t *img_dsc = dsc->src;
+
+        if (img_dsc->data_size < trle->tiles_pos)
+            goto exit_trle_open;
+
+        table = img_dsc->data + TRLE_HEADER_SIZE;
+        trle->tiles = img_dsc->data + trle->tiles_pos;
+    }
+    else
+    {
+        uint32_t br = 0;
+
+        /* Read the table in the place of the offsets, then convert it. */
+        table_buf = (uint8_t *)trle->offsets;
+        if ((lv_fs_read(&trle->file, table_buf, table_size, &br) != LV_FS_RES_OK) || (br != table_size))
+            goto exit_trle_open;
+
+        table = table_buf;
+    }
+
+    for (i = 0; i <= tiles_num; i++)
+        trle->offsets[i] = trle_get_u32(table + i * sizeof(uint32_t));
+
+    for (i = 0; i < tiles_num; i++)
+    {
+        if (trle->offsets[i + 1] < trle->offsets[i])
+            goto exit_trle_open;
+
+        comp_max = LV_MAX(comp_max, trle->offsets[i + 1] - trle->offsets[i]);
+    }
+
+    if ((dsc->src_type == LV_IMG_SRC_VARIABLE) &&
+            (((const lv_img_dsc_t *)dsc->src)->data_size < trle->tiles_pos + trle->offsets[tiles_num]))
+        goto exit_trle_open;
+
+    if (trle->is_file)
+    {
+        trle->comp = lv_mem_alloc(comp_max ? comp_max : 1);
+        if (trle->comp == NULL)
+            goto exit_trle_open;
+    }
+
+    trle->strip = lv_mem_alloc((uint32_t)trle->w * trle->tile_h * trle->px_size);
+    trle->decoded = lv_mem_alloc(trle->tiles_x);
+    if ((trle->strip == NULL) || (trle->decoded == NULL))
+        goto exit_trle_open;
+
+    trle->strip_row = -1;
+
+    /* No whole image, the lines come from trle_read_line(). */
+    dsc->img_data = NULL;
+    dsc->user_data = trle;
+
+    return LV_RES_OK;
+
+exit_trle_open:
+
+    trle_free(trle);
+
+    return LV_RES_INV;
+}
+
+static lv_res_t trle_decode_tile(trle_t *trle, uint32_t row, uint32_t col)
+{
+    uint32_t idx = row * trle->tiles_x + col;
+    uint32_t size = trle->offsets[idx + 1] - trle->offsets[idx];
+    uint32_t tw = LV_MIN(trle->tile_w, trle->w - col * trle->tile_w);
+    uint32_t th = LV_MIN(trle->tile_h, trle->h - row * trle->tile_h);
+    uint32_t px = trle->px_size;
+    uint32_t stride = trle->w * px;
+    uint8_t *dst_row = trle->strip + col * trle->tile_w * px;
+    const uint8_t *src, *end;
+    uint32_t x = 0, y = 0;
+
+    if (trle->is_file)
+    {
+        uint32_t br = 0;
+
+        if ((lv_fs_seek(&trle->file, trle->tiles_pos + trle->offsets[idx], LV_FS_SEEK_SET) != LV_FS_RES_OK) ||
+                (lv_fs_read(&trle->file, trle->comp, size, &br) != LV_FS_RES_OK) || (br != size))
+            return LV_RES_INV;
+
+        src = trle->comp;
+    }
+    else
+    {
+        src = trle->tiles + trle->offsets[idx];
+    }
+    end = src + size;
+
+    while (y < th)
+    {
+        uint32_t n, i, chunk;
+        bool run;
+
+        if (src >= end)
+            return LV_RES_INV;
+
+        run = (*src & 0x80) ? true : false;
+        n = (*src++ & 0x7F) + 1;
+
+        if ((uint32_t)(end - src) < (run ? px : n * px))
+            return LV_RES_INV;
+
+        while (n)
+        {
+            uint8_t *dst = dst_row + x * px;
+
+            if (y == th)
+                return LV_RES_INV;
+
+            chunk = LV_MIN(n, tw - x);
+            if (!run)
+            {
+                lv_memcpy(dst, src, chunk * px);
+                src += chunk * px;
+            }
+            else if (px == sizeof(uint16_t))
+            {
+                uint16_t u16Px, *pu16Dst = (uint16_t *)dst;
+
+                lv_memcpy(&u16Px, src, sizeof(u16Px));
+                for (i = 0; i < chunk; i++)
+                    pu16Dst[i] = u16Px;
+            }
+            else
+            {
+                for (i = 0; i < chunk; i++)
+                    lv_memcpy(dst + i * px, src, px);
+            }
+
+            n -= chunk;
+            x += chunk;
+            if (x == tw)
+            {
+                x = 0;
+                y++;
+                dst_row += stride;
+            }
+        }
+
+        if (run)
+            src += px;
+    }
+
+    return LV_RES_OK;
+}
+
+static lv_res_t trle_read_line(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc, lv_coord_t x, lv_coord_t y,
+                               lv_coord_t len, uint8_t *buf)
+{
+    trle_t *trle = dsc->user_data;
+    int32_t row, col;
+
+    LV_UNUSED(decoder);
+
+    if ((x < 0) || (y < 0) || (len <= 0) || (x + len > trle->w) || (y >= trle->h))
+        return LV_RES_INV;
+
+    row = y / trle->tile_h;
+    if (row != trle->strip_row)
+    {
+        lv_memset_00(trle->decoded, trle->tiles_x);
+        trle->strip_row = row;
+    }
+
+    for (col = x / trle->tile_w; col <= (x + len - 1) / trle->tile_w; col++)
+    {
+        if (trle->decoded[col])
+            continue;
+
+        if (trle_decode_tile(trle, row, col) != LV_RES_OK)
+        {
+            LV_LOG_WARN("TRLE: corrupted tile %d,%d", (int)col, (int)row);
+            trle->strip_row = -1;
+            return LV_RES_INV;
+        }
+        trle->decoded[col] = 1;
+    }
+
+    lv_memcpy(buf, trle->strip + ((uint32_t)(y % trle->tile_h) * trle->w + x) * trle->px_size, len * trle->px_size);
+
+    return LV_RES_OK;
+}
+
+static void trle_close(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    LV_UNUSED(decoder);
+
+    if (dsc->user_data)
+    {
+        trle_free(dsc->user_data);
+        dsc->user_data = NULL;
+    }
+}
+
+void lv_img_trle_init(void)
+{
+    lv_img_decoder_t *dec = lv_img_decoder_create();
+
+    if (dec == NULL)
+        return;
+
+    lv_img_decoder_set_info_cb(dec, trle_info);
+    lv_img_decoder_set_open_cb(dec, trle_open);
+    lv_img_decoder_set_read_line_cb(dec, trle_read_line);
+    lv_img_decoder_set_close_cb(dec, trle_close);
+}
+
+#endif /* LV_USE_IMG_TRLE */
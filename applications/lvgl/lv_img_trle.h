@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef __LV_IMG_TRLE_H__
+#define __LV_IMG_TRLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Tiled RLE images, made by packages/LVGL-v8.3.5/scripts/img_to_trle.py.
+ * The source is a "*.trle" file or an lv_img_dsc_t of LV_IMG_CF_RAW with the
+ * file in its data.
+ */
+void lv_img_trle_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LV_IMG_TRLE_H__ */
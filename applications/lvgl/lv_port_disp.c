@@ -6,10 +6,22 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-12-17     Wayne        The first version
+ * 2026-10-19     RT-Thread    Clean the flushed area of the draw buffer only
+ * 2026-10-19     RT-Thread    Report flushed frames for the touch latency
+ * 2026-10-19     RT-Thread    Add the OSD layer as a second display
+ * 2026-10-19     RT-Thread    Flush in a thread of its own, frame-time histograms
+ * 2026-10-19     RT-Thread    Register the tiled RLE image decoder
+ * 2026-10-19     RT-Thread    Count the frames of the GE2D statistics at the flush
+ * 2026-10-19     RT-Thread    Render time per refresh for the demos
+ * 2026-10-19     RT-Thread    Copy the partial flush without LVGL calls
  */
 #include <lvgl.h>
 #include "mmu.h"
 #include "lv_gpu_n9h30_2dge.h"
+#include "lv_img_trle.h"
+#if defined(BSP_USING_VPOST_OSD)
+    #include "drv_vpost.h"
+#endif
 
 #define LOG_TAG             "lvgl.disp"
 #define DBG_ENABLE
@@ -22,90 +34,223 @@
     #define NU_PKG_LVGL_RENDERING_LAYER "lcd"
 #endif
 
+#if (LV_USE_OSD_OVERLAY==1) && !defined(BSP_USING_VPOST_OSD)
+    #error "LV_USE_OSD_OVERLAY needs BSP_USING_VPOST_OSD"
+#endif
+
+/* The OSD pixels of this colour show the rendering layer. */
+#if !defined(NU_PKG_LVGL_OSD_COLKEY)
+    #define NU_PKG_LVGL_OSD_COLKEY      0xFF00FF
+#endif
+
 #ifndef BIT31
     #define BIT31    (0x80000000)       ///< Bit 31 mask of an 32 bit integer
 #endif
 
-/*A static or global variable to store the buffers*/
-static lv_disp_draw_buf_t disp_buf;
-static rt_device_t lcd_device = 0;
-static struct rt_device_graphic_info info;
-static lv_disp_drv_t disp_drv;  /*Descriptor of a display driver*/
+/*
+ * Flush thread: the pan, the vsync wait and the GE2D copy to the frame
+ * buffer run above the LVGL thread, which goes on with its timers, the
+ * input and the other display meanwhile. LVGL keeps one flush per display
+ * in flight, the queue holds the ones of both layers.
+ */
+#if (LV_USE_FLUSH_THREAD==1)
+    #if !defined(PKG_LVGL_THREAD_PRIO)
+        #define PKG_LVGL_THREAD_PRIO    (RT_THREAD_PRIORITY_MAX * 2 / 3)
+    #endif
+    #define NU_FLUSH_THREAD_PRIO        (PKG_LVGL_THREAD_PRIO - 1)
+    #define NU_FLUSH_THREAD_STACK       2048
+    #define NU_FLUSH_QUEUE_NUM          4
+#endif
 
-static void *buf3_next = RT_NULL;
+/* Frame-time histograms: NU_HIST_NUM buckets of NU_HIST_STEP_MS, the last one is open. */
+#define NU_HIST_NUM             16
+#define NU_HIST_STEP_MS         5
 
-static uint32_t u32FirstFlush = 0;
+/* Set when the flush in flight is done, cleared when the next one is submitted. */
+#define NU_FLUSH_DONE_EVENT     (1 << 0)
 
-static void nu_antitearing(lv_disp_draw_buf_t *draw_buf, lv_color_t *color_p)
+struct nu_lvgl_disp
+{
+    const char *name;
+    rt_device_t device;
+    struct rt_device_graphic_info info;
+
+    /*A static or global variable to store the buffers*/
+    lv_disp_draw_buf_t disp_buf;
+    lv_disp_drv_t disp_drv;         /*Descriptor of a display driver*/
+    lv_disp_t *disp;
+
+    void *buf3_next;
+    uint32_t u32FirstFlush;
+
+    struct rt_event flush_event;        /* NU_FLUSH_DONE_EVENT, for wait_cb */
+    uint32_t render_hist[NU_HIST_NUM];  /* from monitor_cb */
+    uint32_t render_frames;             /* refreshes and their render time, from monitor_cb */
+    uint32_t render_ms;
+    uint32_t flush_hist[NU_HIST_NUM];   /* flush_cb to lv_disp_flush_ready() */
+};
+typedef struct nu_lvgl_disp *nu_lvgl_disp_t;
+
+struct nu_flush_req
 {
-    if (buf3_next)
+    nu_lvgl_disp_t psDisp;
+    lv_area_t area;
+    lv_color_t *color_p;
+    rt_tick_t tick;
+};
+
+static struct nu_lvgl_disp s_NuLvglDisp = { .name = NU_PKG_LVGL_RENDERING_LAYER };
+#if (LV_USE_OSD_OVERLAY==1)
+    static struct nu_lvgl_disp s_NuLvglOsd = { .name = "osd" };
+#endif
+
+#if (LV_USE_FLUSH_THREAD==1)
+    static rt_mq_t s_FlushMq = RT_NULL;
+#endif
+
+extern void lv_port_indev_frame_flushed(void);
+
+static void nu_hist_add(uint32_t *hist, uint32_t ms)
+{
+    uint32_t idx = ms / NU_HIST_STEP_MS;
+
+    hist[(idx < NU_HIST_NUM) ? idx : (NU_HIST_NUM - 1)]++;
+}
+
+static void nu_antitearing(nu_lvgl_disp_t psDisp, lv_disp_draw_buf_t *draw_buf, lv_color_t *color_p)
+{
+    if (psDisp->buf3_next)
     {
         /* vsync-none: Use triple screen-sized buffers. */
         if (draw_buf->buf1 == color_p)
-            draw_buf->buf1 = buf3_next;
+            draw_buf->buf1 = psDisp->buf3_next;
         else
-            draw_buf->buf2 = buf3_next;
+            draw_buf->buf2 = psDisp->buf3_next;
 
-        draw_buf->buf_act = buf3_next;
-        buf3_next = color_p;
+        draw_buf->buf_act = psDisp->buf3_next;
+        psDisp->buf3_next = color_p;
     }
-    else
+}
+
+static void nu_flush_done(nu_lvgl_disp_t psDisp, rt_tick_t tick)
+{
+    if (!psDisp->u32FirstFlush)
     {
-        /* vsync-after: Use ping-pong screen-sized buffers only.*/
-        rt_device_control(lcd_device, RTGRAPHIC_CTRL_WAIT_VSYNC, RT_NULL);
+        /* Enable backlight at first flushing. */
+        rt_device_control(psDisp->device, RTGRAPHIC_CTRL_POWERON, RT_NULL);
+        psDisp->u32FirstFlush = 1;
     }
+
+    lv_port_indev_frame_flushed();
+
+    nu_hist_add(psDisp->flush_hist, (rt_tick_get() - tick) * 1000 / RT_TICK_PER_SECOND);
+
+    lv_disp_flush_ready(&psDisp->disp_drv);
+
+    rt_event_send(&psDisp->flush_event, NU_FLUSH_DONE_EVENT);
 }
 
-static void nu_flush_full_refresh(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+/* The hardware part of a flush, in the flush thread or inline */
+static void nu_flush_exec(struct nu_flush_req *psReq)
 {
-    mmu_clean_dcache((uint32_t)color_p, disp_drv->draw_buf->size * sizeof(lv_color_t));
-
-    /* Use PANDISPLAY without H/W copying */
-    rt_device_control(lcd_device, RTGRAPHIC_CTRL_PAN_DISPLAY, color_p);
+    nu_lvgl_disp_t psDisp = psReq->psDisp;
 
-    nu_antitearing(disp_drv->draw_buf, color_p);
+    if (psDisp->disp_drv.full_refresh)
+    {
+        /* Use PANDISPLAY without H/W copying */
+        rt_device_control(psDisp->device, RTGRAPHIC_CTRL_PAN_DISPLAY, psReq->color_p);
 
-    if (!u32FirstFlush)
+        /* vsync-after: Use ping-pong screen-sized buffers only.*/
+        if (psDisp->buf3_next == RT_NULL)
+            rt_device_control(psDisp->device, RTGRAPHIC_CTRL_WAIT_VSYNC, RT_NULL);
+    }
+    else
     {
-        /* Enable backlight at first flushing. */
-        rt_device_control(lcd_device, RTGRAPHIC_CTRL_POWERON, RT_NULL);
-        u32FirstFlush = 1;
+        /* No LVGL drawing here: the engine copies the rows, or the CPU does. */
+        lv_color_t *fb = (lv_color_t *)psDisp->info.framebuffer;
+        lv_coord_t w = lv_area_get_width(&psReq->area);
+        lv_coord_t y;
+
+        if (!lv_draw_n9h30_2dge_copy(fb, psDisp->info.width, &psReq->area, psReq->color_p))
+        {
+            for (y = psReq->area.y1; y <= psReq->area.y2; y++)
+                rt_memcpy(fb + y * psDisp->info.width + psReq->area.x1,
+                          psReq->color_p + (y - psReq->area.y1) * w, w * sizeof(lv_color_t));
+        }
     }
 
-    lv_disp_flush_ready(disp_drv);
+    nu_flush_done(psDisp, psReq->tick);
 }
 
-static void nu_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+static void nu_flush_submit(nu_lvgl_disp_t psDisp, const lv_area_t *area, lv_color_t *color_p)
 {
-    int32_t area_w = lv_area_get_width(area);
-    int32_t area_h = lv_area_get_height(area);
+    struct nu_flush_req sReq;
 
-    lv_draw_sw_blend_dsc_t blend_flush = {0};
-    lv_draw_ctx_t draw_flush = {0};
-    lv_area_t flush_area = {0, 0, info.width - 1, info.height - 1 };
+    sReq.psDisp = psDisp;
+    sReq.area = *area;
+    sReq.color_p = color_p;
+    sReq.tick = rt_tick_get();
 
-    //rt_kprintf("[nu_flush %d %08x] %dx%d %d %d\n", lv_area_get_size(area), color_p, area_w, area_h, area->x1, area->y1 );
+    /* LVGL keeps one flush per display in flight, the flag of the last one is stale. */
+    rt_event_recv(&psDisp->flush_event, NU_FLUSH_DONE_EVENT, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, 0, RT_NULL);
 
-    blend_flush.blend_area = area;
-    blend_flush.src_buf    = color_p;
-    blend_flush.mask_buf   = NULL;
-    blend_flush.opa        = LV_OPA_MAX;
-    blend_flush.blend_mode = LV_BLEND_MODE_NORMAL;
+#if (LV_USE_FLUSH_THREAD==1)
+    if ((s_FlushMq != RT_NULL) && (rt_mq_send(s_FlushMq, &sReq, sizeof(sReq)) == RT_EOK))
+        return;
+#endif
 
-    draw_flush.buf         = info.framebuffer;
-    draw_flush.clip_area   = &flush_area;
-    draw_flush.buf_area    = &flush_area;
+    nu_flush_exec(&sReq);
+}
 
-    lv_draw_n9h30_2dge_blend(&draw_flush, (const lv_draw_sw_blend_dsc_t *)&blend_flush);
+#if (LV_USE_FLUSH_THREAD==1)
+static void nu_flush_entry(void *parameter)
+{
+    struct nu_flush_req sReq;
 
-    if (!u32FirstFlush)
+    while (1)
     {
-        /* Enable backlight at first flushing. */
-        rt_device_control(lcd_device, RTGRAPHIC_CTRL_POWERON, RT_NULL);
-        u32FirstFlush = 1;
+        if (rt_mq_recv(s_FlushMq, &sReq, sizeof(sReq), RT_WAITING_FOREVER) == RT_EOK)
+            nu_flush_exec(&sReq);
     }
+}
+#endif
+
+static void nu_flush_full_refresh(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    nu_lvgl_disp_t psDisp = (nu_lvgl_disp_t)disp_drv->user_data;
+
+    /* A screen-sized area exceeds the D-cache, the helper cleans the whole cache by index then. */
+    mmu_clean_dcache_rect((uint32_t)(color_p + area->y1 * disp_drv->hor_res + area->x1),
+                          disp_drv->hor_res * sizeof(lv_color_t),
+                          lv_area_get_width(area) * sizeof(lv_color_t),
+                          lv_area_get_height(area));
+
+    /* LVGL swaps its buffers after this callback, the third one is put in here. */
+    nu_antitearing(psDisp, disp_drv->draw_buf, color_p);
 
-    lv_disp_flush_ready(disp_drv);
+    lv_draw_n9h30_2dge_frame_done();
+
+    nu_flush_submit(psDisp, area, color_p);
+}
+
+static void nu_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    if (lv_disp_flush_is_last(disp_drv))
+        lv_draw_n9h30_2dge_frame_done();
+
+    nu_flush_submit((nu_lvgl_disp_t)disp_drv->user_data, area, color_p);
+}
+
+/*
+ * LVGL waits for a flush in flight, sleep until the flush thread is done. The
+ * flag stays set until the next submit, a flush done before the wait returns
+ * at once and the frames LVGL does not wait for leave nothing behind.
+ */
+static void nu_flush_wait(lv_disp_drv_t *disp_drv)
+{
+    nu_lvgl_disp_t psDisp = (nu_lvgl_disp_t)disp_drv->user_data;
+
+    rt_event_recv(&psDisp->flush_event, NU_FLUSH_DONE_EVENT, RT_EVENT_FLAG_OR, RT_TICK_PER_SECOND / 60, RT_NULL);
 }
 
 void nu_perf_monitor(struct _lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
@@ -113,87 +258,237 @@ void nu_perf_monitor(struct _lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px
     LOG_I("Elapsed: %dms, Pixel: %d, Bytes:%d, %d%\n", time, px, px * sizeof(lv_color_t), px * 100 / disp_drv->draw_buf->size);
 }
 
-void lv_port_disp_init(void)
+static void nu_disp_monitor(struct _lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+    nu_lvgl_disp_t psDisp = (nu_lvgl_disp_t)disp_drv->user_data;
+
+    nu_hist_add(psDisp->render_hist, time);
+    psDisp->render_frames++;
+    psDisp->render_ms += time;
+}
+
+static rt_err_t nu_disp_register(nu_lvgl_disp_t psDisp, bool full_refresh)
 {
     rt_err_t result;
     void *buf1 = RT_NULL;
     void *buf2 = RT_NULL;
     uint32_t u32FBSize;
 
-    lcd_device = rt_device_find(NU_PKG_LVGL_RENDERING_LAYER);
-    if (lcd_device == RT_NULL)
+    psDisp->device = rt_device_find(psDisp->name);
+    if (psDisp->device == RT_NULL)
     {
         LOG_E("error!");
-        return;
+        return -RT_ERROR;
     }
 
     /* get framebuffer address */
-    result = rt_device_control(lcd_device, RTGRAPHIC_CTRL_GET_INFO, &info);
+    result = rt_device_control(psDisp->device, RTGRAPHIC_CTRL_GET_INFO, &psDisp->info);
     if (result != RT_EOK)
     {
         LOG_E("error!");
         /* get device information failed */
-        return;
+        return result;
     }
 
     /* Disable backlight at startup. */
-    rt_device_control(lcd_device, RTGRAPHIC_CTRL_POWEROFF, RT_NULL);
+    rt_device_control(psDisp->device, RTGRAPHIC_CTRL_POWEROFF, RT_NULL);
 
-    RT_ASSERT(info.bits_per_pixel == 8 || info.bits_per_pixel == 16 ||
-              info.bits_per_pixel == 24 || info.bits_per_pixel == 32);
+    RT_ASSERT(psDisp->info.bits_per_pixel == 8 || psDisp->info.bits_per_pixel == 16 ||
+              psDisp->info.bits_per_pixel == 24 || psDisp->info.bits_per_pixel == 32);
 
-    lv_disp_drv_init(&disp_drv); /*Basic initialization*/
+    lv_disp_drv_init(&psDisp->disp_drv); /*Basic initialization*/
 
     /*Set the resolution of the display*/
-    disp_drv.hor_res = info.width;
-    disp_drv.ver_res = info.height;
-    u32FBSize = info.height * info.width * (info.bits_per_pixel / 8);
+    psDisp->disp_drv.hor_res = psDisp->info.width;
+    psDisp->disp_drv.ver_res = psDisp->info.height;
+    psDisp->disp_drv.user_data = psDisp;
+    psDisp->disp_drv.wait_cb = nu_flush_wait;
+    rt_event_init(&psDisp->flush_event, psDisp->name, RT_IPC_FLAG_FIFO);
+    u32FBSize = psDisp->info.height * psDisp->info.width * (psDisp->info.bits_per_pixel / 8);
 
-#if (LV_USE_ANTI_TEARING==1)
-    disp_drv.full_refresh = 1;
-#endif
-    LOG_I("LVGL: %s anti-tearing", disp_drv.full_refresh ? "Enabled" : "Disabled");
+    psDisp->disp_drv.full_refresh = full_refresh;
+    LOG_I("LVGL: %s %s anti-tearing", psDisp->name, psDisp->disp_drv.full_refresh ? "Enabled" : "Disabled");
 
-    if (disp_drv.full_refresh)
+    if (psDisp->disp_drv.full_refresh)
     {
-        buf1 = (void *)((uint32_t)info.framebuffer & ~BIT31); // Use Cacheable VRAM
+        buf1 = (void *)((uint32_t)psDisp->info.framebuffer & ~BIT31); // Use Cacheable VRAM
         buf2 = (void *)((uint32_t)buf1 + u32FBSize);
-        buf3_next = (void *)((uint32_t)buf2 + u32FBSize);
-        LOG_I("LVGL: Use triple screen-sized buffers(full_refresh) - buf1@%08x, buf2@%08x, buf3_next@%08x", buf1, buf2, buf3_next);
+        psDisp->buf3_next = (void *)((uint32_t)buf2 + u32FBSize);
+        LOG_I("LVGL: Use triple screen-sized buffers(full_refresh) - buf1@%08x, buf2@%08x, buf3_next@%08x", buf1, buf2, psDisp->buf3_next);
 
-        disp_drv.flush_cb = nu_flush_full_refresh;
+        psDisp->disp_drv.flush_cb = nu_flush_full_refresh;
     }
     else
     {
-        buf1 = (void *)(((uint32_t)info.framebuffer & ~BIT31) + u32FBSize); // Use Cacheable VRAM
+        buf1 = (void *)(((uint32_t)psDisp->info.framebuffer & ~BIT31) + u32FBSize); // Use Cacheable VRAM
         buf2 = (void *)((uint32_t)buf1 + u32FBSize);
         LOG_I("LVGL: Use two screen-sized buffers - buf1@%08x, buf2@%08x", buf1, buf2);
-        rt_device_control(lcd_device, RTGRAPHIC_CTRL_PAN_DISPLAY, info.framebuffer);
+        rt_device_control(psDisp->device, RTGRAPHIC_CTRL_PAN_DISPLAY, psDisp->info.framebuffer);
 
-        disp_drv.flush_cb = nu_flush;
+        psDisp->disp_drv.flush_cb = nu_flush;
     }
 
     /*Initialize `disp_buf` with the buffer(s).*/
-    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, info.width * info.height);
+    lv_disp_draw_buf_init(&psDisp->disp_buf, buf1, buf2, psDisp->info.width * psDisp->info.height);
 
-    result = rt_device_open(lcd_device, 0);
+    result = rt_device_open(psDisp->device, 0);
     if (result != RT_EOK)
     {
         LOG_E("error!");
-        return;
+        return result;
     }
 
     /*Set a display buffer*/
-    disp_drv.draw_buf = &disp_buf;
+    psDisp->disp_drv.draw_buf = &psDisp->disp_buf;
 
 #if (LV_GPU_USE_N9H30_2DGE==1)
-    disp_drv.draw_ctx_init = lv_draw_n9h30_2dge_ctx_init;
-    disp_drv.draw_ctx_deinit = lv_draw_n9h30_2dge_ctx_init;
-    disp_drv.draw_ctx_size = sizeof(lv_draw_n9h30_2dge_ctx_t);
+    psDisp->disp_drv.draw_ctx_init = lv_draw_n9h30_2dge_ctx_init;
+    psDisp->disp_drv.draw_ctx_deinit = lv_draw_n9h30_2dge_ctx_init;
+    psDisp->disp_drv.draw_ctx_size = sizeof(lv_draw_n9h30_2dge_ctx_t);
 #endif
     /*Called after every refresh cycle to tell the rendering and flushing time + the number of flushed pixels*/
-    //disp_drv.monitor_cb = nu_perf_monitor;
+    //psDisp->disp_drv.monitor_cb = nu_perf_monitor;
+    psDisp->disp_drv.monitor_cb = nu_disp_monitor;
 
     /*Finally register the driver*/
-    lv_disp_drv_register(&disp_drv);
+    psDisp->disp = lv_disp_drv_register(&psDisp->disp_drv);
+
+    return (psDisp->disp != NULL) ? RT_EOK : -RT_ENOMEM;
+}
+
+#if (LV_USE_OSD_OVERLAY==1)
+/*
+ * The OSD layer is a display of its own, scanned out over the rendering
+ * layer by VPOST. Its screen is filled with the key colour, which shows the
+ * rendering layer; the objects placed on it are composited by the scanout
+ * and redraw only the OSD. The layer redraws the changed areas only.
+ */
+static void nu_osd_register(void)
+{
+    nu_lvgl_disp_t psDisp = &s_NuLvglOsd;
+    lv_color_t key = lv_color_hex(NU_PKG_LVGL_OSD_COLKEY);
+    rt_uint32_t u32ColKey = key.full;
+    lv_color_t *fb;
+    uint32_t i;
+
+    if (nu_disp_register(psDisp, false) != RT_EOK)
+        return;
+
+    /* Key colour until the first flush of the layer */
+    fb = (lv_color_t *)psDisp->info.framebuffer;
+    for (i = 0; i < psDisp->info.width * psDisp->info.height; i++)
+        fb[i] = key;
+
+    if (rt_device_control(psDisp->device, RTGRAPHIC_CTRL_SET_OSD_COLKEY, &u32ColKey) != RT_EOK)
+        LOG_E("LVGL: Failed to set the OSD colour key");
+
+    lv_obj_set_style_bg_color(lv_disp_get_scr_act(psDisp->disp), key, 0);
+    lv_obj_set_style_bg_opa(lv_disp_get_scr_act(psDisp->disp), LV_OPA_COVER, 0);
+}
+#endif
+
+/* The display of the OSD layer, NULL without it */
+lv_disp_t *lv_port_disp_get_osd(void)
+{
+#if (LV_USE_OSD_OVERLAY==1)
+    return s_NuLvglOsd.disp;
+#else
+    return NULL;
+#endif
+}
+
+/* The refreshes of a display so far and their render time, as monitor_cb reports them */
+void lv_port_disp_get_render(lv_disp_t *disp, uint32_t *frames, uint32_t *ms)
+{
+    nu_lvgl_disp_t psDisp = (nu_lvgl_disp_t)disp->driver->user_data;
+
+    *frames = psDisp->render_frames;
+    *ms = psDisp->render_ms;
+}
+
+void lv_port_disp_init(void)
+{
+#if (LV_USE_FLUSH_THREAD==1)
+    rt_thread_t flush_thread;
+
+    s_FlushMq = rt_mq_create("lv_flush", sizeof(struct nu_flush_req), NU_FLUSH_QUEUE_NUM, RT_IPC_FLAG_FIFO);
+    flush_thread = rt_thread_create("lv_flush", nu_flush_entry, RT_NULL, NU_FLUSH_THREAD_STACK, NU_FLUSH_THREAD_PRIO, 5);
+    if ((s_FlushMq == RT_NULL) || (flush_thread == RT_NULL))
+    {
+        LOG_E("LVGL: Failed to create the flush thread, flush inline.");
+        if (s_FlushMq != RT_NULL)
+            rt_mq_delete(s_FlushMq);
+        s_FlushMq = RT_NULL;
+    }
+    else
+    {
+        rt_thread_startup(flush_thread);
+    }
+#endif
+
+    /* The first registered display stays the default one. */
+#if (LV_USE_ANTI_TEARING==1)
+    nu_disp_register(&s_NuLvglDisp, true);
+#else
+    nu_disp_register(&s_NuLvglDisp, false);
+#endif
+
+#if (LV_USE_OSD_OVERLAY==1)
+    nu_osd_register();
+#endif
+
+#if (LV_USE_IMG_TRLE==1)
+    lv_img_trle_init();
+#endif
+}
+
+static void nu_hist_dump(const char *name, const uint32_t *hist)
+{
+    int i;
+
+    rt_kprintf("  %s\n", name);
+    for (i = 0; i < NU_HIST_NUM; i++)
+    {
+        if (hist[i] == 0)
+            continue;
+
+        if (i == NU_HIST_NUM - 1)
+            rt_kprintf("    >=%3d ms: %u\n", i * NU_HIST_STEP_MS, hist[i]);
+        else
+            rt_kprintf("    %3d-%3d ms: %u\n", i * NU_HIST_STEP_MS, (i + 1) * NU_HIST_STEP_MS - 1, hist[i]);
+    }
+}
+
+static int lv_disp_stat(int argc, char *argv[])
+{
+    nu_lvgl_disp_t apsDisp[] =
+    {
+        &s_NuLvglDisp,
+#if (LV_USE_OSD_OVERLAY==1)
+        &s_NuLvglOsd,
+#endif
+    };
+    int i;
+
+    for (i = 0; i < sizeof(apsDisp) / sizeof(apsDisp[0]); i++)
+    {
+        nu_lvgl_disp_t psDisp = apsDisp[i];
+
+        if (psDisp->disp == NULL)
+            continue;
+
+        if ((argc > 1) && !rt_strcmp(argv[1], "reset"))
+        {
+            rt_memset(psDisp->render_hist, 0, sizeof(psDisp->render_hist));
+            rt_memset(psDisp->flush_hist, 0, sizeof(psDisp->flush_hist));
+            continue;
+        }
+
+        rt_kprintf("%s:\n", psDisp->name);
+        nu_hist_dump("render (monitor_cb)", psDisp->render_hist);
+        nu_hist_dump("flush", psDisp->flush_hist);
+    }
+
+    return 0;
 }
+MSH_CMD_EXPORT(lv_disp_stat, LVGL render and flush time histograms);
@@ -7,37 +7,205 @@
  * Date           Author       Notes
  * 2021-10-18     Meco Man     The first version
  * 2021-12-17     Wayne        Add input event
+ * 2026-10-19     RT-Thread    Queue timestamped events, event-driven reading
  */
 #include <lvgl.h>
 #include <stdbool.h>
+#include <rthw.h>
 #include <rtdevice.h>
 #include "touch.h"
 
-static lv_indev_state_t last_state = LV_INDEV_STATE_REL;
-static rt_int16_t last_x = 0;
-static rt_int16_t last_y = 0;
+/*
+ * The touch events are queued with their tick by the touch thread and
+ * drained by the read callback with continue_reading, so LVGL sees every
+ * point of a swipe and every tap. In the event-driven mode the read timer
+ * runs at the idle period while released, a new event flags a wakeup which
+ * the LVGL thread turns into a ready read timer.
+ */
+#define TOUCH_EVENT_QUEUE_NUM       32
+#define TOUCH_EVENT_IDLE_PERIOD     500
+#define TOUCH_LATENCY_MAX_MS        1000
+
+#ifndef LV_USE_INDEV_EVENT_DRIVEN
+    #define LV_USE_INDEV_EVENT_DRIVEN   0
+#endif
+
+struct touch_event
+{
+    rt_int16_t x;
+    rt_int16_t y;
+    lv_indev_state_t state;
+    rt_tick_t tick;
+};
+
+struct touch_stat
+{
+    rt_uint32_t events;
+    rt_uint32_t coalesced;          /* moves merged into the newest one on a full queue */
+    rt_uint32_t dropped;
+    rt_uint32_t max_depth;
+    rt_uint32_t latency_num;        /* touch-to-flush samples */
+    rt_uint32_t latency_sum;
+    rt_uint32_t latency_min;
+    rt_uint32_t latency_max;
+};
+
+static struct touch_event touch_queue[TOUCH_EVENT_QUEUE_NUM];
+static rt_uint32_t touch_head = 0, touch_tail = 0;
+static struct touch_event last_event = { 0, 0, LV_INDEV_STATE_REL, 0 };
+
+static lv_indev_drv_t *touch_indev_drv = RT_NULL;
+static volatile int touch_event_driven = LV_USE_INDEV_EVENT_DRIVEN;
+static volatile rt_uint8_t touch_wakeup = 0;  /* set by the touch thread, taken by the LVGL thread */
+static rt_tick_t touch_pending_tick = 0;     /* oldest event read since the last flush */
+static struct touch_stat touch_stat = { .latency_min = RT_UINT32_MAX };
 
 static void input_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
-    data->point.x = last_x;
-    data->point.y = last_y;
-    data->state = last_state;
+    rt_base_t level;
+    bool more = false;
+
+    level = rt_hw_interrupt_disable();
+    if (touch_head != touch_tail)
+    {
+        last_event = touch_queue[touch_tail % TOUCH_EVENT_QUEUE_NUM];
+        touch_tail++;
+        more = (touch_head != touch_tail);
+
+        if (touch_pending_tick == 0)
+            touch_pending_tick = last_event.tick ? last_event.tick : 1;
+    }
+    rt_hw_interrupt_enable(level);
+
+    data->point.x = last_event.x;
+    data->point.y = last_event.y;
+    data->state = last_event.state;
+    data->continue_reading = more;
+
+    /* Long presses need the periodic reads, a released idle pointer does not. */
+    if (indev_drv->read_timer != NULL)
+    {
+        uint32_t period = (touch_event_driven && (last_event.state == LV_INDEV_STATE_REL)) ?
+                          TOUCH_EVENT_IDLE_PERIOD : LV_INDEV_DEF_READ_PERIOD;
+
+        if (indev_drv->read_timer->period != period)
+            lv_timer_set_period(indev_drv->read_timer, period);
+    }
 }
 
 void nu_touch_inputevent_cb(rt_int16_t x, rt_int16_t y, rt_uint8_t state)
 {
+    struct touch_event event;
+    struct touch_event *newest;
+    rt_uint32_t depth;
+    rt_base_t level;
+
     switch (state)
     {
     case RT_TOUCH_EVENT_UP:
-        last_state = LV_INDEV_STATE_RELEASED;
+        event.state = LV_INDEV_STATE_RELEASED;
         break;
     case RT_TOUCH_EVENT_MOVE:
     case RT_TOUCH_EVENT_DOWN:
-        last_x = x;
-        last_y = y;
-        last_state = LV_INDEV_STATE_PRESSED;
+        event.state = LV_INDEV_STATE_PRESSED;
         break;
+    default:
+        return;
+    }
+
+    event.tick = rt_tick_get();
+
+    level = rt_hw_interrupt_disable();
+
+    /* The release keeps the point of the last press. */
+    if (event.state == LV_INDEV_STATE_RELEASED)
+    {
+        newest = (touch_head != touch_tail) ? &touch_queue[(touch_head - 1) % TOUCH_EVENT_QUEUE_NUM] : &last_event;
+        event.x = newest->x;
+        event.y = newest->y;
+    }
+    else
+    {
+        event.x = x;
+        event.y = y;
+    }
+
+    depth = touch_head - touch_tail;
+    newest = &touch_queue[(touch_head - 1) % TOUCH_EVENT_QUEUE_NUM];
+    if (depth < TOUCH_EVENT_QUEUE_NUM)
+    {
+        touch_queue[touch_head % TOUCH_EVENT_QUEUE_NUM] = event;
+        touch_head++;
+        if (++depth > touch_stat.max_depth)
+            touch_stat.max_depth = depth;
+    }
+    else if (event.state == LV_INDEV_STATE_RELEASED)
+    {
+        /*
+         * Full: a release is never lost, the pointer would stay pressed. The
+         * newest press takes the place of the entry before it and the release
+         * the newest one, two taps at the end of the queue become one press.
+         */
+        if (newest->state == LV_INDEV_STATE_PRESSED)
+            touch_queue[(touch_head - 2) % TOUCH_EVENT_QUEUE_NUM] = *newest;
+        *newest = event;
+        touch_stat.coalesced++;
     }
+    else if (newest->state == LV_INDEV_STATE_PRESSED)
+    {
+        /* Full: move the newest point, the pressed/released sequence stays intact. */
+        newest->x = event.x;
+        newest->y = event.y;
+        touch_stat.coalesced++;
+    }
+    else
+    {
+        touch_stat.dropped++;
+    }
+    touch_stat.events++;
+
+    rt_hw_interrupt_enable(level);
+
+    /* The LVGL timers are not thread safe, the wakeup timer makes the read timer ready. */
+    if (touch_event_driven)
+        touch_wakeup = 1;
+}
+
+/* Runs at every pass of the LVGL timers, reads at this pass instead of the idle period. */
+static void touch_wakeup_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+
+    if (!touch_wakeup)
+        return;
+
+    /* Cleared first, an event queued after it is drained by this read or wakes the next pass. */
+    touch_wakeup = 0;
+    if ((touch_indev_drv != RT_NULL) && (touch_indev_drv->read_timer != NULL))
+        lv_timer_ready(touch_indev_drv->read_timer);
+}
+
+/* Called by the display port when a frame was flushed, closes the latency sample. */
+void lv_port_indev_frame_flushed(void)
+{
+    rt_uint32_t latency;
+
+    if (touch_pending_tick == 0)
+        return;
+
+    latency = (rt_tick_get() - touch_pending_tick) * 1000 / RT_TICK_PER_SECOND;
+    touch_pending_tick = 0;
+
+    /* No frame followed the input soon, it drew nothing. */
+    if (latency > TOUCH_LATENCY_MAX_MS)
+        return;
+
+    touch_stat.latency_num++;
+    touch_stat.latency_sum += latency;
+    if (latency < touch_stat.latency_min)
+        touch_stat.latency_min = latency;
+    if (latency > touch_stat.latency_max)
+        touch_stat.latency_max = latency;
 }
 
 void lv_port_indev_init(void)
@@ -51,4 +219,38 @@ void lv_port_indev_init(void)
 
     /* Register the driver in LVGL and save the created input device object */
     lv_indev_drv_register(&indev_drv);
+
+    touch_indev_drv = &indev_drv;
+    lv_timer_create(touch_wakeup_cb, 0, NULL);
+}
+
+static int lv_touch_stat(int argc, char *argv[])
+{
+    if (argc == 1)
+    {
+        rt_kprintf("mode:      %s\n", touch_event_driven ? "event" : "poll");
+        rt_kprintf("events:    %u, coalesced %u, dropped %u, max queued %u\n",
+                   touch_stat.events, touch_stat.coalesced, touch_stat.dropped, touch_stat.max_depth);
+        if (touch_stat.latency_num)
+            rt_kprintf("touch-to-flush: %u samples, min %u ms, avg %u ms, max %u ms\n", touch_stat.latency_num,
+                       touch_stat.latency_min, touch_stat.latency_sum / touch_stat.latency_num, touch_stat.latency_max);
+    }
+    else if (!rt_strcmp(argv[1], "reset"))
+    {
+        rt_memset(&touch_stat, 0, sizeof(touch_stat));
+        touch_stat.latency_min = RT_UINT32_MAX;
+    }
+    else if (!rt_strcmp(argv[1], "mode") && (argc == 3))
+    {
+        /* The read callback applies the period at its next run. */
+        touch_event_driven = !rt_strcmp(argv[2], "event");
+    }
+    else
+    {
+        rt_kprintf("Usage: lv_touch_stat [reset | mode <event|poll>]\n");
+        return -RT_EINVAL;
+    }
+
+    return 0;
 }
+MSH_CMD_EXPORT(lv_touch_stat, LVGL touch queue and latency statistics);
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+
+#if defined(BSP_USING_LVGL_MEMPOOL)
+
+#include <string.h>
+#include "board.h"
+#include "lv_port_mem.h"
+
+#define DBG_TAG    "lv.mem"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+/*
+ * The pool is cut in two parts:
+ *  - a slab of 4KB pages for the small objects, styles and their lists which
+ *    LVGL allocates and frees all the time. A page holds the blocks of one
+ *    size class and goes back to the free pages once it is empty.
+ *  - a memheap for the rest, draw layers and image caches. Small requests
+ *    fall back to it when the slab is full.
+ * A block of the system heap costs a header and the rounding to RT_ALIGN_SIZE,
+ * the slab has neither.
+ */
+#define NU_LVMEM_PAGE_SIZE      4096
+#define NU_LVMEM_SLAB_SIZE      RT_ALIGN_DOWN(BSP_LVGL_MEMPOOL_SLAB_SIZE * 1024, NU_LVMEM_PAGE_SIZE)
+#define NU_LVMEM_PAGE_NUM       (NU_LVMEM_SLAB_SIZE / NU_LVMEM_PAGE_SIZE)
+#define NU_LVMEM_SMALL_MAX      256
+#define NU_LVMEM_NONE           0xFFFF
+
+#if (BSP_LVGL_MEMPOOL_SLAB_SIZE >= BSP_LVGL_MEMPOOL_SIZE)
+    #error "BSP_LVGL_MEMPOOL_SLAB_SIZE must be smaller than BSP_LVGL_MEMPOOL_SIZE"
+#endif
+
+#define NU_LVMEM_IN_SLAB(p)     (((rt_uint8_t *)(p) >= s_pu8Slab) && ((rt_uint8_t *)(p) < (s_pu8Slab + NU_LVMEM_SLAB_SIZE)))
+
+struct nu_lvmem_page
+{
+    void *free;         /* free blocks of the page */
+    rt_uint16_t used;
+    rt_uint16_t next;   /* next page on the partial list of the class, or on the free pages */
+    rt_uint16_t prev;
+    rt_uint8_t cls;
+};
+
+struct nu_lvmem_class
+{
+    rt_uint16_t partial;    /* pages with free blocks */
+    rt_uint32_t used;
+    rt_uint32_t peak;
+    rt_uint32_t pages;
+    rt_uint32_t allocs;
+};
+
+static const rt_uint16_t s_au16ClassSize[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+#define NU_LVMEM_CLASS_NUM      (sizeof(s_au16ClassSize) / sizeof(s_au16ClassSize[0]))
+
+static rt_uint8_t s_au8SizeClass[NU_LVMEM_SMALL_MAX / 8 + 1];
+static struct nu_lvmem_class s_asClass[NU_LVMEM_CLASS_NUM];
+static struct nu_lvmem_page s_asPage[NU_LVMEM_PAGE_NUM];
+static rt_uint16_t s_u16FreePage;
+static rt_uint32_t s_u32PageUsed;
+static rt_uint32_t s_u32PagePeak;
+
+static rt_uint8_t *s_pu8Slab;
+static struct rt_memheap s_sHeap;
+static struct rt_mutex s_sLock;
+
+static rt_uint32_t s_u32Fallbacks;      /* small requests served by the memheap */
+static rt_uint32_t s_u32LargeAllocs;
+static rt_uint32_t s_u32Failures;
+static rt_uint32_t s_u32FootprintPeak;  /* slab pages and memheap in use */
+
+static void nu_lvmem_partial_insert(struct nu_lvmem_class *psClass, rt_uint16_t idx)
+{
+    struct nu_lvmem_page *psPage = &s_asPage[idx];
+
+    psPage->prev = NU_LVMEM_NONE;
+    psPage->next = psClass->partial;
+    if (psClass->partial != NU_LVMEM_NONE)
+        s_asPage[psClass->partial].prev = idx;
+    psClass->partial = idx;
+}
+
+static void nu_lvmem_partial_remove(struct nu_lvmem_class *psClass, rt_uint16_t idx)
+{
+    struct nu_lvmem_page *psPage = &s_asPage[idx];
+
+    if (psPage->prev != NU_LVMEM_NONE)
+        s_asPage[psPage->prev].next = psPage->next;
+    else
+        psClass->partial = psPage->next;
+
+    if (psPage->next != NU_LVMEM_NONE)
+        s_asPage[psPage->next].prev = psPage->prev;
+}
+
+static void nu_lvmem_footprint(void)
+{
+    rt_uint32_t u32Footprint;
+
+    if (s_u32PageUsed > s_u32PagePeak)
+        s_u32PagePeak = s_u32PageUsed;
+
+    u32Footprint = s_u32PageUsed * NU_LVMEM_PAGE_SIZE + (s_sHeap.pool_size - s_sHeap.available_size);
+    if (u32Footprint > s_u32FootprintPeak)
+        s_u32FootprintPeak = u32Footprint;
+}
+
+/* Take a free page for the class and cut it in blocks. */
+static rt_uint16_t nu_lvmem_page_new(int cls)
+{
+    rt_uint16_t idx = s_u16FreePage;
+    struct nu_lvmem_page *psPage;
+    rt_uint8_t *pu8Block;
+    int i, num = NU_LVMEM_PAGE_SIZE / s_au16ClassSize[cls];
+
+    if (idx == NU_LVMEM_NONE)
+        return NU_LVMEM_NONE;
+
+    psPage = &s_asPage[idx];
+    s_u16FreePage = psPage->next;
+
+    pu8Block = s_pu8Slab + idx * NU_LVMEM_PAGE_SIZE;
+    psPage->free = pu8Block;
+    for (i = 0; i < num - 1; i++, pu8Block += s_au16ClassSize[cls])
+        *(void **)pu8Block = pu8Block + s_au16ClassSize[cls];
+    *(void **)pu8Block = RT_NULL;
+
+    psPage->used = 0;
+    psPage->cls = cls;
+    nu_lvmem_partial_insert(&s_asClass[cls], idx);
+    s_asClass[cls].pages++;
+    s_u32PageUsed++;
+
+    return idx;
+}
+
+static void *nu_lvmem_slab_alloc(int cls)
+{
+    struct nu_lvmem_class *psClass = &s_asClass[cls];
+    struct nu_lvmem_page *psPage;
+    rt_uint16_t idx;
+    void **block;
+
+    idx = psClass->partial;
+    if (idx == NU_LVMEM_NONE)
+    {
+        idx = nu_lvmem_page_new(cls);
+        if (idx == NU_LVMEM_NONE)
+            return RT_NULL;
+    }
+
+    psPage = &s_asPage[idx];
+    block = (void **)psPage->free;
+    psPage->free = *block;
+    psPage->used++;
+    if (psPage->free == RT_NULL)
+        nu_lvmem_partial_remove(psClass, idx);
+
+    psClass->allocs++;
+    if (++psClass->used > psClass->peak)
+        psClass->peak = psClass->used;
+
+    return block;
+}
+
+static void nu_lvmem_slab_free(void *ptr)
+{
+    rt_uint16_t idx = ((rt_uint8_t *)ptr - s_pu8Slab) / NU_LVMEM_PAGE_SIZE;
+    struct nu_lvmem_page *psPage = &s_asPage[idx];
+    struct nu_lvmem_class *psClass = &s_asClass[psPage->cls];
+    rt_bool_t bWasFull = (psPage->free == RT_NULL);
+
+    *(void **)ptr = psPage->free;
+    psPage->free = ptr;
+    psPage->used--;
+    psClass->used--;
+
+    if (psPage->used == 0)
+    {
+        /* Keep the last page of the class, an object is often freed and allocated again. */
+        if (!bWasFull && (psClass->partial == idx) && (psPage->next == NU_LVMEM_NONE))
+            return;
+
+        if (!bWasFull)
+            nu_lvmem_partial_remove(psClass, idx);
+
+        psPage->next = s_u16FreePage;
+        s_u16FreePage = idx;
+        psClass->pages--;
+        s_u32PageUsed--;
+    }
+    else if (bWasFull)
+    {
+        nu_lvmem_partial_insert(psClass, idx);
+    }
+}
+
+void *lv_port_mem_alloc(size_t size)
+{
+    void *ptr = RT_NULL;
+
+    if (size == 0)
+        return RT_NULL;
+
+    rt_mutex_take(&s_sLock, RT_WAITING_FOREVER);
+
+    if (size <= NU_LVMEM_SMALL_MAX)
+    {
+        ptr = nu_lvmem_slab_alloc(s_au8SizeClass[(size + 7) >> 3]);
+        if (ptr == RT_NULL)
+            s_u32Fallbacks++;
+    }
+    else
+    {
+        s_u32LargeAllocs++;
+    }
+
+    if (ptr == RT_NULL)
+    {
+        ptr = rt_memheap_alloc(&s_sHeap, size);
+        if (ptr == RT_NULL)
+            s_u32Failures++;
+    }
+
+    nu_lvmem_footprint();
+
+    rt_mutex_release(&s_sLock);
+
+    return ptr;
+}
+
+void lv_port_mem_free(void *ptr)
+{
+    if (ptr == RT_NULL)
+        return;
+
+    if (NU_LVMEM_IN_SLAB(ptr))
+    {
+        rt_mutex_take(&s_sLock, RT_WAITING_FOREVER);
+        nu_lvmem_slab_free(ptr);
+        rt_mutex_release(&s_sLock);
+    }
+    else
+    {
+        rt_memheap_free(ptr);
+    }
+}
+
+void *lv_port_mem_realloc(void *ptr, size_t size)
+{
+    rt_uint16_t u16OldSize;
+    void *new_ptr;
+
+    if (ptr == RT_NULL)
+        return lv_port_mem_alloc(size);
+
+    if (size == 0)
+    {
+        lv_port_mem_free(ptr);
+        return RT_NULL;
+    }
+
+    if (!NU_LVMEM_IN_SLAB(ptr))
+    {
+        rt_mutex_take(&s_sLock, RT_WAITING_FOREVER);
+        new_ptr = rt_memheap_realloc(&s_sHeap, ptr, size);
+        if (new_ptr == RT_NULL)
+            s_u32Failures++;
+        nu_lvmem_footprint();
+        rt_mutex_release(&s_sLock);
+
+        return new_ptr;
+    }
+
+    u16OldSize = s_au16ClassSize[s_asPage[((rt_uint8_t *)ptr - s_pu8Slab) / NU_LVMEM_PAGE_SIZE].cls];
+    if (size <= u16OldSize)
+        return ptr;
+
+    new_ptr = lv_port_mem_alloc(size);
+    if (new_ptr != RT_NULL)
+    {
+        memcpy(new_ptr, ptr, u16OldSize);
+        lv_port_mem_free(ptr);
+    }
+
+    return new_ptr;
+}
+
+int lv_port_mem_init(void)
+{
+    rt_uint8_t *pu8Pool = (rt_uint8_t *)RT_ALIGN((rt_ubase_t)BOARD_LVGL_POOL_START, NU_LVMEM_PAGE_SIZE);
+    rt_uint8_t *pu8End = (rt_uint8_t *)BOARD_LVGL_POOL_START + BOARD_LVGL_POOL_SIZE;
+    int i, cls;
+
+    rt_mutex_init(&s_sLock, "lvmem", RT_IPC_FLAG_PRIO);
+
+    for (i = 0, cls = 0; i < sizeof(s_au8SizeClass); i++)
+    {
+        while (s_au16ClassSize[cls] < i * 8)
+            cls++;
+        s_au8SizeClass[i] = cls;
+    }
+
+    for (cls = 0; cls < NU_LVMEM_CLASS_NUM; cls++)
+        s_asClass[cls].partial = NU_LVMEM_NONE;
+
+    s_pu8Slab = pu8Pool;
+    for (i = 0; i < NU_LVMEM_PAGE_NUM; i++)
+        s_asPage[i].next = (i == NU_LVMEM_PAGE_NUM - 1) ? NU_LVMEM_NONE : i + 1;
+    s_u16FreePage = 0;
+
+    if (rt_memheap_init(&s_sHeap, "lvgl", pu8Pool + NU_LVMEM_SLAB_SIZE, pu8End - pu8Pool - NU_LVMEM_SLAB_SIZE) != RT_EOK)
+    {
+        LOG_E("Failed to init the LVGL memheap.");
+        return -RT_ERROR;
+    }
+
+    LOG_I("LVGL pool: %08x-%08x, slab %d KB", pu8Pool, pu8End, NU_LVMEM_SLAB_SIZE / 1024);
+
+    return RT_EOK;
+}
+INIT_PREV_EXPORT(lv_port_mem_init);
+
+/* Largest free block of the memheap, against the whole free size it tells the fragmentation. */
+static rt_size_t nu_lvmem_heap_largest(void)
+{
+    rt_size_t largest = 0, size;
+    struct rt_memheap_item *item;
+
+    rt_sem_take(&s_sHeap.lock, RT_WAITING_FOREVER);
+    for (item = s_sHeap.free_list->next_free; item != s_sHeap.free_list; item = item->next_free)
+    {
+        size = (rt_ubase_t)item->next - (rt_ubase_t)item - RT_ALIGN(sizeof(struct rt_memheap_item), RT_ALIGN_SIZE);
+        if (size > largest)
+            largest = size;
+    }
+    rt_sem_release(&s_sHeap.lock);
+
+    return largest;
+}
+
+static int lv_mem_stat(int argc, char *argv[])
+{
+    rt_size_t total, used, max_used, largest;
+    rt_uint32_t u32Bytes = 0;
+    int cls;
+
+    if ((argc > 1) && !rt_strcmp(argv[1], "reset"))
+    {
+        rt_mutex_take(&s_sLock, RT_WAITING_FOREVER);
+        for (cls = 0; cls < NU_LVMEM_CLASS_NUM; cls++)
+        {
+            s_asClass[cls].peak = s_asClass[cls].used;
+            s_asClass[cls].allocs = 0;
+        }
+        s_u32PagePeak = 0;
+        s_u32FootprintPeak = 0;
+        s_u32Fallbacks = s_u32LargeAllocs = s_u32Failures = 0;
+        s_sHeap.max_used_size = s_sHeap.pool_size - s_sHeap.available_size;
+        nu_lvmem_footprint();
+        rt_mutex_release(&s_sLock);
+        return 0;
+    }
+
+    rt_mutex_take(&s_sLock, RT_WAITING_FOREVER);
+
+    rt_kprintf("class   used   peak  pages     allocs\n");
+    for (cls = 0; cls < NU_LVMEM_CLASS_NUM; cls++)
+    {
+        struct nu_lvmem_class *psClass = &s_asClass[cls];
+
+        rt_kprintf("%5d %6u %6u %6u %10u\n", s_au16ClassSize[cls], psClass->used, psClass->peak, psClass->pages, psClass->allocs);
+        u32Bytes += psClass->used * s_au16ClassSize[cls];
+    }
+
+    rt_kprintf("slab: %u/%d pages, peak %u, %u%% of the pages in use\n",
+               s_u32PageUsed, NU_LVMEM_PAGE_NUM, s_u32PagePeak,
+               s_u32PageUsed ? u32Bytes * 100 / (s_u32PageUsed * NU_LVMEM_PAGE_SIZE) : 0);
+    rt_kprintf("small requests on the heap: %u, large requests: %u, failures: %u\n",
+               s_u32Fallbacks, s_u32LargeAllocs, s_u32Failures);
+
+    rt_mutex_release(&s_sLock);
+
+    rt_memheap_info(&s_sHeap, &total, &used, &max_used);
+    largest = nu_lvmem_heap_largest();
+    rt_kprintf("heap: %u/%u bytes, peak %u, largest free %u, fragmentation %u%%\n",
+               used, total, max_used, largest,
+               (total > used) ? 100 - (rt_uint32_t)((rt_uint64_t)largest * 100 / (total - used)) : 0);
+    rt_kprintf("peak footprint: %u bytes\n", s_u32FootprintPeak);
+
+    return 0;
+}
+MSH_CMD_EXPORT(lv_mem_stat, LVGL memory pool usage);
+
+#endif /* BSP_USING_LVGL_MEMPOOL */
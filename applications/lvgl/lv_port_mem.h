@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef __LV_PORT_MEM_H__
+#define __LV_PORT_MEM_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* LV_MEM_CUSTOM allocator on the LVGL pool of the DDR(BSP_USING_LVGL_MEMPOOL) */
+void *lv_port_mem_alloc(size_t size);
+void *lv_port_mem_realloc(void *ptr, size_t size);
+void lv_port_mem_free(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LV_PORT_MEM_H__ */
@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ * 2026-10-19     RT-Thread    partial mode, frames checked against the software
+ */
+
+/*
+ * Headless host run of the GE2D coverage scenes: lv_gpu_n9h30_2dge.c draws
+ * the scenes of lv_demo_benchmark on the engine model of ge2d_model.c, one
+ * CSV line per scene gives the pixels per frame of each path, the engine
+ * and cache traffic and the frame time estimated by the cost tables. With a
+ * baseline, a scene whose engine share drops or whose estimate grows fails
+ * the run.
+ *
+ *   ge2d_host [-p] [-r] [-o out.csv] [-b baseline.csv] [-s first[-last]] [-m op:ns_call:ps_px]
+ *
+ * -p draws the changed areas only (partial mode) instead of whole frames,
+ * the areas then start on any column of the screen.
+ * -r renders the scenes once more with the engine off, in a child process
+ * on the same clock. Every frame has to come out the same, pixel by pixel.
+ * -m sets the software cost of a path (fill, map, map_opa), take the values
+ * printed by "ge2d_stat calib" on the board.
+ */
+#include <rtthread.h>
+#include <lvgl.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "lv_demo_benchmark.h"
+#include "lv_gpu_n9h30_2dge.h"
+#include "lv_demo_ge2d_cov.h"
+#include "lv_port_mem.h"
+#include "mmu.h"
+#include "ge2d_model.h"
+
+#define HOST_SCENE_TIMEOUT_MS       10000
+#define HOST_LINE_MAX               512
+
+/* The regression limits against the baseline */
+#define HOST_PCT_DROP_MAX           1       /* points of the engine share */
+#define HOST_EST_GROW_PCT_MAX       5       /* percents of the estimate */
+
+/* The software blend, per call and per pixel, an ARM926 at 300 MHz */
+typedef struct
+{
+    const char *name;
+    uint32_t ns_call;
+    uint32_t ps_px;
+} host_sw_cost_t;
+
+static host_sw_cost_t s_sw_cost[GE2D_OP_NUM] =
+{
+    [GE2D_OP_FILL]    = { "fill",    1500,  3500 },
+    [GE2D_OP_MAP]     = { "map",     1500,  6000 },
+    [GE2D_OP_MAP_OPA] = { "map_opa", 2000, 16000 },
+};
+
+typedef struct
+{
+    char name[64];
+    uint32_t ge2d_pct;
+    uint32_t est_us;
+} host_result_t;
+
+/* The frames of a scene, by a hash of their pixels */
+typedef struct
+{
+    uint64_t *hash;
+    uint32_t num;
+    uint32_t size;
+} host_frames_t;
+
+static rt_tick_t s_tick;
+static volatile int s_finished;
+
+static lv_disp_drv_t s_disp_drv;
+static lv_disp_draw_buf_t s_disp_buf;
+static lv_color_t *s_framebuffer;
+static host_frames_t s_frames;
+
+rt_tick_t rt_tick_get(void)
+{
+    return s_tick;
+}
+
+void rt_thread_mdelay(rt_int32_t ms)
+{
+    s_tick += ms;
+}
+
+void *lv_port_mem_alloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *lv_port_mem_realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+void lv_port_mem_free(void *ptr)
+{
+    free(ptr);
+}
+
+/* FNV-1a over the words of a frame */
+static void host_frame_add(const lv_color_t *frame, uint32_t px)
+{
+    const uint32_t *p = (const uint32_t *)frame;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i;
+
+    for (i = 0; i < px * sizeof(lv_color_t) / sizeof(uint32_t); i++)
+        hash = (hash ^ p[i]) * 0x100000001b3ULL;
+
+    if (s_frames.num == s_frames.size)
+    {
+        s_frames.size = s_frames.size ? s_frames.size * 2 : 64;
+        s_frames.hash = realloc(s_frames.hash, s_frames.size * sizeof(uint64_t));
+        RT_ASSERT(s_frames.hash);
+    }
+    s_frames.hash[s_frames.num++] = hash;
+}
+
+/* As nu_flush_full_refresh(): the engine reads the frame from memory. */
+static void host_flush_full_refresh(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    mmu_clean_dcache_rect((uint32_t)(uintptr_t)(color_p + area->y1 * disp_drv->hor_res + area->x1),
+                          disp_drv->hor_res * sizeof(lv_color_t),
+                          lv_area_get_width(area) * sizeof(lv_color_t),
+                          lv_area_get_height(area));
+
+    lv_draw_n9h30_2dge_frame_done();
+
+    host_frame_add(color_p, disp_drv->hor_res * disp_drv->ver_res);
+
+    lv_disp_flush_ready(disp_drv);
+}
+
+/* As nu_flush_exec(): the area is copied to the framebuffer by the engine, or row by row. */
+static void host_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    lv_coord_t w = lv_area_get_width(area);
+    lv_coord_t y;
+
+    if (!lv_draw_n9h30_2dge_copy(s_framebuffer, disp_drv->hor_res, area, color_p))
+    {
+        for (y = area->y1; y <= area->y2; y++)
+            rt_memcpy(s_framebuffer + y * disp_drv->hor_res + area->x1,
+                      color_p + (y - area->y1) * w, w * sizeof(lv_color_t));
+    }
+
+    if (lv_disp_flush_is_last(disp_drv))
+    {
+        lv_draw_n9h30_2dge_frame_done();
+        host_frame_add(s_framebuffer, disp_drv->hor_res * disp_drv->ver_res);
+    }
+
+    lv_disp_flush_ready(disp_drv);
+}
+
+static int host_disp_register(bool full_refresh)
+{
+    uint32_t px = LV_HOR_RES_MAX * LV_VER_RES_MAX;
+    void *buf1, *buf2;
+
+    buf1 = rt_malloc_align(px * sizeof(lv_color_t), RT_ALIGN_SIZE);
+    buf2 = rt_malloc_align(px * sizeof(lv_color_t), RT_ALIGN_SIZE);
+    s_framebuffer = rt_malloc_align(px * sizeof(lv_color_t), RT_ALIGN_SIZE);
+    if (!buf1 || !buf2 || !s_framebuffer)
+        return -RT_ENOMEM;
+    rt_memset(s_framebuffer, 0, px * sizeof(lv_color_t));
+
+    lv_disp_draw_buf_init(&s_disp_buf, buf1, buf2, px);
+
+    lv_disp_drv_init(&s_disp_drv);
+    s_disp_drv.hor_res = LV_HOR_RES_MAX;
+    s_disp_drv.ver_res = LV_VER_RES_MAX;
+    s_disp_drv.draw_buf = &s_disp_buf;
+    s_disp_drv.full_refresh = full_refresh;
+    s_disp_drv.flush_cb = s_disp_drv.full_refresh ? host_flush_full_refresh : host_flush;
+    s_disp_drv.draw_ctx_init = lv_draw_n9h30_2dge_ctx_init;
+    s_disp_drv.draw_ctx_deinit = lv_draw_n9h30_2dge_ctx_deinit;
+    s_disp_drv.draw_ctx_size = sizeof(lv_draw_n9h30_2dge_ctx_t);
+
+    return lv_disp_drv_register(&s_disp_drv) ? RT_EOK : -RT_ERROR;
+}
+
+static void host_finished(void)
+{
+    s_finished = 1;
+}
+
+/* Runs a scene on its own screen, as ge2d_cov_next() does on the board. */
+static int host_run_scene(int16_t scene_no)
+{
+    lv_obj_t *scr_old = lv_scr_act();
+    lv_obj_t *scr = lv_obj_create(NULL);
+    rt_tick_t start;
+
+    lv_scr_load(scr);
+    lv_obj_del(scr_old);
+
+    lv_draw_n9h30_2dge_reset_stat();
+    ge2d_model_reset();
+    s_frames.num = 0;
+    s_finished = 0;
+
+    lv_demo_benchmark_run_scene(scene_no);
+
+    start = s_tick;
+    while (!s_finished)
+    {
+        if ((s_tick - start) > HOST_SCENE_TIMEOUT_MS)
+            return -RT_ETIMEOUT;
+
+        s_tick++;
+        lv_timer_handler();
+    }
+
+    return RT_EOK;
+}
+
+static uint64_t host_sw_ns(const lv_draw_n9h30_2dge_stat_t *stat)
+{
+    uint64_t ns = 0;
+    int op;
+
+    for (op = 0; op < GE2D_OP_NUM; op++)
+        ns += (uint64_t)stat->sw_calls[op] * s_sw_cost[op].ns_call + (uint64_t)stat->sw_px[op] * s_sw_cost[op].ps_px / 1000;
+
+    return ns;
+}
+
+static void host_report(FILE *fp, const lv_demo_ge2d_cov_scene_t *scene, host_result_t *result)
+{
+    lv_draw_n9h30_2dge_stat_t stat;
+    ge2d_model_stat_t model;
+    uint64_t ge2d_px = 0, all_px = 0, sw_ns;
+    uint32_t frames, ops = 0, op;
+
+    lv_draw_n9h30_2dge_get_stat(&stat);
+    ge2d_model_get(&model);
+    frames = stat.frames ? stat.frames : 1;
+
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        ge2d_px += stat.ge2d_px[op];
+        all_px += stat.ge2d_px[op] + stat.sw_px[op];
+    }
+    for (op = 0; op < GE2D_MODEL_OP_NUM; op++)
+        ops += model.ops[op];
+    sw_ns = host_sw_ns(&stat);
+
+    rt_snprintf(result->name, sizeof(result->name), "%s", scene->name);
+    result->ge2d_pct = all_px ? (uint32_t)(ge2d_px * 100 / all_px) : 100;
+    result->est_us = (uint32_t)((model.ge2d_ns + model.cache_ns + sw_ns) / 1000 / frames);
+
+    fprintf(fp, "%d,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%llu,%llu,%u,%u,%u,%u,%u\n",
+            scene->scene_no, scene->name, stat.frames,
+            stat.ge2d_px[GE2D_OP_FILL] / frames, stat.sw_px[GE2D_OP_FILL] / frames,
+            stat.ge2d_px[GE2D_OP_MAP] / frames, stat.sw_px[GE2D_OP_MAP] / frames,
+            stat.ge2d_px[GE2D_OP_MAP_OPA] / frames, stat.sw_px[GE2D_OP_MAP_OPA] / frames,
+            stat.letters_ge2d / frames, stat.letters_sw / frames,
+            result->ge2d_pct, ops / frames,
+            (unsigned long long)((model.rd_bytes + model.wr_bytes) / frames),
+            (unsigned long long)(model.cache_lines / frames), model.cache_all / frames,
+            (uint32_t)(model.ge2d_ns / 1000 / frames), (uint32_t)(model.cache_ns / 1000 / frames),
+            (uint32_t)(sw_ns / 1000 / frames), result->est_us);
+}
+
+/* Compares the run with a CSV of an earlier one, scene by scene name. */
+static int host_compare(const char *path, const host_result_t *results, uint32_t num)
+{
+    char line[HOST_LINE_MAX];
+    uint32_t checked = 0, failed = 0, i;
+    FILE *fp;
+
+    fp = fopen(path, "r");
+    if (!fp)
+    {
+        fprintf(stderr, "ge2d_host: can't open %s\n", path);
+        return -RT_ERROR;
+    }
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        char *field[21];
+        char *save = RT_NULL;
+        uint32_t n = 0, base_pct, base_est;
+
+        for (field[n] = strtok_r(line, ",\n", &save); field[n] && (n < 20); field[n] = strtok_r(RT_NULL, ",\n", &save))
+            n++;
+        if ((n < 20) || !rt_strcmp(field[0], "scene"))
+            continue;
+
+        base_pct = atoi(field[11]);
+        base_est = atoi(field[19]);
+
+        for (i = 0; i < num; i++)
+        {
+            if (rt_strcmp(results[i].name, field[1]))
+                continue;
+
+            checked++;
+            if ((results[i].ge2d_pct + HOST_PCT_DROP_MAX) < base_pct)
+            {
+                fprintf(stderr, "ge2d_host: %s: engine share %u%%, was %u%%\n", results[i].name, results[i].ge2d_pct, base_pct);
+                failed++;
+            }
+            if ((uint64_t)results[i].est_us * 100 > (uint64_t)base_est * (100 + HOST_EST_GROW_PCT_MAX))
+            {
+                fprintf(stderr, "ge2d_host: %s: estimated %u us per frame, was %u us\n", results[i].name, results[i].est_us, base_est);
+                failed++;
+            }
+            break;
+        }
+    }
+    fclose(fp);
+
+    printf("ge2d_host: %u scenes compared with %s, %u regressions\n", checked, path, failed);
+
+    return (checked && !failed) ? RT_EOK : -RT_ERROR;
+}
+
+/* The frames of the scenes to ref, as a count and the hashes per scene */
+static int host_record_scenes(uint32_t first, uint32_t last, FILE *ref)
+{
+    uint32_t i;
+
+    for (i = first; i <= last; i++)
+    {
+        if (host_run_scene(lv_demo_ge2d_cov_scenes[i].scene_no) != RT_EOK)
+            return -RT_ETIMEOUT;
+        fwrite(&s_frames.num, sizeof(s_frames.num), 1, ref);
+        fwrite(s_frames.hash, sizeof(uint64_t), s_frames.num, ref);
+    }
+
+    return RT_EOK;
+}
+
+/* The software rendering of the scenes by a child, on a clock and LVGL state of its own */
+static FILE *host_reference(uint32_t first, uint32_t last, bool full_refresh)
+{
+    FILE *ref = tmpfile();
+    pid_t pid;
+    int status;
+
+    if (!ref)
+        return RT_NULL;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        lv_init();
+        if (host_disp_register(full_refresh) != RT_EOK)
+            _exit(2);
+        lv_draw_n9h30_2dge_enable(false);
+        lv_demo_benchmark_set_finished_cb(host_finished);
+        status = host_record_scenes(first, last, ref);
+        fflush(ref);
+        _exit(status == RT_EOK ? 0 : 1);
+    }
+
+    if ((pid < 0) || (waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || WEXITSTATUS(status))
+    {
+        fclose(ref);
+        return RT_NULL;
+    }
+    rewind(ref);
+
+    return ref;
+}
+
+/* The frames of a scene against the software rendering, and the rows the engine moved off the word grid */
+static int host_check_frames(const lv_demo_ge2d_cov_scene_t *scene, FILE *ref)
+{
+    ge2d_model_stat_t model;
+    uint64_t hash;
+    uint32_t num, i;
+    int ret = RT_EOK;
+
+    ge2d_model_get(&model);
+    if (model.misaligned)
+    {
+        fprintf(stderr, "ge2d_host: %s: %u engine operations off the word grid\n", scene->name, model.misaligned);
+        ret = -RT_ERROR;
+    }
+
+    if (fread(&num, sizeof(num), 1, ref) != 1)
+    {
+        fprintf(stderr, "ge2d_host: %s: no software rendering\n", scene->name);
+        return -RT_ERROR;
+    }
+    for (i = 0; i < num; i++)
+    {
+        if (fread(&hash, sizeof(hash), 1, ref) != 1)
+            return -RT_ERROR;
+        if ((ret == RT_EOK) && ((i >= s_frames.num) || (hash != s_frames.hash[i])))
+        {
+            fprintf(stderr, "ge2d_host: %s: frame %u differs from the software rendering\n", scene->name, i);
+            ret = -RT_ERROR;
+        }
+    }
+    if ((ret == RT_EOK) && (num != s_frames.num))
+    {
+        fprintf(stderr, "ge2d_host: %s: %u frames, the software rendering has %u\n", scene->name, s_frames.num, num);
+        ret = -RT_ERROR;
+    }
+
+    return ret;
+}
+
+static int host_set_sw_cost(const char *arg)
+{
+    char name[16];
+    uint32_t ns_call, ps_px;
+    int op;
+
+    if (sscanf(arg, "%15[^:]:%u:%u", name, &ns_call, &ps_px) != 3)
+        return -RT_EINVAL;
+
+    for (op = 0; op < GE2D_OP_NUM; op++)
+    {
+        if (!rt_strcmp(name, s_sw_cost[op].name))
+        {
+            s_sw_cost[op].ns_call = ns_call;
+            s_sw_cost[op].ps_px = ps_px;
+            return RT_EOK;
+        }
+    }
+
+    return -RT_EINVAL;
+}
+
+static void host_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-p] [-r] [-o out.csv] [-b baseline.csv] [-s first[-last]] [-m fill|map|map_opa:ns_call:ps_px]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *out_path = RT_NULL, *base_path = RT_NULL;
+    uint32_t first = 0, last = lv_demo_ge2d_cov_scene_num - 1, i;
+    bool full_refresh = LV_USE_ANTI_TEARING, check = false;
+    uint32_t mismatched = 0;
+    host_result_t *results;
+    FILE *fp = stdout, *ref = RT_NULL;
+    int opt, ret = 0;
+
+    while ((opt = getopt(argc, argv, "pro:b:s:m:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            full_refresh = false;
+            break;
+        case 'r':
+            check = true;
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        case 'b':
+            base_path = optarg;
+            break;
+        case 's':
+            if (sscanf(optarg, "%u-%u", &first, &last) == 1)
+                last = first;
+            break;
+        case 'm':
+            if (host_set_sw_cost(optarg) != RT_EOK)
+            {
+                host_usage(argv[0]);
+                return 2;
+            }
+            break;
+        default:
+            host_usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((first > last) || (last >= lv_demo_ge2d_cov_scene_num))
+    {
+        fprintf(stderr, "ge2d_host: scenes are 0-%u\n", lv_demo_ge2d_cov_scene_num - 1);
+        return 2;
+    }
+
+    if (check)
+    {
+        ref = host_reference(first, last, full_refresh);
+        if (!ref)
+        {
+            fprintf(stderr, "ge2d_host: the software rendering failed\n");
+            return 2;
+        }
+    }
+
+    if (out_path)
+    {
+        fp = fopen(out_path, "w");
+        if (!fp)
+        {
+            fprintf(stderr, "ge2d_host: can't create %s\n", out_path);
+            return 2;
+        }
+    }
+
+    lv_init();
+    if (host_disp_register(full_refresh) != RT_EOK)
+    {
+        fprintf(stderr, "ge2d_host: no display\n");
+        return 2;
+    }
+
+    results = calloc(lv_demo_ge2d_cov_scene_num, sizeof(host_result_t));
+    RT_ASSERT(results);
+
+    lv_demo_benchmark_set_finished_cb(host_finished);
+
+    fprintf(fp, "scene,name,frames,fill_ge2d,fill_sw,map_ge2d,map_sw,map_opa_ge2d,map_opa_sw,letters_ge2d,letters_sw,"
+            "ge2d_pct,ge2d_ops,ge2d_bytes,cache_lines,cache_all,ge2d_us,cache_us,sw_us,est_us\n");
+
+    for (i = first; i <= last; i++)
+    {
+        if (host_run_scene(lv_demo_ge2d_cov_scenes[i].scene_no) != RT_EOK)
+        {
+            fprintf(stderr, "ge2d_host: scene %d (%s) did not finish\n", lv_demo_ge2d_cov_scenes[i].scene_no, lv_demo_ge2d_cov_scenes[i].name);
+            ret = 1;
+            break;
+        }
+        host_report(fp, &lv_demo_ge2d_cov_scenes[i], &results[i - first]);
+        if (ref && (host_check_frames(&lv_demo_ge2d_cov_scenes[i], ref) != RT_EOK))
+            mismatched++;
+    }
+
+    if (fp != stdout)
+        fclose(fp);
+
+    if (ref)
+    {
+        printf("ge2d_host: %u scenes checked against the software rendering, %u differ\n", last - first + 1, mismatched);
+        fclose(ref);
+        if (mismatched)
+            ret = 1;
+    }
+
+    if (!ret && base_path && (host_compare(base_path, results, last - first + 1) != RT_EOK))
+        ret = 1;
+
+    free(results);
+
+    return ret;
+}
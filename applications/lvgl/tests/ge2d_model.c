@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ * 2026-10-19     RT-Thread    fills and blits move whole words
+ * 2026-10-19     RT-Thread    alpha blits round as lv_color_mix()
+ */
+
+/*
+ * Software model of the GE2D (drv_2dge.c) and of the D-cache maintenance of
+ * the ARM926 (libcpu/arm/arm926/mmu.c) for the host test of the N9H30 draw
+ * context. The operations used by lv_gpu_n9h30_2dge.c are carried out on the
+ * buffers, and the model counts them with the bytes the engine moves and the
+ * cache lines maintained. A cost table turns the counts into time.
+ *
+ * The fills and blits move whole words: at 16bpp a row that starts or ends
+ * between the two pixels of a word is moved from and to the word addresses
+ * around it, as the engine does. Such a blit lands one pixel off.
+ */
+#include <rtthread.h>
+#include "nu_2d.h"
+#include "mmu.h"
+
+#include "ge2d_model.h"
+
+/*
+ * Cost table of the N9H30 at 300 MHz with DDR, estimated: an operation
+ * starts with ge2dInit() and the registers and ends with the interrupt, the
+ * engine moves the bytes at the DDR rate. A cache line maintained by address
+ * includes the write back of a dirty line, the whole cache goes by index.
+ */
+#define GE2D_MODEL_OP_NS        1500
+#define GE2D_MODEL_RD_PS_BYTE   2500
+#define GE2D_MODEL_WR_PS_BYTE   2500
+#define GE2D_MODEL_LINE_NS      40
+#define GE2D_MODEL_INDEX_NS     20
+
+/* The D-cache of the ARM926EJ-S in the N9H30 */
+#define GE2D_MODEL_DCACHE_SIZE  (16 * 1024)
+
+/* State of the engine, as drv_2dge.c keeps it */
+static struct
+{
+    int bpp;
+    int width;                  /* pitch of the destination in pixels */
+    uint8_t *dest;
+
+    int draw_mode;
+    uint32_t color_key;
+    uint32_t color_key_mask;
+
+    int alpha;
+    int ks;
+    int kd;
+
+    int clip;
+    int clip_x1, clip_y1;       /* clip_x2 and clip_y2 exclusive */
+    int clip_x2, clip_y2;
+} s_ge2d = { .bpp = 16 };
+
+static ge2d_model_stat_t s_stat;
+
+static const char *s_op_names[GE2D_MODEL_OP_NUM] = { "fill", "blit", "blit_alpha", "expand" };
+
+void ge2d_model_reset(void)
+{
+    memset(&s_stat, 0, sizeof(s_stat));
+}
+
+void ge2d_model_get(ge2d_model_stat_t *stat)
+{
+    *stat = s_stat;
+}
+
+const char *ge2d_model_op_name(ge2d_model_op_e op)
+{
+    return s_op_names[op];
+}
+
+static void ge2d_model_account(ge2d_model_op_e op, uint64_t px, uint64_t rd_bytes, uint64_t wr_bytes)
+{
+    s_stat.ops[op]++;
+    s_stat.px[op] += px;
+    s_stat.rd_bytes += rd_bytes;
+    s_stat.wr_bytes += wr_bytes;
+    s_stat.ge2d_ns += GE2D_MODEL_OP_NS + (rd_bytes * GE2D_MODEL_RD_PS_BYTE + wr_bytes * GE2D_MODEL_WR_PS_BYTE) / 1000;
+}
+
+static uint32_t ge2d_model_make_color(int color)
+{
+    if (s_ge2d.bpp == 16)
+        return ((color & 0x00f80000) >> 8) | ((color & 0x0000fc00) >> 5) | ((color & 0x000000f8) >> 3);
+
+    return (uint32_t)color;
+}
+
+static void ge2d_model_put_px(int x, int y, uint32_t color)
+{
+    if (s_ge2d.bpp == 16)
+        ((uint16_t *)s_ge2d.dest)[y * s_ge2d.width + x] = (uint16_t)color;
+    else
+        ((uint32_t *)s_ge2d.dest)[y * s_ge2d.width + x] = color;
+}
+
+static uint32_t ge2d_model_get_at(const uint8_t *p)
+{
+    return (s_ge2d.bpp == 16) ? *(const uint16_t *)p : *(const uint32_t *)p;
+}
+
+static void ge2d_model_put_at(uint8_t *p, uint32_t color)
+{
+    if (s_ge2d.bpp == 16)
+        *(uint16_t *)p = (uint16_t)color;
+    else
+        *(uint32_t *)p = color;
+}
+
+/*
+ * The word addresses the engine moves for a row of n pixels at dst (and src),
+ * the pixel count grows to the end of the last word. Returns 1 when the row
+ * was off the word grid.
+ */
+static int ge2d_model_row(uint8_t **dst, const uint8_t **src, int *n)
+{
+    uintptr_t start = (uintptr_t)*dst, end = start + (uintptr_t)*n * (s_ge2d.bpp / 8);
+    int off = (start & 3) || (end & 3);
+
+    if (src)
+    {
+        off |= ((uintptr_t)*src & 3) != 0;
+        *src = (const uint8_t *)((uintptr_t)*src & ~(uintptr_t)3);
+    }
+    start &= ~(uintptr_t)3;
+    end = (end + 3) & ~(uintptr_t)3;
+    *dst = (uint8_t *)start;
+    *n = (int)((end - start) / (s_ge2d.bpp / 8));
+
+    return off;
+}
+
+/*
+ * The rectangle inside the clipper, false if it is empty. The engine does not
+ * clip to the size given to ge2dInit(), the callers pass the height of the
+ * drawn area there and start below it.
+ */
+static int ge2d_model_clip(int *x1, int *y1, int *x2, int *y2)
+{
+    if (s_ge2d.clip)
+    {
+        *x1 = (*x1 > s_ge2d.clip_x1) ? *x1 : s_ge2d.clip_x1;
+        *y1 = (*y1 > s_ge2d.clip_y1) ? *y1 : s_ge2d.clip_y1;
+        *x2 = (*x2 < s_ge2d.clip_x2) ? *x2 : s_ge2d.clip_x2;
+        *y2 = (*y2 < s_ge2d.clip_y2) ? *y2 : s_ge2d.clip_y2;
+    }
+
+    return (*x1 < *x2) && (*y1 < *y2);
+}
+
+/* (src * Ks + dst * Kd) / 255 on every channel */
+/*
+ * Ks * src + Kd * dst of a pixel with Ks + Kd = 255. The rounding of the
+ * engine is not documented, the model rounds as lv_color_mix() so that the
+ * frames match the software rendering pixel for pixel.
+ */
+static uint32_t ge2d_model_blend(uint32_t src, uint32_t dst)
+{
+    uint32_t out = 0;
+    int i;
+
+    if (s_ge2d.bpp == 16)
+    {
+        uint32_t mix = ((uint32_t)s_ge2d.ks + 4) >> 3;
+        uint32_t bg = (dst | (dst << 16)) & 0x7E0F81F;
+        uint32_t fg = (src | (src << 16)) & 0x7E0F81F;
+
+        out = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+
+        return (out >> 16 | out) & 0xFFFF;
+    }
+
+    for (i = 0; i < 24; i += 8)
+    {
+        uint32_t c = ((src >> i) & 0xFF) * s_ge2d.ks + ((dst >> i) & 0xFF) * (255 - s_ge2d.ks);
+
+        out |= ((c * 0x8081U) >> 0x17) << i;
+    }
+
+    return out | 0xFF000000;
+}
+
+void ge2dInit(int bpp, int width, int height, void *destination)
+{
+    if (destination == NULL)
+        return;
+
+    s_ge2d.bpp = bpp;
+    s_ge2d.width = width;
+    (void)height;
+    s_ge2d.dest = destination;
+
+    /* ge2dInit() turns the colour key on, the clipper and the alpha mode stay */
+    s_ge2d.draw_mode = MODE_TRANSPARENT;
+    s_ge2d.color_key = COLOR_KEY;
+    s_ge2d.color_key_mask = 0xFFFFFF;
+}
+
+void ge2dBitblt_SetDrawMode(int opt, int ckey, int mask)
+{
+    if ((opt == MODE_TRANSPARENT) || (opt == MODE_DEST_TRANSPARENT))
+    {
+        s_ge2d.draw_mode = opt;
+        s_ge2d.color_key = ge2d_model_make_color(ckey);
+        s_ge2d.color_key_mask = ge2d_model_make_color(mask);
+    }
+    else
+    {
+        s_ge2d.draw_mode = MODE_OPAQUE;
+    }
+}
+
+int ge2dBitblt_SetAlphaMode(int opt, int ks, int kd)
+{
+    if (ks + kd > 255)
+        return -1;
+
+    s_ge2d.alpha = (opt == 1);
+    s_ge2d.ks = ks;
+    s_ge2d.kd = kd;
+
+    return 0;
+}
+
+void ge2dClip_SetClip(int x1, int y1, int x2, int y2)
+{
+    /* The hardware clipper excludes the last pixel and needs at least 2x2 */
+    s_ge2d.clip = (x1 >= 0) && (y1 >= 0) && (x2 > x1) && (y2 > y1);
+    s_ge2d.clip_x1 = x1;
+    s_ge2d.clip_y1 = y1;
+    s_ge2d.clip_x2 = x2 + 1;
+    s_ge2d.clip_y2 = y2 + 1;
+}
+
+static void ge2d_model_fill(int dx, int dy, int width, int height, uint32_t color)
+{
+    uint32_t bytes_px = s_ge2d.bpp / 8;
+    int x1 = dx, y1 = dy, x2 = dx + width, y2 = dy + height;
+    int i, n, y, off = 0;
+
+    if (!ge2d_model_clip(&x1, &y1, &x2, &y2))
+    {
+        ge2d_model_account(GE2D_MODEL_FILL, 0, 0, 0);
+        return;
+    }
+
+    for (y = y1; y < y2; y++)
+    {
+        uint8_t *row = s_ge2d.dest + ((size_t)y * s_ge2d.width + x1) * bytes_px;
+
+        n = x2 - x1;
+        off |= ge2d_model_row(&row, RT_NULL, &n);
+        for (i = 0; i < n; i++)
+            ge2d_model_put_at(row + i * bytes_px, color);
+    }
+    s_stat.misaligned += off;
+
+    ge2d_model_account(GE2D_MODEL_FILL, (uint64_t)(x2 - x1) * (y2 - y1), 0,
+                       (uint64_t)(x2 - x1) * (y2 - y1) * (s_ge2d.bpp / 8));
+}
+
+void ge2dFill_Solid(int dx, int dy, int width, int height, int color)
+{
+    ge2d_model_fill(dx, dy, width, height, ge2d_model_make_color(color));
+}
+
+void ge2dFill_Solid_RGB565(int dx, int dy, int width, int height, int color)
+{
+    ge2d_model_fill(dx, dy, width, height, (uint32_t)color & 0xffff);
+}
+
+void ge2dSpriteBltx_Screen(int x, int y, int sprite_sx, int sprite_sy, int width, int height, int sprite_width, int sprite_height, void *buf)
+{
+    ge2d_model_op_e op = s_ge2d.alpha ? GE2D_MODEL_BLIT_ALPHA : GE2D_MODEL_BLIT;
+    int x1 = x, y1 = y, x2 = x + width, y2 = y + height;
+    uint32_t bytes_px = s_ge2d.bpp / 8;
+    uint64_t px;
+    int i, n, dy, off = 0;
+
+    (void)sprite_height;
+
+    if (!ge2d_model_clip(&x1, &y1, &x2, &y2))
+    {
+        ge2d_model_account(op, 0, 0, 0);
+        return;
+    }
+
+    for (dy = y1; dy < y2; dy++)
+    {
+        uint8_t *row = s_ge2d.dest + ((size_t)dy * s_ge2d.width + x1) * bytes_px;
+        const uint8_t *src_row = (const uint8_t *)buf +
+                                 ((size_t)(sprite_sy + dy - y) * sprite_width + sprite_sx + x1 - x) * bytes_px;
+
+        n = x2 - x1;
+        off |= ge2d_model_row(&row, &src_row, &n);
+        for (i = 0; i < n; i++)
+        {
+            uint32_t src = ge2d_model_get_at(src_row + i * bytes_px);
+
+            if ((s_ge2d.draw_mode == MODE_TRANSPARENT) &&
+                    ((src & s_ge2d.color_key_mask) == (s_ge2d.color_key & s_ge2d.color_key_mask)))
+                continue;
+
+            if (s_ge2d.alpha)
+                src = ge2d_model_blend(src, ge2d_model_get_at(row + i * bytes_px));
+
+            ge2d_model_put_at(row + i * bytes_px, src);
+        }
+    }
+    s_stat.misaligned += off;
+
+    px = (uint64_t)(x2 - x1) * (y2 - y1);
+    ge2d_model_account(op, px, px * bytes_px * (s_ge2d.alpha ? 2 : 1), px * bytes_px);
+}
+
+void ge2dColorExpansionBlt(int x, int y, int width, int height, int fore_color, int back_color, int opt, void *buf)
+{
+    const uint8_t *bits = buf;
+    uint32_t fore = ge2d_model_make_color(fore_color);
+    uint32_t back = ge2d_model_make_color(back_color);
+    int x1 = x, y1 = y, x2 = x + width, y2 = y + height;
+    uint64_t written = 0;
+    int dx, dy;
+
+    if (!ge2d_model_clip(&x1, &y1, &x2, &y2))
+    {
+        ge2d_model_account(GE2D_MODEL_EXPAND, 0, 0, 0);
+        return;
+    }
+
+    /* Rows of width bits, the first pixel in the most significant bit */
+    for (dy = y1; dy < y2; dy++)
+    {
+        const uint8_t *row = bits + (dy - y) * (width / 8);
+
+        for (dx = x1; dx < x2; dx++)
+        {
+            int bit = dx - x;
+
+            if (row[bit >> 3] & (0x80 >> (bit & 0x7)))
+                ge2d_model_put_px(dx, dy, fore);
+            else if (opt == MODE_TRANSPARENT)
+                continue;
+            else
+                ge2d_model_put_px(dx, dy, back);
+            written++;
+        }
+    }
+
+    ge2d_model_account(GE2D_MODEL_EXPAND, written, (uint64_t)(y2 - y1) * (width / 8),
+                       written * (s_ge2d.bpp / 8));
+}
+
+/* D-cache: only the time of the maintenance, the host memory is coherent */
+
+rt_uint32_t mmu_dcache_size(void)
+{
+    return GE2D_MODEL_DCACHE_SIZE;
+}
+
+static void ge2d_model_cache_range(rt_uint32_t buffer, rt_uint32_t size)
+{
+    uint32_t lines;
+
+    if (size == 0)
+        return;
+
+    lines = ((buffer % CACHE_LINE_SIZE) + size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE;
+    s_stat.cache_lines += lines;
+    s_stat.cache_ns += (uint64_t)lines * GE2D_MODEL_LINE_NS;
+}
+
+static void ge2d_model_cache_all(void)
+{
+    s_stat.cache_all++;
+    s_stat.cache_ns += (uint64_t)(GE2D_MODEL_DCACHE_SIZE / CACHE_LINE_SIZE) * GE2D_MODEL_INDEX_NS;
+}
+
+void mmu_clean_invalidated_dcache(rt_uint32_t buffer, rt_uint32_t size)
+{
+    ge2d_model_cache_range(buffer, size);
+}
+
+void mmu_clean_dcache(rt_uint32_t buffer, rt_uint32_t size)
+{
+    ge2d_model_cache_range(buffer, size);
+}
+
+void mmu_invalidate_dcache(rt_uint32_t buffer, rt_uint32_t size)
+{
+    ge2d_model_cache_range(buffer, size);
+}
+
+void mmu_clean_dcache_all(void)
+{
+    ge2d_model_cache_all();
+}
+
+void mmu_clean_invalidated_dcache_all(void)
+{
+    ge2d_model_cache_all();
+}
+
+/* The rows of a rectangle, or the whole cache when they are more than it holds, as in mmu.c */
+static void ge2d_model_cache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height)
+{
+    rt_uint32_t row_lines;
+
+    if ((width == 0) || (height == 0))
+        return;
+
+    if (width + CACHE_LINE_SIZE >= stride)
+    {
+        width = stride * (height - 1) + width;
+        height = 1;
+    }
+
+    row_lines = ((buffer % CACHE_LINE_SIZE) + width + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE;
+    if (row_lines * CACHE_LINE_SIZE * height > mmu_dcache_size())
+    {
+        ge2d_model_cache_all();
+        return;
+    }
+
+    for (; height > 0; height--)
+    {
+        ge2d_model_cache_range(buffer, width);
+        buffer += stride;
+    }
+}
+
+void mmu_clean_dcache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height)
+{
+    ge2d_model_cache_rect(buffer, stride, width, height);
+}
+
+void mmu_clean_invalidated_dcache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height)
+{
+    ge2d_model_cache_rect(buffer, stride, width, height);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef __GE2D_MODEL_H__
+#define __GE2D_MODEL_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    GE2D_MODEL_FILL = 0,        /* ge2dFill_Solid*() */
+    GE2D_MODEL_BLIT,            /* ge2dSpriteBltx_Screen() */
+    GE2D_MODEL_BLIT_ALPHA,      /* ge2dSpriteBltx_Screen() with the alpha mode on */
+    GE2D_MODEL_EXPAND,          /* ge2dColorExpansionBlt() */
+    GE2D_MODEL_OP_NUM
+} ge2d_model_op_e;
+
+/* The engine and the D-cache since the last reset */
+typedef struct
+{
+    uint32_t ops[GE2D_MODEL_OP_NUM];
+    uint64_t px[GE2D_MODEL_OP_NUM];     /* pixels written inside the clipper */
+    uint64_t rd_bytes;                  /* read by the engine */
+    uint64_t wr_bytes;                  /* written by the engine */
+    uint64_t cache_lines;               /* lines maintained by address */
+    uint32_t cache_all;                 /* maintenances of the whole cache by index */
+    uint64_t ge2d_ns;                   /* engine time by the cost table */
+    uint64_t cache_ns;                  /* cache maintenance time by the cost table */
+    uint32_t misaligned;                /* fills and blits with a row off the word grid */
+} ge2d_model_stat_t;
+
+void ge2d_model_reset(void);
+
+void ge2d_model_get(ge2d_model_stat_t *stat);
+
+const char *ge2d_model_op_name(ge2d_model_op_e op);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GE2D_MODEL_H__ */
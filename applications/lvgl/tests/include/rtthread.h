@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * Host stand-in of <rtthread.h> for the GE2D test: the part of the kernel
+ * API used by LVGL (lv_rt_thread_conf.h), the N9H30 draw context and the
+ * coverage demo, on top of the C library. The tick is the clock of the
+ * test, it runs only when the test moves it.
+ */
+#ifndef __RT_THREAD_H__
+#define __RT_THREAD_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <rtconfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int8_t      rt_int8_t;
+typedef int16_t     rt_int16_t;
+typedef int32_t     rt_int32_t;
+typedef uint8_t     rt_uint8_t;
+typedef uint16_t    rt_uint16_t;
+typedef uint32_t    rt_uint32_t;
+typedef long        rt_base_t;
+typedef rt_base_t   rt_err_t;
+typedef rt_uint32_t rt_tick_t;
+typedef size_t      rt_size_t;
+typedef int         rt_bool_t;
+
+#define RT_NULL             0
+#define RT_TRUE             1
+#define RT_FALSE            0
+
+#define RT_EOK              0
+#define RT_ERROR            1
+#define RT_ETIMEOUT         2
+#define RT_ENOMEM           5
+#define RT_EINVAL           10
+
+#define RT_UINT32_MAX       UINT32_MAX
+
+#undef RT_TICK_PER_SECOND
+#define RT_TICK_PER_SECOND  1000
+
+#define rt_align(n)         __attribute__((aligned(n)))
+#define RT_WEAK             __attribute__((weak))
+
+#define RT_ASSERT(EX)                                                           \
+    do                                                                          \
+    {                                                                           \
+        if (!(EX))                                                              \
+        {                                                                       \
+            fprintf(stderr, "(%s) assertion failed at %s:%d\n", #EX, __func__, __LINE__); \
+            abort();                                                            \
+        }                                                                       \
+    } while (0)
+
+/* msh is not there, the command stays referenced */
+#define MSH_CMD_EXPORT(command, desc)   \
+    static void *const __msh_##command __attribute__((unused)) = (void *)command
+
+#define rt_kprintf          printf
+#define rt_snprintf         snprintf
+#define rt_vsnprintf        vsnprintf
+#define rt_strcmp           strcmp
+#define rt_strlen           strlen
+#define rt_memset           memset
+#define rt_memcpy           memcpy
+#define rt_memcmp           memcmp
+#define rt_malloc           malloc
+#define rt_realloc          realloc
+#define rt_free             free
+
+static inline void *rt_malloc_align(rt_size_t size, rt_size_t align)
+{
+    return aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+static inline void rt_free_align(void *ptr)
+{
+    free(ptr);
+}
+
+/* One thread: the lock is always free */
+typedef struct rt_mutex *rt_mutex_t;
+
+#define RT_WAITING_FOREVER  -1
+#define RT_IPC_FLAG_PRIO    1
+
+static inline rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag)
+{
+    static int lock;
+
+    (void)name;
+    (void)flag;
+    return (rt_mutex_t)&lock;
+}
+
+static inline rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    (void)mutex;
+    (void)time;
+    return RT_EOK;
+}
+
+static inline rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    (void)mutex;
+    return RT_EOK;
+}
+
+/* The clock of the test, in ms */
+rt_tick_t rt_tick_get(void);
+void rt_thread_mdelay(rt_int32_t ms);
+
+static inline rt_tick_t rt_tick_get_millisecond(void)
+{
+    return rt_tick_get();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RT_THREAD_H__ */
@@ -47,6 +47,13 @@
     #define MOUNT_POINT_SPIFLASH0 "/mnt/"PARTITION_NAME_FILESYSTEM
 #endif
 
+#if defined(RT_MTD_NAND_USING_FTL) && !defined(PKG_USING_DFS_YAFFS)
+    #include <rtdevice.h>
+    #define NAND_FTL_MTD_NAME     "nand1"
+    #define NAND_FTL_NAME         "ftl0"
+    #define MOUNT_POINT_FMINAND   "/mnt/fminand"
+#endif
+
 #ifdef RT_USING_DFS_MNTTABLE
 
 /*
@@ -275,6 +282,28 @@ int filesystem_init(void)
     }
 #endif
 
+#if defined(NAND_FTL_NAME)
+    {
+        /* FAT on the NAND flash translation layer */
+        if (!rt_mtd_nand_ftl_create(NAND_FTL_MTD_NAME, NAND_FTL_NAME))
+        {
+            LOG_E("Failed to create FTL on %s", NAND_FTL_MTD_NAME);
+            goto exit_filesystem_init;
+        }
+
+        if (dfs_mount(NAND_FTL_NAME, MOUNT_POINT_FMINAND, "elm", 0, RT_NULL) != 0)
+        {
+            rt_kprintf("Format %s for the first use.\n", NAND_FTL_NAME);
+            if (dfs_mkfs("elm", NAND_FTL_NAME) != 0 ||
+                    dfs_mount(NAND_FTL_NAME, MOUNT_POINT_FMINAND, "elm", 0, RT_NULL) != 0)
+            {
+                LOG_E("Failed to mount NAND FTL");
+                goto exit_filesystem_init;
+            }
+        }
+    }
+#endif
+
 exit_filesystem_init:
 
     return -result;
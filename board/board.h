@@ -7,6 +7,7 @@
 * Change Logs:
 * Date            Author       Notes
 * 2020-1-16       Wayne        First version
+* 2026-10-19      RT-Thread    Carve the LVGL memory pool off the heap end
 *
 ******************************************************************************/
 
@@ -27,7 +28,16 @@
 #define BOARD_SDRAM_START      0x0
 #define BOARD_SDRAM_SIZE       0x04000000
 #define BOARD_SDRAM_NCNB_SIZE  0x200000
-#define BOARD_HEAP_END         ((void*)(BOARD_SDRAM_SIZE-BOARD_SDRAM_NCNB_SIZE))
+
+/* LVGL memory pool, between the heap (and the VPOST frame buffers in it) and the non-cacheable DDR */
+#if defined(BSP_USING_LVGL_MEMPOOL)
+    #define BOARD_LVGL_POOL_SIZE   (BSP_LVGL_MEMPOOL_SIZE * 1024)
+#else
+    #define BOARD_LVGL_POOL_SIZE   0
+#endif
+#define BOARD_LVGL_POOL_START  ((void*)(BOARD_SDRAM_SIZE-BOARD_SDRAM_NCNB_SIZE-BOARD_LVGL_POOL_SIZE))
+
+#define BOARD_HEAP_END         BOARD_LVGL_POOL_START
 
 #if defined(RT_USING_MTD_NAND)
     #include <drivers/mtd_nand.h>
@@ -147,6 +147,123 @@ static int rt_hw_spiflash_init(void)
     return 0;
 }
 INIT_COMPONENT_EXPORT(rt_hw_spiflash_init);
+
+#if defined(RT_USING_SFUD) && defined(RT_USING_FINSH) && defined(SFUD_USING_QSPI)
+#include <stdlib.h>
+
+#define QSPI_BENCH_CHUNK_MAX    (64 * 1024)
+
+static int qspi_bench_mode(sfud_flash_t flash, int lines, rt_bool_t burst, rt_bool_t continuous)
+{
+    if (nu_qspi_set_burst("qspi0", burst) != RT_EOK)
+        return -1;
+
+    /* leave continuous read before changing the read instruction */
+    if (sfud_qspi_continuous_read_enable(flash, RT_FALSE) != SFUD_SUCCESS)
+        return -1;
+
+    if (sfud_qspi_fast_read_enable(flash, lines) != SFUD_SUCCESS)
+        return -1;
+
+    if (continuous && sfud_qspi_continuous_read_enable(flash, RT_TRUE) != SFUD_SUCCESS)
+        return -1;
+
+    return 0;
+}
+
+static void qspi_bench(int argc, char *argv[])
+{
+    static const struct
+    {
+        const char *name;
+        int lines;
+        rt_bool_t burst;
+        rt_bool_t continuous;
+    } modes[] =
+    {
+        { "single",      1, RT_FALSE, RT_FALSE },
+        { "quad",        4, RT_FALSE, RT_FALSE },
+        { "quad+burst",  4, RT_TRUE,  RT_FALSE },
+        { "quad+cont",   4, RT_TRUE,  RT_TRUE  },
+    };
+    sfud_flash_t flash;
+    rt_uint8_t *buf;
+    rt_uint32_t addr = 0, total = 1024 * 1024, chunk = 4096;
+    rt_uint32_t i, off, len;
+    rt_tick_t tick;
+
+    if (argc > 1)
+        total = strtoul(argv[1], RT_NULL, 0);
+    if (argc > 2)
+        chunk = strtoul(argv[2], RT_NULL, 0);
+    if (argc > 3)
+        addr = strtoul(argv[3], RT_NULL, 0);
+
+    if (total == 0 || chunk == 0 || chunk > QSPI_BENCH_CHUNK_MAX)
+    {
+        rt_kprintf("Usage: qspi_bench [total bytes] [chunk bytes(<=%d)] [address]\n", QSPI_BENCH_CHUNK_MAX);
+        return;
+    }
+
+    flash = rt_sfud_flash_find_by_dev_name(FAL_USING_NOR_FLASH_DEV_NAME);
+    if (flash == RT_NULL)
+    {
+        rt_kprintf("%s not found.\n", FAL_USING_NOR_FLASH_DEV_NAME);
+        return;
+    }
+
+    if (addr + total > flash->chip.capacity)
+    {
+        rt_kprintf("Out of flash range.\n");
+        return;
+    }
+
+    buf = rt_malloc(chunk);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("No memory.\n");
+        return;
+    }
+
+    rt_kprintf("%-12s %10s %10s\n", "mode", "ms", "KB/s");
+    for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        if (qspi_bench_mode(flash, modes[i].lines, modes[i].burst, modes[i].continuous) < 0)
+        {
+            rt_kprintf("%-12s not supported\n", modes[i].name);
+            continue;
+        }
+
+        tick = rt_tick_get();
+        for (off = 0; off < total; off += len)
+        {
+            len = (total - off > chunk) ? chunk : total - off;
+            if (sfud_read(flash, addr + off, len, buf) != SFUD_SUCCESS)
+                break;
+        }
+        tick = rt_tick_get() - tick;
+
+        if (off < total)
+        {
+            rt_kprintf("%-12s read failed at 0x%08x\n", modes[i].name, addr + off);
+            continue;
+        }
+        if (tick == 0)
+            tick = 1;
+
+        rt_kprintf("%-12s %10d %10d\n", modes[i].name,
+                   tick * 1000 / RT_TICK_PER_SECOND,
+                   (rt_uint32_t)((rt_uint64_t)total * RT_TICK_PER_SECOND / 1024 / tick));
+    }
+
+    /* back to the probe default, the flash must not stay in continuous read mode */
+    qspi_bench_mode(flash, 4, RT_TRUE, RT_FALSE);
+
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(qspi_bench, compare SPI NOR read throughput of single/quad/burst/continuous read);
+#endif
+
 #endif /* BOARD_USING_STORAGE_SPIFLASH */
 
 #if defined(RT_USING_MTD_NAND) && defined(BSP_USING_FMINAND)
@@ -17,6 +17,13 @@
 #include <board.h>
 
 /* ===================== Flash device Configuration ========================= */
+#if defined(FAL_USING_FILE_PORT)
+extern struct fal_flash_dev file_flash0;
+#define FAL_FILE_FLASH_DEV      &file_flash0,
+#else
+#define FAL_FILE_FLASH_DEV
+#endif
+
 #if defined(RT_USING_SFUD)
 extern struct fal_flash_dev nor_flash0;
 
@@ -24,6 +31,12 @@ extern struct fal_flash_dev nor_flash0;
 #define FAL_FLASH_DEV_TABLE                                                    \
 {                                                                              \
     &nor_flash0,                                                               \
+    FAL_FILE_FLASH_DEV                                                         \
+}
+#elif defined(FAL_USING_FILE_PORT)
+#define FAL_FLASH_DEV_TABLE                                                    \
+{                                                                              \
+    FAL_FILE_FLASH_DEV                                                         \
 }
 #else
 #define FAL_FLASH_DEV_TABLE                                                    \
@@ -35,11 +48,20 @@ extern struct fal_flash_dev nor_flash0;
 /* ====================== Partition Configuration ============================ */
 #ifdef FAL_PART_HAS_TABLE_CFG
 
+#if defined(FAL_USING_FILE_PORT)
+#define FAL_FILE_PART_TABLE                                                    \
+    {FAL_PART_MAGIC_WORD, "kvsim",      FAL_FILE_PORT_DEV_NAME,                 0, FAL_FILE_PORT_SIZE, 0},
+#else
+#define FAL_FILE_PART_TABLE
+#endif
+
 /* partition table------------------------------------------------------------ */
 #define FAL_PART_TABLE                                                         \
 {                                                                              \
     {FAL_PART_MAGIC_WORD, "rtthread",   FAL_USING_NOR_FLASH_DEV_NAME,           0,  4*1024*1024, 0}, \
     {FAL_PART_MAGIC_WORD, "filesystem", FAL_USING_NOR_FLASH_DEV_NAME, 4*1024*1024, 12*1024*1024, 0}, \
+    {FAL_PART_MAGIC_WORD, "kvdb",       FAL_USING_NOR_FLASH_DEV_NAME, 16*1024*1024, 1*1024*1024, 0}, \
+    FAL_FILE_PART_TABLE                                                        \
 }
 #endif /* FAL_PART_HAS_TABLE_CFG */
 
@@ -7,6 +7,9 @@
 * Change Logs:
 * Date            Author           Notes
 * 2020-12-12      Wayne            First version
+* 2026-10-19      RT-Thread        Declare the checksum capability
+* 2026-10-19      RT-Thread        Make the lwiperf example selectable
+* 2026-10-19      RT-Thread        Set the MAC address for bonding, faster link poll
 *
 ******************************************************************************/
 
@@ -40,6 +43,13 @@
 
 #define NU_EMAC_TID_STACK_SIZE  1024
 
+/* A bond fails over when the link monitor sees the link down. */
+#if defined(RT_LWIP_USING_BOND)
+    #define NU_EMAC_LINK_POLL_TICKS  (RT_TICK_PER_SECOND / 10)
+#else
+    #define NU_EMAC_LINK_POLL_TICKS  RT_TICK_PER_SECOND
+#endif
+
 /* Private typedef --------------------------------------------------------------*/
 struct nu_emac_lwip_pbuf
 {
@@ -280,7 +290,7 @@ static void link_monitor(void *param)
 
         } /* if ( LinkStatus_Last != LinkStatus_Current ) */
 
-        rt_thread_delay(RT_TICK_PER_SECOND);
+        rt_thread_delay(NU_EMAC_LINK_POLL_TICKS);
 
     } /* while(1) */
 
@@ -389,6 +399,7 @@ static rt_err_t nu_emac_control(rt_device_t dev, int cmd, void *args)
 
         break;
 
+    case NIOCTL_SADDR:
     case NIOCTL_PRIV_CHANGE_MAC:
     {
         uint8_t *pu8MacAddr = (uint8_t *)args;
@@ -640,6 +651,10 @@ static int rt_hw_nu_emac_init(void)
         psNuEMAC->eth.eth_rx            = nu_emac_rx;
         psNuEMAC->eth.eth_tx            = nu_emac_tx;
 
+        /* The EMAC only checks the CRC and drops bad frames, the IP, TCP,
+           UDP and ICMP checksums stay in software on this interface. */
+        psNuEMAC->eth.hw_checksum       = 0;
+
         snprintf(szTmp, sizeof(szTmp), "%s_tx", psNuEMAC->name);
         rt_hw_interrupt_install(psNuEMAC->irqn_tx, nu_emac_tx_isr, (void *)psNuEMAC, szTmp);
         rt_hw_interrupt_umask(psNuEMAC->irqn_tx);
@@ -667,11 +682,19 @@ int nu_emac_assign_mac_addr(EMAC_IDX evIdx, uint8_t *pu8MacAddr)
     return 0;
 }
 
-#if 0
+#if defined(BSP_USING_EMAC_LWIPERF)
 /*
-    Remeber src += lwipiperf_SRCS in components\net\lwip\lwip-*\SConscript
+    iperf 2 over the raw API of lwIP, the result of each run is printed with
+    the TCP profile it ran with. See "Network throughput" in README.md.
 */
 #include "lwip/apps/lwiperf.h"
+#include "lwip/tcpip.h"
+
+#if defined(RT_LWIP_USING_HIGH_THROUGHPUT)
+    #define NU_LWIPERF_PROFILE  "high-throughput"
+#else
+    #define NU_LWIPERF_PROFILE  "default"
+#endif
 
 static void
 lwiperf_report(void *arg, enum lwiperf_report_type report_type,
@@ -684,16 +707,66 @@ lwiperf_report(void *arg, enum lwiperf_report_type report_type,
 
     NU_EMAC_TRACE("IPERF report: type=%d, remote: %s:%d, total bytes: %"U32_F", duration in ms: %"U32_F", kbits/s: %"U32_F"\n",
                   (int)report_type, ipaddr_ntoa(remote_addr), (int)remote_port, bytes_transferred, ms_duration, bandwidth_kbitpsec);
+    NU_EMAC_TRACE("IPERF profile: %s, TCP_WND: %d, TCP_SND_BUF: %d, PBUF_POOL_SIZE: %d\n",
+                  NU_LWIPERF_PROFILE, (int)TCP_WND, (int)TCP_SND_BUF, (int)PBUF_POOL_SIZE);
+}
+
+/* the raw API runs in the tcpip thread */
+static void lwiperf_start(void *ctx)
+{
+    ip_addr_t *remote_addr = (ip_addr_t *)ctx;
+
+    if (remote_addr == RT_NULL)
+    {
+        if (lwiperf_start_tcp_server_default(lwiperf_report, NULL) == NULL)
+            NU_EMAC_TRACE("IPERF: failed to start the server\n");
+    }
+    else
+    {
+        if (lwiperf_start_tcp_client_default(remote_addr, lwiperf_report, NULL) == NULL)
+            NU_EMAC_TRACE("IPERF: failed to connect %s\n", ipaddr_ntoa(remote_addr));
+        rt_free(remote_addr);
+    }
 }
 
 int lwiperf_example_init(void)
 {
-    lwiperf_start_tcp_server_default(lwiperf_report, NULL);
+    return (tcpip_callback(lwiperf_start, RT_NULL) == ERR_OK) ? 0 : -1;
+}
+INIT_APP_EXPORT(lwiperf_example_init);
+
+/* lwiperf <host>: send to "iperf -s" on the host for 10 seconds */
+static int lwiperf(int argc, char **argv)
+{
+    ip_addr_t *remote_addr;
+
+    if (argc != 2)
+    {
+        rt_kprintf("Usage: lwiperf <host running iperf -s>\n");
+        rt_kprintf("The server for \"iperf -c <board>\" listens on port %d.\n", LWIPERF_TCP_PORT_DEFAULT);
+        return -1;
+    }
+
+    remote_addr = (ip_addr_t *)rt_malloc(sizeof(ip_addr_t));
+    if (remote_addr == RT_NULL)
+        return -RT_ENOMEM;
+
+    if (!ipaddr_aton(argv[1], remote_addr))
+    {
+        rt_kprintf("Invalid address: %s\n", argv[1]);
+        rt_free(remote_addr);
+        return -1;
+    }
+
+    if (tcpip_callback(lwiperf_start, remote_addr) != ERR_OK)
+    {
+        rt_free(remote_addr);
+        return -1;
+    }
 
     return 0;
 }
-INIT_APP_EXPORT(lwiperf_example_init);
-MSH_CMD_EXPORT(lwiperf_example_init, start lwip tcp server);
-#endif
+MSH_CMD_EXPORT(lwiperf, run an iperf 2 client to a host);
+#endif /* BSP_USING_EMAC_LWIPERF */
 
 #endif /* #if defined( BSP_USING_EMAC ) && defined( RT_USING_LWIP )*/
@@ -35,6 +35,15 @@
 /* fsclk = fpclk / ((div+1)*2), but div=1 is suggested. */
 #define DEF_SPI_MAX_SPEED  (SPI_INPUT_CLOCK/((1)*2))
 
+/* TX0~TX3 are shifted by one trigger. */
+#define DEF_SPI_FIFO_NUM   4
+
+/* Byte-wise data stages longer than this are moved in 32-bit words. */
+#define DEF_SPI_BURST_MIN  (DEF_SPI_FIFO_NUM * sizeof(uint32_t))
+
+/* 0 in TX_BIT_LEN field means 32-bit. */
+#define NU_SPI_BITLEN(width)   ((width) & 0x1f)
+
 enum
 {
     QSPI_START = -1,
@@ -57,6 +66,7 @@ struct nu_qspi
     E_SYS_IPRST rstidx;
     E_SYS_IPCLK clkidx;
     uint32_t dummy;
+    rt_bool_t burst;
 
     struct rt_qspi_configuration  configuration;
 };
@@ -86,6 +96,7 @@ static struct nu_qspi nu_qspi_arr [] =
         .idx = 0,
         .rstidx = SPI0RST,
         .clkidx = SPI0CKEN,
+        .burst = RT_TRUE,
     },
 #endif
 #if defined(BSP_USING_QSPI1)
@@ -94,6 +105,7 @@ static struct nu_qspi nu_qspi_arr [] =
         .idx = 1,
         .rstidx = SPI1RST,
         .clkidx = SPI1CKEN,
+        .burst = RT_TRUE,
     },
 #endif
 }; /* nu_qspi */
@@ -150,7 +162,7 @@ static rt_err_t nu_qspi_bus_configure(struct rt_spi_device *device,
         spiIoctl(qspi_bus->idx, SPI_IOC_SET_MODE, (uint32_t)u32SPIMode, 0);
 
         /* Set data width */
-        spiIoctl(qspi_bus->idx, SPI_IOC_SET_TX_BITLEN, (uint32_t)configuration->data_width, 0);
+        spiIoctl(qspi_bus->idx, SPI_IOC_SET_TX_BITLEN, NU_SPI_BITLEN(configuration->data_width), 0);
 
         /* Set speed */
         u32SPISpeed = configuration->max_hz;
@@ -303,9 +315,84 @@ static void nu_qspi_transmission_with_poll(struct nu_qspi *spi_bus,
     }
 }
 
+/**
+ * @brief SPI bus polling in 32-bit words
+ * @param dev : The pointer of the specified SPI module.
+ * @param send_addr : Source address
+ * @param recv_addr : Destination address
+ * @param length    : Data length, multiple of 4
+ * @note  A byte stream is packed into words, so each trigger moves 16 bytes instead of 4.
+ */
+static void nu_qspi_transmission_with_burst(struct nu_qspi *spi_bus,
+        uint8_t *send_addr, uint8_t *recv_addr, int length)
+{
+    uint32_t idx = spi_bus->idx;
+    int trans_num = length / sizeof(uint32_t);
+    rt_bool_t msb = (spi_bus->configuration.parent.mode & RT_SPI_MSB) ? RT_TRUE : RT_FALSE;
+
+    spiIoctl(idx, SPI_IOC_SET_TX_BITLEN, NU_SPI_BITLEN(32), 0);
+
+    while (trans_num > 0)
+    {
+        int i;
+
+        uint32_t u32TxNum = (trans_num > DEF_SPI_FIFO_NUM) ? DEF_SPI_FIFO_NUM : trans_num;
+
+        for (i = 0; i < u32TxNum; i++)
+        {
+            uint32_t u32Data = 0;
+
+            /* First byte on the wire goes to the first shifted bits of the word. */
+            if (send_addr != RT_NULL)
+            {
+                u32Data = msb ? nu_get32_be(send_addr) : nu_get32_le(send_addr);
+                send_addr += sizeof(uint32_t);
+            }
+            spiWrite(idx, i, u32Data);
+        }
+
+        spiIoctl(idx, SPI_IOC_SET_TX_NUM, u32TxNum - 1, 0);
+
+        spiIoctl(idx, SPI_IOC_TRIGGER, 0, 0);
+
+        while (spiGetBusyStatus(idx)) {};
+
+        if (recv_addr != RT_NULL)
+        {
+            for (i = 0; i < u32TxNum; i++)
+            {
+                if (msb)
+                    nu_set32_be(recv_addr, spiRead(idx, i));
+                else
+                    nu_set32_le(recv_addr, spiRead(idx, i));
+                recv_addr += sizeof(uint32_t);
+            }
+        }
+
+        trans_num -= u32TxNum;
+    }
+
+    /* Restore data width */
+    spiIoctl(idx, SPI_IOC_SET_TX_BITLEN, NU_SPI_BITLEN(spi_bus->configuration.parent.data_width), 0);
+}
+
 void nu_qspi_transfer(struct nu_qspi *spi_bus, uint8_t *tx, uint8_t *rx, int length, uint8_t bytes_per_word)
 {
     RT_ASSERT(spi_bus != RT_NULL);
+
+    if (spi_bus->burst && (bytes_per_word == 1) && (length >= DEF_SPI_BURST_MIN))
+    {
+        int burst_len = RT_ALIGN_DOWN(length, sizeof(uint32_t));
+
+        nu_qspi_transmission_with_burst(spi_bus, tx, rx, burst_len);
+
+        tx = (tx != RT_NULL) ? tx + burst_len : RT_NULL;
+        rx = (rx != RT_NULL) ? rx + burst_len : RT_NULL;
+        length -= burst_len;
+        if (length == 0)
+            return;
+    }
+
     nu_qspi_transmission_with_poll(spi_bus, tx, rx, length, bytes_per_word);
 }
 
@@ -425,8 +512,8 @@ static rt_uint32_t nu_qspi_bus_xfer(struct rt_spi_device *device, struct rt_spi_
                          1);
     }
 
-    /* alternate_bytes stage */
-    if ((qspi_message->alternate_bytes.size > 0) && (qspi_message->alternate_bytes.size <= 4))
+    /* alternate_bytes stage, size is in bits */
+    if ((qspi_message->alternate_bytes.size > 0) && (qspi_message->alternate_bytes.size <= 32))
     {
         rt_uint32_t u32AlternateByte = 0;
         rt_uint32_t u32NumOfByte = qspi_message->alternate_bytes.size / 8;
@@ -523,6 +610,18 @@ static int rt_hw_qspi_init(void)
 
 INIT_DEVICE_EXPORT(rt_hw_qspi_init);
 
+rt_err_t nu_qspi_set_burst(const char *bus_name, rt_bool_t enable)
+{
+    struct nu_qspi *spi_bus = (struct nu_qspi *)rt_device_find(bus_name);
+
+    if ((spi_bus == RT_NULL) || (spi_bus->dev.parent.type != RT_Device_Class_SPIBUS))
+        return -RT_ERROR;
+
+    spi_bus->burst = enable;
+
+    return RT_EOK;
+}
+
 rt_err_t nu_qspi_bus_attach_device(const char *bus_name, const char *device_name, rt_uint8_t data_line_width, void (*enter_qspi_mode)(), void (*exit_qspi_mode)())
 {
     struct rt_qspi_device *qspi_device = RT_NULL;
@@ -16,5 +16,6 @@
 #include <rtdevice.h>
 
 rt_err_t nu_qspi_bus_attach_device(const char *bus_name, const char *device_name, rt_uint8_t data_line_width, void (*enter_qspi_mode)(), void (*exit_qspi_mode)());
+rt_err_t nu_qspi_set_burst(const char *bus_name, rt_bool_t enable);
 
 #endif // __DRV_QSPI_H___
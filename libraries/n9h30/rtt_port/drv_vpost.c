@@ -7,6 +7,7 @@
 * Change Logs:
 * Date            Author       Notes
 * 2021-4-13       Wayne        First version
+* 2026-10-19      RT-Thread    Add OSD colour key control
 *
 ******************************************************************************/
 
@@ -19,6 +20,7 @@
 #include <rtdbg.h>
 #include "NuMicro.h"
 #include <drv_sys.h>
+#include "drv_vpost.h"
 
 /* Private typedef --------------------------------------------------------------*/
 
@@ -218,6 +220,34 @@ static rt_err_t vpost_layer_control(rt_device_t dev, int cmd, void *args)
     }
     break;
 
+#if defined(BSP_USING_VPOST_OSD)
+    case RTGRAPHIC_CTRL_SET_OSD_COLKEY:
+    {
+        if (psVpost->layer != eVpost_OSD)
+            return -RT_ERROR;
+
+        if (args != RT_NULL)
+        {
+            rt_uint32_t u32ColKey = *((rt_uint32_t *)args);
+
+            /* The key is compared under the colour mask, in the components of the source format. */
+#if (BSP_LCD_BPP==32)
+            vpostOSDSetColKey((u32ColKey >> 16) & 0xff, (u32ColKey >> 8) & 0xff, u32ColKey & 0xff);
+#else
+            vpostOSDSetColKey((u32ColKey >> 11) & 0x1f, (u32ColKey >> 5) & 0x3f, u32ColKey & 0x1f);
+#endif
+            /* Display the LCD layer on the key colour, the OSD elsewhere. */
+            vpostOSDSetOverlay(DISPLAY_VIDEO, DISPLAY_OSD, 0);
+        }
+        else
+        {
+            vpostOSDSetColKey(0, 0, 0);
+            vpostOSDSetOverlay(DISPLAY_OSD, DISPLAY_OSD, 0);
+        }
+    }
+    break;
+#endif
+
     default:
         return -RT_ERROR;
     }
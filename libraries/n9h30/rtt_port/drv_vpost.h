@@ -0,0 +1,25 @@
+/**************************************************************************//**
+*
+* @copyright (C) 2020 Nuvoton Technology Corp. All rights reserved.
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Change Logs:
+* Date            Author       Notes
+* 2026-10-19      RT-Thread    First version
+*
+******************************************************************************/
+
+#ifndef __DRV_VPOST_H__
+#define __DRV_VPOST_H__
+
+#include <rtthread.h>
+
+/*
+ * Colour key of the OSD layer. args points to a rt_uint32_t colour in the
+ * pixel format of the layer: the OSD pixels of this colour show the LCD
+ * layer. A RT_NULL args turns the key off, the OSD layer covers the LCD.
+ */
+#define RTGRAPHIC_CTRL_SET_OSD_COLKEY   (RT_DEVICE_CTRL_BASE(Graphic) + 0x20)
+
+#endif /* __DRV_VPOST_H__ */
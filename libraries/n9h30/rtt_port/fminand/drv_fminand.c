@@ -34,10 +34,25 @@
 
 #include "nand.h"
 
+/* Copyback in the optional commands of the ONFI parameter page */
+#define ONFI_OPT_CMD_COPYBACK   (1 << 4)
+
 struct nu_fminand
 {
     struct nand_chip nandchip;
     struct rt_mutex  lock;
+
+    /* statistics of the batched operations */
+    rt_uint32_t      batch_read_pages;
+    rt_uint32_t      batch_write_pages;
+    rt_uint32_t      corrected_pages;
+    rt_uint32_t      copyback_pages;
+    rt_uint32_t      reprogram_pages;
+
+    /* copy-back, from the ONFI parameter page */
+    rt_bool_t        copyback;
+    rt_uint32_t      plane_mask;         /* plane bits of the block address */
+    rt_uint32_t      blocks_per_lun;
 };
 typedef struct nu_fminand *nu_fminand_t;
 
@@ -46,6 +61,10 @@ static struct nu_fminand s_nu_fminand = {0};
 #define FMINAND_NAND_CHIP    (&s_nu_fminand.nandchip)
 #define FMINAND_MTD_INFO     (&s_nu_fminand.nandchip.mtd)
 
+extern int nuvoton_nand_read_pages(struct mtd_info *mtd, int page, int count, uint8_t *buf);
+extern int nuvoton_nand_write_pages(struct mtd_info *mtd, int page, int count, const uint8_t *buf);
+extern int nuvoton_nand_copy_page(struct mtd_info *mtd, int src_page, int dst_page, uint8_t *buf);
+
 static void nu_fminand_dump_buffer(int page, rt_uint8_t *buf, int len, const char *title)
 {
     int i;
@@ -111,23 +130,50 @@ static rt_err_t nu_fminand_read_page(struct rt_mtd_nand_device *device,
     result = rt_mutex_take(FMINAND_FLASH_LOCK, RT_WAITING_FOREVER);
     RT_ASSERT(result == RT_EOK);
 
-    if (data && data_len)
+    if (spare && spare_len)
     {
-        int ret = nand_read_skip_bad(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize * page, &data_len, NULL, FMINAND_MTD_INFO->size, (u_char *)data);
-        //int ret = nand_read(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize*page, &data_len, (u_char *)data);
-        if (ret != 0)
+        /* Data and the free bytes of the spare area in one access. */
+        struct mtd_oob_ops ops = {0};
+        int ret;
+
+        ops.mode    = MTD_OPS_AUTO_OOB;
+        ops.datbuf  = (data && data_len) ? (uint8_t *)data : NULL;
+        ops.len     = (data && data_len) ? FMINAND_MTD_INFO->writesize : 0;
+        ops.oobbuf  = (uint8_t *)spare;
+        ops.ooblen  = (spare_len > FMINAND_MTD_INFO->oobavail) ? FMINAND_MTD_INFO->oobavail : spare_len;
+
+        ret = mtd_read_oob(FMINAND_MTD_INFO, (loff_t)FMINAND_MTD_INFO->writesize * page, &ops);
+        if (ret == -EUCLEAN)
         {
-            result = -RT_ERROR;
-            goto exit_nu_fminand_read_page;
+            /* Corrected bit-flips, the caller may relocate the block. */
+            result = -RT_MTD_EECC_CORRECT;
+        }
+        else if (ret != 0)
+        {
+            result = -RT_MTD_EECC;
         }
+        goto exit_nu_fminand_read_page;
     }
 
-//    if (spare && spare_len)
-//    {
-//        if (result != RT_EOK)
-//            goto exit_nu_fminand_read_page;
-//    }
-
+    if (data && data_len)
+    {
+        /*
+         * Pages are addressed raw like the spare path above, the bad blocks are handled by the upper layer.
+         * The data-only calls used to skip bad blocks (nand_*_skip_bad), which shifted the page past every
+         * bad block before it. Data written that way behind a bad block, e.g. by yaffs with in-band tags,
+         * is found at another page now and has to be written again.
+         */
+        size_t len = data_len;
+        int ret = nand_read(FMINAND_MTD_INFO, (loff_t)FMINAND_MTD_INFO->writesize * page, &len, (u_char *)data);
+        if (ret == -EUCLEAN)
+        {
+            result = -RT_MTD_EECC_CORRECT;
+        }
+        else if (ret != 0)
+        {
+            result = -RT_MTD_EECC;
+        }
+    }
 
 exit_nu_fminand_read_page:
 
@@ -158,24 +204,38 @@ static rt_err_t nu_fminand_write_page(struct rt_mtd_nand_device *device,
     result = rt_mutex_take(FMINAND_FLASH_LOCK, RT_WAITING_FOREVER);
     RT_ASSERT(result == RT_EOK);
 
-    /* Read data: 0~2111, to cache */
+    if (spare && spare_len)
+    {
+        /* Program the data together with the free bytes of the spare area. */
+        struct mtd_oob_ops ops = {0};
+        int ret;
+
+        ops.mode    = MTD_OPS_AUTO_OOB;
+        ops.datbuf  = (data && data_len) ? (uint8_t *)data : NULL;
+        ops.len     = (data && data_len) ? FMINAND_MTD_INFO->writesize : 0;
+        ops.oobbuf  = (uint8_t *)spare;
+        ops.ooblen  = (spare_len > FMINAND_MTD_INFO->oobavail) ? FMINAND_MTD_INFO->oobavail : spare_len;
+
+        ret = mtd_write_oob(FMINAND_MTD_INFO, (loff_t)FMINAND_MTD_INFO->writesize * page, &ops);
+        if (ret != 0)
+        {
+            result = -RT_MTD_EIO;
+        }
+        goto exit_nu_fminand_write_page;
+    }
+
+    /* Raw page, see nu_fminand_read_page() */
     if (data && data_len)
     {
-        int ret = nand_write_skip_bad(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize * page, &data_len, NULL, FMINAND_MTD_INFO->size, (u_char *)data, 0);
-//            int ret = nand_write(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize*page, &data_len, (u_char *)data);
+        size_t len = data_len;
+        int ret = nand_write(FMINAND_MTD_INFO, (loff_t)FMINAND_MTD_INFO->writesize * page, &len, (u_char *)data);
         if (ret != 0)
         {
-            result = -RT_ERROR;
+            result = -RT_MTD_EIO;
             goto exit_nu_fminand_write_page;
         }
     }
 
-//    if (spare && spare_len)
-//    {
-//        if (result != RT_EOK)
-//            goto exit_nu_fminand_write_page;
-//    }
-
 exit_nu_fminand_write_page:
 
     rt_mutex_release(FMINAND_FLASH_LOCK);
@@ -183,10 +243,24 @@ exit_nu_fminand_write_page:
     return result;
 }
 
+/* Copy-back moves a page inside one plane of one LUN, the layout comes from the ONFI parameter page. */
+static rt_bool_t nu_fminand_can_copyback(rt_uint32_t src_block, rt_uint32_t dst_block)
+{
+    nu_fminand_t psNuFmiNand = &s_nu_fminand;
+
+    if (!psNuFmiNand->copyback)
+        return RT_FALSE;
+
+    if ((src_block / psNuFmiNand->blocks_per_lun) != (dst_block / psNuFmiNand->blocks_per_lun))
+        return RT_FALSE;
+
+    return ((src_block ^ dst_block) & psNuFmiNand->plane_mask) ? RT_FALSE : RT_TRUE;
+}
+
 static rt_err_t nu_fminand_move_page(struct rt_mtd_nand_device *device, rt_off_t src_page, rt_off_t dst_page)
 {
     rt_err_t result = RT_EOK ;
-    void *page_buf = RT_NULL;
+    rt_uint8_t *page_buf = RT_NULL;
 
     RT_ASSERT(device);
 
@@ -202,26 +276,60 @@ static rt_err_t nu_fminand_move_page(struct rt_mtd_nand_device *device, rt_off_t
     result = rt_mutex_take(FMINAND_FLASH_LOCK, RT_WAITING_FOREVER);
     RT_ASSERT(result == RT_EOK);
 
+    page_buf = rt_malloc(FMINAND_MTD_INFO->writesize + FMINAND_MTD_INFO->oobavail);
+    if (page_buf == RT_NULL)
     {
-        page_buf = rt_malloc(FMINAND_MTD_INFO->writesize);
-        size_t retlen = FMINAND_MTD_INFO->writesize;
+        result = -RT_MTD_ENOMEM;
+        goto exit_nu_fminand_move_page;
+    }
 
-        //int ret = nand_read(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize*src_page, &retlen, (u_char *)page_buf);
-        int ret = nand_read_skip_bad(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize * src_page, &retlen, NULL, FMINAND_MTD_INFO->size, (u_char *)page_buf);
-        if (ret != 0)
+    /* Copy-back needs both blocks good and on the same plane. */
+    if (nu_fminand_can_copyback(src_page / device->pages_per_block, dst_page / device->pages_per_block) &&
+            !nand_block_isbad(FMINAND_MTD_INFO, src_page * FMINAND_MTD_INFO->writesize) &&
+            !nand_block_isbad(FMINAND_MTD_INFO, dst_page * FMINAND_MTD_INFO->writesize))
+    {
+        int ret = nuvoton_nand_copy_page(FMINAND_MTD_INFO, src_page, dst_page, page_buf);
+        if (ret < 0)
+        {
+            result = -RT_MTD_EIO;
+            goto exit_nu_fminand_move_page;
+        }
+        else if (ret > 0)
+        {
+            s_nu_fminand.copyback_pages++;
+            goto exit_nu_fminand_move_page;
+        }
+        /* Bitflips in the source page, nothing programmed, read and program it below. */
+    }
+
+    {
+        /* The data and the free bytes of the spare area, the tags of the file system. */
+        struct mtd_oob_ops ops = {0};
+        int ret;
+
+        ops.mode    = MTD_OPS_AUTO_OOB;
+        ops.datbuf  = page_buf;
+        ops.len     = FMINAND_MTD_INFO->writesize;
+        ops.oobbuf  = page_buf + FMINAND_MTD_INFO->writesize;
+        ops.ooblen  = FMINAND_MTD_INFO->oobavail;
+
+        /* Corrected bit-flips are dropped by programming the page again. */
+        ret = mtd_read_oob(FMINAND_MTD_INFO, (loff_t)FMINAND_MTD_INFO->writesize * src_page, &ops);
+        if (ret != 0 && ret != -EUCLEAN)
         {
             result = -RT_ERROR;
             goto exit_nu_fminand_move_page;
         }
 
-        //ret = nand_write(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize*dst_page, &retlen, (u_char *)page_buf);
-        ret = nand_write_skip_bad(FMINAND_MTD_INFO, FMINAND_MTD_INFO->writesize * dst_page, &retlen, NULL, FMINAND_MTD_INFO->size, (u_char *)page_buf, 0);
+        ops.retlen = ops.oobretlen = 0;
+        ret = mtd_write_oob(FMINAND_MTD_INFO, (loff_t)FMINAND_MTD_INFO->writesize * dst_page, &ops);
         if (ret != 0)
         {
             result = -RT_ERROR;
             goto exit_nu_fminand_move_page;
         }
 
+        s_nu_fminand.reprogram_pages++;
     }
 
 exit_nu_fminand_move_page:
@@ -234,6 +342,89 @@ exit_nu_fminand_move_page:
     return result;
 }
 
+/* Run a batched operation block by block, the cache sequences do not cross blocks. */
+static rt_err_t nu_fminand_batch(struct rt_mtd_nand_device *device, rt_off_t page, rt_uint8_t *data,
+                                 rt_uint32_t page_num, rt_bool_t is_write)
+{
+    rt_err_t result = RT_EOK;
+    rt_uint32_t count;
+    int ret;
+
+    RT_ASSERT(device);
+    RT_ASSERT(data);
+
+    if ((page < device->block_start * device->pages_per_block) ||
+            ((page + page_num - 1) / device->pages_per_block > device->block_end))
+    {
+        LOG_E("[EIO] batch page:%d, num:%d", page, page_num);
+        return -RT_MTD_EIO;
+    }
+
+    result = rt_mutex_take(FMINAND_FLASH_LOCK, RT_WAITING_FOREVER);
+    RT_ASSERT(result == RT_EOK);
+
+    while (page_num > 0)
+    {
+        count = device->pages_per_block - (page % device->pages_per_block);
+        if (count > page_num)
+            count = page_num;
+
+        /* Bad blocks are handled by the caller, the batch does not skip them. */
+        if (nand_block_isbad(FMINAND_MTD_INFO, page * FMINAND_MTD_INFO->writesize))
+        {
+            result = -RT_MTD_EIO;
+            break;
+        }
+
+        if (is_write)
+        {
+            ret = nuvoton_nand_write_pages(FMINAND_MTD_INFO, page, count, data);
+            if (ret < 0)
+            {
+                result = -RT_MTD_EIO;
+                break;
+            }
+            s_nu_fminand.batch_write_pages += count;
+        }
+        else
+        {
+            ret = nuvoton_nand_read_pages(FMINAND_MTD_INFO, page, count, data);
+            if (ret < 0)
+            {
+                result = -RT_MTD_EECC;
+                break;
+            }
+            s_nu_fminand.batch_read_pages += count;
+            s_nu_fminand.corrected_pages += ret;
+        }
+
+        page += count;
+        page_num -= count;
+        data += count * device->page_size;
+    }
+
+    rt_mutex_release(FMINAND_FLASH_LOCK);
+
+    return result;
+}
+
+/**
+ * Read continuous pages with NAND cache read, data only.
+ * The page is the absolute page number like the read_page operation.
+ */
+rt_err_t nu_fminand_read_pages(struct rt_mtd_nand_device *device, rt_off_t page, rt_uint8_t *data, rt_uint32_t page_num)
+{
+    return nu_fminand_batch(device, page, data, page_num, RT_FALSE);
+}
+
+/**
+ * Program continuous erased pages with NAND cache program, data only.
+ */
+rt_err_t nu_fminand_write_pages(struct rt_mtd_nand_device *device, rt_off_t page, const rt_uint8_t *data, rt_uint32_t page_num)
+{
+    return nu_fminand_batch(device, page, (rt_uint8_t *)data, page_num, RT_TRUE);
+}
+
 static rt_err_t nu_fminand_erase_block_force(struct rt_mtd_nand_device *device, rt_uint32_t block)
 {
     rt_err_t result = RT_EOK ;
@@ -372,6 +563,20 @@ static int nand_init_chip(void)
     if (nand_scan_tail(FMINAND_MTD_INFO))
         return -1;
 
+    /* Without the ONFI parameter page the layout is unknown, pages are moved by read and program. */
+    s_nu_fminand.blocks_per_lun = FMINAND_MTD_INFO->size / FMINAND_MTD_INFO->erasesize;
+#ifdef CONFIG_SYS_NAND_ONFI_DETECTION
+    if (FMINAND_NAND_CHIP->onfi_version)
+    {
+        struct nand_onfi_params *p = &FMINAND_NAND_CHIP->onfi_params;
+
+        s_nu_fminand.copyback   = (p->opt_cmd & ONFI_OPT_CMD_COPYBACK) ? RT_TRUE : RT_FALSE;
+        s_nu_fminand.plane_mask = (1 << (p->interleaved_bits & 0xF)) - 1;
+        if (p->blocks_per_lun)
+            s_nu_fminand.blocks_per_lun = p->blocks_per_lun;
+    }
+#endif
+
     return 0;
 }
 
@@ -399,7 +604,7 @@ int rt_hw_mtd_fminand_init(void)
 
         mtd_partitions[i].oob_size        =  FMINAND_MTD_INFO->oobsize;                       /* Out of bank size */
         mtd_partitions[i].oob_free        =  FMINAND_MTD_INFO->oobavail;                      /* the free area in oob that flash driver not use */
-        mtd_partitions[i].plane_num       =  0 ;                                 /* the number of plane in the NAND Flash */
+        mtd_partitions[i].plane_num       =  s_nu_fminand.copyback ? (s_nu_fminand.plane_mask + 1) : 0;   /* the number of plane in the NAND Flash, 0 if unknown */
         mtd_partitions[i].ops             =  &nu_fminand_ops;
 
         rt_snprintf(szTmp, sizeof(szTmp), "nand%d", i);
@@ -777,7 +982,193 @@ static int nfiles(int argc, char **argv)
     return 0;
 }
 
+static void nbench_report(const char *name, rt_uint32_t pages, rt_uint32_t page_size, rt_tick_t ticks, rt_tick_t max_ticks)
+{
+    if (ticks == 0)
+        ticks = 1;
+
+    rt_kprintf("%-14s %6d pages %8d ms %8d KB/s  max %d ms\n", name, pages,
+               ticks * 1000 / RT_TICK_PER_SECOND,
+               (rt_uint32_t)((rt_uint64_t)pages * page_size * RT_TICK_PER_SECOND / 1024 / ticks),
+               max_ticks * 1000 / RT_TICK_PER_SECOND);
+}
+
+static rt_bool_t nbench_erase(struct rt_mtd_nand_device *device, rt_uint32_t block, rt_uint32_t num)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < num; i++)
+    {
+        if (nu_fminand_erase_block(device, block + i) != RT_EOK)
+            return RT_FALSE;
+    }
+    return RT_TRUE;
+}
+
+/* Compare the page by page path with the batched cache read/program and copy-back. */
+static int nbench(int argc, char **argv)
+{
+    struct rt_mtd_nand_device *device;
+    rt_uint32_t partition, block, num, ppb, i, pages;
+    rt_uint8_t *wbuf = RT_NULL, *rbuf = RT_NULL;
+    rt_tick_t start, t, max;
+    rt_off_t page;
+    int ret = -1;
+
+    if (argc != 4)
+    {
+        LOG_E("Usage %s: %s <partition_no> <start block> <block num>.\n", __func__, __func__);
+        return -1;
+    }
+
+    partition = atoi(argv[1]);
+    if (partition >= MTD_FMINAND_PARTITION_NUM)
+        return -1;
+
+    device = &mtd_partitions[partition];
+    block = atoi(argv[2]) + device->block_start;
+    num = atoi(argv[3]);
+    ppb = device->pages_per_block;
+    pages = num * ppb;
+
+    /* Two more blocks for the move test, on the same plane of a single-plane chip. */
+    if ((num == 0) || (block + num + 2 > device->block_end + 1))
+    {
+        LOG_E("Out of partition range.\n");
+        return -1;
+    }
+
+    for (i = 0; i < num + 2; i++)
+    {
+        if (nu_fminand_check_block(device, block + i) != RT_EOK)
+        {
+            LOG_E("Block %d is bad, choose other blocks.\n", block + i);
+            return -1;
+        }
+    }
+
+    wbuf = rt_malloc(ppb * device->page_size);
+    rbuf = rt_malloc(ppb * device->page_size);
+    if (!wbuf || !rbuf)
+    {
+        LOG_E("no memory\n");
+        goto exit_nbench;
+    }
+
+    for (i = 0; i < ppb * device->page_size; i++)
+        wbuf[i] = i / 5 - i;
+
+    /* Page by page through the MTD NAND interface */
+    if (!nbench_erase(device, block, num))
+        goto exit_nbench;
+
+    max = 0;
+    start = rt_tick_get();
+    for (page = block * ppb; page < (block + num) * ppb; page++)
+    {
+        t = rt_tick_get();
+        if (rt_mtd_nand_write(device, page, wbuf + (page % ppb) * device->page_size, device->page_size, RT_NULL, 0) != RT_EOK)
+            goto exit_nbench;
+        t = rt_tick_get() - t;
+        max = (t > max) ? t : max;
+    }
+    nbench_report("write page", pages, device->page_size, rt_tick_get() - start, max);
+
+    max = 0;
+    start = rt_tick_get();
+    for (page = block * ppb; page < (block + num) * ppb; page++)
+    {
+        t = rt_tick_get();
+        if (rt_mtd_nand_read(device, page, rbuf, device->page_size, RT_NULL, 0) != RT_EOK)
+            goto exit_nbench;
+        t = rt_tick_get() - t;
+        max = (t > max) ? t : max;
+        if (rt_memcmp(rbuf, wbuf + (page % ppb) * device->page_size, device->page_size))
+        {
+            LOG_E("Mismatch at page %d.\n", page);
+            goto exit_nbench;
+        }
+    }
+    nbench_report("read page", pages, device->page_size, rt_tick_get() - start, max);
+
+    /* Batched cache program and cache read, one block per call */
+    if (!nbench_erase(device, block, num))
+        goto exit_nbench;
+
+    max = 0;
+    start = rt_tick_get();
+    for (i = 0; i < num; i++)
+    {
+        t = rt_tick_get();
+        if (nu_fminand_write_pages(device, (block + i) * ppb, wbuf, ppb) != RT_EOK)
+            goto exit_nbench;
+        t = rt_tick_get() - t;
+        max = (t > max) ? t : max;
+    }
+    nbench_report("write batch", pages, device->page_size, rt_tick_get() - start, max / ppb);
+
+    max = 0;
+    start = rt_tick_get();
+    for (i = 0; i < num; i++)
+    {
+        t = rt_tick_get();
+        if (nu_fminand_read_pages(device, (block + i) * ppb, rbuf, ppb) != RT_EOK)
+            goto exit_nbench;
+        t = rt_tick_get() - t;
+        max = (t > max) ? t : max;
+        if (rt_memcmp(rbuf, wbuf, ppb * device->page_size))
+        {
+            LOG_E("Mismatch in block %d.\n", block + i);
+            goto exit_nbench;
+        }
+    }
+    nbench_report("read batch", pages, device->page_size, rt_tick_get() - start, max / ppb);
+
+    /* Move the first block two blocks on, by copy-back when the chip allows it */
+    if (!nbench_erase(device, block + 2, 1))
+        goto exit_nbench;
+
+    max = 0;
+    start = rt_tick_get();
+    for (i = 0; i < ppb; i++)
+    {
+        t = rt_tick_get();
+        if (rt_mtd_nand_move_page(device, block * ppb + i, (block + 2) * ppb + i) != RT_EOK)
+            goto exit_nbench;
+        t = rt_tick_get() - t;
+        max = (t > max) ? t : max;
+    }
+    nbench_report("move page", ppb, device->page_size, rt_tick_get() - start, max);
+
+    if (nu_fminand_read_pages(device, (block + 2) * ppb, rbuf, ppb) != RT_EOK ||
+            rt_memcmp(rbuf, wbuf, ppb * device->page_size))
+    {
+        LOG_E("Moved block %d mismatch.\n", block + 2);
+        goto exit_nbench;
+    }
+
+    rt_kprintf("batch read %d, batch write %d, corrected %d, copy-back %d, reprogrammed %d pages\n",
+               s_nu_fminand.batch_read_pages, s_nu_fminand.batch_write_pages, s_nu_fminand.corrected_pages,
+               s_nu_fminand.copyback_pages, s_nu_fminand.reprogram_pages);
+
+    ret = 0;
+
+exit_nbench:
+
+    if (ret != 0)
+        rt_kprintf("nbench failed.\n");
+
+    if (wbuf)
+        rt_free(wbuf);
+
+    if (rbuf)
+        rt_free(rbuf);
+
+    return ret;
+}
+
 #ifdef FINSH_USING_MSH
+    MSH_CMD_EXPORT(nbench, nand page and batched read/write/move throughput);
     MSH_CMD_EXPORT(nfiles, write files);
     MSH_CMD_EXPORT(nid, nand id);
     MSH_CMD_EXPORT(nlist, list all partition information on nand);
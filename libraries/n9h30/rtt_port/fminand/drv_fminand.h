@@ -17,4 +17,12 @@
 
 rt_err_t rt_hw_mtd_fminand_register(const char *device_name);
 
+#if defined(RT_USING_MTD_NAND)
+#include "drivers/mtd_nand.h"
+
+/* Batched page access with cache read/program, page is absolute like rt_mtd_nand_read(). */
+rt_err_t nu_fminand_read_pages(struct rt_mtd_nand_device *device, rt_off_t page, rt_uint8_t *data, rt_uint32_t page_num);
+rt_err_t nu_fminand_write_pages(struct rt_mtd_nand_device *device, rt_off_t page, const rt_uint8_t *data, rt_uint32_t page_num);
+#endif
+
 #endif //__DRV_GPIO_H__
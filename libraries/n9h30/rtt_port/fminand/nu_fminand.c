@@ -47,6 +47,14 @@
 #define BCH_PARITY_LEN_T24 45
 
 
+/*-----------------------------------------------------------------------------
+ * Commands of the batched page operations
+ *---------------------------------------------------------------------------*/
+#define NAND_CMD_READCACHESEQ   0x31    // read next page while transferring the cache register
+#define NAND_CMD_READCACHEEND   0x3F    // move the last page to the cache register
+#define NAND_CMD_COPYBACKREAD   0x35    // read for internal data move
+
+
 #define BCH_T15   0x00400000
 #define BCH_T12   0x00200000
 #define BCH_T8    0x00100000
@@ -61,6 +69,7 @@ struct nuvoton_nand_info
     struct nand_chip        chip;
     int                     eBCHAlgo;
     int                     m_i32SMRASize;
+    unsigned int            m_u32Corrected;     // fields corrected by BCH
 };
 struct nuvoton_nand_info g_nuvoton_nand;
 struct nuvoton_nand_info *nuvoton_nand;
@@ -565,6 +574,7 @@ static __inline int _nuvoton_nand_dma_transfer(struct mtd_info *mtd, const u_cha
                 else if (stat > 0)
                 {
                     //mtd->ecc_stats.corrected += stat; //Occure: MLC UBIFS mount error
+                    nand->m_u32Corrected++;
                     outpw(REG_NANDINTSTS, 0x4);
                 }
 
@@ -663,6 +673,188 @@ static int nuvoton_nand_read_oob_hwecc(struct mtd_info *mtd, struct nand_chip *c
     return 0;
 }
 
+static void nuvoton_nand_wait_ready(struct nand_chip *chip)
+{
+    int volatile i;
+
+    /* tWB: the busy state is not shown right after the command */
+    if (chip->chip_delay)
+        for (i = 0; i < chip->chip_delay; i++);
+    while (!(inpw(REG_NANDINTSTS) & READYBUSY));
+}
+
+static int nuvoton_nand_status(void)
+{
+    outpw(REG_NANDCMD, NAND_CMD_STATUS);
+    return (unsigned char)inpw(REG_NANDDATA);
+}
+
+/* DMA a page out of the cache register and check ECC, return bitflips or -1 */
+static int nuvoton_nand_read_dma(struct mtd_info *mtd, uint8_t *buf)
+{
+    unsigned int failed = mtd->ecc_stats.failed;
+    unsigned int corrected = nuvoton_nand->m_u32Corrected;
+
+    _nuvoton_nand_dma_transfer(mtd, buf, mtd->writesize, 0x0);
+
+    if (mtd->ecc_stats.failed != failed)
+        return -1;
+
+    return (nuvoton_nand->m_u32Corrected != corrected) ? 1 : 0;
+}
+
+static void nuvoton_nand_write_dma(struct mtd_info *mtd, const uint8_t *buf)
+{
+    /* Free OOB bytes are left erased, the parity codes are filled by the controller */
+    memset((void *)REG_NANDRA0, 0xFF, mtd->oobsize);
+
+    _nuvoton_nand_dma_transfer(mtd, buf, mtd->writesize, 0x1);
+}
+
+/**
+ * nuvoton_nand_read_pages - read pages of one block with cache read
+ * @mtd:        mtd info structure
+ * @page:       first page
+ * @count:      page number, the pages must not cross a block
+ * @buf:        buffer to store read data
+ *
+ * The array reads the next page (31h) while the DMA moves the current
+ * page out of the cache register with BCH ECC check.
+ *
+ * Return: the pages with corrected bitflips, or -1 on an uncorrectable page
+ */
+int nuvoton_nand_read_pages(struct mtd_info *mtd, int page, int count, uint8_t *buf)
+{
+    struct nand_chip *chip = mtd_to_nand(mtd);
+    int i, stat, ret = 0;
+
+    chip->pagebuf = -1;
+
+    /* The page is in the cache register after 30h */
+    nuvoton_nand_command(mtd, NAND_CMD_READ0, 0, page);
+
+    for (i = 0; i < count; i++)
+    {
+        if (count > 1)
+        {
+            outpw(REG_NANDCMD, (i == count - 1) ? NAND_CMD_READCACHEEND : NAND_CMD_READCACHESEQ);
+            nuvoton_nand_wait_ready(chip);
+        }
+
+        stat = nuvoton_nand_read_dma(mtd, buf);
+        if (stat < 0)
+        {
+            ret = -1;
+            /* drain the pipeline before leaving */
+            if (i < count - 1)
+            {
+                outpw(REG_NANDCMD, NAND_CMD_READCACHEEND);
+                nuvoton_nand_wait_ready(chip);
+            }
+            break;
+        }
+        ret += stat;
+        buf += mtd->writesize;
+    }
+
+    return ret;
+}
+
+/**
+ * nuvoton_nand_write_pages - program pages of one block with cache program
+ * @mtd:        mtd info structure
+ * @page:       first page
+ * @count:      page number, the pages must not cross a block
+ * @buf:        data buffer
+ *
+ * The next page is moved by DMA while the array programs the current page (15h).
+ *
+ * Return: 0 or -EIO
+ */
+int nuvoton_nand_write_pages(struct mtd_info *mtd, int page, int count, const uint8_t *buf)
+{
+    struct nand_chip *chip = mtd_to_nand(mtd);
+    int i, status;
+    int cached = NAND_HAS_CACHEPROG(chip);
+
+    chip->pagebuf = -1;
+
+    for (i = 0; i < count; i++)
+    {
+        nuvoton_nand_command(mtd, NAND_CMD_SEQIN, 0, page + i);
+        nuvoton_nand_write_dma(mtd, buf);
+
+        outpw(REG_NANDCMD, (cached && (i < count - 1)) ? NAND_CMD_CACHEDPROG : NAND_CMD_PAGEPROG);
+        nuvoton_nand_wait_ready(chip);
+
+        /* FAIL_N1 reports the previous page of a cache program */
+        status = nuvoton_nand_status();
+        if (status & (NAND_STATUS_FAIL | (cached ? NAND_STATUS_FAIL_N1 : 0)))
+            return -EIO;
+
+        buf += mtd->writesize;
+    }
+
+    return 0;
+}
+
+/**
+ * nuvoton_nand_copy_page - move a page inside the chip
+ * @mtd:        mtd info structure
+ * @src_page:   source page
+ * @dst_page:   destination page, on the same plane
+ * @buf:        page buffer for the ECC check of the source page
+ *
+ * The source page is read out once for ECC check. A clean page is
+ * programmed back by copy-back (35h/85h), so the data and the spare area
+ * do not cross the bus again. A page with corrected bitflips is not
+ * programmed, copy-back would move the bitflips; the caller reads and
+ * programs it with its spare area.
+ *
+ * Return: 1 for copy-back, 0 for a source page with bitflips, or -EIO
+ */
+int nuvoton_nand_copy_page(struct mtd_info *mtd, int src_page, int dst_page, uint8_t *buf)
+{
+    struct nand_chip *chip = mtd_to_nand(mtd);
+    int stat, status;
+
+    chip->pagebuf = -1;
+
+    /* 00h-address-35h, the page register keeps the page for 85h */
+    outpw(REG_NANDCMD, NAND_CMD_READ0);
+    outpw(REG_NANDADDR, 0);
+    outpw(REG_NANDADDR, 0);
+    outpw(REG_NANDADDR, src_page & 0xFF);
+    if (chip->chipsize > (128 << 20))
+    {
+        outpw(REG_NANDADDR, (src_page >> 8) & 0xFF);
+        outpw(REG_NANDADDR, ((src_page >> 16) & 0xFF) | ENDADDR);
+    }
+    else
+    {
+        outpw(REG_NANDADDR, ((src_page >> 8) & 0xFF) | ENDADDR);
+    }
+    outpw(REG_NANDCMD, NAND_CMD_COPYBACKREAD);
+    nuvoton_nand_wait_ready(chip);
+
+    stat = nuvoton_nand_read_dma(mtd, buf);
+    if (stat < 0)
+        return -EIO;
+    else if (stat > 0)
+        return 0;
+
+    /* 85h keeps the page register, only the address is changed */
+    nuvoton_nand_command(mtd, NAND_CMD_RNDIN, 0, dst_page);
+    outpw(REG_NANDCMD, NAND_CMD_PAGEPROG);
+    nuvoton_nand_wait_ready(chip);
+
+    status = nuvoton_nand_status();
+    if (status & NAND_STATUS_FAIL)
+        return -EIO;
+
+    return 1;
+}
+
 int board_nand_init(struct nand_chip *nand)
 {
     struct mtd_info *mtd;
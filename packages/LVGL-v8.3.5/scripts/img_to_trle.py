@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+##################################################################
+# Tiled RLE (TRLE) image converter
+# Dependencies: (PYTHON-3) Pillow
+#
+# Converts an image to RGB565 (with an alpha byte per pixel when
+# --alpha is given), cuts it in tiles and run-length compresses
+# every tile. Writes <name>.trle for the file system and <name>.c
+# with an lv_img_dsc_t of LV_IMG_CF_RAW for a C array.
+#
+# TRLE file, little endian:
+#   0 -  7  "_TRLE__" followed by '\0'
+#   8 -  9  width
+#  10 - 11  height
+#  12 - 13  tile width
+#  14 - 15  tile height
+#  16       pixel format: 0 RGB565, 1 RGB565 followed by an alpha byte
+#  17       flags: bit0 RGB565 in big endian (LV_COLOR_16_SWAP)
+#  18 - 19  reserved
+#  20 -     offsets of the tiles, row by row, and the end of the last
+#           one. 32 bits each, counted from the first tile.
+#
+# A tile is compressed as one line of its pixels, row after row.
+# A control byte c < 0x80 is followed by c + 1 literal pixels,
+# c >= 0x80 by a pixel to repeat (c & 0x7F) + 1 times.
+##################################################################
+import argparse, os, struct, sys, time
+from PIL import Image
+
+TRLE_MAGIC = b"_TRLE__\x00"
+TRLE_PF_RGB565 = 0
+TRLE_PF_RGB565A8 = 1
+TRLE_FLAG_SWAP = 0x01
+RLE_MAX = 128
+
+
+def to_pixels(im, alpha, swap):
+    """Pixels of the image in the byte order of the display."""
+    pixels = []
+    for r, g, b, a in im.getdata():
+        c = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+        px = c.to_bytes(2, byteorder='big' if swap else 'little')
+        if alpha:
+            px += bytes([a])
+        pixels.append(px)
+    return pixels
+
+
+def rle_encode(pixels):
+    out = bytearray()
+    i = 0
+    n = len(pixels)
+    while i < n:
+        run = 1
+        while i + run < n and run < RLE_MAX and pixels[i + run] == pixels[i]:
+            run += 1
+
+        if run >= 2:
+            out.append(0x80 | (run - 1))
+            out += pixels[i]
+            i += run
+            continue
+
+        # Literals up to the next run of 3 pixels or more.
+        start = i
+        while i < n and i - start < RLE_MAX:
+            if i + 2 < n and pixels[i] == pixels[i + 1] == pixels[i + 2]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        for px in pixels[start:i]:
+            out += px
+    return out
+
+
+def rle_decode(data, count, px_size):
+    pixels = []
+    i = 0
+    while len(pixels) < count:
+        c = data[i]
+        i += 1
+        if c & 0x80:
+            pixels += [bytes(data[i:i + px_size])] * ((c & 0x7F) + 1)
+            i += px_size
+        else:
+            for _ in range(c + 1):
+                pixels.append(bytes(data[i:i + px_size]))
+                i += px_size
+    return pixels
+
+
+def convert(im, tile_w, tile_h, alpha, swap):
+    width, height = im.size
+    pixels = to_pixels(im.convert("RGBA"), alpha, swap)
+    px_size = 3 if alpha else 2
+
+    offsets = []
+    tiles = bytearray()
+    for ty in range(0, height, tile_h):
+        for tx in range(0, width, tile_w):
+            tw = min(tile_w, width - tx)
+            th = min(tile_h, height - ty)
+            tile = [pixels[(ty + y) * width + tx + x] for y in range(th) for x in range(tw)]
+            comp = rle_encode(tile)
+            assert rle_decode(comp, len(tile), px_size) == tile
+            offsets.append(len(tiles))
+            tiles += comp
+    offsets.append(len(tiles))
+
+    header = bytearray(TRLE_MAGIC)
+    header += struct.pack("<HHHHBBH", width, height, tile_w, tile_h,
+                          TRLE_PF_RGB565A8 if alpha else TRLE_PF_RGB565,
+                          TRLE_FLAG_SWAP if swap else 0, 0)
+    for off in offsets:
+        header += struct.pack("<I", off)
+
+    return header + tiles, width * height * px_size
+
+
+def c_array(name, data, width, height):
+    lines = ["//LVGL TRLE C ARRAY", '#include "lvgl.h"', "",
+             "const LV_ATTRIBUTE_MEM_ALIGN uint8_t " + name + "_map[] = {"]
+    for i in range(0, len(data), 16):
+        lines.append("\t" + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    lines += ["};", "",
+              "const lv_img_dsc_t " + name + " = {",
+              "\t.header.always_zero = 0,",
+              "\t.header.w = " + str(width) + ",",
+              "\t.header.h = " + str(height) + ",",
+              "\t.data_size = " + str(len(data)) + ",",
+              "\t.header.cf = LV_IMG_CF_RAW,",
+              "\t.data = " + name + "_map,",
+              "};", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an image to the tiled RLE format of LVGL")
+    parser.add_argument("input", help="input image, any format Pillow reads")
+    parser.add_argument("-o", "--output", help="output name without extension (default: input name)")
+    parser.add_argument("--tile", default="32x32", help="tile size WxH (default: 32x32)")
+    parser.add_argument("--alpha", action="store_true", help="keep the alpha channel (RGB565A8)")
+    parser.add_argument("--swap", action="store_true", help="swap the bytes of RGB565 (LV_COLOR_16_SWAP)")
+    args = parser.parse_args()
+
+    try:
+        tile_w, tile_h = (int(v) for v in args.tile.lower().split("x"))
+    except ValueError:
+        sys.exit("bad tile size: " + args.tile)
+    if not (0 < tile_w < 65536 and 0 < tile_h < 65536):
+        sys.exit("bad tile size: " + args.tile)
+
+    try:
+        im = Image.open(args.input)
+    except OSError:
+        sys.exit("cannot open " + args.input)
+
+    name = args.output or os.path.splitext(os.path.basename(args.input))[0]
+
+    start_time = time.time()
+    data, raw_size = convert(im, tile_w, tile_h, args.alpha, args.swap)
+    width, height = im.size
+
+    with open(name + ".trle", "wb") as f:
+        f.write(data)
+    with open(name + ".c", "w") as f:
+        f.write(c_array(os.path.basename(name), data, width, height))
+
+    print("Input:")
+    print("\t" + args.input)
+    print("\tRES = " + str(width) + " x " + str(height))
+    print("Output:")
+    print("\tTime taken = " + str(round(time.time() - start_time, 2)) + " sec")
+    print("\tbin size = " + str(round(len(data) / 1024, 1)) + " KB, raw " +
+          str(round(raw_size / 1024, 1)) + " KB (" + str(round(len(data) * 100 / raw_size)) + "%)")
+    print("\t" + name + ".trle\t(bin file)" + "\n\t" + name + ".c\t\t(c array)")
+
+
+if __name__ == "__main__":
+    main()
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     RT-Thread    pipelined READ/WRITE, read-ahead, attribute cache
  */
 
 #include <stdio.h>
@@ -19,7 +20,24 @@
 #include "nfs.h"
 
 #define NAME_MAX    64
-#define DFS_NFS_MAX_MTU  1024
+
+/* largest READ/WRITE size, the server may ask for less in FSINFO */
+#ifndef RT_NFS_MAX_RWSIZE
+#define RT_NFS_MAX_RWSIZE   1024
+#endif
+/* READ/WRITE calls in flight */
+#ifndef RT_NFS_RPC_WINDOW
+#define RT_NFS_RPC_WINDOW   4
+#endif
+/* lifetime of the cached attributes in ms */
+#ifndef RT_NFS_ATTR_TIMEOUT
+#define RT_NFS_ATTR_TIMEOUT 3000
+#endif
+
+#define NFS_RWSIZE_MIN      1024
+/* leaves room for the RPC header in the buffers of the client */
+#define NFS_RWSIZE_LIMIT    (UDPMSGSIZE - 512)
+#define NFS_ATTR_CACHE_NUM  8
 
 #ifdef _WIN32
 #define strtok_r strtok_s
@@ -31,7 +49,11 @@ struct nfs_file
     size_t offset;      /* current offset */
 
     size_t size;        /* total size */
-    bool_t eof;         /* end of file */
+    bool_t eof;         /* end of file is the end of the read-ahead data */
+
+    char *ra_buf;       /* read-ahead buffer, rsize * RT_NFS_RPC_WINDOW bytes */
+    size_t ra_offset;   /* file offset of the read-ahead data */
+    size_t ra_len;      /* bytes of read-ahead data */
 };
 
 struct nfs_dir
@@ -44,6 +66,16 @@ struct nfs_dir
     READDIR3res res;
 };
 
+struct nfs_attr
+{
+    char *path;             /* NULL for a free entry */
+    nfs_fh3 handle;
+    ftype3 type;
+    size3 size;
+    uint32 mtime;
+    rt_tick_t tick;         /* when the attributes were fetched */
+};
+
 #define HOST_LENGTH         32
 #define EXPORT_PATH_LENGTH  32
 
@@ -57,6 +89,18 @@ struct nfs_filesystem
     char host[HOST_LENGTH];
     char export[EXPORT_PATH_LENGTH];
     void *data;             /* nfs_file or nfs_dir */
+
+    size_t rsize;           /* READ size */
+    size_t wsize;           /* WRITE size */
+    struct nfs_attr attr_cache[NFS_ATTR_CACHE_NUM];
+
+    /* statistics */
+    rt_uint32_t read_calls;
+    rt_uint32_t write_calls;
+    rt_uint32_t retrans;
+    rt_uint32_t ra_hits;    /* reads without READ call */
+    rt_uint32_t attr_hits;
+    rt_uint32_t attr_misses;
 };
 
 typedef struct nfs_filesystem nfs_filesystem;
@@ -263,72 +307,174 @@ static nfs_fh3 *get_dir_handle(nfs_filesystem *nfs, const char *name)
     return handle;
 }
 
-static size_t nfs_get_filesize(nfs_filesystem *nfs, nfs_fh3 *handle)
+static void nfs_attr_free(struct nfs_attr *attr)
+{
+    if (attr->path != NULL)
+    {
+        rt_free(attr->path);
+        attr->path = NULL;
+        xdr_free((xdrproc_t)xdr_nfs_fh3, (char *)&attr->handle);
+    }
+}
+
+/* drop the cached attributes of path, of all paths when path is NULL */
+static void nfs_attr_invalidate(nfs_filesystem *nfs, const char *path)
+{
+    int index;
+
+    for (index = 0; index < NFS_ATTR_CACHE_NUM; index ++)
+    {
+        struct nfs_attr *attr = &nfs->attr_cache[index];
+
+        if (attr->path != NULL && (path == NULL || strcmp(attr->path, path) == 0))
+            nfs_attr_free(attr);
+    }
+}
+
+/*
+ * Attributes and handle of path. The cached attributes are used while they
+ * are younger than RT_NFS_ATTR_TIMEOUT, refresh asks the server in any case
+ * but saves the LOOKUP calls of the path. The entry is valid until the next
+ * call on the cache.
+ */
+static struct nfs_attr *nfs_getattr(nfs_filesystem *nfs, const char *path, rt_bool_t refresh)
 {
     GETATTR3args args;
     GETATTR3res res;
     fattr3 *info;
-    size_t size;
+    nfs_fh3 *handle;
+    struct nfs_attr *attr = NULL;
+    struct nfs_attr *slot = &nfs->attr_cache[0];
+    int index, retry;
 
-    args.object = *handle;
+    for (index = 0; index < NFS_ATTR_CACHE_NUM; index ++)
+    {
+        struct nfs_attr *iter = &nfs->attr_cache[index];
 
-    memset(&res, '\0', sizeof(res));
+        if (iter->path != NULL && strcmp(iter->path, path) == 0)
+        {
+            attr = iter;
+            break;
+        }
 
-    if ((nfsproc3_getattr_3(args, &res, nfs->nfs_client) != RPC_SUCCESS) ||
-        res.status != NFS3_OK)
+        /* a free entry, or else the oldest one */
+        if (slot->path != NULL && (iter->path == NULL || iter->tick - slot->tick > RT_TICK_MAX / 2))
+            slot = iter;
+    }
+
+    if (attr != NULL && refresh == RT_FALSE &&
+        rt_tick_get() - attr->tick < rt_tick_from_millisecond(RT_NFS_ATTR_TIMEOUT))
+    {
+        nfs->attr_hits ++;
+        return attr;
+    }
+    nfs->attr_misses ++;
+
+    /* a cached handle may be stale, then look the path up again */
+    for (retry = (attr != NULL) ? 1 : 0; retry >= 0; retry --)
     {
-        rt_kprintf("GetAttr failed: %d\n", res.status);
+        if (attr == NULL)
+        {
+            handle = get_handle(nfs, path);
+            if (handle == NULL)
+                return NULL;
 
-        return 0;
+            nfs_attr_free(slot);
+            slot->path = rt_strdup(path);
+            if (slot->path == NULL)
+            {
+                xdr_free((xdrproc_t)xdr_nfs_fh3, (char *)handle);
+                rt_free(handle);
+
+                return NULL;
+            }
+            slot->handle = *handle;
+            rt_free(handle);
+            attr = slot;
+        }
+
+        args.object = attr->handle;
+
+        memset(&res, '\0', sizeof(res));
+
+        if ((nfsproc3_getattr_3(args, &res, nfs->nfs_client) == RPC_SUCCESS) &&
+            res.status == NFS3_OK)
+        {
+            info = &res.GETATTR3res_u.resok.obj_attributes;
+            attr->type = info->type;
+            attr->size = info->size;
+            attr->mtime = info->mtime.seconds;
+            attr->tick = rt_tick_get();
+            xdr_free((xdrproc_t)xdr_GETATTR3res, (char *)&res);
+
+            return attr;
+        }
+
+        xdr_free((xdrproc_t)xdr_GETATTR3res, (char *)&res);
+        slot = attr;
+        nfs_attr_free(attr);
+        attr = NULL;
     }
 
-    info = &res.GETATTR3res_u.resok.obj_attributes;
-    size = info->size;
-    xdr_free((xdrproc_t)xdr_GETATTR3res, (char *)&res);
+    rt_kprintf("GetAttr failed\n");
+
+    return NULL;
+}
+
+/* READ/WRITE size from the preferred and the largest size of the server */
+static size_t nfs_rwsize(uint32 pref, uint32 max)
+{
+    size_t size = RT_NFS_MAX_RWSIZE;
+
+    if (size > NFS_RWSIZE_LIMIT)
+        size = NFS_RWSIZE_LIMIT;
+    if (pref != 0 && pref < size)
+        size = pref;
+    if (max != 0 && max < size)
+        size = max;
+    if (size >= NFS_RWSIZE_MIN)
+        size &= ~(NFS_RWSIZE_MIN - 1);
 
     return size;
 }
 
-rt_bool_t nfs_is_directory(nfs_filesystem *nfs, const char *name)
+static void nfs_fsinfo(nfs_filesystem *nfs)
 {
-    GETATTR3args args;
-    GETATTR3res res;
-    fattr3 *info;
-    nfs_fh3 *handle;
-    rt_bool_t result;
+    FSINFO3args args;
+    FSINFO3res res;
 
-    result = RT_FALSE;
-    handle = get_handle(nfs, name);
-    if (handle == NULL)
-        return RT_FALSE;
+    nfs->rsize = nfs_rwsize(0, NFS_RWSIZE_MIN);
+    nfs->wsize = nfs->rsize;
 
-    args.object = *handle;
+    args.fsroot = nfs->root_handle;
 
     memset(&res, '\0', sizeof(res));
 
-    if (nfsproc3_getattr_3(args, &res, nfs->nfs_client) != RPC_SUCCESS)
+    if ((nfsproc3_fsinfo_3(args, &res, nfs->nfs_client) != RPC_SUCCESS) ||
+        res.status != NFS3_OK)
     {
-        rt_kprintf("GetAttr failed\n");
-
-        return RT_FALSE;
+        rt_kprintf("FsInfo failed, using %d bytes READ/WRITE\n", nfs->rsize);
     }
-    else if (res.status != NFS3_OK)
+    else
     {
-        rt_kprintf("Getattr failed: %d\n", res.status);
+        FSINFO3resok *info = &res.FSINFO3res_u.resok;
 
-        return RT_FALSE;
+        nfs->rsize = nfs_rwsize(info->rtpref, info->rtmax);
+        nfs->wsize = nfs_rwsize(info->wtpref, info->wtmax);
     }
 
-    info = &res.GETATTR3res_u.resok.obj_attributes;
+    xdr_free((xdrproc_t)xdr_FSINFO3res, (char *)&res);
+}
 
-    if (info->type == NFS3DIR)
-        result = RT_TRUE;
+rt_bool_t nfs_is_directory(nfs_filesystem *nfs, const char *name)
+{
+    struct nfs_attr *attr;
 
-    xdr_free((xdrproc_t)xdr_GETATTR3res, (char *)&res);
-    xdr_free((xdrproc_t)xdr_nfs_fh3, (char *)handle);
-    rt_free(handle);
+    attr = nfs_getattr(nfs, name, RT_FALSE);
+    if (attr == NULL)
+        return RT_FALSE;
 
-    return result;
+    return (attr->type == NFS3DIR) ? RT_TRUE : RT_FALSE;
 }
 
 int nfs_create(nfs_filesystem *nfs, const char *name, mode_t mode)
@@ -348,6 +494,7 @@ int nfs_create(nfs_filesystem *nfs, const char *name, mode_t mode)
     {
         return -1;
     }
+    nfs_attr_invalidate(nfs, name);
     args.where.dir = *handle;
     args.where.name = strrchr(name, '/') + 1;
     if (args.where.name == NULL)
@@ -396,6 +543,7 @@ int nfs_mkdir(nfs_filesystem *nfs, const char *name, mode_t mode)
     handle = get_dir_handle(nfs, name);
     if (handle == NULL)
         return -1;
+    nfs_attr_invalidate(nfs, name);
 
     args.where.dir = *handle;
     args.where.name = strrchr(name, '/') + 1;
@@ -475,6 +623,7 @@ int nfs_mount(struct dfs_filesystem *fs, unsigned long rwflag, const void *data)
     copy_handle(&nfs->current_handle, &nfs->root_handle);
 
     nfs->nfs_client->cl_auth = authnone_create();
+    nfs_fsinfo(nfs);
     fs->data = nfs;
 
     return 0;
@@ -540,6 +689,7 @@ int nfs_unmount(struct dfs_filesystem *fs)
         nfs->mount_client = NULL;
     }
 
+    nfs_attr_invalidate(nfs, NULL);
     rt_free(nfs);
     fs->data = NULL;
 
@@ -551,13 +701,105 @@ int nfs_ioctl(struct dfs_fd *file, int cmd, void *args)
     return -ENOSYS;
 }
 
-int nfs_read(struct dfs_fd *file, void *buf, size_t count)
+/* READ3res into the buffer preset in data, which holds data_len bytes */
+static bool_t xdr_nfs_read_res(XDR *xdrs, READ3res *objp)
+{
+    READ3resok *resok = &objp->READ3res_u.resok;
+    unsigned int maxsize = resok->data.data_len;
+
+    if (!xdr_nfsstat3(xdrs, &objp->status))
+        return (FALSE);
+    if (objp->status != NFS3_OK)
+        return xdr_READ3resfail(xdrs, &objp->READ3res_u.resfail);
+
+    if (!xdr_post_op_attr(xdrs, &resok->file_attributes))
+        return (FALSE);
+    if (!xdr_count3(xdrs, &resok->count))
+        return (FALSE);
+    if (!xdr_bool(xdrs, &resok->eof))
+        return (FALSE);
+
+    return xdr_bytes(xdrs, (char **)&resok->data.data_val, (unsigned int *)&resok->data.data_len, maxsize);
+}
+
+struct nfs_read_slot
 {
     READ3args args;
     READ3res res;
+};
+
+/*
+ * Read num blocks of rsize bytes at offset into buf, the READ calls are
+ * in flight together. Returns the bytes read in one piece from offset,
+ * or -1 on failure.
+ */
+static int nfs_read_window(nfs_filesystem *nfs, nfs_file *fd, size_t offset, int num, char *buf, bool_t *eof)
+{
+    struct nfs_read_slot *slot;
+    int index, total = 0;
+
+    slot = rt_malloc(sizeof(struct nfs_read_slot) * num);
+    if (slot == NULL)
+        return -1;
+
+    for (index = 0; index < num; index ++)
+    {
+        slot[index].args.file = fd->handle;
+        slot[index].args.offset = offset + index * nfs->rsize;
+        slot[index].args.count = nfs->rsize;
+
+        memset(&slot[index].res, 0, sizeof(READ3res));
+        slot[index].res.READ3res_u.resok.data.data_val = buf + index * nfs->rsize;
+        slot[index].res.READ3res_u.resok.data.data_len = nfs->rsize;
+    }
+
+    nfs->read_calls += num;
+    if (clntudp_call_window(nfs->nfs_client, NFSPROC3_READ,
+                            (xdrproc_t)xdr_READ3args, (char *)&slot[0].args, sizeof(struct nfs_read_slot),
+                            (xdrproc_t)xdr_nfs_read_res, (char *)&slot[0].res, sizeof(struct nfs_read_slot),
+                            num, &nfs->retrans) != RPC_SUCCESS)
+    {
+        rt_kprintf("Read failed\n");
+        total = -1;
+    }
+    else
+    {
+        for (index = 0; index < num; index ++)
+        {
+            READ3resok *resok = &slot[index].res.READ3res_u.resok;
+
+            if (slot[index].res.status != NFS3_OK)
+            {
+                rt_kprintf("Read failed: %d\n", slot[index].res.status);
+                if (total == 0)
+                    total = -1;
+                break;
+            }
+
+            total += resok->data.data_len;
+            if (resok->eof)
+            {
+                *eof = TRUE;
+                break;
+            }
+            /* a short read leaves a gap before the next block */
+            if (resok->data.data_len < nfs->rsize)
+                break;
+        }
+    }
+
+    rt_free(slot);
+
+    return total;
+}
+
+int nfs_read(struct dfs_fd *file, void *buf, size_t count)
+{
     ssize_t bytes, total = 0;
     nfs_file *fd;
     nfs_filesystem *nfs;
+    bool_t eof;
+    int num;
 
     if (file->type == FT_DIRECTORY)
         return -EISDIR;
@@ -572,62 +814,91 @@ int nfs_read(struct dfs_fd *file, void *buf, size_t count)
     if (nfs->nfs_client == NULL)
         return -1;
 
-    /* end of file */
-    if (fd->eof == TRUE)
-        return 0;
+    if (fd->ra_buf == NULL)
+    {
+        fd->ra_buf = rt_malloc(nfs->rsize * RT_NFS_RPC_WINDOW);
+        if (fd->ra_buf == NULL)
+            return -ENOMEM;
+    }
 
-    args.file = fd->handle;
-    do
+    if (fd->offset >= fd->ra_offset && fd->offset < fd->ra_offset + fd->ra_len &&
+        count <= fd->ra_offset + fd->ra_len - fd->offset)
     {
-        args.offset = fd->offset;
-        args.count = count > DFS_NFS_MAX_MTU ? DFS_NFS_MAX_MTU : count;
-        count -= args.count;
+        nfs->ra_hits ++;
+    }
 
-        memset(&res, 0, sizeof(res));
-        if (nfsproc3_read_3(args, &res, nfs->nfs_client) != RPC_SUCCESS)
+    while (count > 0)
+    {
+        /* take what the read-ahead buffer holds */
+        if (fd->offset >= fd->ra_offset && fd->offset < fd->ra_offset + fd->ra_len)
         {
-            rt_kprintf("Read failed\n");
-            total = 0;
-            break;
+            bytes = fd->ra_offset + fd->ra_len - fd->offset;
+            if (bytes > count)
+                bytes = count;
+
+            memcpy(buf, fd->ra_buf + (fd->offset - fd->ra_offset), bytes);
+            buf = (void *)((char *)buf + bytes);
+            count -= bytes;
+            total += bytes;
+            fd->offset += bytes;
+            continue;
         }
-        else if (res.status != NFS3_OK)
-        {
-            rt_kprintf("Read failed: %d\n", res.status);
-            total = 0;
+
+        /* end of file */
+        if (fd->eof == TRUE && fd->offset == fd->ra_offset + fd->ra_len)
             break;
+
+        /* a sequential read fills the window, a random one reads what it needs */
+        if (fd->offset == fd->ra_offset + fd->ra_len)
+        {
+            num = RT_NFS_RPC_WINDOW;
         }
         else
         {
-            bytes = res.READ3res_u.resok.count;
-            total += bytes;
-            fd->offset += bytes;
-            /* update current position */
-            file->pos = fd->offset;
-            memcpy(buf, res.READ3res_u.resok.data.data_val, bytes);
-            buf = (void *)((char *)buf + args.count);
-            if (res.READ3res_u.resok.eof)
-            {
-                /* something should probably be here */
-                fd->eof = TRUE;
-                break;
-            }
+            num = (count + nfs->rsize - 1) / nfs->rsize;
+            if (num > RT_NFS_RPC_WINDOW)
+                num = RT_NFS_RPC_WINDOW;
         }
-        xdr_free((xdrproc_t)xdr_READ3res, (char *)&res);
+
+        eof = FALSE;
+        bytes = nfs_read_window(nfs, fd, fd->offset, num, fd->ra_buf, &eof);
+        if (bytes < 0)
+        {
+            fd->ra_len = 0;
+            fd->eof = FALSE;
+            if (total == 0)
+                total = -EIO;
+            break;
+        }
+
+        fd->ra_offset = fd->offset;
+        fd->ra_len = bytes;
+        fd->eof = eof;
+        if (bytes == 0)
+            break;
     }
-    while (count > 0);
 
-    xdr_free((xdrproc_t)xdr_READ3res, (char *)&res);
+    /* update current position */
+    file->pos = fd->offset;
 
     return total;
 }
 
-int nfs_write(struct dfs_fd *file, const void *buf, size_t count)
+struct nfs_write_slot
 {
     WRITE3args args;
     WRITE3res res;
+};
+
+int nfs_write(struct dfs_fd *file, const void *buf, size_t count)
+{
+    struct nfs_write_slot *slot;
     ssize_t bytes, total = 0;
     nfs_file *fd;
     nfs_filesystem *nfs;
+    size_t offset;
+    int index, num;
+    rt_bool_t done = RT_FALSE;
 
     if (file->type == FT_DIRECTORY)
         return -EISDIR;
@@ -641,48 +912,80 @@ int nfs_write(struct dfs_fd *file, const void *buf, size_t count)
     if (nfs->nfs_client == NULL)
         return -1;
 
-    args.file = fd->handle;
-    args.stable = FILE_SYNC;
-
-    do
-    {
-        args.offset = fd->offset;
+    slot = rt_malloc(sizeof(struct nfs_write_slot) * RT_NFS_RPC_WINDOW);
+    if (slot == NULL)
+        return -ENOMEM;
 
-        memset(&res, 0, sizeof(res));
-        args.data.data_val = (void *)buf;
-        args.count = count > DFS_NFS_MAX_MTU ? DFS_NFS_MAX_MTU : count;
-        args.data.data_len = args.count;
-        count -= args.count;
-        buf = (const void *)((char *)buf + args.count);
+    /* the read-ahead data and the cached attributes are stale now */
+    fd->ra_len = 0;
+    fd->eof = FALSE;
+    nfs_attr_invalidate(nfs, file->path);
 
-        if (nfsproc3_write_3(args, &res, nfs->nfs_client) != RPC_SUCCESS)
+    while (count > 0 && done == RT_FALSE)
+    {
+        offset = fd->offset;
+        for (num = 0; num < RT_NFS_RPC_WINDOW && count > 0; num ++)
         {
-            rt_kprintf("Write failed\n");
-            total = 0;
-            break;
+            slot[num].args.file = fd->handle;
+            slot[num].args.offset = offset;
+            slot[num].args.stable = FILE_SYNC;
+            slot[num].args.count = count > nfs->wsize ? nfs->wsize : count;
+            slot[num].args.data.data_val = (void *)buf;
+            slot[num].args.data.data_len = slot[num].args.count;
+            memset(&slot[num].res, 0, sizeof(WRITE3res));
+
+            offset += slot[num].args.count;
+            count -= slot[num].args.count;
+            buf = (const void *)((char *)buf + slot[num].args.count);
         }
-        else if (res.status != NFS3_OK)
+
+        nfs->write_calls += num;
+        if (clntudp_call_window(nfs->nfs_client, NFSPROC3_WRITE,
+                                (xdrproc_t)xdr_WRITE3args, (char *)&slot[0].args, sizeof(struct nfs_write_slot),
+                                (xdrproc_t)xdr_WRITE3res, (char *)&slot[0].res, sizeof(struct nfs_write_slot),
+                                num, &nfs->retrans) != RPC_SUCCESS)
         {
-            rt_kprintf("Write failed: %d\n", res.status);
-            total = 0;
+            /* the writes of this window are not confirmed, nothing of it is counted */
+            rt_kprintf("Write failed\n");
+            for (index = 0; index < num; index ++)
+                xdr_free((xdrproc_t)xdr_WRITE3res, (char *)&slot[index].res);
+            done = RT_TRUE;
             break;
         }
-        else
+
+        /* the file is written up to the first failed or short write */
+        for (index = 0; index < num; index ++)
         {
-            bytes = res.WRITE3res_u.resok.count;
-            fd->offset += bytes;
-            total += bytes;
-            /* update current position */
-            file->pos = fd->offset;
-            /* update file size */
-            if (fd->size < fd->offset) fd->size = fd->offset;
-            file->size = fd->size;
+            if (done == RT_FALSE)
+            {
+                if (slot[index].res.status != NFS3_OK)
+                {
+                    rt_kprintf("Write failed: %d\n", slot[index].res.status);
+                    done = RT_TRUE;
+                }
+                else
+                {
+                    bytes = slot[index].res.WRITE3res_u.resok.count;
+                    fd->offset += bytes;
+                    total += bytes;
+                    if (bytes < slot[index].args.count)
+                        done = RT_TRUE;
+                }
+            }
+            xdr_free((xdrproc_t)xdr_WRITE3res, (char *)&slot[index].res);
         }
-        xdr_free((xdrproc_t)xdr_WRITE3res, (char *)&res);
     }
-    while (count > 0);
 
-    xdr_free((xdrproc_t)xdr_WRITE3res, (char *)&res);
+    rt_free(slot);
+
+    /* update current position */
+    file->pos = fd->offset;
+    /* update file size */
+    if (fd->size < fd->offset) fd->size = fd->offset;
+    file->size = fd->size;
+
+    if (total == 0 && (count > 0 || done == RT_TRUE))
+        return -EIO;
 
     return total;
 }
@@ -734,6 +1037,8 @@ int nfs_close(struct dfs_fd *file)
         fd = (struct nfs_file *)nfs->data;
 
         xdr_free((xdrproc_t)xdr_nfs_fh3, (char *)&fd->handle);
+        if (fd->ra_buf != NULL)
+            rt_free(fd->ra_buf);
         rt_free(fd);
     }
 
@@ -767,7 +1072,7 @@ int nfs_open(struct dfs_fd *file)
     else
     {
         nfs_file *fp;
-        nfs_fh3 *handle;
+        struct nfs_attr *attr;
 
         /* create file */
         if (file->flags & O_CREAT)
@@ -781,8 +1086,9 @@ int nfs_open(struct dfs_fd *file)
         if (fp == NULL)
             return -ENOMEM;
 
-        handle = get_handle(nfs, file->path);
-        if (handle == NULL)
+        /* the handle may come from the cache, the size is fetched again */
+        attr = nfs_getattr(nfs, file->path, RT_TRUE);
+        if (attr == NULL)
         {
             rt_free(fp);
 
@@ -790,13 +1096,14 @@ int nfs_open(struct dfs_fd *file)
         }
 
         /* get size of file */
-        fp->size = nfs_get_filesize(nfs, handle);
+        fp->size = attr->size;
         fp->offset = 0;
         fp->eof = FALSE;
+        fp->ra_buf = NULL;
+        fp->ra_offset = 0;
+        fp->ra_len = 0;
 
-        copy_handle(&fp->handle, handle);
-        xdr_free((xdrproc_t)xdr_nfs_fh3, (char *)handle);
-        rt_free(handle);
+        copy_handle(&fp->handle, &attr->handle);
 
         if (file->flags & O_APPEND)
         {
@@ -813,52 +1120,28 @@ int nfs_open(struct dfs_fd *file)
 
 int nfs_stat(struct dfs_filesystem *fs, const char *path, struct stat *st)
 {
-    GETATTR3args args;
-    GETATTR3res res;
-    fattr3 *info;
-    nfs_fh3 *handle;
+    struct nfs_attr *attr;
     nfs_filesystem *nfs;
 
     RT_ASSERT(fs != NULL);
     RT_ASSERT(fs->data != NULL);
     nfs = (nfs_filesystem *)fs->data;
 
-    handle = get_handle(nfs, path);
-    if (handle == NULL)
+    attr = nfs_getattr(nfs, path, RT_FALSE);
+    if (attr == NULL)
         return -1;
 
-    args.object = *handle;
-
-    memset(&res, '\0', sizeof(res));
-
-    if (nfsproc3_getattr_3(args, &res, nfs->nfs_client) != RPC_SUCCESS)
-    {
-        rt_kprintf("GetAttr failed\n");
-        return -1;
-    }
-    else if (res.status != NFS3_OK)
-    {
-        rt_kprintf("Getattr failed: %d\n", res.status);
-        return -1;
-    }
-
-    info = &res.GETATTR3res_u.resok.obj_attributes;
-
     st->st_dev = 0;
 
     st->st_mode = S_IFREG | S_IRUSR | S_IRGRP | S_IROTH | S_IWUSR | S_IWGRP | S_IWOTH;
-    if (info->type == NFS3DIR)
+    if (attr->type == NFS3DIR)
     {
         st->st_mode &= ~S_IFREG;
         st->st_mode |= S_IFDIR | S_IXUSR | S_IXGRP | S_IXOTH;
     }
 
-    st->st_size  = info->size;
-    st->st_mtime = info->mtime.seconds;
-
-    xdr_free((xdrproc_t)xdr_GETATTR3res, (char *)&res);
-    xdr_free((xdrproc_t)xdr_nfs_fh3, (char *)handle);
-    rt_free(handle);
+    st->st_size  = attr->size;
+    st->st_mtime = attr->mtime;
 
     return 0;
 }
@@ -866,7 +1149,7 @@ int nfs_stat(struct dfs_filesystem *fs, const char *path, struct stat *st)
 nfs_dir *nfs_opendir(nfs_filesystem *nfs, const char *path)
 {
     nfs_dir *dir;
-    nfs_fh3 *handle;
+    struct nfs_attr *attr;
 
     dir = rt_malloc(sizeof(nfs_dir));
     if (dir == NULL)
@@ -874,16 +1157,14 @@ nfs_dir *nfs_opendir(nfs_filesystem *nfs, const char *path)
         return NULL;
     }
 
-    handle = get_handle(nfs, path);
-    if (handle == NULL)
+    attr = nfs_getattr(nfs, path, RT_FALSE);
+    if (attr == NULL)
     {
         rt_free(dir);
         return NULL;
     }
 
-    copy_handle(&dir->handle, handle);
-    xdr_free((xdrproc_t)xdr_nfs_fh3, (char *)handle);
-    rt_free(handle);
+    copy_handle(&dir->handle, &attr->handle);
 
     dir->cookie = 0;
     memset(&dir->cookieverf, '\0', sizeof(cookieverf3));
@@ -944,13 +1225,17 @@ char *nfs_readdir(nfs_filesystem *nfs, nfs_dir *dir)
 int nfs_unlink(struct dfs_filesystem *fs, const char *path)
 {
     int ret = 0;
+    rt_bool_t is_directory;
     nfs_filesystem *nfs;
 
     RT_ASSERT(fs != NULL);
     RT_ASSERT(fs->data != NULL);
     nfs = (nfs_filesystem *)fs->data;
 
-    if (nfs_is_directory(nfs, path) == RT_FALSE)
+    is_directory = nfs_is_directory(nfs, path);
+    nfs_attr_invalidate(nfs, path);
+
+    if (is_directory == RT_FALSE)
     {
         /* remove file */
         REMOVE3args args;
@@ -1052,6 +1337,9 @@ int nfs_rename(struct dfs_filesystem *fs, const char *src, const char *dest)
     if (args.from.name == NULL)
         args.from.name = (char *)src;
 
+    /* a renamed directory moves the paths below it */
+    nfs_attr_invalidate(nfs, NULL);
+
     args.to.dir = *dHandle;
     args.to.name = strrchr(src, '/') + 1;
     if (args.to.name == NULL)
@@ -1156,6 +1444,36 @@ static const struct dfs_filesystem_ops _nfs =
     nfs_rename,
 };
 
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <dfs_private.h>
+
+void nfsstat(void)
+{
+    struct dfs_filesystem *iter;
+    nfs_filesystem *nfs;
+
+    dfs_lock();
+    for (iter = &filesystem_table[0];
+            iter < &filesystem_table[DFS_FILESYSTEMS_MAX]; iter++)
+    {
+        if (iter->ops != &_nfs || iter->data == NULL)
+            continue;
+
+        nfs = (nfs_filesystem *)iter->data;
+        rt_kprintf("%s on %s:%s\n", iter->path, nfs->host, nfs->export);
+        rt_kprintf("  rsize %d, wsize %d, window %d, attribute timeout %d ms\n",
+                   nfs->rsize, nfs->wsize, RT_NFS_RPC_WINDOW, RT_NFS_ATTR_TIMEOUT);
+        rt_kprintf("  read calls %u, write calls %u, retransmits %u, read-ahead hits %u\n",
+                   nfs->read_calls, nfs->write_calls, nfs->retrans, nfs->ra_hits);
+        rt_kprintf("  attribute cache hits %u, misses %u\n",
+                   nfs->attr_hits, nfs->attr_misses);
+    }
+    dfs_unlock();
+}
+FINSH_FUNCTION_EXPORT(nfsstat, show NFS client statistics);
+#endif
+
 int nfs_init(void)
 {
     /* register nfs file system */
@@ -0,0 +1,945 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * Self test of the NFS client against a stand-in server on the loopback
+ * interface. The server answers the portmapper, MOUNT and the NFSv3 calls of
+ * the client from a RAM directory of a few files, all on the port 111. It
+ * holds back one READ/WRITE reply until the next one is sent, so a window of
+ * calls gets its replies out of order, and drops calls on request to make the
+ * client retransmit.
+ *
+ * The test is the utest case components.dfs.nfs: utest_run components.dfs.nfs
+ */
+
+#include <rtthread.h>
+
+#ifdef RT_NFS_USING_TEST
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <dfs_fs.h>
+
+#include <rpc/rpc.h>
+#include <rpc/pmap.h>
+#include <utest.h>
+
+#include "mount.h"
+#include "nfs.h"
+
+#ifndef RT_NFS_MAX_RWSIZE
+#define RT_NFS_MAX_RWSIZE   1024
+#endif
+#ifndef RT_NFS_RPC_WINDOW
+#define RT_NFS_RPC_WINDOW   4
+#endif
+#ifndef RT_NFS_ATTR_TIMEOUT
+#define RT_NFS_ATTR_TIMEOUT 3000
+#endif
+
+#define NFS_TEST_MOUNT          "/nfs_test"
+#define NFS_TEST_EXPORT         "127.0.0.1:/test"
+#define NFS_TEST_FILE           "test.bin"
+
+#define NFS_TEST_FILES          4
+#define NFS_TEST_NAME_MAX       16
+#define NFS_TEST_FILE_MAX       (64 * 1024)
+/* the file of the test, a multiple of every READ/WRITE size */
+#define NFS_TEST_SIZE           (32 * 1024)
+/* size of the reads of the application, below the READ size */
+#define NFS_TEST_CHUNK          512
+
+/* sizes offered in FSINFO */
+#define NFS_TEST_RWMAX          8192
+#define NFS_TEST_RWPREF         2048
+
+#define NFS_TEST_BUF_SIZE       UDPMSGSIZE
+/* a held reply is sent alone when no other call comes in this time */
+#define NFS_TEST_HOLD_MS        20
+#define NFS_TEST_STACK_SIZE     2048
+
+#define NFS_TEST_AUTH_NONE      0
+#define NFS_TEST_ROOT_ID        1
+
+struct nfs_test_file
+{
+    char name[NFS_TEST_NAME_MAX];
+    rt_uint8_t *data;                   /* NULL for a free entry */
+    rt_uint32_t size;
+};
+
+struct nfs_test_server
+{
+    int sock;
+    rt_thread_t thread;
+    volatile rt_bool_t stop;
+    struct rt_semaphore done;
+
+    struct nfs_test_file files[NFS_TEST_FILES];
+    rt_uint32_t mtime;
+
+    /* behaviour, set by the test */
+    volatile rt_bool_t reorder;         /* hold a READ/WRITE reply for the next one */
+    volatile rt_uint32_t drop;          /* READ/WRITE calls to leave without reply */
+
+    /* what the server saw */
+    rt_uint32_t calls[NFSPROC3_COMMIT + 1];
+    rt_uint32_t dropped;
+    rt_uint32_t reordered;
+    rt_uint32_t max_read;
+    rt_uint32_t max_write;
+
+    rt_uint8_t in[NFS_TEST_BUF_SIZE];
+    rt_uint8_t out[NFS_TEST_BUF_SIZE];
+    rt_uint8_t held[NFS_TEST_BUF_SIZE];
+    int held_len;
+    struct sockaddr_in held_to;
+};
+
+/* XDR stream on a message buffer, an overrun sets err */
+struct nfs_test_xdr
+{
+    rt_uint8_t *buf;
+    rt_uint32_t pos;
+    rt_uint32_t len;
+    rt_bool_t err;
+};
+
+static rt_uint32_t nfs_test_get(struct nfs_test_xdr *x)
+{
+    rt_uint32_t v;
+
+    if (x->pos + 4 > x->len)
+    {
+        x->err = RT_TRUE;
+        return 0;
+    }
+    v = ((rt_uint32_t)x->buf[x->pos] << 24) | ((rt_uint32_t)x->buf[x->pos + 1] << 16) |
+        ((rt_uint32_t)x->buf[x->pos + 2] << 8) | x->buf[x->pos + 3];
+    x->pos += 4;
+
+    return v;
+}
+
+static rt_uint64_t nfs_test_get_hyper(struct nfs_test_xdr *x)
+{
+    rt_uint64_t v = (rt_uint64_t)nfs_test_get(x) << 32;
+
+    return v | nfs_test_get(x);
+}
+
+/* variable length opaque data, the result points into the message */
+static const rt_uint8_t *nfs_test_get_opaque(struct nfs_test_xdr *x, rt_uint32_t *len)
+{
+    const rt_uint8_t *data;
+
+    *len = nfs_test_get(x);
+    if (x->err || *len > x->len - x->pos)
+    {
+        x->err = RT_TRUE;
+        *len = 0;
+        return RT_NULL;
+    }
+    data = &x->buf[x->pos];
+    x->pos += (*len + 3) & ~3UL;
+    if (x->pos > x->len)
+    {
+        x->err = RT_TRUE;
+    }
+
+    return data;
+}
+
+static void nfs_test_put(struct nfs_test_xdr *x, rt_uint32_t v)
+{
+    if (x->pos + 4 > x->len)
+    {
+        x->err = RT_TRUE;
+        return;
+    }
+    x->buf[x->pos] = v >> 24;
+    x->buf[x->pos + 1] = v >> 16;
+    x->buf[x->pos + 2] = v >> 8;
+    x->buf[x->pos + 3] = v;
+    x->pos += 4;
+}
+
+static void nfs_test_put_hyper(struct nfs_test_xdr *x, rt_uint64_t v)
+{
+    nfs_test_put(x, (rt_uint32_t)(v >> 32));
+    nfs_test_put(x, (rt_uint32_t)v);
+}
+
+static void nfs_test_put_opaque(struct nfs_test_xdr *x, const void *data, rt_uint32_t len)
+{
+    rt_uint32_t padded = (len + 3) & ~3UL;
+
+    nfs_test_put(x, len);
+    if (x->err || padded > x->len - x->pos)
+    {
+        x->err = RT_TRUE;
+        return;
+    }
+    rt_memcpy(&x->buf[x->pos], data, len);
+    rt_memset(&x->buf[x->pos + len], 0, padded - len);
+    x->pos += padded;
+}
+
+/* =============== stand-in server =============== */
+
+/* the handle is the id: NFS_TEST_ROOT_ID for the directory, the file entry after it */
+static struct nfs_test_file *nfs_test_file_of(struct nfs_test_server *srv, rt_uint32_t id)
+{
+    if (id <= NFS_TEST_ROOT_ID || id > NFS_TEST_ROOT_ID + NFS_TEST_FILES)
+    {
+        return RT_NULL;
+    }
+
+    return (srv->files[id - NFS_TEST_ROOT_ID - 1].data != RT_NULL) ? &srv->files[id - NFS_TEST_ROOT_ID - 1] : RT_NULL;
+}
+
+/* the id of a valid handle, 0 otherwise */
+static rt_uint32_t nfs_test_get_fh(struct nfs_test_server *srv, struct nfs_test_xdr *in)
+{
+    const rt_uint8_t *fh;
+    rt_uint32_t len, id;
+
+    fh = nfs_test_get_opaque(in, &len);
+    if (fh == RT_NULL || len != 4)
+    {
+        return 0;
+    }
+    id = ((rt_uint32_t)fh[0] << 24) | ((rt_uint32_t)fh[1] << 16) | ((rt_uint32_t)fh[2] << 8) | fh[3];
+
+    return (id == NFS_TEST_ROOT_ID || nfs_test_file_of(srv, id) != RT_NULL) ? id : 0;
+}
+
+static void nfs_test_put_fh(struct nfs_test_xdr *out, rt_uint32_t id)
+{
+    rt_uint8_t fh[4] = { id >> 24, id >> 16, id >> 8, id };
+
+    nfs_test_put_opaque(out, fh, sizeof(fh));
+}
+
+static void nfs_test_put_fattr(struct nfs_test_server *srv, struct nfs_test_xdr *out, rt_uint32_t id)
+{
+    struct nfs_test_file *file = nfs_test_file_of(srv, id);
+    rt_uint32_t size = file ? file->size : 0;
+    int i;
+
+    nfs_test_put(out, file ? NFS3REG : NFS3DIR);
+    nfs_test_put(out, file ? 0644 : 0755);
+    nfs_test_put(out, file ? 1 : 2);
+    nfs_test_put(out, 0);
+    nfs_test_put(out, 0);
+    nfs_test_put_hyper(out, size);
+    nfs_test_put_hyper(out, size);
+    nfs_test_put(out, 0);
+    nfs_test_put(out, 0);
+    nfs_test_put_hyper(out, 1);
+    nfs_test_put_hyper(out, id);
+    /* atime, mtime and ctime */
+    for (i = 0; i < 3; i++)
+    {
+        nfs_test_put(out, srv->mtime);
+        nfs_test_put(out, 0);
+    }
+}
+
+/* post_op_attr */
+static void nfs_test_put_attr(struct nfs_test_server *srv, struct nfs_test_xdr *out, rt_uint32_t id)
+{
+    nfs_test_put(out, TRUE);
+    nfs_test_put_fattr(srv, out, id);
+}
+
+/* wcc_data without attributes */
+static void nfs_test_put_wcc(struct nfs_test_xdr *out)
+{
+    nfs_test_put(out, FALSE);
+    nfs_test_put(out, FALSE);
+}
+
+static struct nfs_test_file *nfs_test_lookup(struct nfs_test_server *srv, const rt_uint8_t *name, rt_uint32_t len)
+{
+    int i;
+
+    for (i = 0; i < NFS_TEST_FILES; i++)
+    {
+        if (srv->files[i].data != RT_NULL && rt_strlen(srv->files[i].name) == len &&
+                rt_memcmp(srv->files[i].name, name, len) == 0)
+        {
+            return &srv->files[i];
+        }
+    }
+
+    return RT_NULL;
+}
+
+static rt_uint32_t nfs_test_id_of(struct nfs_test_server *srv, struct nfs_test_file *file)
+{
+    return NFS_TEST_ROOT_ID + 1 + (rt_uint32_t)(file - &srv->files[0]);
+}
+
+static int nfs_test_nfs(struct nfs_test_server *srv, rt_uint32_t proc, struct nfs_test_xdr *in, struct nfs_test_xdr *out)
+{
+    struct nfs_test_file *file;
+    const rt_uint8_t *name, *data;
+    rt_uint32_t id, dir, len, count;
+    rt_uint64_t offset;
+    int i;
+
+    if (proc > NFSPROC3_COMMIT)
+    {
+        return PROC_UNAVAIL;
+    }
+    srv->calls[proc]++;
+
+    switch (proc)
+    {
+    case NFSPROC3_NULL:
+        break;
+
+    case NFSPROC3_GETATTR:
+        id = nfs_test_get_fh(srv, in);
+        if (id == 0)
+        {
+            nfs_test_put(out, NFS3ERR_STALE);
+            break;
+        }
+        nfs_test_put(out, NFS3_OK);
+        nfs_test_put_fattr(srv, out, id);
+        break;
+
+    case NFSPROC3_LOOKUP:
+        dir = nfs_test_get_fh(srv, in);
+        name = nfs_test_get_opaque(in, &len);
+        file = (dir == NFS_TEST_ROOT_ID && name) ? nfs_test_lookup(srv, name, len) : RT_NULL;
+        if (file == RT_NULL)
+        {
+            nfs_test_put(out, (dir == NFS_TEST_ROOT_ID) ? NFS3ERR_NOENT : NFS3ERR_STALE);
+            nfs_test_put(out, FALSE);
+            break;
+        }
+        id = nfs_test_id_of(srv, file);
+        nfs_test_put(out, NFS3_OK);
+        nfs_test_put_fh(out, id);
+        nfs_test_put_attr(srv, out, id);
+        nfs_test_put_attr(srv, out, NFS_TEST_ROOT_ID);
+        break;
+
+    case NFSPROC3_CREATE:
+        dir = nfs_test_get_fh(srv, in);
+        name = nfs_test_get_opaque(in, &len);
+        if (dir != NFS_TEST_ROOT_ID || name == RT_NULL || len == 0 || len >= NFS_TEST_NAME_MAX)
+        {
+            nfs_test_put(out, (dir != NFS_TEST_ROOT_ID) ? NFS3ERR_STALE : NFS3ERR_NAMETOOLONG);
+            nfs_test_put_wcc(out);
+            break;
+        }
+        /* the attributes to set are ignored */
+        file = nfs_test_lookup(srv, name, len);
+        if (file != RT_NULL)
+        {
+            nfs_test_put(out, NFS3ERR_EXIST);
+            nfs_test_put_wcc(out);
+            break;
+        }
+        for (i = 0; i < NFS_TEST_FILES && srv->files[i].data != RT_NULL; i++);
+        if (i == NFS_TEST_FILES || (srv->files[i].data = rt_malloc(NFS_TEST_FILE_MAX)) == RT_NULL)
+        {
+            nfs_test_put(out, NFS3ERR_NOSPC);
+            nfs_test_put_wcc(out);
+            break;
+        }
+        file = &srv->files[i];
+        rt_memcpy(file->name, name, len);
+        file->name[len] = '\0';
+        file->size = 0;
+        id = nfs_test_id_of(srv, file);
+        nfs_test_put(out, NFS3_OK);
+        nfs_test_put(out, TRUE);
+        nfs_test_put_fh(out, id);
+        nfs_test_put_attr(srv, out, id);
+        nfs_test_put_wcc(out);
+        break;
+
+    case NFSPROC3_WRITE:
+        file = nfs_test_file_of(srv, nfs_test_get_fh(srv, in));
+        offset = nfs_test_get_hyper(in);
+        count = nfs_test_get(in);
+        nfs_test_get(in);
+        data = nfs_test_get_opaque(in, &len);
+        if (count > srv->max_write)
+        {
+            srv->max_write = count;
+        }
+        if (file == RT_NULL || data == RT_NULL || offset + len > NFS_TEST_FILE_MAX)
+        {
+            nfs_test_put(out, (file == RT_NULL) ? NFS3ERR_STALE : NFS3ERR_NOSPC);
+            nfs_test_put_wcc(out);
+            break;
+        }
+        if (offset > file->size)
+        {
+            rt_memset(file->data + file->size, 0, (rt_size_t)offset - file->size);
+        }
+        rt_memcpy(file->data + offset, data, len);
+        if (offset + len > file->size)
+        {
+            file->size = (rt_uint32_t)offset + len;
+        }
+        srv->mtime++;
+        nfs_test_put(out, NFS3_OK);
+        nfs_test_put_wcc(out);
+        nfs_test_put(out, len);
+        nfs_test_put(out, FILE_SYNC);
+        nfs_test_put_hyper(out, 0);
+        break;
+
+    case NFSPROC3_READ:
+        id = nfs_test_get_fh(srv, in);
+        file = nfs_test_file_of(srv, id);
+        offset = nfs_test_get_hyper(in);
+        count = nfs_test_get(in);
+        if (count > srv->max_read)
+        {
+            srv->max_read = count;
+        }
+        if (file == RT_NULL)
+        {
+            nfs_test_put(out, NFS3ERR_STALE);
+            nfs_test_put(out, FALSE);
+            break;
+        }
+        if (count > NFS_TEST_RWMAX)
+        {
+            count = NFS_TEST_RWMAX;
+        }
+        len = (offset >= file->size) ? 0 : file->size - (rt_uint32_t)offset;
+        if (len > count)
+        {
+            len = count;
+        }
+        nfs_test_put(out, NFS3_OK);
+        nfs_test_put_attr(srv, out, id);
+        nfs_test_put(out, len);
+        nfs_test_put(out, (offset + len >= file->size) ? TRUE : FALSE);
+        nfs_test_put_opaque(out, file->data + (rt_size_t)(len ? offset : 0), len);
+        break;
+
+    case NFSPROC3_REMOVE:
+        dir = nfs_test_get_fh(srv, in);
+        name = nfs_test_get_opaque(in, &len);
+        file = (dir == NFS_TEST_ROOT_ID && name) ? nfs_test_lookup(srv, name, len) : RT_NULL;
+        if (file == RT_NULL)
+        {
+            nfs_test_put(out, (dir == NFS_TEST_ROOT_ID) ? NFS3ERR_NOENT : NFS3ERR_STALE);
+            nfs_test_put_wcc(out);
+            break;
+        }
+        rt_free(file->data);
+        file->data = RT_NULL;
+        nfs_test_put(out, NFS3_OK);
+        nfs_test_put_wcc(out);
+        break;
+
+    case NFSPROC3_FSINFO:
+        id = nfs_test_get_fh(srv, in);
+        if (id == 0)
+        {
+            nfs_test_put(out, NFS3ERR_STALE);
+            nfs_test_put(out, FALSE);
+            break;
+        }
+        nfs_test_put(out, NFS3_OK);
+        nfs_test_put_attr(srv, out, id);
+        nfs_test_put(out, NFS_TEST_RWMAX);
+        nfs_test_put(out, NFS_TEST_RWPREF);
+        nfs_test_put(out, 512);
+        nfs_test_put(out, NFS_TEST_RWMAX);
+        nfs_test_put(out, NFS_TEST_RWPREF);
+        nfs_test_put(out, 512);
+        nfs_test_put(out, 1024);
+        nfs_test_put_hyper(out, NFS_TEST_FILE_MAX);
+        nfs_test_put(out, 1);
+        nfs_test_put(out, 0);
+        nfs_test_put(out, 0);
+        break;
+
+    default:
+        return PROC_UNAVAIL;
+    }
+
+    return SUCCESS;
+}
+
+static int nfs_test_mount(struct nfs_test_server *srv, rt_uint32_t proc, struct nfs_test_xdr *in, struct nfs_test_xdr *out)
+{
+    rt_uint32_t len;
+
+    switch (proc)
+    {
+    case MOUNTPROC3_NULL:
+    case MOUNTPROC3_UMNT:
+        nfs_test_get_opaque(in, &len);
+        break;
+
+    case MOUNTPROC3_MNT:
+        /* every export path is the RAM directory */
+        nfs_test_get_opaque(in, &len);
+        nfs_test_put(out, MNT3_OK);
+        nfs_test_put_fh(out, NFS_TEST_ROOT_ID);
+        nfs_test_put(out, 1);
+        nfs_test_put(out, NFS_TEST_AUTH_NONE);
+        break;
+
+    default:
+        return PROC_UNAVAIL;
+    }
+
+    return SUCCESS;
+}
+
+static void nfs_test_send(struct nfs_test_server *srv, const void *buf, int len, struct sockaddr_in *to)
+{
+    sendto(srv->sock, buf, len, 0, (struct sockaddr *)to, sizeof(struct sockaddr_in));
+}
+
+/* the held reply goes out alone */
+static void nfs_test_flush(struct nfs_test_server *srv)
+{
+    if (srv->held_len > 0)
+    {
+        nfs_test_send(srv, srv->held, srv->held_len, &srv->held_to);
+        srv->held_len = 0;
+    }
+}
+
+static void nfs_test_dispatch(struct nfs_test_server *srv, int len, struct sockaddr_in *from)
+{
+    struct nfs_test_xdr in = { srv->in, 0, (rt_uint32_t)len, RT_FALSE };
+    struct nfs_test_xdr out = { srv->out, 0, NFS_TEST_BUF_SIZE, RT_FALSE };
+    rt_uint32_t xid, prog, vers, proc, stat_pos, skip;
+    rt_bool_t pipelined;
+    int accept;
+
+    xid = nfs_test_get(&in);
+    if (nfs_test_get(&in) != CALL || nfs_test_get(&in) != RPC_MSG_VERSION)
+    {
+        return;
+    }
+    prog = nfs_test_get(&in);
+    vers = nfs_test_get(&in);
+    proc = nfs_test_get(&in);
+    /* credential and verifier */
+    nfs_test_get(&in);
+    nfs_test_get_opaque(&in, &skip);
+    nfs_test_get(&in);
+    nfs_test_get_opaque(&in, &skip);
+    if (in.err)
+    {
+        return;
+    }
+
+    pipelined = (prog == NFS_PROGRAM && (proc == NFSPROC3_READ || proc == NFSPROC3_WRITE));
+    if (pipelined && srv->drop > 0)
+    {
+        srv->drop--;
+        srv->dropped++;
+        return;
+    }
+
+    nfs_test_put(&out, xid);
+    nfs_test_put(&out, REPLY);
+    nfs_test_put(&out, MSG_ACCEPTED);
+    nfs_test_put(&out, NFS_TEST_AUTH_NONE);
+    nfs_test_put(&out, 0);
+    stat_pos = out.pos;
+    nfs_test_put(&out, SUCCESS);
+
+    if (prog == PMAPPROG && vers == PMAPVERS && proc == PMAPPROC_GETPORT)
+    {
+        /* every program is served on this port */
+        accept = SUCCESS;
+        nfs_test_put(&out, PMAPPORT);
+    }
+    else if (prog == MOUNT_PROGRAM && vers == MOUNT_V3)
+    {
+        accept = nfs_test_mount(srv, proc, &in, &out);
+    }
+    else if (prog == NFS_PROGRAM && vers == NFS_V3)
+    {
+        accept = nfs_test_nfs(srv, proc, &in, &out);
+    }
+    else
+    {
+        accept = PROG_UNAVAIL;
+    }
+    if (accept == SUCCESS && in.err)
+    {
+        accept = GARBAGE_ARGS;
+    }
+    if (accept != SUCCESS || out.err)
+    {
+        out.err = RT_FALSE;
+        out.pos = stat_pos;
+        nfs_test_put(&out, (accept != SUCCESS) ? accept : SYSTEM_ERR);
+    }
+
+    if (pipelined && srv->reorder)
+    {
+        if (srv->held_len == 0)
+        {
+            rt_memcpy(srv->held, out.buf, out.pos);
+            srv->held_len = out.pos;
+            srv->held_to = *from;
+            return;
+        }
+        /* this reply overtakes the held one */
+        nfs_test_send(srv, out.buf, out.pos, from);
+        nfs_test_flush(srv);
+        srv->reordered++;
+        return;
+    }
+
+    nfs_test_flush(srv);
+    nfs_test_send(srv, out.buf, out.pos, from);
+}
+
+static void nfs_test_server_entry(void *parameter)
+{
+    struct nfs_test_server *srv = (struct nfs_test_server *)parameter;
+    struct sockaddr_in from;
+    socklen_t fromlen;
+    int len;
+
+    while (!srv->stop)
+    {
+        fromlen = sizeof(from);
+        len = recvfrom(srv->sock, srv->in, NFS_TEST_BUF_SIZE, 0, (struct sockaddr *)&from, &fromlen);
+        if (len < 0)
+        {
+            nfs_test_flush(srv);
+            continue;
+        }
+        nfs_test_dispatch(srv, len, &from);
+    }
+
+    nfs_test_flush(srv);
+    rt_sem_release(&srv->done);
+}
+
+static struct nfs_test_server *nfs_test_server_start(void)
+{
+    struct nfs_test_server *srv;
+    struct sockaddr_in addr;
+    int timeout = NFS_TEST_HOLD_MS;
+
+    srv = rt_calloc(1, sizeof(struct nfs_test_server));
+    if (srv == RT_NULL)
+    {
+        rt_kprintf("no memory for the stand-in server\n");
+        return RT_NULL;
+    }
+    srv->mtime = 1;
+
+    srv->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (srv->sock < 0)
+    {
+        rt_kprintf("create socket error\n");
+        rt_free(srv);
+        return RT_NULL;
+    }
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PMAPPORT);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (bind(srv->sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        rt_kprintf("port %d of 127.0.0.1 is in use\n", PMAPPORT);
+        lwip_close(srv->sock);
+        rt_free(srv);
+        return RT_NULL;
+    }
+    setsockopt(srv->sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    rt_sem_init(&srv->done, "nfs_srv", 0, RT_IPC_FLAG_FIFO);
+    /* the same priority as the test, the client and the server take turns */
+    srv->thread = rt_thread_create("nfs_srv", nfs_test_server_entry, srv, NFS_TEST_STACK_SIZE,
+                                   rt_thread_self()->current_priority, 10);
+    if (srv->thread == RT_NULL)
+    {
+        rt_kprintf("create thread error\n");
+        rt_sem_detach(&srv->done);
+        lwip_close(srv->sock);
+        rt_free(srv);
+        return RT_NULL;
+    }
+    rt_thread_startup(srv->thread);
+
+    return srv;
+}
+
+static void nfs_test_server_stop(struct nfs_test_server *srv)
+{
+    int i;
+
+    srv->stop = RT_TRUE;
+    rt_sem_take(&srv->done, RT_WAITING_FOREVER);
+    rt_sem_detach(&srv->done);
+    lwip_close(srv->sock);
+
+    for (i = 0; i < NFS_TEST_FILES; i++)
+    {
+        if (srv->files[i].data != RT_NULL)
+        {
+            rt_free(srv->files[i].data);
+        }
+    }
+    rt_free(srv);
+}
+
+/* =============== client test =============== */
+
+static struct nfs_test_server *nfs_test_srv;
+static rt_uint8_t *nfs_test_buf;
+static rt_uint32_t nfs_test_rwsize;
+static rt_uint32_t nfs_test_blocks;
+
+#define NFS_TEST_PATH   NFS_TEST_MOUNT "/" NFS_TEST_FILE
+
+static void nfs_test_fill(rt_uint8_t *buf, rt_uint32_t offset, rt_uint32_t len, rt_uint8_t seed)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = (rt_uint8_t)((offset + i) * 31 + (offset + i) / 251 + seed);
+    }
+}
+
+static int nfs_test_match(const rt_uint8_t *buf, rt_uint32_t offset, rt_uint32_t len, rt_uint8_t seed)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] != (rt_uint8_t)((offset + i) * 31 + (offset + i) / 251 + seed))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static struct nfs_test_file *nfs_test_server_file(void)
+{
+    return nfs_test_lookup(nfs_test_srv, (const rt_uint8_t *)NFS_TEST_FILE, rt_strlen(NFS_TEST_FILE));
+}
+
+/* a window of WRITE calls, the replies come back out of order */
+static void nfs_test_write_window(void)
+{
+    struct nfs_test_server *srv = nfs_test_srv;
+    struct nfs_test_file *file;
+    rt_uint32_t calls;
+    int fd, len = -1;
+
+    srv->reorder = RT_TRUE;
+    calls = srv->calls[NFSPROC3_WRITE];
+    nfs_test_fill(nfs_test_buf, 0, NFS_TEST_SIZE, 1);
+    fd = open(NFS_TEST_PATH, O_WRONLY | O_CREAT);
+    if (fd >= 0)
+    {
+        len = write(fd, nfs_test_buf, NFS_TEST_SIZE);
+        close(fd);
+    }
+    uassert_int_equal(len, NFS_TEST_SIZE);
+
+    file = nfs_test_server_file();
+    uassert_not_null(file);
+    if (file != RT_NULL)
+    {
+        uassert_int_equal(file->size, NFS_TEST_SIZE);
+        uassert_buf_equal(file->data, nfs_test_buf, NFS_TEST_SIZE);
+    }
+    uassert_int_equal(srv->max_write, nfs_test_rwsize);
+    uassert_int_equal(srv->calls[NFSPROC3_WRITE] - calls, nfs_test_blocks);
+    if (RT_NFS_RPC_WINDOW > 1)
+    {
+        uassert_true(srv->reordered > 0);
+    }
+}
+
+/* small sequential reads are served by the read-ahead windows, then one read away from them */
+static void nfs_test_read_ahead(void)
+{
+    struct nfs_test_server *srv = nfs_test_srv;
+    rt_uint32_t calls, off;
+    rt_uint8_t byte;
+    int fd;
+
+    calls = srv->calls[NFSPROC3_READ];
+    rt_memset(nfs_test_buf, 0, NFS_TEST_SIZE);
+    fd = open(NFS_TEST_PATH, O_RDONLY);
+    uassert_true(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    for (off = 0; off < NFS_TEST_SIZE; off += NFS_TEST_CHUNK)
+    {
+        if (read(fd, nfs_test_buf + off, NFS_TEST_CHUNK) != NFS_TEST_CHUNK)
+        {
+            break;
+        }
+    }
+    uassert_int_equal(off, NFS_TEST_SIZE);
+    uassert_int_equal(read(fd, &byte, 1), 0);
+    uassert_true(nfs_test_match(nfs_test_buf, 0, NFS_TEST_SIZE, 1));
+    calls = srv->calls[NFSPROC3_READ] - calls;
+    uassert_in_range(calls, nfs_test_blocks, nfs_test_blocks + RT_NFS_RPC_WINDOW);
+    uassert_int_equal(srv->max_read, nfs_test_rwsize);
+
+    off = NFS_TEST_SIZE / 3 + 7;
+    uassert_int_equal(lseek(fd, off, SEEK_SET), (off_t)off);
+    uassert_int_equal(read(fd, nfs_test_buf, 3000), 3000);
+    uassert_true(nfs_test_match(nfs_test_buf, off, 3000, 1));
+    close(fd);
+}
+
+/* a lost call is sent again after the timeout of the client */
+static void nfs_test_retransmit(void)
+{
+    struct nfs_test_server *srv = nfs_test_srv;
+    struct nfs_test_file *file;
+    rt_uint32_t len = 2 * nfs_test_rwsize, dropped;
+    int fd, ret = -1;
+
+    srv->reorder = RT_FALSE;
+    dropped = srv->dropped;
+    srv->drop = 1;
+    nfs_test_fill(nfs_test_buf, 0, len, 2);
+    fd = open(NFS_TEST_PATH, O_WRONLY);
+    if (fd >= 0)
+    {
+        ret = write(fd, nfs_test_buf, len);
+        close(fd);
+    }
+    uassert_int_equal(ret, len);
+    file = nfs_test_server_file();
+    uassert_true(file != RT_NULL && nfs_test_match(file->data, 0, len, 2) &&
+                 nfs_test_match(file->data + len, len, NFS_TEST_SIZE - len, 1));
+
+    srv->drop = 1;
+    ret = -1;
+    rt_memset(nfs_test_buf, 0, NFS_TEST_SIZE);
+    fd = open(NFS_TEST_PATH, O_RDONLY);
+    if (fd >= 0)
+    {
+        ret = read(fd, nfs_test_buf, len);
+        close(fd);
+    }
+    uassert_int_equal(ret, len);
+    uassert_true(nfs_test_match(nfs_test_buf, 0, len, 2));
+    uassert_int_equal(srv->dropped - dropped, 2);
+}
+
+/* stat() takes the cached attributes until they time out */
+static void nfs_test_attr_cache(void)
+{
+    struct nfs_test_server *srv = nfs_test_srv;
+    struct stat st;
+    rt_uint32_t calls;
+
+    if (RT_NFS_ATTR_TIMEOUT == 0)
+    {
+        return;
+    }
+
+    calls = srv->calls[NFSPROC3_GETATTR];
+    uassert_int_equal(stat(NFS_TEST_PATH, &st), 0);
+    uassert_int_equal(st.st_size, NFS_TEST_SIZE);
+    uassert_int_equal(stat(NFS_TEST_PATH, &st), 0);
+    uassert_true(srv->calls[NFSPROC3_GETATTR] - calls <= 1);
+
+    rt_thread_mdelay(RT_NFS_ATTR_TIMEOUT + 100);
+    calls = srv->calls[NFSPROC3_GETATTR];
+    uassert_int_equal(stat(NFS_TEST_PATH, &st), 0);
+    uassert_int_equal(srv->calls[NFSPROC3_GETATTR] - calls, 1);
+}
+
+static void nfs_test_remove(void)
+{
+    struct stat st;
+
+    uassert_int_equal(unlink(NFS_TEST_PATH), 0);
+    uassert_true(stat(NFS_TEST_PATH, &st) < 0);
+    uassert_null(nfs_test_server_file());
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    nfs_test_buf = rt_malloc(NFS_TEST_SIZE);
+    if (nfs_test_buf == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    nfs_test_srv = nfs_test_server_start();
+    if (nfs_test_srv == RT_NULL)
+    {
+        rt_free(nfs_test_buf);
+        return -RT_ERROR;
+    }
+
+    /* the mount point may exist already */
+    mkdir(NFS_TEST_MOUNT, 0777);
+    if (dfs_mount(RT_NULL, NFS_TEST_MOUNT, "nfs", 0, NFS_TEST_EXPORT) != 0)
+    {
+        rt_kprintf("mount %s on %s failed\n", NFS_TEST_EXPORT, NFS_TEST_MOUNT);
+        nfs_test_server_stop(nfs_test_srv);
+        rt_free(nfs_test_buf);
+        return -RT_ERROR;
+    }
+
+    /* the client takes the smaller of its limit and the preferred size, in whole KB */
+    nfs_test_rwsize = (RT_NFS_MAX_RWSIZE < NFS_TEST_RWPREF) ? RT_NFS_MAX_RWSIZE : NFS_TEST_RWPREF;
+    nfs_test_rwsize &= ~1023UL;
+    nfs_test_blocks = NFS_TEST_SIZE / nfs_test_rwsize;
+
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    int ret = dfs_unmount(NFS_TEST_MOUNT);
+
+    nfs_test_server_stop(nfs_test_srv);
+    rt_free(nfs_test_buf);
+
+    return (ret == 0) ? RT_EOK : -RT_ERROR;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(nfs_test_write_window);
+    UTEST_UNIT_RUN(nfs_test_read_ahead);
+    UTEST_UNIT_RUN(nfs_test_retransmit);
+    UTEST_UNIT_RUN(nfs_test_attr_cache);
+    UTEST_UNIT_RUN(nfs_test_remove);
+}
+UTEST_TC_EXPORT(testcase, "components.dfs.nfs", utest_tc_init, utest_tc_cleanup, 60);
+
+#endif /* RT_NFS_USING_TEST */
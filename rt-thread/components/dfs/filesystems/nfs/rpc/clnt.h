@@ -317,6 +317,14 @@ extern CLIENT *clntudp_bufcreate (struct sockaddr_in *__raddr,
                   struct timeval __wait_resend, int *__sockp,
                   unsigned int __sendsz, unsigned int __recvsz);
 
+/*
+ * Pipelined calls of one procedure on an UDP client, see clnt_udp.c.
+ */
+extern enum clnt_stat clntudp_call_window (CLIENT *__clnt, unsigned long __proc,
+                  xdrproc_t __xargs, char *__args, unsigned int __argsz,
+                  xdrproc_t __xres, char *__res, unsigned int __ressz,
+                  int __num, unsigned int *__retrans);
+
 extern int callrpc (const char *__host, const unsigned long __prognum,
             const unsigned long __versnum, const unsigned long __procnum,
             const xdrproc_t __inproc, const char *__in,
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     RT-Thread    add clntudp_call_window() for pipelined calls
  */
 /* @(#)clnt_udp.c   2.2 88/08/01 4.0 RPCSRC */
 /*
@@ -389,6 +390,165 @@ static bool_t clntudp_control(CLIENT *cl, int request, char *info)
     return (TRUE);
 }
 
+/*
+ * Pipelined calls of one procedure.
+ *
+ * The calls of args[0] .. args[num - 1] (argsz bytes apart) are all sent
+ * before the first reply is awaited, each with its own transaction id. The
+ * replies are matched by transaction id and decoded into results[i]
+ * (resultsz bytes apart) in the order they arrive. On a receive timeout the
+ * calls without reply are sent again, up to CLNTUDP_WINDOW_RETRANS times.
+ * The caller bounds num by the server and socket buffering.
+ */
+#define CLNTUDP_WINDOW_MAX      16
+#define CLNTUDP_WINDOW_RETRANS  3
+
+static bool_t clntudp_encode(CLIENT *cl, uint32_t xid, unsigned long proc,
+    xdrproc_t xargs, char *argsp, int *outlen)
+{
+    register struct cu_data *cu = (struct cu_data *) cl->cl_private;
+    register XDR *xdrs = &(cu->cu_outxdrs);
+
+    xdrs->x_op = XDR_ENCODE;
+    XDR_SETPOS(xdrs, cu->cu_xdrpos);
+    *(uint32_t *) (cu->cu_outbuf) = xid;
+
+    if ((!XDR_PUTLONG(xdrs, (long *) &proc)) ||
+            (!AUTH_MARSHALL(cl->cl_auth, xdrs)) || (!(*xargs) (xdrs, argsp)))
+    {
+        return FALSE;
+    }
+    *outlen = (int) XDR_GETPOS(xdrs);
+
+    return TRUE;
+}
+
+enum clnt_stat clntudp_call_window(CLIENT *cl, unsigned long proc,
+    xdrproc_t xargs, char *args, unsigned int argsz,
+    xdrproc_t xresults, char *results, unsigned int resultsz,
+    int num, unsigned int *retrans)
+{
+    register struct cu_data *cu = (struct cu_data *) cl->cl_private;
+    uint32_t xid[CLNTUDP_WINDOW_MAX];
+    bool_t replied[CLNTUDP_WINDOW_MAX];
+    struct sockaddr_in from;
+    struct rpc_msg reply_msg;
+    XDR reply_xdrs;
+    socklen_t fromlen;
+    int i, inlen, outlen, pending, tries = CLNTUDP_WINDOW_RETRANS;
+    bool_t resend = FALSE;
+
+    if (cl->cl_ops != &udp_ops || num <= 0 || num > CLNTUDP_WINDOW_MAX)
+    {
+        cu->cu_error.re_status = RPC_FAILED;
+        return RPC_FAILED;
+    }
+
+    /* the transaction ids follow the one of the last call */
+    xid[0] = *(uint32_t *) (cu->cu_outbuf) + 1;
+    for (i = 0; i < num; i++)
+    {
+        xid[i] = xid[0] + i;
+        replied[i] = FALSE;
+    }
+    *(uint32_t *) (cu->cu_outbuf) = xid[num - 1];
+
+    pending = num;
+    cu->cu_error.re_status = RPC_SUCCESS;
+
+send_again:
+    for (i = 0; i < num; i++)
+    {
+        if (replied[i])
+            continue;
+
+        if (!clntudp_encode(cl, xid[i], proc, xargs, args + i * argsz, &outlen))
+        {
+            cu->cu_error.re_status = RPC_CANTENCODEARGS;
+            goto out;
+        }
+        if (sendto(cu->cu_sock, cu->cu_outbuf, outlen, 0,
+                   (struct sockaddr *) &(cu->cu_raddr), cu->cu_rlen) != outlen)
+        {
+            cu->cu_error.re_errno = errno;
+            cu->cu_error.re_status = RPC_CANTSEND;
+            goto out;
+        }
+        if (resend && retrans != NULL)
+            (*retrans)++;
+    }
+
+    while (pending > 0)
+    {
+        fromlen = sizeof(struct sockaddr);
+        inlen = recvfrom(cu->cu_sock, cu->cu_inbuf,
+                         (int) cu->cu_recvsz, 0,
+                         (struct sockaddr *) &from, &fromlen);
+        if (inlen < 0 && errno == EINTR)
+            continue;
+
+        if (inlen < 0)
+        {
+            /* timed out, send the calls without reply again */
+            if (tries-- > 0)
+            {
+                resend = TRUE;
+                goto send_again;
+            }
+            cu->cu_error.re_errno = errno;
+            cu->cu_error.re_status = RPC_TIMEDOUT;
+            goto out;
+        }
+        if (inlen < 4)
+            continue;
+
+        /* late replies of retransmitted calls are dropped here */
+        for (i = 0; i < num; i++)
+        {
+            if (!replied[i] && *((uint32_t *) (cu->cu_inbuf)) == xid[i])
+                break;
+        }
+        if (i == num)
+            continue;
+
+        reply_msg.acpted_rply.ar_verf = _null_auth;
+        reply_msg.acpted_rply.ar_results.where = results + i * resultsz;
+        reply_msg.acpted_rply.ar_results.proc = xresults;
+
+        xdrmem_create(&reply_xdrs, cu->cu_inbuf, (unsigned int) inlen, XDR_DECODE);
+        if (!xdr_replymsg(&reply_xdrs, &reply_msg))
+        {
+            cu->cu_error.re_status = RPC_CANTDECODERES;
+            goto out;
+        }
+
+        _seterr_reply(&reply_msg, &(cu->cu_error));
+        if (cu->cu_error.re_status == RPC_SUCCESS &&
+            !AUTH_VALIDATE(cl->cl_auth, &reply_msg.acpted_rply.ar_verf))
+        {
+            cu->cu_error.re_status = RPC_AUTHERROR;
+            cu->cu_error.re_why = AUTH_INVALIDRESP;
+        }
+        if (reply_msg.acpted_rply.ar_verf.oa_base != NULL)
+        {
+            extern bool_t xdr_opaque_auth(XDR *xdrs, struct opaque_auth *ap);
+
+            reply_xdrs.x_op = XDR_FREE;
+            (void) xdr_opaque_auth(&reply_xdrs, &(reply_msg.acpted_rply.ar_verf));
+        }
+        if (cu->cu_error.re_status != RPC_SUCCESS)
+            goto out;
+
+        replied[i] = TRUE;
+        pending--;
+    }
+
+out:
+    /* clntudp_encode() left the id of the last call sent, the next call follows xid[num - 1] */
+    *(uint32_t *) (cu->cu_outbuf) = xid[num - 1];
+    return (enum clnt_stat)(cu->cu_error.re_status);
+}
+
 static void clntudp_destroy(CLIENT *cl)
 {
     register struct cu_data *cu = (struct cu_data *) cl->cl_private;
@@ -68,6 +68,11 @@ int dfs_file_stat(const char *path, struct stat *buf);
 int dfs_file_rename(const char *oldpath, const char *newpath);
 int dfs_file_ftruncate(struct dfs_fd *fd, off_t length);
 
+#ifdef RT_USING_POSIX_EPOLL
+/* drop the closing file from the epoll instances */
+void rt_epoll_fd_close(struct dfs_fd *fd);
+#endif
+
 /* 0x5254 is just a magic number to make these relatively unique ("RT") */
 #define RT_FIOFTRUNCATE 0x52540000U
 
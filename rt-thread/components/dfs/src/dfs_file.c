@@ -129,6 +129,10 @@ int dfs_file_close(struct dfs_fd *fd)
     if (fd == NULL)
         return -ENXIO;
 
+#ifdef RT_USING_POSIX_EPOLL
+    rt_epoll_fd_close(fd);
+#endif
+
     if (fd->fops->close != NULL)
         result = fd->fops->close(fd);
 
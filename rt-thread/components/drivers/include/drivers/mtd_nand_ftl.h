@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef __MTD_NAND_FTL_H__
+#define __MTD_NAND_FTL_H__
+
+#include <rtthread.h>
+#include "drivers/mtd_nand.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* number of log blocks, each one buffers the page updates of one logical block */
+#ifndef RT_MTD_NAND_FTL_LOG_BLOCKS
+#define RT_MTD_NAND_FTL_LOG_BLOCKS      8
+#endif
+
+/* erase count gap between the most and the least worn blocks which moves cold data */
+#ifndef RT_MTD_NAND_FTL_WL_THRESHOLD
+#define RT_MTD_NAND_FTL_WL_THRESHOLD    100
+#endif
+
+#ifndef RT_MTD_NAND_FTL_GC_PRIORITY
+#define RT_MTD_NAND_FTL_GC_PRIORITY     (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+
+/* log block, the pages are appended and the newest copy of a page wins */
+struct rt_mtd_nand_ftl_log
+{
+    rt_uint16_t pblock;             /* physical block, RT_MTD_NAND_FTL_NONE when the slot is unused */
+    rt_uint16_t lblock;             /* logical block */
+    rt_uint16_t next;               /* next free page */
+    rt_uint16_t *pmap;              /* logical page -> page in the log block */
+    rt_uint32_t seq;
+    rt_tick_t   stamp;              /* last use, for LRU replacement */
+};
+
+struct rt_mtd_nand_ftl
+{
+    struct rt_device parent;
+    struct rt_mtd_nand_device *mtd;
+    struct rt_mutex lock;
+
+    rt_uint32_t ppb;                /* pages per block */
+    rt_uint32_t page_size;          /* also the sector size */
+    rt_uint32_t pblocks;            /* physical blocks of the MTD partition */
+    rt_uint32_t lblocks;            /* logical blocks exported */
+
+    /* block mapping, 2 bytes for each logical block */
+    rt_uint16_t *dmap;
+    /* physical block state, sequence and erase counter */
+    rt_uint8_t  *state;
+    rt_uint32_t *seq;
+    rt_uint32_t *erase_cnt;
+
+    struct rt_mtd_nand_ftl_log logs[RT_MTD_NAND_FTL_LOG_BLOCKS];
+    rt_uint32_t next_seq;
+
+    rt_uint8_t *page_buf;
+
+    /* background garbage collection */
+    rt_thread_t gc_thread;
+    struct rt_semaphore gc_sem;
+    volatile rt_bool_t gc_exit;
+    struct rt_semaphore gc_done;
+
+    /* statistics */
+    rt_uint32_t full_merges;
+    rt_uint32_t switch_merges;
+    rt_uint32_t gc_merges;
+    rt_uint32_t erases;
+    rt_uint32_t wl_moves;
+    rt_uint32_t wl_checked;         /* erase counter at the last wear levelling check */
+    rt_uint32_t corrected;          /* pages read with corrected bit-flips */
+    rt_uint32_t lost;               /* uncorrectable pages met by the merge */
+    rt_uint32_t bad_blocks;
+    rt_uint32_t recovered;          /* stale or torn blocks found by the last mount */
+};
+typedef struct rt_mtd_nand_ftl *rt_mtd_nand_ftl_t;
+
+#define RT_MTD_NAND_FTL_NONE        0xFFFF
+
+/**
+ * Mount the FTL on a MTD NAND device and register it as a block device.
+ * One sector is one NAND page.
+ *
+ * @param mtd_name MTD NAND device name
+ * @param ftl_name block device name
+ *
+ * @return the block device, RT_NULL on failure
+ */
+rt_device_t rt_mtd_nand_ftl_create(const char *mtd_name, const char *ftl_name);
+
+/**
+ * Stop the garbage collection and unregister the block device.
+ */
+rt_err_t rt_mtd_nand_ftl_delete(rt_device_t dev);
+
+/**
+ * Drop all logical data, the blocks are erased by the garbage collection.
+ */
+rt_err_t rt_mtd_nand_ftl_format(rt_device_t dev);
+
+/**
+ * Print the mapping and wear statistics.
+ */
+void rt_mtd_nand_ftl_show(rt_device_t dev);
+
+#ifdef RT_MTD_NAND_USING_SIM
+/**
+ * Create a RAM backed NAND which follows the NAND programming rules,
+ * for the FTL tests without real hardware.
+ */
+struct rt_mtd_nand_device *rt_mtd_nand_sim_create(const char *name, rt_uint32_t blocks,
+        rt_uint32_t pages_per_block, rt_uint32_t page_size, rt_uint32_t oob_size);
+
+/**
+ * Lose the power during the ops-th program/erase operation, 0 restores the power.
+ */
+void rt_mtd_nand_sim_powercut(struct rt_mtd_nand_device *device, int ops);
+
+/**
+ * Make a block fail on the next erase or program.
+ */
+void rt_mtd_nand_sim_wear_out(struct rt_mtd_nand_device *device, rt_uint32_t block);
+
+rt_err_t rt_mtd_nand_sim_delete(struct rt_mtd_nand_device *device);
+
+void rt_mtd_nand_sim_stat(struct rt_mtd_nand_device *device, rt_uint32_t *programs, rt_uint32_t *erases);
+#endif /* RT_MTD_NAND_USING_SIM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MTD_NAND_FTL_H__ */
@@ -46,6 +46,9 @@ extern "C" {
 
 #ifdef RT_USING_MTD_NAND
 #include "drivers/mtd_nand.h"
+#ifdef RT_MTD_NAND_USING_FTL
+#include "drivers/mtd_nand_ftl.h"
+#endif /* RT_MTD_NAND_USING_FTL */
 #endif /* RT_USING_MTD_NAND */
 
 #ifdef RT_USING_USB_DEVICE
@@ -0,0 +1,1557 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * NAND flash translation layer, it exports a MTD NAND partition as a block
+ * device with one sector per NAND page.
+ *
+ * The mapping is a hybrid log-block scheme, so the RAM cost is two bytes per
+ * logical block instead of a full page table:
+ *
+ *  - each logical block is mapped to one data block, where page N holds the
+ *    logical page N;
+ *  - a few log blocks take the page updates. The pages are appended in order
+ *    and the newest copy of a logical page wins;
+ *  - a full log block becomes the data block directly when it was written in
+ *    order (switch merge), otherwise the newest pages of the log and the data
+ *    block are copied into a new data block (full merge).
+ *
+ * Every page carries a tag in the free spare bytes: the logical address, a
+ * sequence number taken when the block was allocated, and the erase counter.
+ * Blocks are never reused before they are erased, and the mount picks the
+ * newest complete copy of every logical block, so a power loss at any time
+ * falls back to the last completed write. The blank blocks found by the mount
+ * are erased again before use, an erase which was cut may look blank.
+ *
+ * A low priority thread keeps a few blocks erased, merges idle log blocks
+ * and moves cold data out of the least worn blocks (static wear levelling).
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef RT_MTD_NAND_USING_FTL
+#include <drivers/mtd_nand_ftl.h>
+
+#define DBG_TAG               "mtd.ftl"
+#define DBG_LVL               DBG_INFO
+#include <rtdbg.h>
+
+#define FTL_TAG_MAGIC         0x4C46
+#define FTL_TAG_DATA          0x0D
+#define FTL_TAG_LOG           0x06
+
+#define FTL_ERASE_UNKNOWN     0xFFFFFFFF
+/* retries of a program which failed on a worn block */
+#define FTL_RETRY             3
+/* spare blocks for the bad blocks which grow in the life time, in 1/50 */
+#define FTL_RESERVE(blocks)   (2 + (blocks) / 50)
+
+#define FTL_GC_PERIOD_MS      1000
+/* erased blocks kept ready by the garbage collection */
+#define FTL_GC_FREE_BLOCKS    (RT_MTD_NAND_FTL_LOG_BLOCKS + 2)
+/* a log block unused for this time is merged in the background */
+#define FTL_GC_IDLE_MS        2000
+/* erases between the wear levelling checks */
+#define FTL_WL_INTERVAL       32
+
+enum
+{
+    FTL_BLOCK_FREE = 0,
+    FTL_BLOCK_DIRTY,
+    FTL_BLOCK_DATA,
+    FTL_BLOCK_LOG,
+    FTL_BLOCK_BAD,
+};
+
+enum
+{
+    FTL_TAG_VALID = 0,
+    FTL_TAG_BLANK,
+    FTL_TAG_CORRUPT,
+};
+
+/* the tag in the free spare bytes of every page */
+struct ftl_tag
+{
+    rt_uint16_t magic;
+    rt_uint8_t  type;
+    rt_uint8_t  reserved;
+    rt_uint16_t lblock;
+    rt_uint16_t lpage;
+    rt_uint32_t seq;
+    rt_uint32_t erase_cnt;
+    rt_uint16_t crc;
+    rt_uint16_t pad;
+};
+
+/* the crc covers the fields before it */
+#define FTL_TAG_CRC_LEN       (sizeof(struct ftl_tag) - 2 * sizeof(rt_uint16_t))
+
+static rt_uint16_t ftl_crc16(const rt_uint8_t *buf, rt_uint32_t len)
+{
+    rt_uint16_t crc = 0xFFFF;
+    int i;
+
+    while (len--)
+    {
+        crc ^= (rt_uint16_t)(*buf++) << 8;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+static int ftl_tag_check(const struct ftl_tag *tag)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)tag;
+    rt_uint32_t i;
+
+    for (i = 0; i < sizeof(struct ftl_tag); i++)
+    {
+        if (p[i] != 0xFF)
+        {
+            break;
+        }
+    }
+    if (i == sizeof(struct ftl_tag))
+    {
+        return FTL_TAG_BLANK;
+    }
+
+    if (tag->magic != FTL_TAG_MAGIC || tag->crc != ftl_crc16(p, FTL_TAG_CRC_LEN))
+    {
+        return FTL_TAG_CORRUPT;
+    }
+
+    return FTL_TAG_VALID;
+}
+
+static rt_bool_t ftl_is_blank(const rt_uint8_t *buf, rt_uint32_t len)
+{
+    while (len--)
+    {
+        if (*buf++ != 0xFF)
+        {
+            return RT_FALSE;
+        }
+    }
+
+    return RT_TRUE;
+}
+
+rt_inline rt_off_t ftl_page(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock, rt_uint32_t page)
+{
+    return (rt_off_t)(ftl->mtd->block_start + pblock) * ftl->ppb + page;
+}
+
+static rt_err_t ftl_read_page(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock, rt_uint32_t page,
+                              void *buf, struct ftl_tag *tag)
+{
+    rt_err_t result;
+
+    result = rt_mtd_nand_read(ftl->mtd, ftl_page(ftl, pblock, page),
+                              buf, buf ? ftl->page_size : 0,
+                              (rt_uint8_t *)tag, tag ? sizeof(struct ftl_tag) : 0);
+    if (result == -RT_MTD_EECC_CORRECT)
+    {
+        ftl->corrected++;
+        result = RT_EOK;
+    }
+
+    return result;
+}
+
+static rt_err_t ftl_write_page(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock, rt_uint32_t page,
+                               const void *buf, rt_uint8_t type, rt_uint32_t lblock, rt_uint32_t lpage)
+{
+    struct ftl_tag tag;
+
+    rt_memset(&tag, 0xFF, sizeof(tag));
+    tag.magic     = FTL_TAG_MAGIC;
+    tag.type      = type;
+    tag.lblock    = lblock;
+    tag.lpage     = lpage;
+    tag.seq       = ftl->seq[pblock];
+    tag.erase_cnt = ftl->erase_cnt[pblock];
+    tag.crc       = ftl_crc16((const rt_uint8_t *)&tag, FTL_TAG_CRC_LEN);
+
+    return rt_mtd_nand_write(ftl->mtd, ftl_page(ftl, pblock, page),
+                             buf, ftl->page_size, (const rt_uint8_t *)&tag, sizeof(tag));
+}
+
+static void ftl_mark_bad(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock)
+{
+    LOG_W("%s: block %d is worn out.", ftl->parent.parent.name, ftl->mtd->block_start + pblock);
+
+    rt_mtd_nand_mark_badblock(ftl->mtd, ftl->mtd->block_start + pblock);
+    ftl->state[pblock] = FTL_BLOCK_BAD;
+    ftl->bad_blocks++;
+}
+
+static rt_err_t ftl_erase(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock)
+{
+    if (rt_mtd_nand_erase_block(ftl->mtd, ftl->mtd->block_start + pblock) != RT_EOK)
+    {
+        ftl_mark_bad(ftl, pblock);
+        return -RT_EIO;
+    }
+
+    ftl->state[pblock] = FTL_BLOCK_FREE;
+    ftl->seq[pblock] = 0;
+    ftl->erase_cnt[pblock]++;
+    ftl->erases++;
+
+    return RT_EOK;
+}
+
+/* a block is given back, the garbage collection erases it */
+static void ftl_release(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock)
+{
+    ftl->state[pblock] = FTL_BLOCK_DIRTY;
+    if (ftl->gc_thread)
+    {
+        rt_sem_release(&ftl->gc_sem);
+    }
+}
+
+/* the least worn free block, an erase is done in place when there is no free one */
+static rt_uint32_t ftl_alloc(struct rt_mtd_nand_ftl *ftl)
+{
+    rt_uint32_t i, free_blk, dirty_blk;
+    int retry;
+
+    for (retry = 0; retry <= FTL_RETRY; retry++)
+    {
+        free_blk = dirty_blk = RT_MTD_NAND_FTL_NONE;
+        for (i = 0; i < ftl->pblocks; i++)
+        {
+            if (ftl->state[i] == FTL_BLOCK_FREE)
+            {
+                if (free_blk == RT_MTD_NAND_FTL_NONE || ftl->erase_cnt[i] < ftl->erase_cnt[free_blk])
+                {
+                    free_blk = i;
+                }
+            }
+            else if (ftl->state[i] == FTL_BLOCK_DIRTY)
+            {
+                if (dirty_blk == RT_MTD_NAND_FTL_NONE || ftl->erase_cnt[i] < ftl->erase_cnt[dirty_blk])
+                {
+                    dirty_blk = i;
+                }
+            }
+        }
+
+        if (free_blk != RT_MTD_NAND_FTL_NONE)
+        {
+            ftl->seq[free_blk] = ftl->next_seq++;
+            return free_blk;
+        }
+        if (dirty_blk == RT_MTD_NAND_FTL_NONE)
+        {
+            LOG_E("%s: no free block.", ftl->parent.parent.name);
+            return RT_MTD_NAND_FTL_NONE;
+        }
+        /* a failed erase retires the block, then try the next one */
+        ftl_erase(ftl, dirty_blk);
+    }
+
+    return RT_MTD_NAND_FTL_NONE;
+}
+
+static void ftl_log_reset(struct rt_mtd_nand_ftl *ftl, struct rt_mtd_nand_ftl_log *log)
+{
+    log->pblock = RT_MTD_NAND_FTL_NONE;
+    log->lblock = RT_MTD_NAND_FTL_NONE;
+    log->next = 0;
+    log->seq = 0;
+    rt_memset(log->pmap, 0xFF, ftl->ppb * sizeof(rt_uint16_t));
+}
+
+static struct rt_mtd_nand_ftl_log *ftl_find_log(struct rt_mtd_nand_ftl *ftl, rt_uint32_t lblock)
+{
+    int i;
+
+    for (i = 0; i < RT_MTD_NAND_FTL_LOG_BLOCKS; i++)
+    {
+        if (ftl->logs[i].pblock != RT_MTD_NAND_FTL_NONE && ftl->logs[i].lblock == lblock)
+        {
+            return &ftl->logs[i];
+        }
+    }
+
+    return RT_NULL;
+}
+
+static struct rt_mtd_nand_ftl_log *ftl_lru_log(struct rt_mtd_nand_ftl *ftl)
+{
+    struct rt_mtd_nand_ftl_log *lru = RT_NULL;
+    int i;
+
+    for (i = 0; i < RT_MTD_NAND_FTL_LOG_BLOCKS; i++)
+    {
+        if (ftl->logs[i].pblock == RT_MTD_NAND_FTL_NONE)
+        {
+            continue;
+        }
+        if (lru == RT_NULL || (rt_int32_t)(ftl->logs[i].stamp - lru->stamp) < 0)
+        {
+            lru = &ftl->logs[i];
+        }
+    }
+
+    return lru;
+}
+
+/* page N of the log block holds logical page N, the log block can be the data block */
+static rt_bool_t ftl_log_in_order(struct rt_mtd_nand_ftl *ftl, struct rt_mtd_nand_ftl_log *log)
+{
+    rt_uint32_t i;
+
+    if (log->next < ftl->ppb)
+    {
+        return RT_FALSE;
+    }
+    for (i = 0; i < ftl->ppb; i++)
+    {
+        if (log->pmap[i] != i)
+        {
+            return RT_FALSE;
+        }
+    }
+
+    return RT_TRUE;
+}
+
+/**
+ * Write the newest copy of every page of a logical block into one data block.
+ *
+ * @param log the log block of the logical block, RT_NULL for none
+ * @param dst the destination block, RT_MTD_NAND_FTL_NONE to allocate one
+ */
+static rt_err_t ftl_merge(struct rt_mtd_nand_ftl *ftl, rt_uint32_t lblock,
+                          struct rt_mtd_nand_ftl_log *log, rt_uint32_t dst)
+{
+    rt_uint32_t old = ftl->dmap[lblock];
+    rt_uint32_t i, src_blk, src_page;
+    int retry;
+
+    if (log && dst == RT_MTD_NAND_FTL_NONE && ftl_log_in_order(ftl, log))
+    {
+        /* switch merge, nothing to copy */
+        ftl->dmap[lblock] = log->pblock;
+        ftl->state[log->pblock] = FTL_BLOCK_DATA;
+        if (old != RT_MTD_NAND_FTL_NONE)
+        {
+            ftl_release(ftl, old);
+        }
+        ftl_log_reset(ftl, log);
+        ftl->switch_merges++;
+        return RT_EOK;
+    }
+
+    for (retry = 0; retry < FTL_RETRY; retry++)
+    {
+        if (dst == RT_MTD_NAND_FTL_NONE)
+        {
+            dst = ftl_alloc(ftl);
+            if (dst == RT_MTD_NAND_FTL_NONE)
+            {
+                return -RT_EFULL;
+            }
+        }
+        else
+        {
+            ftl->seq[dst] = ftl->next_seq++;
+        }
+        ftl->state[dst] = FTL_BLOCK_DATA;
+
+        for (i = 0; i < ftl->ppb; i++)
+        {
+            if (log && log->pmap[i] != RT_MTD_NAND_FTL_NONE)
+            {
+                src_blk = log->pblock;
+                src_page = log->pmap[i];
+            }
+            else
+            {
+                src_blk = old;
+                src_page = i;
+            }
+
+            if (src_blk == RT_MTD_NAND_FTL_NONE)
+            {
+                rt_memset(ftl->page_buf, 0xFF, ftl->page_size);
+            }
+            else if (ftl_read_page(ftl, src_blk, src_page, ftl->page_buf, RT_NULL) != RT_EOK)
+            {
+                /* keep what was read, dropping the whole logical block is worse */
+                LOG_E("%s: lost logical page %d:%d.", ftl->parent.parent.name, lblock, i);
+                ftl->lost++;
+            }
+
+            /* the last page is written last, it tells the block is complete */
+            if (ftl_write_page(ftl, dst, i, ftl->page_buf, FTL_TAG_DATA, lblock, i) != RT_EOK)
+            {
+                break;
+            }
+        }
+
+        if (i == ftl->ppb)
+        {
+            break;
+        }
+        ftl_mark_bad(ftl, dst);
+        dst = RT_MTD_NAND_FTL_NONE;
+    }
+
+    if (retry == FTL_RETRY)
+    {
+        return -RT_EIO;
+    }
+
+    ftl->dmap[lblock] = dst;
+    if (old != RT_MTD_NAND_FTL_NONE)
+    {
+        ftl_release(ftl, old);
+    }
+    if (log)
+    {
+        ftl_release(ftl, log->pblock);
+        ftl_log_reset(ftl, log);
+    }
+    ftl->full_merges++;
+
+    return RT_EOK;
+}
+
+static struct rt_mtd_nand_ftl_log *ftl_get_slot(struct rt_mtd_nand_ftl *ftl)
+{
+    int i;
+
+    for (i = 0; i < RT_MTD_NAND_FTL_LOG_BLOCKS; i++)
+    {
+        if (ftl->logs[i].pblock == RT_MTD_NAND_FTL_NONE)
+        {
+            return &ftl->logs[i];
+        }
+    }
+
+    return RT_NULL;
+}
+
+/* take a log block for the logical block, the least recently used one is merged when all are busy */
+static struct rt_mtd_nand_ftl_log *ftl_get_log(struct rt_mtd_nand_ftl *ftl, rt_uint32_t lblock)
+{
+    struct rt_mtd_nand_ftl_log *log;
+    rt_uint32_t pblock;
+
+    log = ftl_get_slot(ftl);
+    if (log == RT_NULL)
+    {
+        log = ftl_lru_log(ftl);
+        if (ftl_merge(ftl, log->lblock, log, RT_MTD_NAND_FTL_NONE) != RT_EOK)
+        {
+            return RT_NULL;
+        }
+    }
+
+    pblock = ftl_alloc(ftl);
+    if (pblock == RT_MTD_NAND_FTL_NONE)
+    {
+        return RT_NULL;
+    }
+    ftl->state[pblock] = FTL_BLOCK_LOG;
+
+    log->pblock = pblock;
+    log->lblock = lblock;
+    log->seq = ftl->seq[pblock];
+    log->next = 0;
+    log->stamp = rt_tick_get();
+
+    return log;
+}
+
+static rt_err_t ftl_write_sector(struct rt_mtd_nand_ftl *ftl, rt_uint32_t sector, const void *buf)
+{
+    struct rt_mtd_nand_ftl_log *log;
+    rt_uint32_t lblock = sector / ftl->ppb, lpage = sector % ftl->ppb;
+    rt_uint32_t worn;
+    rt_err_t result;
+    int retry;
+
+    for (retry = 0; retry < FTL_RETRY; retry++)
+    {
+        log = ftl_find_log(ftl, lblock);
+        if (log && log->next >= ftl->ppb)
+        {
+            result = ftl_merge(ftl, lblock, log, RT_MTD_NAND_FTL_NONE);
+            if (result != RT_EOK)
+            {
+                return result;
+            }
+            log = RT_NULL;
+        }
+        if (log == RT_NULL)
+        {
+            log = ftl_get_log(ftl, lblock);
+            if (log == RT_NULL)
+            {
+                return -RT_EFULL;
+            }
+        }
+
+        if (ftl_write_page(ftl, log->pblock, log->next, buf, FTL_TAG_LOG, lblock, lpage) == RT_EOK)
+        {
+            log->pmap[lpage] = log->next++;
+            log->stamp = rt_tick_get();
+            return RT_EOK;
+        }
+
+        /* save the pages written before into a data block, then retire the log block */
+        worn = log->pblock;
+        result = ftl_merge(ftl, lblock, log, RT_MTD_NAND_FTL_NONE);
+        if (result != RT_EOK)
+        {
+            return result;
+        }
+        ftl_mark_bad(ftl, worn);
+    }
+
+    return -RT_EIO;
+}
+
+static rt_err_t ftl_read_sector(struct rt_mtd_nand_ftl *ftl, rt_uint32_t sector, void *buf)
+{
+    struct rt_mtd_nand_ftl_log *log;
+    rt_uint32_t lblock = sector / ftl->ppb, lpage = sector % ftl->ppb;
+
+    log = ftl_find_log(ftl, lblock);
+    if (log && log->pmap[lpage] != RT_MTD_NAND_FTL_NONE)
+    {
+        return ftl_read_page(ftl, log->pblock, log->pmap[lpage], buf, RT_NULL);
+    }
+    if (ftl->dmap[lblock] != RT_MTD_NAND_FTL_NONE)
+    {
+        return ftl_read_page(ftl, ftl->dmap[lblock], lpage, buf, RT_NULL);
+    }
+
+    /* never written */
+    rt_memset(buf, 0xFF, ftl->page_size);
+
+    return RT_EOK;
+}
+
+/**
+ * Rebuild the page map of a log block. The scan stops at the first blank page,
+ * a torn page is skipped because it can not be programmed again.
+ */
+static void ftl_scan_log(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock, rt_uint16_t *pmap, rt_uint16_t *next)
+{
+    struct ftl_tag tag;
+    rt_uint32_t page;
+    int state;
+
+    rt_memset(pmap, 0xFF, ftl->ppb * sizeof(rt_uint16_t));
+    *next = 0;
+
+    for (page = 0; page < ftl->ppb; page++)
+    {
+        if (ftl_read_page(ftl, pblock, page, RT_NULL, &tag) != RT_EOK)
+        {
+            *next = page + 1;
+            continue;
+        }
+
+        state = ftl_tag_check(&tag);
+        if (state == FTL_TAG_BLANK)
+        {
+            if (ftl_read_page(ftl, pblock, page, ftl->page_buf, RT_NULL) == RT_EOK
+                    && ftl_is_blank(ftl->page_buf, ftl->page_size))
+            {
+                break;
+            }
+            /* the power was lost while the page was programmed */
+            *next = page + 1;
+        }
+        else if (state == FTL_TAG_VALID && tag.type == FTL_TAG_LOG && tag.seq == ftl->seq[pblock]
+                 && tag.lpage < ftl->ppb)
+        {
+            pmap[tag.lpage] = page;
+            *next = page + 1;
+        }
+        else
+        {
+            *next = page + 1;
+        }
+    }
+}
+
+/* classify the block by the tags of its first and last pages */
+static void ftl_scan_block(struct rt_mtd_nand_ftl *ftl, rt_uint32_t pblock, rt_uint16_t *owner,
+                           struct rt_mtd_nand_ftl_log *scratch)
+{
+    struct ftl_tag tag, last;
+    int state;
+
+    if (rt_mtd_nand_check_block(ftl->mtd, ftl->mtd->block_start + pblock) != RT_EOK)
+    {
+        ftl->state[pblock] = FTL_BLOCK_BAD;
+        ftl->bad_blocks++;
+        return;
+    }
+
+    if (ftl_read_page(ftl, pblock, 0, RT_NULL, &tag) != RT_EOK)
+    {
+        ftl->state[pblock] = FTL_BLOCK_DIRTY;
+        return;
+    }
+
+    state = ftl_tag_check(&tag);
+    if (state == FTL_TAG_BLANK)
+    {
+        /*
+         * The block may hold a program or an erase which was cut, it is erased
+         * again before use.
+         */
+        ftl->state[pblock] = FTL_BLOCK_DIRTY;
+        return;
+    }
+    if (state == FTL_TAG_CORRUPT || tag.lblock >= ftl->lblocks || tag.seq == 0)
+    {
+        ftl->state[pblock] = FTL_BLOCK_DIRTY;
+        ftl->recovered++;
+        return;
+    }
+
+    ftl->erase_cnt[pblock] = tag.erase_cnt;
+    ftl->seq[pblock] = tag.seq;
+    owner[pblock] = tag.lblock;
+    if (tag.seq >= ftl->next_seq)
+    {
+        ftl->next_seq = tag.seq + 1;
+    }
+
+    if (tag.type == FTL_TAG_DATA)
+    {
+        /* a merge writes the pages in order, the block is complete when the last page is there */
+        if (ftl_read_page(ftl, pblock, ftl->ppb - 1, RT_NULL, &last) == RT_EOK
+                && ftl_tag_check(&last) == FTL_TAG_VALID && last.type == FTL_TAG_DATA
+                && last.seq == tag.seq && last.lpage == ftl->ppb - 1)
+        {
+            ftl->state[pblock] = FTL_BLOCK_DATA;
+        }
+        else
+        {
+            ftl->state[pblock] = FTL_BLOCK_DIRTY;
+            ftl->recovered++;
+        }
+    }
+    else if (tag.type == FTL_TAG_LOG)
+    {
+        /* a log block written in order was switched to a data block */
+        ftl_scan_log(ftl, pblock, scratch->pmap, &scratch->next);
+        ftl->state[pblock] = ftl_log_in_order(ftl, scratch) ? FTL_BLOCK_DATA : FTL_BLOCK_LOG;
+    }
+    else
+    {
+        ftl->state[pblock] = FTL_BLOCK_DIRTY;
+        ftl->recovered++;
+    }
+}
+
+static rt_err_t ftl_mount(struct rt_mtd_nand_ftl *ftl)
+{
+    struct rt_mtd_nand_ftl_log scratch, *log;
+    rt_uint16_t *owner;
+    rt_uint32_t pb, lb, cur, known = 0;
+    rt_uint64_t sum = 0;
+    rt_err_t result = RT_EOK;
+
+    owner = rt_malloc(ftl->pblocks * sizeof(rt_uint16_t));
+    scratch.pmap = rt_malloc(ftl->ppb * sizeof(rt_uint16_t));
+    if (owner == RT_NULL || scratch.pmap == RT_NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    ftl->next_seq = 1;
+    rt_memset(ftl->dmap, 0xFF, ftl->lblocks * sizeof(rt_uint16_t));
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        owner[pb] = RT_MTD_NAND_FTL_NONE;
+        ftl->seq[pb] = 0;
+        ftl->erase_cnt[pb] = FTL_ERASE_UNKNOWN;
+        ftl_scan_block(ftl, pb, owner, &scratch);
+    }
+
+    /* the data block with the highest sequence wins */
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        if (ftl->state[pb] != FTL_BLOCK_DATA)
+        {
+            continue;
+        }
+        lb = owner[pb];
+        cur = ftl->dmap[lb];
+        if (cur == RT_MTD_NAND_FTL_NONE)
+        {
+            ftl->dmap[lb] = pb;
+            continue;
+        }
+        if (ftl->seq[pb] > ftl->seq[cur])
+        {
+            ftl->dmap[lb] = pb;
+            ftl->state[cur] = FTL_BLOCK_DIRTY;
+        }
+        else
+        {
+            ftl->state[pb] = FTL_BLOCK_DIRTY;
+        }
+        ftl->recovered++;
+    }
+
+    /* a log block is valid when it is newer than the data block */
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        if (ftl->state[pb] != FTL_BLOCK_LOG)
+        {
+            continue;
+        }
+        lb = owner[pb];
+        cur = ftl->dmap[lb];
+        if (cur != RT_MTD_NAND_FTL_NONE && ftl->seq[cur] > ftl->seq[pb])
+        {
+            ftl->state[pb] = FTL_BLOCK_DIRTY;
+            ftl->recovered++;
+            continue;
+        }
+
+        log = ftl_find_log(ftl, lb);
+        if (log)
+        {
+            /* only one log block per logical block is active, the older one is stale */
+            if (ftl->seq[log->pblock] > ftl->seq[pb])
+            {
+                ftl->state[pb] = FTL_BLOCK_DIRTY;
+                ftl->recovered++;
+                continue;
+            }
+            ftl->state[log->pblock] = FTL_BLOCK_DIRTY;
+            ftl->recovered++;
+        }
+        else
+        {
+            log = ftl_get_slot(ftl);
+            if (log == RT_NULL)
+            {
+                /* more log blocks than the slots, the configuration was changed */
+                log = ftl_lru_log(ftl);
+                result = ftl_merge(ftl, log->lblock, log, RT_MTD_NAND_FTL_NONE);
+                if (result != RT_EOK)
+                {
+                    goto __exit;
+                }
+            }
+        }
+
+        log->pblock = pb;
+        log->lblock = lb;
+        log->seq = ftl->seq[pb];
+        log->stamp = rt_tick_get();
+        ftl_scan_log(ftl, pb, log->pmap, &log->next);
+    }
+
+    /* the erase counters of the erased blocks are not recorded, take the average */
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        if (ftl->erase_cnt[pb] != FTL_ERASE_UNKNOWN)
+        {
+            sum += ftl->erase_cnt[pb];
+            known++;
+        }
+    }
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        if (ftl->erase_cnt[pb] == FTL_ERASE_UNKNOWN)
+        {
+            ftl->erase_cnt[pb] = known ? (rt_uint32_t)(sum / known) : 0;
+        }
+    }
+    ftl->wl_checked = ftl->erases;
+
+__exit:
+    rt_free(scratch.pmap);
+    rt_free(owner);
+
+    return result;
+}
+
+/* one unit of background work, the lock is released between the units */
+static rt_bool_t ftl_gc_step(struct rt_mtd_nand_ftl *ftl)
+{
+    struct rt_mtd_nand_ftl_log *log;
+    rt_uint32_t i, lb, free_num, dirty = RT_MTD_NAND_FTL_NONE;
+    rt_uint32_t cold = RT_MTD_NAND_FTL_NONE, worn = RT_MTD_NAND_FTL_NONE;
+    rt_bool_t worked = RT_FALSE;
+
+    rt_mutex_take(&ftl->lock, RT_WAITING_FOREVER);
+
+    /* keep some erased blocks, so the writer does not wait for an erase */
+    for (i = 0, free_num = 0; i < ftl->pblocks; i++)
+    {
+        if (ftl->state[i] == FTL_BLOCK_FREE)
+        {
+            free_num++;
+        }
+        else if (ftl->state[i] == FTL_BLOCK_DIRTY)
+        {
+            if (dirty == RT_MTD_NAND_FTL_NONE || ftl->erase_cnt[i] < ftl->erase_cnt[dirty])
+            {
+                dirty = i;
+            }
+        }
+    }
+    if (free_num < FTL_GC_FREE_BLOCKS && dirty != RT_MTD_NAND_FTL_NONE)
+    {
+        ftl_erase(ftl, dirty);
+        worked = RT_TRUE;
+        goto __exit;
+    }
+
+    /* all log blocks are busy, merge the idle one before a new logical block needs it */
+    if (ftl_get_slot(ftl) == RT_NULL)
+    {
+        log = ftl_lru_log(ftl);
+        if (rt_tick_get() - log->stamp >= rt_tick_from_millisecond(FTL_GC_IDLE_MS))
+        {
+            if (ftl_merge(ftl, log->lblock, log, RT_MTD_NAND_FTL_NONE) == RT_EOK)
+            {
+                ftl->gc_merges++;
+                worked = RT_TRUE;
+            }
+            goto __exit;
+        }
+    }
+
+    /* static wear levelling, move the coldest data into the most worn free block */
+    if (ftl->erases - ftl->wl_checked >= FTL_WL_INTERVAL)
+    {
+        ftl->wl_checked = ftl->erases;
+        for (i = 0; i < ftl->pblocks; i++)
+        {
+            if (ftl->state[i] == FTL_BLOCK_DATA)
+            {
+                if (cold == RT_MTD_NAND_FTL_NONE || ftl->erase_cnt[i] < ftl->erase_cnt[cold])
+                {
+                    cold = i;
+                }
+            }
+            else if (ftl->state[i] == FTL_BLOCK_FREE)
+            {
+                if (worn == RT_MTD_NAND_FTL_NONE || ftl->erase_cnt[i] > ftl->erase_cnt[worn])
+                {
+                    worn = i;
+                }
+            }
+        }
+        if (cold == RT_MTD_NAND_FTL_NONE || worn == RT_MTD_NAND_FTL_NONE
+                || ftl->erase_cnt[worn] - ftl->erase_cnt[cold] <= RT_MTD_NAND_FTL_WL_THRESHOLD)
+        {
+            goto __exit;
+        }
+
+        for (lb = 0; lb < ftl->lblocks; lb++)
+        {
+            if (ftl->dmap[lb] == cold)
+            {
+                LOG_D("%s: move logical block %d to block %d.", ftl->parent.parent.name, lb, worn);
+                if (ftl_merge(ftl, lb, ftl_find_log(ftl, lb), worn) == RT_EOK)
+                {
+                    ftl->wl_moves++;
+                    worked = RT_TRUE;
+                }
+                break;
+            }
+        }
+    }
+
+__exit:
+    rt_mutex_release(&ftl->lock);
+
+    return worked;
+}
+
+static void ftl_gc_entry(void *parameter)
+{
+    struct rt_mtd_nand_ftl *ftl = (struct rt_mtd_nand_ftl *)parameter;
+
+    while (!ftl->gc_exit)
+    {
+        rt_sem_take(&ftl->gc_sem, rt_tick_from_millisecond(FTL_GC_PERIOD_MS));
+        while (!ftl->gc_exit && ftl_gc_step(ftl));
+    }
+
+    rt_sem_release(&ftl->gc_done);
+}
+
+/* RT-Thread device interface */
+static rt_size_t ftl_dev_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct rt_mtd_nand_ftl *ftl = (struct rt_mtd_nand_ftl *)dev;
+    rt_uint8_t *buf = (rt_uint8_t *)buffer;
+    rt_size_t i;
+
+    if (pos < 0 || pos + size > ftl->lblocks * ftl->ppb)
+    {
+        return 0;
+    }
+
+    rt_mutex_take(&ftl->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < size; i++)
+    {
+        if (ftl_read_sector(ftl, pos + i, buf + i * ftl->page_size) != RT_EOK)
+        {
+            LOG_E("%s: read sector %d failed.", ftl->parent.parent.name, pos + i);
+            break;
+        }
+    }
+    rt_mutex_release(&ftl->lock);
+
+    return i;
+}
+
+static rt_size_t ftl_dev_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct rt_mtd_nand_ftl *ftl = (struct rt_mtd_nand_ftl *)dev;
+    const rt_uint8_t *buf = (const rt_uint8_t *)buffer;
+    rt_size_t i;
+
+    if (pos < 0 || pos + size > ftl->lblocks * ftl->ppb)
+    {
+        return 0;
+    }
+
+    rt_mutex_take(&ftl->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < size; i++)
+    {
+        if (ftl_write_sector(ftl, pos + i, buf + i * ftl->page_size) != RT_EOK)
+        {
+            LOG_E("%s: write sector %d failed.", ftl->parent.parent.name, pos + i);
+            break;
+        }
+    }
+    rt_mutex_release(&ftl->lock);
+
+    return i;
+}
+
+/*
+ * drop the logical blocks which are covered by the sectors entirely
+ *
+ * The mount rebuilds the map from the tags of the pages, so a trim is durable
+ * only once no block with a copy of the data is left. The blocks given back
+ * here are erased before returning. An older copy of a trimmed block waiting
+ * for the garbage collection is found by the tag of its first page and erased
+ * too, the other dirty blocks are left to the garbage collection.
+ */
+static void ftl_trim(struct rt_mtd_nand_ftl *ftl, rt_uint32_t start, rt_uint32_t end)
+{
+    struct rt_mtd_nand_ftl_log *log;
+    struct ftl_tag tag;
+    rt_uint32_t lb, pb, first, last;
+
+    first = (start + ftl->ppb - 1) / ftl->ppb;
+    last = end / ftl->ppb;
+    if (last > ftl->lblocks)
+    {
+        last = ftl->lblocks;
+    }
+    if (first >= last)
+    {
+        return;
+    }
+
+    rt_mutex_take(&ftl->lock, RT_WAITING_FOREVER);
+    for (lb = first; lb < last; lb++)
+    {
+        log = ftl_find_log(ftl, lb);
+        if (log)
+        {
+            /* a block which fails is marked bad, the mount skips it as well */
+            ftl_erase(ftl, log->pblock);
+            ftl_log_reset(ftl, log);
+        }
+        if (ftl->dmap[lb] != RT_MTD_NAND_FTL_NONE)
+        {
+            ftl_erase(ftl, ftl->dmap[lb]);
+            ftl->dmap[lb] = RT_MTD_NAND_FTL_NONE;
+        }
+    }
+
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        if (ftl->state[pb] == FTL_BLOCK_DIRTY
+                && ftl_read_page(ftl, pb, 0, RT_NULL, &tag) == RT_EOK
+                && ftl_tag_check(&tag) == FTL_TAG_VALID
+                && tag.lblock >= first && tag.lblock < last)
+        {
+            ftl_erase(ftl, pb);
+        }
+    }
+    rt_mutex_release(&ftl->lock);
+}
+
+static rt_err_t ftl_dev_control(rt_device_t dev, int cmd, void *args)
+{
+    struct rt_mtd_nand_ftl *ftl = (struct rt_mtd_nand_ftl *)dev;
+
+    RT_ASSERT(ftl != RT_NULL);
+
+    if (cmd == RT_DEVICE_CTRL_BLK_GETGEOME)
+    {
+        struct rt_device_blk_geometry *geometry = (struct rt_device_blk_geometry *)args;
+
+        if (geometry == RT_NULL)
+        {
+            return -RT_ERROR;
+        }
+        geometry->bytes_per_sector = ftl->page_size;
+        geometry->block_size = ftl->page_size * ftl->ppb;
+        geometry->sector_count = ftl->lblocks * ftl->ppb;
+    }
+    else if (cmd == RT_DEVICE_CTRL_BLK_ERASE)
+    {
+        rt_uint32_t *addrs = (rt_uint32_t *)args;
+
+        if (addrs == RT_NULL || addrs[0] > addrs[1])
+        {
+            return -RT_ERROR;
+        }
+        ftl_trim(ftl, addrs[0], (addrs[0] == addrs[1]) ? addrs[1] + 1 : addrs[1]);
+    }
+
+    /* RT_DEVICE_CTRL_BLK_SYNC: every write is on the flash when it returns */
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops ftl_dev_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    ftl_dev_read,
+    ftl_dev_write,
+    ftl_dev_control
+};
+#endif
+
+static struct rt_mtd_nand_ftl *ftl_from_device(rt_device_t dev)
+{
+#ifdef RT_USING_DEVICE_OPS
+    if (dev && dev->ops == &ftl_dev_ops)
+#else
+    if (dev && dev->read == ftl_dev_read)
+#endif
+    {
+        return (struct rt_mtd_nand_ftl *)dev;
+    }
+
+    return RT_NULL;
+}
+
+static void ftl_free(struct rt_mtd_nand_ftl *ftl)
+{
+    int i;
+
+    for (i = 0; i < RT_MTD_NAND_FTL_LOG_BLOCKS; i++)
+    {
+        rt_free(ftl->logs[i].pmap);
+    }
+    rt_free(ftl->page_buf);
+    rt_free(ftl->erase_cnt);
+    rt_free(ftl->seq);
+    rt_free(ftl->state);
+    rt_free(ftl->dmap);
+    rt_free(ftl);
+}
+
+rt_device_t rt_mtd_nand_ftl_create(const char *mtd_name, const char *ftl_name)
+{
+    struct rt_mtd_nand_device *mtd;
+    struct rt_mtd_nand_ftl *ftl;
+    rt_uint32_t pblocks;
+    int i;
+
+    mtd = (struct rt_mtd_nand_device *)rt_device_find(mtd_name);
+    if (mtd == RT_NULL || mtd->parent.type != RT_Device_Class_MTD)
+    {
+        LOG_E("MTD NAND device %s not found.", mtd_name);
+        return RT_NULL;
+    }
+    if (mtd->oob_free < sizeof(struct ftl_tag))
+    {
+        LOG_E("%s has %d free spare bytes, the FTL needs %d.", mtd_name, mtd->oob_free, sizeof(struct ftl_tag));
+        return RT_NULL;
+    }
+
+    pblocks = mtd->block_end - mtd->block_start + 1;
+    if (pblocks >= RT_MTD_NAND_FTL_NONE || pblocks <= RT_MTD_NAND_FTL_LOG_BLOCKS + FTL_RESERVE(pblocks)
+            || mtd->pages_per_block >= RT_MTD_NAND_FTL_NONE)
+    {
+        LOG_E("%s: %d blocks are not supported.", mtd_name, pblocks);
+        return RT_NULL;
+    }
+
+    ftl = (struct rt_mtd_nand_ftl *)rt_calloc(1, sizeof(struct rt_mtd_nand_ftl));
+    if (ftl == RT_NULL)
+    {
+        return RT_NULL;
+    }
+    ftl->mtd = mtd;
+    ftl->ppb = mtd->pages_per_block;
+    ftl->page_size = mtd->page_size;
+    ftl->pblocks = pblocks;
+    ftl->lblocks = pblocks - RT_MTD_NAND_FTL_LOG_BLOCKS - FTL_RESERVE(pblocks);
+    rt_strncpy(ftl->parent.parent.name, ftl_name, RT_NAME_MAX);
+
+    ftl->dmap = (rt_uint16_t *)rt_malloc(ftl->lblocks * sizeof(rt_uint16_t));
+    ftl->state = (rt_uint8_t *)rt_malloc(pblocks);
+    ftl->seq = (rt_uint32_t *)rt_malloc(pblocks * sizeof(rt_uint32_t));
+    ftl->erase_cnt = (rt_uint32_t *)rt_malloc(pblocks * sizeof(rt_uint32_t));
+    ftl->page_buf = (rt_uint8_t *)rt_malloc(ftl->page_size);
+    if (!ftl->dmap || !ftl->state || !ftl->seq || !ftl->erase_cnt || !ftl->page_buf)
+    {
+        goto __fail;
+    }
+    for (i = 0; i < RT_MTD_NAND_FTL_LOG_BLOCKS; i++)
+    {
+        ftl->logs[i].pmap = (rt_uint16_t *)rt_malloc(ftl->ppb * sizeof(rt_uint16_t));
+        if (ftl->logs[i].pmap == RT_NULL)
+        {
+            goto __fail;
+        }
+        ftl_log_reset(ftl, &ftl->logs[i]);
+    }
+
+    if (ftl_mount(ftl) != RT_EOK)
+    {
+        goto __fail;
+    }
+
+    rt_mutex_init(&ftl->lock, "ftl", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&ftl->gc_sem, "ftlgc", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&ftl->gc_done, "ftlgcd", 0, RT_IPC_FLAG_FIFO);
+
+    ftl->parent.type = RT_Device_Class_Block;
+#ifdef RT_USING_DEVICE_OPS
+    ftl->parent.ops  = &ftl_dev_ops;
+#else
+    ftl->parent.init = RT_NULL;
+    ftl->parent.open = RT_NULL;
+    ftl->parent.close = RT_NULL;
+    ftl->parent.read  = ftl_dev_read;
+    ftl->parent.write = ftl_dev_write;
+    ftl->parent.control = ftl_dev_control;
+#endif
+    if (rt_device_register(&ftl->parent, ftl_name, RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_STANDALONE) != RT_EOK)
+    {
+        rt_sem_detach(&ftl->gc_done);
+        rt_sem_detach(&ftl->gc_sem);
+        rt_mutex_detach(&ftl->lock);
+        goto __fail;
+    }
+
+    ftl->gc_thread = rt_thread_create("ftlgc", ftl_gc_entry, ftl, 2048, RT_MTD_NAND_FTL_GC_PRIORITY, 10);
+    if (ftl->gc_thread)
+    {
+        rt_thread_startup(ftl->gc_thread);
+        /* erase the blocks the mount found dirty */
+        rt_sem_release(&ftl->gc_sem);
+    }
+    else
+    {
+        LOG_W("%s: no garbage collection thread, blocks are erased when they are needed.", ftl_name);
+    }
+
+    LOG_I("%s: %d logical blocks on %s, %d bad blocks, %d blocks recovered.",
+          ftl_name, ftl->lblocks, mtd_name, ftl->bad_blocks, ftl->recovered);
+
+    return &ftl->parent;
+
+__fail:
+    LOG_E("%s: create on %s failed.", ftl_name, mtd_name);
+    ftl_free(ftl);
+
+    return RT_NULL;
+}
+
+rt_err_t rt_mtd_nand_ftl_delete(rt_device_t dev)
+{
+    struct rt_mtd_nand_ftl *ftl = ftl_from_device(dev);
+
+    if (ftl == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    if (ftl->gc_thread)
+    {
+        ftl->gc_exit = RT_TRUE;
+        rt_sem_release(&ftl->gc_sem);
+        rt_sem_take(&ftl->gc_done, RT_WAITING_FOREVER);
+    }
+
+    rt_device_unregister(dev);
+    rt_sem_detach(&ftl->gc_done);
+    rt_sem_detach(&ftl->gc_sem);
+    rt_mutex_detach(&ftl->lock);
+    ftl_free(ftl);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_mtd_nand_ftl_format(rt_device_t dev)
+{
+    struct rt_mtd_nand_ftl *ftl = ftl_from_device(dev);
+    rt_uint32_t pb;
+    int i;
+
+    if (ftl == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&ftl->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < RT_MTD_NAND_FTL_LOG_BLOCKS; i++)
+    {
+        ftl_log_reset(ftl, &ftl->logs[i]);
+    }
+    rt_memset(ftl->dmap, 0xFF, ftl->lblocks * sizeof(rt_uint16_t));
+    /* erase now, the old data must not come back after a power loss */
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        if (ftl->state[pb] != FTL_BLOCK_BAD && ftl->state[pb] != FTL_BLOCK_FREE)
+        {
+            ftl_erase(ftl, pb);
+        }
+    }
+    rt_mutex_release(&ftl->lock);
+
+    return RT_EOK;
+}
+
+void rt_mtd_nand_ftl_show(rt_device_t dev)
+{
+    struct rt_mtd_nand_ftl *ftl = ftl_from_device(dev);
+    rt_uint32_t count[FTL_BLOCK_BAD + 1] = {0};
+    rt_uint32_t pb, min = 0xFFFFFFFF, max = 0, good = 0;
+    rt_uint64_t sum = 0;
+
+    if (ftl == RT_NULL)
+    {
+        rt_kprintf("It is not a NAND FTL device.\n");
+        return;
+    }
+
+    rt_mutex_take(&ftl->lock, RT_WAITING_FOREVER);
+    for (pb = 0; pb < ftl->pblocks; pb++)
+    {
+        count[ftl->state[pb]]++;
+        if (ftl->state[pb] == FTL_BLOCK_BAD)
+        {
+            continue;
+        }
+        min = (ftl->erase_cnt[pb] < min) ? ftl->erase_cnt[pb] : min;
+        max = (ftl->erase_cnt[pb] > max) ? ftl->erase_cnt[pb] : max;
+        sum += ftl->erase_cnt[pb];
+        good++;
+    }
+    rt_mutex_release(&ftl->lock);
+
+    rt_kprintf("FTL %s on %s\n", ftl->parent.parent.name, ftl->mtd->parent.parent.name);
+    rt_kprintf("blocks: %d physical, %d logical, %d pages of %d bytes\n",
+               ftl->pblocks, ftl->lblocks, ftl->ppb, ftl->page_size);
+    rt_kprintf("state : %d data, %d log, %d free, %d dirty, %d bad\n", count[FTL_BLOCK_DATA],
+               count[FTL_BLOCK_LOG], count[FTL_BLOCK_FREE], count[FTL_BLOCK_DIRTY], count[FTL_BLOCK_BAD]);
+    rt_kprintf("erase : min %d, avg %d, max %d, %d erases\n", good ? min : 0,
+               good ? (rt_uint32_t)(sum / good) : 0, max, ftl->erases);
+    rt_kprintf("merge : %d full, %d switch, %d background, %d wear levelling moves\n",
+               ftl->full_merges, ftl->switch_merges, ftl->gc_merges, ftl->wl_moves);
+    rt_kprintf("errors: %d corrected, %d lost, %d stale or torn blocks found by mount\n",
+               ftl->corrected, ftl->lost, ftl->recovered);
+}
+
+#if defined(RT_USING_FINSH)
+#include <finsh.h>
+
+static rt_uint32_t ftl_rand(rt_uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+static void ftl_bench(rt_device_t dev, rt_uint32_t sectors)
+{
+    struct rt_mtd_nand_ftl *ftl = ftl_from_device(dev);
+    rt_uint32_t i, merges, seed = rt_tick_get();
+    rt_uint8_t *buf;
+    rt_tick_t tick;
+
+    sectors = (sectors > ftl->lblocks * ftl->ppb) ? ftl->lblocks * ftl->ppb : sectors;
+    buf = (rt_uint8_t *)rt_malloc(ftl->page_size);
+    if (buf == RT_NULL)
+    {
+        return;
+    }
+    rt_memset(buf, 0x5A, ftl->page_size);
+
+    tick = rt_tick_get();
+    for (i = 0; i < sectors && rt_device_write(dev, i, buf, 1) == 1; i++);
+    tick = rt_tick_get() - tick;
+    rt_kprintf("sequential write: %d sectors, %d ms, %d KB/s\n", i, tick * 1000 / RT_TICK_PER_SECOND,
+               tick ? (rt_uint32_t)((rt_uint64_t)i * ftl->page_size * RT_TICK_PER_SECOND / 1024 / tick) : 0);
+
+    tick = rt_tick_get();
+    for (i = 0; i < sectors && rt_device_read(dev, i, buf, 1) == 1; i++);
+    tick = rt_tick_get() - tick;
+    rt_kprintf("sequential read : %d sectors, %d ms, %d KB/s\n", i, tick * 1000 / RT_TICK_PER_SECOND,
+               tick ? (rt_uint32_t)((rt_uint64_t)i * ftl->page_size * RT_TICK_PER_SECOND / 1024 / tick) : 0);
+
+    merges = ftl->full_merges + ftl->switch_merges;
+    tick = rt_tick_get();
+    for (i = 0; i < sectors / 4 && rt_device_write(dev, ftl_rand(&seed) % sectors, buf, 1) == 1; i++);
+    tick = rt_tick_get() - tick;
+    rt_kprintf("random write    : %d sectors, %d ms, %d IOPS, %d merges\n", i, tick * 1000 / RT_TICK_PER_SECOND,
+               tick ? i * RT_TICK_PER_SECOND / tick : 0, ftl->full_merges + ftl->switch_merges - merges);
+
+    rt_free(buf);
+}
+
+#ifdef RT_MTD_NAND_USING_SIM
+#define FTL_TEST_SIM            "ftlsim"
+#define FTL_TEST_DEV            "ftltest"
+#define FTL_TEST_BLOCKS         48
+#define FTL_TEST_PPB            16
+#define FTL_TEST_PAGE           512
+#define FTL_TEST_OOB            32
+
+static void ftl_test_fill(rt_uint32_t *buf, rt_uint32_t sector, rt_uint32_t version)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < FTL_TEST_PAGE / 4; i++)
+    {
+        buf[i] = (sector << 16) ^ version ^ (i * 0x9E3779B9);
+    }
+}
+
+/* the content of the sector must be the version, or a blank sector for version 0 */
+static rt_bool_t ftl_test_match(const rt_uint32_t *buf, rt_uint32_t sector, rt_uint32_t version)
+{
+    rt_uint32_t i;
+
+    if (version == 0)
+    {
+        return ftl_is_blank((const rt_uint8_t *)buf, FTL_TEST_PAGE);
+    }
+    for (i = 0; i < FTL_TEST_PAGE / 4; i++)
+    {
+        if (buf[i] != ((sector << 16) ^ version ^ (i * 0x9E3779B9)))
+        {
+            return RT_FALSE;
+        }
+    }
+
+    return RT_TRUE;
+}
+
+/* write randomly, cut the power, remount and check that no completed write is lost */
+static int ftl_powercut_test(int rounds)
+{
+    struct rt_mtd_nand_device *mtd;
+    rt_device_t dev = RT_NULL;
+    rt_uint32_t *version = RT_NULL, *buf = RT_NULL;
+    rt_uint32_t sectors = 0, s, seed = rt_tick_get(), pending = 0xFFFFFFFF, pending_version = 0;
+    int round, i, result = -RT_ERROR;
+
+    mtd = rt_mtd_nand_sim_create(FTL_TEST_SIM, FTL_TEST_BLOCKS, FTL_TEST_PPB, FTL_TEST_PAGE, FTL_TEST_OOB);
+    if (mtd == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+    version = (rt_uint32_t *)rt_calloc(FTL_TEST_BLOCKS * FTL_TEST_PPB, sizeof(rt_uint32_t));
+    buf = (rt_uint32_t *)rt_malloc(FTL_TEST_PAGE);
+    if (version == RT_NULL || buf == RT_NULL)
+    {
+        goto __exit;
+    }
+
+    for (round = 0; round <= rounds; round++)
+    {
+        dev = rt_mtd_nand_ftl_create(FTL_TEST_SIM, FTL_TEST_DEV);
+        if (dev == RT_NULL)
+        {
+            goto __exit;
+        }
+        sectors = ((struct rt_mtd_nand_ftl *)dev)->lblocks * FTL_TEST_PPB;
+
+        for (s = 0; s < sectors; s++)
+        {
+            if (rt_device_read(dev, s, buf, 1) != 1)
+            {
+                rt_kprintf("round %d: read sector %d failed\n", round, s);
+                goto __exit;
+            }
+            /* the write in progress when the power was lost may or may not be there */
+            if (s == pending && ftl_test_match(buf, s, pending_version))
+            {
+                version[s] = pending_version;
+            }
+            if (!ftl_test_match(buf, s, version[s]))
+            {
+                rt_kprintf("round %d: sector %d lost version %d\n", round, s, version[s]);
+                goto __exit;
+            }
+        }
+        if (round == rounds)
+        {
+            break;
+        }
+
+        if (round == rounds / 2)
+        {
+            rt_mtd_nand_sim_wear_out(mtd, ftl_rand(&seed) % FTL_TEST_BLOCKS);
+        }
+        rt_mtd_nand_sim_powercut(mtd, 1 + ftl_rand(&seed) % 400);
+
+        pending = 0xFFFFFFFF;
+        for (i = 0; i < 4000; i++)
+        {
+            /* half of the writes go to the first logical blocks, like the FAT area */
+            s = (ftl_rand(&seed) & 1) ? ftl_rand(&seed) % (2 * FTL_TEST_PPB) : ftl_rand(&seed) % sectors;
+            ftl_test_fill(buf, s, version[s] + 1);
+            if (rt_device_write(dev, s, buf, 1) != 1)
+            {
+                pending = s;
+                pending_version = version[s] + 1;
+                break;
+            }
+            version[s]++;
+        }
+
+        rt_mtd_nand_sim_powercut(mtd, 0);
+        rt_mtd_nand_ftl_delete(dev);
+        dev = RT_NULL;
+    }
+
+    rt_kprintf("%d power cuts passed.\n", rounds);
+    result = RT_EOK;
+
+__exit:
+    if (dev)
+    {
+        rt_mtd_nand_ftl_show(dev);
+        rt_mtd_nand_ftl_delete(dev);
+    }
+    rt_mtd_nand_sim_delete(mtd);
+    rt_free(buf);
+    rt_free(version);
+
+    return result;
+}
+#endif /* RT_MTD_NAND_USING_SIM */
+
+static int ftl(int argc, char **argv)
+{
+    const char *help = "Usage:\n"
+                       "ftl create <mtd> <name>          - create a FTL block device on a MTD NAND\n"
+                       "ftl delete <name>                - delete a FTL block device\n"
+                       "ftl info <name>                  - show the mapping and wear statistics\n"
+                       "ftl format <name>                - erase all logical data\n"
+                       "ftl bench <name> <sectors>       - sequential and random throughput\n"
+#ifdef RT_MTD_NAND_USING_SIM
+                       "ftl sim <name> <blocks> [ppb] [page size] - create a RAM simulated NAND\n"
+                       "ftl test [rounds]                - power loss test on a simulated NAND\n"
+#endif
+                       ;
+    rt_device_t dev;
+
+    if (argc < 2)
+    {
+        rt_kprintf("%s", help);
+        return 0;
+    }
+
+    if (!rt_strcmp(argv[1], "create") && argc >= 4)
+    {
+        return rt_mtd_nand_ftl_create(argv[2], argv[3]) ? RT_EOK : -RT_ERROR;
+    }
+#ifdef RT_MTD_NAND_USING_SIM
+    else if (!rt_strcmp(argv[1], "sim") && argc >= 4)
+    {
+        rt_uint32_t ppb = (argc > 4) ? atoi(argv[4]) : 64;
+        rt_uint32_t page = (argc > 5) ? atoi(argv[5]) : 2048;
+
+        return rt_mtd_nand_sim_create(argv[2], atoi(argv[3]), ppb, page, (page / 32 < 32) ? 32 : page / 32) ? RT_EOK : -RT_ERROR;
+    }
+    else if (!rt_strcmp(argv[1], "test"))
+    {
+        return ftl_powercut_test((argc > 2) ? atoi(argv[2]) : 50);
+    }
+#endif
+    else if (argc < 3)
+    {
+        rt_kprintf("%s", help);
+        return 0;
+    }
+
+    dev = rt_device_find(argv[2]);
+    if (ftl_from_device(dev) == RT_NULL)
+    {
+        rt_kprintf("FTL device %s not found.\n", argv[2]);
+        return -RT_ERROR;
+    }
+
+    if (!rt_strcmp(argv[1], "delete"))
+    {
+        return rt_mtd_nand_ftl_delete(dev);
+    }
+    else if (!rt_strcmp(argv[1], "info"))
+    {
+        rt_mtd_nand_ftl_show(dev);
+    }
+    else if (!rt_strcmp(argv[1], "format"))
+    {
+        return rt_mtd_nand_ftl_format(dev);
+    }
+    else if (!rt_strcmp(argv[1], "bench") && argc >= 4)
+    {
+        ftl_bench(dev, atoi(argv[3]));
+        rt_mtd_nand_ftl_show(dev);
+    }
+    else
+    {
+        rt_kprintf("%s", help);
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(ftl, NAND flash translation layer);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_MTD_NAND_USING_FTL */
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * RAM backed MTD NAND simulation.
+ * It follows the NAND rules which a flash translation layer must respect:
+ * a page is programmed once and in order inside its block, programming only
+ * clears bits, and the erase unit is a block. Worn out blocks and power
+ * cuts (a torn program or erase) can be injected.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <string.h>
+
+#if defined(RT_MTD_NAND_USING_SIM) && defined(RT_MTD_NAND_USING_FTL)
+#include <drivers/mtd_nand_ftl.h>
+
+#define DBG_TAG               "mtd.sim"
+#define DBG_LVL               DBG_WARNING
+#include <rtdbg.h>
+
+/* the first spare bytes keep the bad block marker */
+#define NAND_SIM_OOB_RESERVED 2
+
+struct nand_sim
+{
+    struct rt_mtd_nand_device parent;
+
+    rt_uint8_t  *mem;               /* the pages, each one followed by its spare area */
+    rt_uint16_t *next_page;         /* the lowest page of the block which can be programmed */
+    rt_uint8_t  *bad;               /* marked bad blocks */
+    rt_uint8_t  *worn;              /* the next program or erase of the block fails */
+    rt_uint32_t  page_total;        /* page_size + oob_size */
+
+    /* < 0: power cut disabled, 0: power is lost, > 0: operations left before the cut */
+    int powercut_ops;
+
+    rt_uint32_t programs;
+    rt_uint32_t erases;
+};
+
+rt_inline rt_uint8_t *nand_sim_page(struct nand_sim *sim, rt_off_t page)
+{
+    return sim->mem + (rt_size_t)page * sim->page_total;
+}
+
+/* RT_FALSE when the power is lost, *torn tells the operation is cut in the middle */
+static rt_bool_t nand_sim_power(struct nand_sim *sim, rt_bool_t *torn)
+{
+    *torn = RT_FALSE;
+    if (sim->powercut_ops < 0)
+    {
+        return RT_TRUE;
+    }
+    if (sim->powercut_ops == 0)
+    {
+        return RT_FALSE;
+    }
+    if (--sim->powercut_ops == 0)
+    {
+        *torn = RT_TRUE;
+    }
+
+    return RT_TRUE;
+}
+
+static rt_err_t nand_sim_read_id(struct rt_mtd_nand_device *device)
+{
+    return RT_EOK;
+}
+
+static rt_err_t nand_sim_read_page(struct rt_mtd_nand_device *device,
+                                   rt_off_t page,
+                                   rt_uint8_t *data, rt_uint32_t data_len,
+                                   rt_uint8_t *spare, rt_uint32_t spare_len)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+    rt_uint8_t *ptr;
+
+    if (page < 0 || page / device->pages_per_block > device->block_end)
+    {
+        return -RT_MTD_EIO;
+    }
+    ptr = nand_sim_page(sim, page);
+
+    if (data && data_len)
+    {
+        rt_memcpy(data, ptr, (data_len > device->page_size) ? device->page_size : data_len);
+    }
+    if (spare && spare_len)
+    {
+        rt_memcpy(spare, ptr + device->page_size + NAND_SIM_OOB_RESERVED,
+                  (spare_len > device->oob_free) ? device->oob_free : spare_len);
+    }
+
+    return RT_EOK;
+}
+
+static void nand_sim_program(rt_uint8_t *dst, const rt_uint8_t *src, rt_uint32_t len)
+{
+    while (len--)
+    {
+        *dst++ &= *src++;
+    }
+}
+
+static rt_err_t nand_sim_write_page(struct rt_mtd_nand_device *device,
+                                    rt_off_t page,
+                                    const rt_uint8_t *data, rt_uint32_t data_len,
+                                    const rt_uint8_t *spare, rt_uint32_t spare_len)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+    rt_uint32_t block = page / device->pages_per_block, offset = page % device->pages_per_block;
+    rt_uint8_t *ptr;
+    rt_bool_t torn;
+
+    if (page < 0 || block > device->block_end)
+    {
+        return -RT_MTD_EIO;
+    }
+    if (offset < sim->next_page[block])
+    {
+        LOG_E("page %d is programmed again or out of order.", page);
+        return -RT_MTD_EIO;
+    }
+    if (!nand_sim_power(sim, &torn))
+    {
+        return -RT_MTD_EIO;
+    }
+
+    ptr = nand_sim_page(sim, page);
+    sim->next_page[block] = offset + 1;
+    sim->programs++;
+
+    data_len = (data_len > device->page_size) ? device->page_size : data_len;
+    spare_len = (spare_len > device->oob_free) ? device->oob_free : spare_len;
+    if (torn || sim->worn[block])
+    {
+        /* half of the page data is there, the spare area is not */
+        if (data)
+        {
+            nand_sim_program(ptr, data, data_len / 2);
+        }
+        return -RT_MTD_EIO;
+    }
+
+    if (data && data_len)
+    {
+        nand_sim_program(ptr, data, data_len);
+    }
+    if (spare && spare_len)
+    {
+        nand_sim_program(ptr + device->page_size + NAND_SIM_OOB_RESERVED, spare, spare_len);
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t nand_sim_move_page(struct rt_mtd_nand_device *device, rt_off_t src_page, rt_off_t dst_page)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+    rt_uint8_t *src;
+
+    if (src_page < 0 || src_page / device->pages_per_block > device->block_end)
+    {
+        return -RT_MTD_EIO;
+    }
+    src = nand_sim_page(sim, src_page);
+
+    return nand_sim_write_page(device, dst_page, src, device->page_size,
+                               src + device->page_size + NAND_SIM_OOB_RESERVED, device->oob_free);
+}
+
+static rt_err_t nand_sim_erase_block(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+    rt_size_t block_bytes = sim->page_total * device->pages_per_block;
+    rt_bool_t torn;
+
+    if (block > device->block_end)
+    {
+        return -RT_MTD_EIO;
+    }
+    if (!nand_sim_power(sim, &torn))
+    {
+        return -RT_MTD_EIO;
+    }
+
+    if (torn)
+    {
+        /* the first half is erased, the block must be erased again before use */
+        rt_memset(nand_sim_page(sim, block * device->pages_per_block), 0xFF, block_bytes / 2);
+        sim->next_page[block] = device->pages_per_block;
+        return -RT_MTD_EIO;
+    }
+    if (sim->worn[block])
+    {
+        return -RT_MTD_EIO;
+    }
+
+    rt_memset(nand_sim_page(sim, block * device->pages_per_block), 0xFF, block_bytes);
+    sim->next_page[block] = 0;
+    sim->erases++;
+
+    return RT_EOK;
+}
+
+static rt_err_t nand_sim_check_block(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+
+    if (block > device->block_end)
+    {
+        return -RT_MTD_EIO;
+    }
+
+    return sim->bad[block] ? -RT_ERROR : RT_EOK;
+}
+
+static rt_err_t nand_sim_mark_badblock(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+    rt_bool_t torn;
+
+    if (block > device->block_end)
+    {
+        return -RT_MTD_EIO;
+    }
+    if (!nand_sim_power(sim, &torn))
+    {
+        return -RT_MTD_EIO;
+    }
+    sim->bad[block] = 1;
+
+    return RT_EOK;
+}
+
+static const struct rt_mtd_nand_driver_ops nand_sim_ops =
+{
+    nand_sim_read_id,
+    nand_sim_read_page,
+    nand_sim_write_page,
+    nand_sim_move_page,
+    nand_sim_erase_block,
+    nand_sim_check_block,
+    nand_sim_mark_badblock,
+};
+
+struct rt_mtd_nand_device *rt_mtd_nand_sim_create(const char *name, rt_uint32_t blocks,
+        rt_uint32_t pages_per_block, rt_uint32_t page_size, rt_uint32_t oob_size)
+{
+    struct nand_sim *sim;
+
+    if (blocks == 0 || blocks > 0xFFFF || pages_per_block == 0 || pages_per_block > 0xFFFF
+            || page_size == 0 || oob_size <= NAND_SIM_OOB_RESERVED)
+    {
+        LOG_E("invalid geometry.");
+        return RT_NULL;
+    }
+
+    sim = (struct nand_sim *)rt_calloc(1, sizeof(struct nand_sim));
+    if (sim == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    sim->page_total = page_size + oob_size;
+    sim->mem = (rt_uint8_t *)rt_malloc((rt_size_t)sim->page_total * pages_per_block * blocks);
+    sim->next_page = (rt_uint16_t *)rt_calloc(blocks, sizeof(rt_uint16_t));
+    sim->bad = (rt_uint8_t *)rt_calloc(blocks, 1);
+    sim->worn = (rt_uint8_t *)rt_calloc(blocks, 1);
+    if (!sim->mem || !sim->next_page || !sim->bad || !sim->worn)
+    {
+        LOG_E("no memory for %d blocks.", blocks);
+        goto __fail;
+    }
+    rt_memset(sim->mem, 0xFF, (rt_size_t)sim->page_total * pages_per_block * blocks);
+    sim->powercut_ops = -1;
+
+    sim->parent.page_size       = page_size;
+    sim->parent.oob_size        = oob_size;
+    sim->parent.oob_free        = oob_size - NAND_SIM_OOB_RESERVED;
+    sim->parent.plane_num       = 1;
+    sim->parent.pages_per_block = pages_per_block;
+    sim->parent.block_total     = blocks;
+    sim->parent.block_start     = 0;
+    sim->parent.block_end       = blocks - 1;
+    sim->parent.ops             = &nand_sim_ops;
+
+    if (rt_mtd_nand_register_device(name, &sim->parent) != RT_EOK)
+    {
+        goto __fail;
+    }
+
+    return &sim->parent;
+
+__fail:
+    rt_free(sim->worn);
+    rt_free(sim->bad);
+    rt_free(sim->next_page);
+    rt_free(sim->mem);
+    rt_free(sim);
+
+    return RT_NULL;
+}
+
+rt_err_t rt_mtd_nand_sim_delete(struct rt_mtd_nand_device *device)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+
+    if (device == RT_NULL || device->ops != &nand_sim_ops)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_device_unregister(&device->parent);
+    rt_free(sim->worn);
+    rt_free(sim->bad);
+    rt_free(sim->next_page);
+    rt_free(sim->mem);
+    rt_free(sim);
+
+    return RT_EOK;
+}
+
+void rt_mtd_nand_sim_powercut(struct rt_mtd_nand_device *device, int ops)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+
+    RT_ASSERT(device->ops == &nand_sim_ops);
+    sim->powercut_ops = (ops > 0) ? ops : -1;
+}
+
+void rt_mtd_nand_sim_wear_out(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+
+    RT_ASSERT(device->ops == &nand_sim_ops);
+    if (block <= device->block_end)
+    {
+        sim->worn[block] = 1;
+    }
+}
+
+void rt_mtd_nand_sim_stat(struct rt_mtd_nand_device *device, rt_uint32_t *programs, rt_uint32_t *erases)
+{
+    struct nand_sim *sim = (struct nand_sim *)device;
+
+    RT_ASSERT(device->ops == &nand_sim_ops);
+    *programs = sim->programs;
+    *erases = sim->erases;
+}
+
+#endif /* RT_MTD_NAND_USING_SIM */
@@ -90,6 +90,21 @@ const sfud_flash *sfud_get_device_table(void);
  * @return result
  */
 sfud_err sfud_qspi_fast_read_enable(sfud_flash *flash, uint8_t data_line_width);
+
+/**
+ * Enable or disable the continuous read (XIP) mode of Dual/Quad I/O fast read.
+ *
+ * The flash keeps the read instruction after a read, so the following reads only send
+ * the address. Any other command takes the flash out of this mode first.
+ *
+ * @note Disable it before a software reset, the boot loader can not talk to a flash in this mode.
+ *
+ * @param flash flash device
+ * @param enabled true: enable, false: disable
+ *
+ * @return result
+ */
+sfud_err sfud_qspi_continuous_read_enable(sfud_flash *flash, bool enabled);
 #endif /* SFUD_USING_QSPI */
 
 /**
@@ -117,6 +132,32 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
  */
 sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size);
 
+/**
+ * start one erase operate and return without waiting for the flash
+ *
+ * @note The largest eraser which fits the address and size is used.
+ *       Poll sfud_busy_check() until the erase is done. Other operations wait for it,
+ *       or suspend it for reading when the flash supports erase suspend.
+ *
+ * @param flash flash device
+ * @param addr start address
+ * @param size erase size
+ * @param erase_size the bytes after addr which are covered by this erase
+ *
+ * @return result
+ */
+sfud_err sfud_erase_start(const sfud_flash *flash, uint32_t addr, size_t size, size_t *erase_size);
+
+/**
+ * check whether the operation started by sfud_erase_start() is still running
+ *
+ * @param flash flash device
+ * @param busy true: still running
+ *
+ * @return result
+ */
+sfud_err sfud_busy_check(const sfud_flash *flash, bool *busy);
+
 /**
  * write flash data (no erase operate)
  *
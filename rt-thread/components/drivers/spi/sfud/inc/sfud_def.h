@@ -130,6 +130,11 @@ if (!(EXPR))                                                                   \
 #define SFUD_CMD_QUAD_IO_READ_DATA                     0xEB
 #endif
 
+/* M5-4 = (1,0) keeps Dual/Quad I/O fast read in continuous read mode */
+#ifndef SFUD_QSPI_CONTINUOUS_READ_MODE
+#define SFUD_QSPI_CONTINUOUS_READ_MODE                 0x20
+#endif
+
 #ifndef SFUD_CMD_QUAD_OUTPUT_READ_DATA
 #define SFUD_CMD_QUAD_OUTPUT_READ_DATA                 0x6B
 #endif
@@ -158,6 +163,14 @@ if (!(EXPR))                                                                   \
 #define SFUD_CMD_RESET                                 0x99
 #endif
 
+#ifndef SFUD_CMD_ERASE_SUSPEND
+#define SFUD_CMD_ERASE_SUSPEND                         0x75
+#endif
+
+#ifndef SFUD_CMD_ERASE_RESUME
+#define SFUD_CMD_ERASE_RESUME                          0x7A
+#endif
+
 #ifndef SFUD_CMD_ENTER_4B_ADDRESS_MODE
 #define SFUD_CMD_ENTER_4B_ADDRESS_MODE                 0xB7
 #endif
@@ -187,6 +200,14 @@ enum {
     SFUD_STATUS_REGISTER_SRP = (1 << 7),                   /**< status register protect */
 };
 
+/**
+ * operation which is still running in the flash after it was started by sfud_erase_start()
+ */
+typedef enum {
+    SFUD_BUSY_NONE = 0,                                    /**< idle */
+    SFUD_BUSY_ERASE = 1,                                   /**< block or sector erase */
+} sfud_busy_op;
+
 /**
  * error code
  */
@@ -211,6 +232,7 @@ typedef struct {
     uint8_t alternate_bytes_lines;
     uint8_t dummy_cycles;
     uint8_t data_lines;
+    uint8_t alternate_bytes;                     /**< mode bits, sent when alternate_bytes_lines is not 0 */
 } sfud_qspi_read_cmd_format;
 #endif /* SFUD_USING_QSPI */
 
@@ -278,9 +300,14 @@ typedef struct {
         size_t times;                            /**< default times for error retry */
     } retry;
     void *user_data;                             /**< some user data */
+    bool suspend_support;                        /**< erase suspend(75h)/resume(7Ah) is supported */
+    sfud_busy_op busy_op;                        /**< operation running in background */
+    uint32_t busy_addr;                          /**< start of the block erased in background */
+    size_t busy_size;                            /**< size of the block erased in background */
 
 #ifdef SFUD_USING_QSPI
     sfud_qspi_read_cmd_format read_cmd_format;   /**< fast read cmd format */
+    bool qspi_continuous_read;                   /**< flash is in continuous read mode, next read skips the instruction */
 #endif
 
 #ifdef SFUD_USING_SFDP
@@ -68,6 +68,9 @@ static sfud_err page256_or_1_byte_write(const sfud_flash *flash, uint32_t addr,
         const uint8_t *data);
 static sfud_err aai_write(const sfud_flash *flash, uint32_t addr, size_t size, const uint8_t *data);
 static sfud_err wait_busy(const sfud_flash *flash);
+static sfud_err busy_op_finish(const sfud_flash *flash);
+static sfud_err erase_suspend(const sfud_flash *flash, bool suspend);
+static size_t get_eraser(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t *cmd);
 static sfud_err reset(const sfud_flash *flash);
 static sfud_err read_jedec_id(sfud_flash *flash);
 static sfud_err set_write_enabled(const sfud_flash *flash, bool enabled);
@@ -166,7 +169,11 @@ const sfud_flash *sfud_get_device_table(void) {
 static void qspi_set_read_cmd_format(sfud_flash *flash, uint8_t ins, uint8_t ins_lines, uint8_t addr_lines,
         uint8_t dummy_cycles, uint8_t data_lines) {
     /* if medium size greater than 16Mb, use 4-Byte address, instruction should be added one */
-    if (flash->chip.capacity <= 0x1000000) {
+    if (ins == SFUD_CMD_READ_DATA) {
+        /* normal read goes through sfud_read() with the current address mode */
+        flash->read_cmd_format.instruction = ins;
+        flash->read_cmd_format.address_size = flash->addr_in_4_byte ? 32 : 24;
+    } else if (flash->chip.capacity <= 0x1000000) {
         flash->read_cmd_format.instruction = ins;
         flash->read_cmd_format.address_size = 24;
     } else {
@@ -177,6 +184,7 @@ static void qspi_set_read_cmd_format(sfud_flash *flash, uint8_t ins, uint8_t ins
     flash->read_cmd_format.instruction_lines = ins_lines;
     flash->read_cmd_format.address_lines = addr_lines;
     flash->read_cmd_format.alternate_bytes_lines = 0;
+    flash->read_cmd_format.alternate_bytes = 0;
     flash->read_cmd_format.dummy_cycles = dummy_cycles;
     flash->read_cmd_format.data_lines = data_lines;
 }
@@ -238,6 +246,41 @@ sfud_err sfud_qspi_fast_read_enable(sfud_flash *flash, uint8_t data_line_width)
 
     return result;
 }
+
+sfud_err sfud_qspi_continuous_read_enable(sfud_flash *flash, bool enabled) {
+    sfud_qspi_read_cmd_format *format;
+    uint8_t ins, mode_cycles;
+    uint8_t dummy;
+
+    SFUD_ASSERT(flash);
+    /* must be call this function after initialize OK */
+    SFUD_ASSERT(flash->init_ok);
+
+    format = &flash->read_cmd_format;
+    ins = (format->address_size == 32) ? format->instruction - 1 : format->instruction;
+    /* only Dual/Quad I/O fast read has the mode bits */
+    if (ins != SFUD_CMD_DUAL_IO_READ_DATA && ins != SFUD_CMD_QUAD_IO_READ_DATA) {
+        return enabled ? SFUD_ERR_NOT_FOUND : SFUD_SUCCESS;
+    }
+    /* the mode bits take the first dummy byte */
+    mode_cycles = 8 / format->address_lines;
+
+    if (enabled && format->alternate_bytes_lines == 0) {
+        format->alternate_bytes_lines = format->address_lines;
+        format->alternate_bytes = SFUD_QSPI_CONTINUOUS_READ_MODE;
+        format->dummy_cycles -= mode_cycles;
+    } else if (!enabled && format->alternate_bytes_lines != 0) {
+        format->alternate_bytes_lines = 0;
+        format->alternate_bytes = 0;
+        format->dummy_cycles += mode_cycles;
+        /* a read without instruction and zero mode bits releases the flash */
+        if (flash->qspi_continuous_read) {
+            return sfud_read(flash, 0, 1, &dummy);
+        }
+    }
+
+    return SFUD_SUCCESS;
+}
 #endif /* SFUD_USING_QSPI */
 
 /**
@@ -256,9 +299,13 @@ static sfud_err hardware_init(sfud_flash *flash) {
         return result;
     }
 
+    flash->busy_op = SFUD_BUSY_NONE;
+
 #ifdef SFUD_USING_QSPI
     /* set default read instruction */
     flash->read_cmd_format.instruction = SFUD_CMD_READ_DATA;
+    flash->read_cmd_format.alternate_bytes_lines = 0;
+    flash->qspi_continuous_read = false;
 #endif /* SFUD_USING_QSPI */
 
     /* SPI write read function must be initialize */
@@ -361,6 +408,9 @@ static sfud_err hardware_init(sfud_flash *flash) {
         return result;
     }
 
+    /* these manufacturers use 75h/7Ah for erase suspend/resume */
+    flash->suspend_support = (flash->chip.mf_id == SFUD_MF_ID_WINBOND) || (flash->chip.mf_id == SFUD_MF_ID_GIGADEVICE);
+
     /* if the flash is large than 16MB (256Mb) then enter in 4-Byte addressing mode */
     if (flash->chip.capacity > (1L << 24)) {
         result = set_4_byte_address_mode(flash, true);
@@ -400,6 +450,7 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
     uint8_t cmd_data[5], cmd_size;
+    bool suspended = false;
 
     SFUD_ASSERT(flash);
     SFUD_ASSERT(data);
@@ -415,7 +466,14 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
         spi->lock(spi);
     }
 
-    result = wait_busy(flash);
+    if (flash->busy_op == SFUD_BUSY_ERASE && flash->suspend_support
+            && (addr + size <= flash->busy_addr || addr >= flash->busy_addr + flash->busy_size)) {
+        /* read the other sectors while the erase is suspended, the erased one must wait for the end */
+        result = erase_suspend(flash, true);
+        suspended = (result == SFUD_SUCCESS);
+    } else {
+        result = busy_op_finish(flash);
+    }
 
     if (result == SFUD_SUCCESS) {
 #ifdef SFUD_USING_QSPI
@@ -430,6 +488,9 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
             result = spi->wr(spi, cmd_data, cmd_size, data, size);
         }
     }
+    if (suspended) {
+        erase_suspend(flash, false);
+    }
     /* unlock SPI */
     if (spi->unlock) {
         spi->unlock(spi);
@@ -458,6 +519,11 @@ sfud_err sfud_chip_erase(const sfud_flash *flash) {
         spi->lock(spi);
     }
 
+    result = busy_op_finish(flash);
+    if (result != SFUD_SUCCESS) {
+        goto __exit;
+    }
+
     /* set the flash write enable */
     result = set_write_enabled(flash, true);
     if (result != SFUD_SUCCESS) {
@@ -503,8 +569,6 @@ __exit:
  * @return result
  */
 sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
-    extern size_t sfud_sfdp_get_suitable_eraser(const sfud_flash *flash, uint32_t addr, size_t erase_size);
-
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
     uint8_t cmd_data[5], cmd_size, cur_erase_cmd;
@@ -528,23 +592,14 @@ sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
         spi->lock(spi);
     }
 
+    result = busy_op_finish(flash);
+    if (result != SFUD_SUCCESS) {
+        goto __exit;
+    }
+
     /* loop erase operate. erase unit is erase granularity */
     while (size) {
-        /* if this flash is support SFDP parameter, then used SFDP parameter supplies eraser */
-#ifdef SFUD_USING_SFDP
-        size_t eraser_index;
-        if (flash->sfdp.available) {
-            /* get the suitable eraser for erase process from SFDP parameter */
-            eraser_index = sfud_sfdp_get_suitable_eraser(flash, addr, size);
-            cur_erase_cmd = flash->sfdp.eraser[eraser_index].cmd;
-            cur_erase_size = flash->sfdp.eraser[eraser_index].size;
-        } else {
-#else
-        {
-#endif
-            cur_erase_cmd = flash->chip.erase_gran_cmd;
-            cur_erase_size = flash->chip.erase_gran;
-        }
+        cur_erase_size = get_eraser(flash, addr, size, &cur_erase_cmd);
         /* set the flash write enable */
         result = set_write_enabled(flash, true);
         if (result != SFUD_SUCCESS) {
@@ -592,6 +647,98 @@ __exit:
     return result;
 }
 
+sfud_err sfud_erase_start(const sfud_flash *flash, uint32_t addr, size_t size, size_t *erase_size) {
+    sfud_err result = SFUD_SUCCESS;
+    const sfud_spi *spi = &flash->spi;
+    uint8_t cmd_data[5], cmd_size, cur_erase_cmd;
+    size_t cur_erase_size;
+
+    SFUD_ASSERT(flash);
+    SFUD_ASSERT(erase_size);
+    /* must be call this function after initialize OK */
+    SFUD_ASSERT(flash->init_ok);
+    /* check the flash address bound */
+    if (size == 0 || addr + size > flash->chip.capacity) {
+        SFUD_INFO("Error: Flash address is out of bound.");
+        return SFUD_ERR_ADDR_OUT_OF_BOUND;
+    }
+
+    /* lock SPI */
+    if (spi->lock) {
+        spi->lock(spi);
+    }
+
+    result = busy_op_finish(flash);
+    if (result != SFUD_SUCCESS) {
+        goto __exit;
+    }
+
+    cur_erase_size = get_eraser(flash, addr, size, &cur_erase_cmd);
+    result = set_write_enabled(flash, true);
+    if (result != SFUD_SUCCESS) {
+        goto __exit;
+    }
+
+    cmd_data[0] = cur_erase_cmd;
+    make_adress_byte_array(flash, addr, &cmd_data[1]);
+    cmd_size = flash->addr_in_4_byte ? 5 : 4;
+    result = spi->wr(spi, cmd_data, cmd_size, NULL, 0);
+    if (result != SFUD_SUCCESS) {
+        SFUD_INFO("Error: Flash erase SPI communicate error.");
+        goto __exit;
+    }
+    /* the write enable latch is cleared by the flash when the erase is done */
+    ((sfud_flash *) flash)->busy_op = SFUD_BUSY_ERASE;
+    ((sfud_flash *) flash)->busy_addr = addr - addr % cur_erase_size;
+    ((sfud_flash *) flash)->busy_size = cur_erase_size;
+
+    cur_erase_size -= addr % cur_erase_size;
+    *erase_size = (size > cur_erase_size) ? cur_erase_size : size;
+
+__exit:
+    /* unlock SPI */
+    if (spi->unlock) {
+        spi->unlock(spi);
+    }
+
+    return result;
+}
+
+sfud_err sfud_busy_check(const sfud_flash *flash, bool *busy) {
+    sfud_err result = SFUD_SUCCESS;
+    const sfud_spi *spi = &flash->spi;
+    uint8_t status;
+
+    SFUD_ASSERT(flash);
+    SFUD_ASSERT(busy);
+
+    *busy = false;
+    if (flash->busy_op == SFUD_BUSY_NONE) {
+        return SFUD_SUCCESS;
+    }
+
+    /* lock SPI */
+    if (spi->lock) {
+        spi->lock(spi);
+    }
+
+    result = sfud_read_status(flash, &status);
+    if (result == SFUD_SUCCESS) {
+        if (status & SFUD_STATUS_REGISTER_BUSY) {
+            *busy = true;
+        } else {
+            ((sfud_flash *) flash)->busy_op = SFUD_BUSY_NONE;
+        }
+    }
+
+    /* unlock SPI */
+    if (spi->unlock) {
+        spi->unlock(spi);
+    }
+
+    return result;
+}
+
 /**
  * write flash data (no erase operate) for write 1 to 256 bytes per page mode or byte write mode
  *
@@ -626,6 +773,11 @@ static sfud_err page256_or_1_byte_write(const sfud_flash *flash, uint32_t addr,
         spi->lock(spi);
     }
 
+    result = busy_op_finish(flash);
+    if (result != SFUD_SUCCESS) {
+        goto __exit;
+    }
+
     /* loop write operate. write unit is write granularity */
     while (size) {
         /* set the flash write enable */
@@ -709,6 +861,10 @@ static sfud_err aai_write(const sfud_flash *flash, uint32_t addr, size_t size, c
     if (spi->lock) {
         spi->lock(spi);
     }
+    result = busy_op_finish(flash);
+    if (result != SFUD_SUCCESS) {
+        goto __exit;
+    }
     /* The address must be even for AAI write mode. So it must write one byte first when address is odd. */
     if (addr % 2 != 0) {
         result = page256_or_1_byte_write(flash, addr++, 1, 1, data++);
@@ -990,6 +1146,66 @@ static sfud_err wait_busy(const sfud_flash *flash) {
     return result;
 }
 
+/**
+ * wait for the operation started by sfud_erase_start(), the SPI must be locked
+ */
+static sfud_err busy_op_finish(const sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+
+    if (flash->busy_op != SFUD_BUSY_NONE) {
+        result = wait_busy(flash);
+        if (result == SFUD_SUCCESS) {
+            ((sfud_flash *) flash)->busy_op = SFUD_BUSY_NONE;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * suspend or resume the running erase, the SPI must be locked
+ */
+static sfud_err erase_suspend(const sfud_flash *flash, bool suspend) {
+    sfud_err result = SFUD_SUCCESS;
+    uint8_t cmd = suspend ? SFUD_CMD_ERASE_SUSPEND : SFUD_CMD_ERASE_RESUME;
+
+    result = flash->spi.wr(&flash->spi, &cmd, 1, NULL, 0);
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+
+    if (suspend) {
+        /* busy is cleared after tSUS, resuming a finished erase is ignored by the flash */
+        result = wait_busy(flash);
+    } else if (flash->retry.delay) {
+        /* let the erase make progress before the next suspend */
+        flash->retry.delay();
+    }
+
+    return result;
+}
+
+/**
+ * get the largest eraser which is aligned to the address and fits the size
+ *
+ * @return erase size of the eraser
+ */
+static size_t get_eraser(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t *cmd) {
+#ifdef SFUD_USING_SFDP
+    extern size_t sfud_sfdp_get_suitable_eraser(const sfud_flash *flash, uint32_t addr, size_t erase_size);
+
+    /* if this flash is support SFDP parameter, then used SFDP parameter supplies eraser */
+    if (flash->sfdp.available) {
+        size_t eraser_index = sfud_sfdp_get_suitable_eraser(flash, addr, size);
+        *cmd = flash->sfdp.eraser[eraser_index].cmd;
+        return flash->sfdp.eraser[eraser_index].size;
+    }
+#endif
+
+    *cmd = flash->chip.erase_gran_cmd;
+    return flash->chip.erase_gran;
+}
+
 static void make_adress_byte_array(const sfud_flash *flash, uint32_t addr, uint8_t *array) {
     uint8_t len, i;
 
@@ -125,6 +125,26 @@ static rt_size_t rt_sfud_write(rt_device_t dev, rt_off_t pos, const void* buffer
 /**
  * SPI write data then read data
  */
+#ifdef SFUD_USING_QSPI
+static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi_read_cmd_format *qspi_read_cmd_format, uint8_t *read_buf, size_t read_size);
+
+/**
+ * Release the flash from continuous read mode before a normal command
+ */
+static sfud_err qspi_continuous_read_exit(const sfud_spi *spi, sfud_flash *sfud_dev) {
+    sfud_qspi_read_cmd_format format = sfud_dev->read_cmd_format;
+    uint8_t dummy;
+
+    format.alternate_bytes_lines = format.address_lines;
+    format.alternate_bytes = 0;
+    if (sfud_dev->read_cmd_format.alternate_bytes_lines == 0) {
+        format.dummy_cycles -= 8 / format.address_lines;
+    }
+
+    return qspi_read(spi, 0, &format, &dummy, 1);
+}
+#endif /* SFUD_USING_QSPI */
+
 static sfud_err spi_write_read(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
         size_t read_size) {
     sfud_err result = SFUD_SUCCESS;
@@ -146,6 +166,12 @@ static sfud_err spi_write_read(const sfud_spi *spi, const uint8_t *write_buf, si
 #ifdef SFUD_USING_QSPI
     if(rtt_dev->rt_spi_device->bus->mode & RT_SPI_BUS_MODE_QSPI) {
         qspi_dev = (struct rt_qspi_device *) (rtt_dev->rt_spi_device);
+        if (sfud_dev->qspi_continuous_read) {
+            result = qspi_continuous_read_exit(spi, sfud_dev);
+            if (result != SFUD_SUCCESS) {
+                return result;
+            }
+        }
         if (write_size && read_size) {
             if (rt_qspi_send_then_recv(qspi_dev, write_buf, write_size, read_buf, read_size) <= 0) {
                 result = SFUD_ERR_TIMEOUT;
@@ -195,16 +221,22 @@ static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi
     RT_ASSERT(qspi_dev);
 
     /* set message struct */
-    message.instruction.content = qspi_read_cmd_format->instruction;
-    message.instruction.qspi_lines = qspi_read_cmd_format->instruction_lines;
+    if (sfud_dev->qspi_continuous_read) {
+        /* the flash still holds the read instruction */
+        message.instruction.content = 0;
+        message.instruction.qspi_lines = 0;
+    } else {
+        message.instruction.content = qspi_read_cmd_format->instruction;
+        message.instruction.qspi_lines = qspi_read_cmd_format->instruction_lines;
+    }
 
     message.address.content = addr;
     message.address.size = qspi_read_cmd_format->address_size;
     message.address.qspi_lines = qspi_read_cmd_format->address_lines;
 
-    message.alternate_bytes.content = 0;
-    message.alternate_bytes.size = 0;
-    message.alternate_bytes.qspi_lines = 0;
+    message.alternate_bytes.content = qspi_read_cmd_format->alternate_bytes;
+    message.alternate_bytes.size = qspi_read_cmd_format->alternate_bytes_lines ? 8 : 0;
+    message.alternate_bytes.qspi_lines = qspi_read_cmd_format->alternate_bytes_lines;
 
     message.dummy_cycles = qspi_read_cmd_format->dummy_cycles;
 
@@ -217,6 +249,9 @@ static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi
 
     if (rt_qspi_transfer_message(qspi_dev, &message) != read_size) {
         result = SFUD_ERR_TIMEOUT;
+    } else {
+        sfud_dev->qspi_continuous_read = (qspi_read_cmd_format->alternate_bytes_lines != 0)
+                && ((qspi_read_cmd_format->alternate_bytes & 0x30) == SFUD_QSPI_CONTINUOUS_READ_MODE);
     }
 
     return result;
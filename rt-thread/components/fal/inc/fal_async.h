@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef _FAL_ASYNC_H_
+#define _FAL_ASYNC_H_
+
+#include <fal.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * request done callback, it runs in the worker thread
+ *
+ * @param part partition
+ * @param addr relative address for partition
+ * @param result >= 0: the erased or written size, -1: error
+ * @param arg user argument
+ */
+typedef void (*fal_async_cb)(const struct fal_partition *part, uint32_t addr, int result, void *arg);
+
+/**
+ * queue an erase of the partition.
+ * Adjacent erases which are waiting in the queue are merged, so the flash
+ * can use its 32K/64K block erase.
+ *
+ * @param part partition
+ * @param addr relative address for partition
+ * @param size erase size
+ * @param cb done callback, may be NULL
+ * @param arg callback argument
+ *
+ * @return RT_EOK: queued, < 0: error code
+ */
+int fal_async_erase(const struct fal_partition *part, uint32_t addr, size_t size, fal_async_cb cb, void *arg);
+
+/**
+ * queue a write of the partition.
+ * The data is programmed in pages, other threads may read the flash between pages.
+ *
+ * @param buf write buffer, it must be kept until the callback is called
+ *
+ * @return RT_EOK: queued, < 0: error code
+ */
+int fal_async_write(const struct fal_partition *part, uint32_t addr, const uint8_t *buf, size_t size,
+                    fal_async_cb cb, void *arg);
+
+/**
+ * wait for all queued requests
+ *
+ * @param timeout timeout in ticks, RT_WAITING_FOREVER for no timeout
+ *
+ * @return RT_EOK: the queue is empty, -RT_ETIMEOUT: timeout
+ */
+int fal_async_sync(rt_int32_t timeout);
+
+/**
+ * print the queue statistics
+ */
+void fal_async_show(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FAL_ASYNC_H_ */
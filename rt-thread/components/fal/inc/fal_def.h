@@ -89,6 +89,10 @@ struct fal_flash_dev
         int (*read)(long offset, uint8_t *buf, size_t size);
         int (*write)(long offset, const uint8_t *buf, size_t size);
         int (*erase)(long offset, size_t size);
+        /* optional, start one erase without waiting for it and return the covered size */
+        int (*erase_start)(long offset, size_t size);
+        /* optional, 1: the started erase is still running, 0: done, < 0: error */
+        int (*busy)(void);
     } ops;
 
     /* write minimum granularity, unit: bit.
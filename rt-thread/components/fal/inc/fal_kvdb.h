@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef _FAL_KVDB_H_
+#define _FAL_KVDB_H_
+
+#include <fal.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the key-value and log store works on FAL partitions */
+#define FAL_KVDB_TYPE_KV               0
+#define FAL_KVDB_TYPE_LOG              1
+
+#ifndef FAL_KVDB_KEY_MAX
+#define FAL_KVDB_KEY_MAX               64
+#endif
+
+/* erase count gap which triggers static wear levelling */
+#ifndef FAL_KVDB_WL_THRESHOLD
+#define FAL_KVDB_WL_THRESHOLD          64
+#endif
+
+/* in-RAM state of one erase sector */
+struct fal_kvdb_sector
+{
+    uint32_t erase_cnt;                /* erase count restored from the sector header */
+    uint32_t seq;                      /* open sequence, 0xFFFFFFFF when the sector is free */
+    uint32_t used;                     /* append offset inside the sector */
+    uint32_t live;                     /* bytes of records which are still referenced */
+    uint8_t  state;
+};
+
+/* in-RAM hash index entry, addr bit31 marks a tombstone */
+struct fal_kvdb_index
+{
+    uint32_t hash;
+    uint32_t addr;
+};
+
+struct fal_kvdb
+{
+    const char *name;
+    const struct fal_partition *part;
+    uint8_t type;
+
+    uint32_t sec_size;
+    uint32_t sec_num;
+    struct fal_kvdb_sector *sectors;
+    uint32_t cur_sec;                  /* sector which takes new records */
+    uint32_t next_seq;
+
+    struct fal_kvdb_index *index;
+    uint32_t index_size;               /* power of two */
+    uint32_t index_used;
+
+    /* statistics */
+    uint32_t gc_count;
+    uint32_t wl_count;
+    uint32_t recovered;                /* damaged records or sectors dropped by the last mount scan */
+
+    struct rt_mutex lock;
+    uint8_t init_ok;
+};
+typedef struct fal_kvdb *fal_kvdb_t;
+
+/**
+ * key-value iterator callback
+ *
+ * @return 0: continue, others: stop the iteration
+ */
+typedef int (*fal_kvdb_kv_cb)(fal_kvdb_t db, const char *key, uint32_t value_len, void *arg);
+
+/**
+ * log iterator callback, records are walked from the oldest to the newest
+ *
+ * @return 0: continue, others: stop the iteration
+ */
+typedef int (*fal_kvdb_log_cb)(fal_kvdb_t db, const uint8_t *buf, uint32_t len, void *arg);
+
+/**
+ * mount a key-value or log store on the partition.
+ * The partition is scanned, damaged records left by a power failure are dropped
+ * and the hash index is rebuilt.
+ *
+ * @param db the store object
+ * @param name store name
+ * @param part_name FAL partition name
+ * @param type FAL_KVDB_TYPE_KV or FAL_KVDB_TYPE_LOG
+ * @param index_size hash index slots (rounded up to power of two), unused for log store
+ *
+ * @return RT_EOK: success, < 0: error code
+ */
+int fal_kvdb_init(fal_kvdb_t db, const char *name, const char *part_name, uint8_t type, uint32_t index_size);
+
+/**
+ * release the RAM resource of the store
+ */
+int fal_kvdb_deinit(fal_kvdb_t db);
+
+/**
+ * erase the whole partition while keeping the per-sector erase counters
+ */
+int fal_kvdb_format(fal_kvdb_t db);
+
+/**
+ * set the value of the key, the old value is replaced
+ *
+ * @return RT_EOK: success, < 0: error code
+ */
+int fal_kvdb_set(fal_kvdb_t db, const char *key, const void *value, uint32_t len);
+
+/**
+ * get the value of the key
+ *
+ * @param value read buffer, may be NULL to query the length only
+ * @param len read buffer size
+ *
+ * @return >= 0: value length, -RT_EEMPTY: key not found, other < 0: error code
+ */
+int fal_kvdb_get(fal_kvdb_t db, const char *key, void *value, uint32_t len);
+
+/**
+ * delete the key
+ *
+ * @return RT_EOK: success, -RT_EEMPTY: key not found, other < 0: error code
+ */
+int fal_kvdb_del(fal_kvdb_t db, const char *key);
+
+/**
+ * walk all live keys of a key-value store
+ */
+int fal_kvdb_iterate(fal_kvdb_t db, fal_kvdb_kv_cb cb, void *arg);
+
+/**
+ * append a record to a log store, the oldest sector is recycled when the partition is full
+ */
+int fal_kvdb_log_append(fal_kvdb_t db, const void *buf, uint32_t len);
+
+/**
+ * walk all records of a log store
+ */
+int fal_kvdb_log_iterate(fal_kvdb_t db, fal_kvdb_log_cb cb, void *arg);
+
+/**
+ * print the usage, garbage collection and erase count statistics
+ */
+void fal_kvdb_show(fal_kvdb_t db);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FAL_KVDB_H_ */
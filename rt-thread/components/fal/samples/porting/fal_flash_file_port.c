@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * File backed NOR flash simulation.
+ * Programming only clears bits and erasing sets a whole block to 0xFF like a
+ * real NOR part, so the flash storage code can be tested on the host or on a
+ * board without touching the real chip. A power cut can be injected after a
+ * given number of program/erase operations.
+ */
+
+#include <fal.h>
+
+#ifdef FAL_USING_FILE_PORT
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#ifndef FAL_FILE_PORT_DEV_NAME
+#define FAL_FILE_PORT_DEV_NAME             "fileflash0"
+#endif
+
+#ifndef FAL_FILE_PORT_PATH
+#define FAL_FILE_PORT_PATH                 "/fal_flash.bin"
+#endif
+
+#ifndef FAL_FILE_PORT_SIZE
+#define FAL_FILE_PORT_SIZE                 (1024 * 1024)
+#endif
+
+#define FILE_PORT_BLK_SIZE                 4096
+#define FILE_PORT_BUF_SIZE                 256
+
+static int file_flash_init(void);
+static int file_flash_read(long offset, uint8_t *buf, size_t size);
+static int file_flash_write(long offset, const uint8_t *buf, size_t size);
+static int file_flash_erase(long offset, size_t size);
+
+struct fal_flash_dev file_flash0 =
+{
+    .name       = FAL_FILE_PORT_DEV_NAME,
+    .addr       = 0,
+    .len        = FAL_FILE_PORT_SIZE,
+    .blk_size   = FILE_PORT_BLK_SIZE,
+    .ops        = {file_flash_init, file_flash_read, file_flash_write, file_flash_erase},
+    .write_gran = 1
+};
+
+static int file_fd = -1;
+/* < 0: power cut disabled, 0: power is lost, > 0: operations left before the cut */
+static int powercut_ops = -1;
+
+/* statistics */
+static uint32_t program_bytes, erase_blocks;
+
+static int file_open(void)
+{
+    uint8_t buf[FILE_PORT_BUF_SIZE];
+    off_t size;
+
+    if (file_fd >= 0)
+    {
+        return 0;
+    }
+
+    /* the file system may not be mounted while FAL is initialized, open the file lazily */
+    file_fd = open(FAL_FILE_PORT_PATH, O_RDWR | O_CREAT, 0666);
+    if (file_fd < 0)
+    {
+        log_e("Open flash file %s failed.", FAL_FILE_PORT_PATH);
+        return -1;
+    }
+
+    /* a new file is a blank chip */
+    memset(buf, 0xFF, sizeof(buf));
+    size = lseek(file_fd, 0, SEEK_END);
+    while (size < (off_t)file_flash0.len)
+    {
+        if (write(file_fd, buf, sizeof(buf)) != sizeof(buf))
+        {
+            close(file_fd);
+            file_fd = -1;
+            return -1;
+        }
+        size += sizeof(buf);
+    }
+
+    return 0;
+}
+
+/* return the bytes the operation may touch before the power is lost */
+static size_t powercut_check(size_t size)
+{
+    if (powercut_ops < 0)
+    {
+        return size;
+    }
+    else if (powercut_ops == 0)
+    {
+        return 0;
+    }
+    else if (--powercut_ops == 0)
+    {
+        /* the operation in progress is torn */
+        return size / 2;
+    }
+
+    return size;
+}
+
+/**
+ * inject a power cut
+ *
+ * @param ops > 0: the power is lost during the ops-th program/erase operation
+ *              0: restore the power
+ */
+void fal_file_flash_powercut(int ops)
+{
+    powercut_ops = (ops > 0) ? ops : -1;
+}
+
+void fal_file_flash_stat(uint32_t *program, uint32_t *erase)
+{
+    *program = program_bytes;
+    *erase = erase_blocks;
+}
+
+static int file_flash_init(void)
+{
+    return 0;
+}
+
+static int file_flash_read(long offset, uint8_t *buf, size_t size)
+{
+    if (file_open() < 0 || lseek(file_fd, offset, SEEK_SET) != offset)
+    {
+        return -1;
+    }
+
+    return read(file_fd, buf, size) == (int)size ? (int)size : -1;
+}
+
+static int file_flash_write(long offset, const uint8_t *buf, size_t size)
+{
+    uint8_t old[FILE_PORT_BUF_SIZE];
+    size_t i, len, done, allowed;
+
+    if (file_open() < 0)
+    {
+        return -1;
+    }
+
+    allowed = powercut_check(size);
+    for (done = 0; done < allowed; done += len)
+    {
+        len = (allowed - done > sizeof(old)) ? sizeof(old) : allowed - done;
+        if (lseek(file_fd, offset + done, SEEK_SET) != (off_t)(offset + done) || read(file_fd, old, len) != (int)len)
+        {
+            return -1;
+        }
+        /* NOR programming can only clear bits */
+        for (i = 0; i < len; i++)
+        {
+            old[i] &= buf[done + i];
+        }
+        if (lseek(file_fd, offset + done, SEEK_SET) != (off_t)(offset + done) || write(file_fd, old, len) != (int)len)
+        {
+            return -1;
+        }
+    }
+    program_bytes += allowed;
+
+    return (allowed == size) ? (int)size : -1;
+}
+
+static int file_flash_erase(long offset, size_t size)
+{
+    uint8_t buf[FILE_PORT_BUF_SIZE];
+    long start = offset & ~(FILE_PORT_BLK_SIZE - 1);
+    size_t len, done, allowed;
+
+    if (file_open() < 0)
+    {
+        return -1;
+    }
+
+    size = ((offset + size + FILE_PORT_BLK_SIZE - 1) & ~(FILE_PORT_BLK_SIZE - 1)) - start;
+    allowed = powercut_check(size);
+    memset(buf, 0xFF, sizeof(buf));
+    if (lseek(file_fd, start, SEEK_SET) != start)
+    {
+        return -1;
+    }
+    for (done = 0; done < allowed; done += len)
+    {
+        len = (allowed - done > sizeof(buf)) ? sizeof(buf) : allowed - done;
+        if (write(file_fd, buf, len) != (int)len)
+        {
+            return -1;
+        }
+    }
+    erase_blocks += allowed / FILE_PORT_BLK_SIZE;
+
+    return (allowed == size) ? (int)size : -1;
+}
+#endif /* FAL_USING_FILE_PORT */
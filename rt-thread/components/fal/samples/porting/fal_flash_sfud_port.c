@@ -24,6 +24,8 @@ static int init(void);
 static int read(long offset, uint8_t *buf, size_t size);
 static int write(long offset, const uint8_t *buf, size_t size);
 static int erase(long offset, size_t size);
+static int erase_start(long offset, size_t size);
+static int busy(void);
 
 static sfud_flash_t sfud_dev = NULL;
 struct fal_flash_dev nor_flash0 =
@@ -32,7 +34,7 @@ struct fal_flash_dev nor_flash0 =
     .addr       = 0,
     .len        = 8 * 1024 * 1024,
     .blk_size   = 4096,
-    .ops        = {init, read, write, erase},
+    .ops        = {init, read, write, erase, erase_start, busy},
     .write_gran = 1
 };
 
@@ -92,5 +94,32 @@ static int erase(long offset, size_t size)
 
     return size;
 }
+
+static int erase_start(long offset, size_t size)
+{
+    size_t erase_size;
+
+    assert(sfud_dev);
+    assert(sfud_dev->init_ok);
+    if (sfud_erase_start(sfud_dev, nor_flash0.addr + offset, size, &erase_size) != SFUD_SUCCESS)
+    {
+        return -1;
+    }
+
+    return erase_size;
+}
+
+static int busy(void)
+{
+    bool is_busy;
+
+    assert(sfud_dev);
+    if (sfud_busy_check(sfud_dev, &is_busy) != SFUD_SUCCESS)
+    {
+        return -1;
+    }
+
+    return is_busy ? 1 : 0;
+}
 #endif /* FAL_USING_SFUD_PORT */
 
@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#include <fal.h>
+
+#ifdef FAL_USING_ASYNC
+
+#include <fal_async.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*
+ * One worker thread runs the queued requests in order:
+ *
+ * - Erases which are waiting in the queue and continue each other on the same
+ *   partition are merged, so the flash driver can pick 32K/64K block erases.
+ * - When the flash device has the erase_start/busy ops, the worker starts one
+ *   erase and sleeps while the flash is busy instead of holding the bus in a
+ *   status polling loop. Readers get the bus meanwhile, the SFUD port suspends
+ *   the erase for them when the chip supports it.
+ * - Writes are split on page boundaries, so readers only wait for one page
+ *   program at most.
+ */
+
+#ifndef FAL_ASYNC_THREAD_PRIORITY
+#define FAL_ASYNC_THREAD_PRIORITY      20
+#endif
+
+#ifndef FAL_ASYNC_THREAD_STACK_SIZE
+#define FAL_ASYNC_THREAD_STACK_SIZE    2048
+#endif
+
+#ifndef FAL_ASYNC_POLL_MS
+#define FAL_ASYNC_POLL_MS              2
+#endif
+
+#define ASYNC_WRITE_PAGE               256
+
+#define ASYNC_OP_ERASE                 0
+#define ASYNC_OP_WRITE                 1
+
+/* erase duration classes: < 32K, < 64K, >= 64K */
+#define ASYNC_ERASE_CLASS_NUM          3
+
+struct fal_async_req
+{
+    rt_list_t list;
+    const struct fal_partition *part;
+    uint8_t op;
+    uint32_t addr;
+    size_t size;
+    const uint8_t *buf;
+    fal_async_cb cb;
+    void *arg;
+};
+
+struct fal_async
+{
+    rt_list_t queue;
+    struct rt_mutex lock;
+    struct rt_semaphore sem;
+    rt_thread_t thread;
+    /* queued and running requests */
+    uint32_t pending;
+
+    /* learned erase time of each class, ms */
+    uint32_t erase_ms[ASYNC_ERASE_CLASS_NUM];
+
+    /* statistics */
+    uint32_t requests;
+    uint32_t merged;
+    uint32_t erase_ops[ASYNC_ERASE_CLASS_NUM];
+    uint32_t polls;
+    uint32_t pages;
+    uint32_t errors;
+    uint32_t max_pending;
+};
+
+static struct fal_async async_obj;
+
+static int async_erase_class(size_t size)
+{
+    if (size < 32 * 1024)
+    {
+        return 0;
+    }
+    else if (size < 64 * 1024)
+    {
+        return 1;
+    }
+
+    return 2;
+}
+
+/* wait for the started erase, sleep for the most of the expected time first */
+static int async_erase_wait(const struct fal_flash_dev *flash_dev, int cls)
+{
+    struct fal_async *async = &async_obj;
+    rt_tick_t start = rt_tick_get();
+    uint32_t ms;
+    int busy;
+
+    if (async->erase_ms[cls] > FAL_ASYNC_POLL_MS)
+    {
+        rt_thread_mdelay(async->erase_ms[cls] * 3 / 4);
+    }
+
+    while ((busy = flash_dev->ops.busy()) > 0)
+    {
+        async->polls++;
+        rt_thread_mdelay(FAL_ASYNC_POLL_MS);
+    }
+
+    /* moving average, the first sample is taken as it is */
+    ms = (rt_tick_get() - start) * 1000 / RT_TICK_PER_SECOND;
+    async->erase_ms[cls] = async->erase_ms[cls] ? (async->erase_ms[cls] * 7 + ms) / 8 : ms;
+
+    return busy;
+}
+
+static int async_erase(const struct fal_partition *part, uint32_t addr, size_t size)
+{
+    struct fal_async *async = &async_obj;
+    const struct fal_flash_dev *flash_dev;
+    long offset, end;
+    int ret, cls;
+
+    flash_dev = fal_flash_device_find(part->flash_name);
+    if (flash_dev == NULL || addr + size > part->len)
+    {
+        return -1;
+    }
+
+    if (flash_dev->ops.erase_start == NULL || flash_dev->ops.busy == NULL)
+    {
+        async->erase_ops[async_erase_class(flash_dev->blk_size)]++;
+        return fal_partition_erase(part, addr, size);
+    }
+
+    offset = part->offset + addr;
+    end = offset + size;
+    while (offset < end)
+    {
+        ret = flash_dev->ops.erase_start(offset, end - offset);
+        if (ret <= 0)
+        {
+            log_e("Async erase error! Flash device(%s) erase error!", part->flash_name);
+            return -1;
+        }
+
+        /* the covered size tells which eraser was used */
+        cls = async_erase_class(ret + (offset % flash_dev->blk_size));
+        async->erase_ops[cls]++;
+        if (async_erase_wait(flash_dev, cls) < 0)
+        {
+            return -1;
+        }
+        offset += ret;
+    }
+
+    return size;
+}
+
+static int async_write(const struct fal_partition *part, uint32_t addr, const uint8_t *buf, size_t size)
+{
+    struct fal_async *async = &async_obj;
+    size_t done, len;
+
+    for (done = 0; done < size; done += len)
+    {
+        /* one page program per bus lock */
+        len = ASYNC_WRITE_PAGE - ((part->offset + addr + done) % ASYNC_WRITE_PAGE);
+        if (len > size - done)
+        {
+            len = size - done;
+        }
+        if (fal_partition_write(part, addr + done, buf + done, len) < 0)
+        {
+            return -1;
+        }
+        async->pages++;
+    }
+
+    return size;
+}
+
+static void async_done(struct fal_async_req *req, int result)
+{
+    struct fal_async *async = &async_obj;
+
+    if (result < 0)
+    {
+        async->errors++;
+    }
+    if (req->cb)
+    {
+        req->cb(req->part, req->addr, result, req->arg);
+    }
+    FAL_FREE(req);
+
+    rt_mutex_take(&async->lock, RT_WAITING_FOREVER);
+    async->pending--;
+    rt_mutex_release(&async->lock);
+}
+
+static void fal_async_entry(void *parameter)
+{
+    struct fal_async *async = (struct fal_async *)parameter;
+    struct fal_async_req *req, *next;
+    rt_list_t merged;
+    size_t size;
+    int result;
+
+    while (1)
+    {
+        rt_sem_take(&async->sem, RT_WAITING_FOREVER);
+
+        rt_list_init(&merged);
+        rt_mutex_take(&async->lock, RT_WAITING_FOREVER);
+        req = rt_list_first_entry(&async->queue, struct fal_async_req, list);
+        rt_list_remove(&req->list);
+        size = req->size;
+        /* take the erases which continue this one */
+        while (req->op == ASYNC_OP_ERASE && !rt_list_isempty(&async->queue))
+        {
+            next = rt_list_first_entry(&async->queue, struct fal_async_req, list);
+            if (next->op != ASYNC_OP_ERASE || next->part != req->part || next->addr != req->addr + size)
+            {
+                break;
+            }
+            rt_list_remove(&next->list);
+            rt_list_insert_before(&merged, &next->list);
+            size += next->size;
+            async->merged++;
+            rt_sem_trytake(&async->sem);
+        }
+        rt_mutex_release(&async->lock);
+
+        if (req->op == ASYNC_OP_ERASE)
+        {
+            result = async_erase(req->part, req->addr, size);
+        }
+        else
+        {
+            result = async_write(req->part, req->addr, req->buf, req->size);
+        }
+
+        while (!rt_list_isempty(&merged))
+        {
+            next = rt_list_first_entry(&merged, struct fal_async_req, list);
+            rt_list_remove(&next->list);
+            async_done(next, (result < 0) ? -1 : (int)next->size);
+        }
+        async_done(req, (result < 0) ? -1 : (int)req->size);
+    }
+}
+
+static int async_submit(const struct fal_partition *part, uint8_t op, uint32_t addr, const uint8_t *buf, size_t size,
+                        fal_async_cb cb, void *arg)
+{
+    struct fal_async *async = &async_obj;
+    struct fal_async_req *req;
+
+    assert(part);
+
+    if (async->thread == RT_NULL)
+    {
+        return -RT_ERROR;
+    }
+    if (addr + size > part->len)
+    {
+        log_e("Async request error! Partition address out of bound.");
+        return -RT_EINVAL;
+    }
+
+    req = FAL_MALLOC(sizeof(struct fal_async_req));
+    if (req == NULL)
+    {
+        return -RT_ENOMEM;
+    }
+    req->part = part;
+    req->op = op;
+    req->addr = addr;
+    req->size = size;
+    req->buf = buf;
+    req->cb = cb;
+    req->arg = arg;
+
+    rt_mutex_take(&async->lock, RT_WAITING_FOREVER);
+    rt_list_insert_before(&async->queue, &req->list);
+    async->requests++;
+    if (++async->pending > async->max_pending)
+    {
+        async->max_pending = async->pending;
+    }
+    rt_mutex_release(&async->lock);
+
+    rt_sem_release(&async->sem);
+
+    return RT_EOK;
+}
+
+int fal_async_erase(const struct fal_partition *part, uint32_t addr, size_t size, fal_async_cb cb, void *arg)
+{
+    return async_submit(part, ASYNC_OP_ERASE, addr, NULL, size, cb, arg);
+}
+
+int fal_async_write(const struct fal_partition *part, uint32_t addr, const uint8_t *buf, size_t size,
+                    fal_async_cb cb, void *arg)
+{
+    assert(buf);
+
+    return async_submit(part, ASYNC_OP_WRITE, addr, buf, size, cb, arg);
+}
+
+int fal_async_sync(rt_int32_t timeout)
+{
+    struct fal_async *async = &async_obj;
+    rt_tick_t start = rt_tick_get();
+
+    while (async->pending)
+    {
+        if (timeout != RT_WAITING_FOREVER && (rt_int32_t)(rt_tick_get() - start) >= timeout)
+        {
+            return -RT_ETIMEOUT;
+        }
+        rt_thread_mdelay(FAL_ASYNC_POLL_MS);
+    }
+
+    return RT_EOK;
+}
+
+void fal_async_show(void)
+{
+    struct fal_async *async = &async_obj;
+
+    rt_kprintf("requests   : %d (%d erases merged), pending %d, max pending %d\n",
+               async->requests, async->merged, async->pending, async->max_pending);
+    rt_kprintf("erase ops  : %d small, %d 32K, %d 64K\n",
+               async->erase_ops[0], async->erase_ops[1], async->erase_ops[2]);
+    rt_kprintf("erase time : %d ms, %d ms, %d ms\n",
+               async->erase_ms[0], async->erase_ms[1], async->erase_ms[2]);
+    rt_kprintf("busy polls : %d, pages %d, errors %d\n", async->polls, async->pages, async->errors);
+}
+
+static int fal_async_init(void)
+{
+    struct fal_async *async = &async_obj;
+
+    rt_list_init(&async->queue);
+    rt_mutex_init(&async->lock, "fal_as", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&async->sem, "fal_as", 0, RT_IPC_FLAG_FIFO);
+
+    async->thread = rt_thread_create("fal_as", fal_async_entry, async,
+                                     FAL_ASYNC_THREAD_STACK_SIZE, FAL_ASYNC_THREAD_PRIORITY, 10);
+    if (async->thread == RT_NULL)
+    {
+        log_e("Create the async flash thread failed.");
+        return -RT_ENOMEM;
+    }
+
+    return rt_thread_startup(async->thread);
+}
+INIT_COMPONENT_EXPORT(fal_async_init);
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+
+struct async_bench_reader
+{
+    const struct fal_partition *part;
+    volatile rt_bool_t running;
+    uint32_t reads;
+    uint32_t max_ms;
+    struct rt_semaphore exit;
+};
+
+/* read the other partition periodically and keep the worst latency */
+static void async_bench_reader_entry(void *parameter)
+{
+    struct async_bench_reader *reader = (struct async_bench_reader *)parameter;
+    uint8_t buf[256];
+    rt_tick_t start;
+    uint32_t ms;
+
+    while (reader->running)
+    {
+        start = rt_tick_get();
+        fal_partition_read(reader->part, (reader->reads * sizeof(buf)) % reader->part->len, buf, sizeof(buf));
+        ms = (rt_tick_get() - start) * 1000 / RT_TICK_PER_SECOND;
+        if (ms > reader->max_ms)
+        {
+            reader->max_ms = ms;
+        }
+        reader->reads++;
+        rt_thread_mdelay(5);
+    }
+    rt_sem_release(&reader->exit);
+}
+
+static void async_bench_run(const struct fal_partition *part, size_t size, const struct fal_partition *read_part,
+                            rt_bool_t async)
+{
+    const struct fal_flash_dev *flash_dev = fal_flash_device_find(part->flash_name);
+    struct async_bench_reader reader;
+    rt_thread_t tid = RT_NULL;
+    rt_tick_t start;
+    size_t off;
+    int result = 0;
+
+    memset(&reader, 0, sizeof(reader));
+    if (read_part)
+    {
+        reader.part = read_part;
+        reader.running = RT_TRUE;
+        rt_sem_init(&reader.exit, "fal_ab", 0, RT_IPC_FLAG_FIFO);
+        tid = rt_thread_create("fal_ab", async_bench_reader_entry, &reader, 1024, FAL_ASYNC_THREAD_PRIORITY - 1, 10);
+        if (tid)
+        {
+            rt_thread_startup(tid);
+        }
+    }
+
+    start = rt_tick_get();
+    for (off = 0; off < size && result >= 0; off += flash_dev->blk_size)
+    {
+        /* the same sector sized erases a file system or a store issues */
+        if (async)
+        {
+            result = fal_async_erase(part, off, flash_dev->blk_size, NULL, NULL);
+        }
+        else
+        {
+            result = fal_partition_erase(part, off, flash_dev->blk_size);
+        }
+    }
+    if (async)
+    {
+        fal_async_sync(RT_WAITING_FOREVER);
+    }
+    start = rt_tick_get() - start;
+
+    if (tid)
+    {
+        reader.running = RT_FALSE;
+        rt_sem_take(&reader.exit, RT_WAITING_FOREVER);
+    }
+    if (read_part)
+    {
+        rt_sem_detach(&reader.exit);
+    }
+
+    rt_kprintf("%-5s erase %d bytes: %d ms", async ? "async" : "sync", size, start * 1000 / RT_TICK_PER_SECOND);
+    if (read_part)
+    {
+        rt_kprintf(", %d reads on %s, max latency %d ms", reader.reads, read_part->name, reader.max_ms);
+    }
+    rt_kprintf("\n");
+}
+
+static void fal_async(uint8_t argc, char **argv)
+{
+    const char *help_info[] =
+    {
+        "fal_async show                          - show the queue statistics",
+        "fal_async bench <part> <size> [rd_part] - sync vs async erase, optional reads on another partition",
+    };
+    const struct fal_partition *part, *read_part = NULL;
+    size_t i, size;
+
+    if (argc >= 2 && !strcmp(argv[1], "show"))
+    {
+        fal_async_show();
+    }
+    else if (argc >= 4 && !strcmp(argv[1], "bench"))
+    {
+        part = fal_partition_find(argv[2]);
+        if (part == NULL)
+        {
+            rt_kprintf("Partition %s not found.\n", argv[2]);
+            return;
+        }
+        if (argc >= 5 && (read_part = fal_partition_find(argv[4])) == NULL)
+        {
+            rt_kprintf("Partition %s not found.\n", argv[4]);
+            return;
+        }
+        size = strtoul(argv[3], NULL, 0);
+        if (size == 0 || size > part->len)
+        {
+            size = part->len;
+        }
+        async_bench_run(part, size, read_part, RT_FALSE);
+        async_bench_run(part, size, read_part, RT_TRUE);
+        fal_async_show();
+    }
+    else
+    {
+        rt_kprintf("Usage:\n");
+        for (i = 0; i < sizeof(help_info) / sizeof(char *); i++)
+        {
+            rt_kprintf("%s\n", help_info[i]);
+        }
+    }
+}
+MSH_CMD_EXPORT(fal_async, FAL asynchronous erase/program queue.);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
+
+#endif /* FAL_USING_ASYNC */
@@ -0,0 +1,1599 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#include <fal.h>
+
+#ifdef FAL_USING_KVDB
+
+#include <fal_kvdb.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*
+ * Flash layout, every erase sector of the partition:
+ *
+ * +-----------------+---------+---------+-----+---------+--------------+
+ * | sector header   | record  | record  | ... | record  | 0xFF (blank) |
+ * +-----------------+---------+---------+-----+---------+--------------+
+ *
+ * The sector header carries the erase counter and the open sequence. Records
+ * are appended only, the newest record of a key wins. A record is protected by
+ * a CRC32 over its header fields, key and value, so a record torn by a power
+ * failure is dropped by the mount scan.
+ *
+ * Record: header, key, 0xFF up to the next word, value, 0xFF up to the next
+ * word. The value starts on a word so it is programmed in whole units of any
+ * write granularity up to 32 bits.
+ */
+
+#define KVDB_SEC_MAGIC                 0x5356464BUL   /* "KFVS" */
+#define KVDB_REC_MAGIC                 0x564BU        /* "KV"   */
+
+#define KVDB_REC_TYPE_KV               0x01
+#define KVDB_REC_TYPE_DEL              0x02
+#define KVDB_REC_TYPE_LOG              0x03
+
+#define KVDB_SEC_FREE                  0
+#define KVDB_SEC_USING                 1
+#define KVDB_SEC_DIRTY                 2
+
+#define KVDB_BLANK_WORD                0xFFFFFFFFUL
+#define KVDB_ADDR_DELETED              0x80000000UL
+#define KVDB_ADDR_MASK                 0x7FFFFFFFUL
+
+/* sectors kept free so garbage collection always has a relocation target */
+#define KVDB_GC_RESERVE                1
+
+#define KVDB_COPY_BUF_SIZE             64
+
+/* largest write granularity supported, in bytes */
+#define KVDB_WRITE_GRAN                4
+#define KVDB_ALIGN(size)               (((size) + (KVDB_WRITE_GRAN - 1)) & ~(KVDB_WRITE_GRAN - 1UL))
+
+struct kvdb_sec_hdr
+{
+    uint32_t magic;
+    uint32_t erase_cnt;
+    /* programmed when the sector is opened for appending */
+    uint32_t seq;
+    uint32_t crc;
+};
+
+struct kvdb_rec_hdr
+{
+    uint16_t magic;
+    uint8_t  type;
+    uint8_t  key_len;
+    uint32_t val_len;
+    uint32_t crc;
+};
+
+#define KVDB_SEC_HDR_SIZE              sizeof(struct kvdb_sec_hdr)
+#define KVDB_REC_HDR_SIZE              sizeof(struct kvdb_rec_hdr)
+
+static int kvdb_alloc(fal_kvdb_t db, uint32_t len, rt_bool_t in_gc, uint32_t *addr);
+
+static const uint32_t crc32_nibble_table[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static uint32_t kvdb_crc32(uint32_t crc, const void *buf, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+
+    crc = ~crc;
+    while (size--)
+    {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+    }
+
+    return ~crc;
+}
+
+/* FNV-1a */
+static uint32_t kvdb_hash(const char *key, size_t len)
+{
+    uint32_t hash = 2166136261UL;
+
+    while (len--)
+    {
+        hash ^= (uint8_t)(*key++);
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+static int kvdb_read(fal_kvdb_t db, uint32_t addr, void *buf, size_t size)
+{
+    return (fal_partition_read(db->part, addr, (uint8_t *)buf, size) < 0) ? -RT_EIO : RT_EOK;
+}
+
+static int kvdb_write(fal_kvdb_t db, uint32_t addr, const void *buf, size_t size)
+{
+    return (fal_partition_write(db->part, addr, (const uint8_t *)buf, size) < 0) ? -RT_EIO : RT_EOK;
+}
+
+/* offset of the value in a record */
+static uint32_t kvdb_val_off(uint8_t key_len)
+{
+    return KVDB_ALIGN(KVDB_REC_HDR_SIZE + key_len);
+}
+
+static uint32_t kvdb_rec_size(const struct kvdb_rec_hdr *hdr)
+{
+    return kvdb_val_off(hdr->key_len) + KVDB_ALIGN(hdr->val_len);
+}
+
+static uint32_t kvdb_rec_crc(const struct kvdb_rec_hdr *hdr)
+{
+    /* the CRC starts from the type field, the magic and the CRC itself are excluded */
+    return kvdb_crc32(0, &hdr->type, sizeof(hdr->type) + sizeof(hdr->key_len) + sizeof(hdr->val_len));
+}
+
+static struct fal_kvdb_sector *kvdb_addr_to_sec(fal_kvdb_t db, uint32_t addr)
+{
+    return &db->sectors[(addr & KVDB_ADDR_MASK) / db->sec_size];
+}
+
+/* =============== hash index =============== */
+
+static int kvdb_key_equal(fal_kvdb_t db, uint32_t addr, const char *key, size_t key_len)
+{
+    struct kvdb_rec_hdr hdr;
+    char buf[FAL_KVDB_KEY_MAX];
+
+    addr &= KVDB_ADDR_MASK;
+    if (kvdb_read(db, addr, &hdr, sizeof(hdr)) != RT_EOK || hdr.key_len != key_len)
+    {
+        return 0;
+    }
+    if (kvdb_read(db, addr + KVDB_REC_HDR_SIZE, buf, key_len) != RT_EOK)
+    {
+        return 0;
+    }
+
+    return memcmp(buf, key, key_len) == 0;
+}
+
+static struct fal_kvdb_index *kvdb_index_find(fal_kvdb_t db, const char *key, size_t key_len, uint32_t hash)
+{
+    uint32_t mask = db->index_size - 1, i;
+    struct fal_kvdb_index *slot;
+
+    for (i = hash & mask; ; i = (i + 1) & mask)
+    {
+        slot = &db->index[i];
+        if (slot->addr == 0)
+        {
+            return NULL;
+        }
+        if (slot->hash == hash && kvdb_key_equal(db, slot->addr, key, key_len))
+        {
+            return slot;
+        }
+    }
+}
+
+static void kvdb_index_place(struct fal_kvdb_index *table, uint32_t size, uint32_t hash, uint32_t addr)
+{
+    uint32_t i;
+
+    for (i = hash & (size - 1); table[i].addr != 0; i = (i + 1) & (size - 1));
+    table[i].hash = hash;
+    table[i].addr = addr;
+}
+
+static int kvdb_index_grow(fal_kvdb_t db)
+{
+    uint32_t i, size = db->index_size * 2;
+    struct fal_kvdb_index *table;
+
+    table = FAL_CALLOC(size, sizeof(struct fal_kvdb_index));
+    if (table == NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    for (i = 0; i < db->index_size; i++)
+    {
+        if (db->index[i].addr)
+        {
+            kvdb_index_place(table, size, db->index[i].hash, db->index[i].addr);
+        }
+    }
+
+    FAL_FREE(db->index);
+    db->index = table;
+    db->index_size = size;
+
+    return RT_EOK;
+}
+
+static int kvdb_index_insert(fal_kvdb_t db, uint32_t hash, uint32_t addr)
+{
+    /* keep the load factor under 3/4 so the probe sequences stay short */
+    if ((db->index_used + 1) * 4 > db->index_size * 3)
+    {
+        int result = kvdb_index_grow(db);
+        if (result != RT_EOK)
+        {
+            return result;
+        }
+    }
+
+    kvdb_index_place(db->index, db->index_size, hash, addr);
+    db->index_used++;
+
+    return RT_EOK;
+}
+
+/* backward shift deletion for linear probing, no tombstone slot is left behind */
+static void kvdb_index_remove(fal_kvdb_t db, struct fal_kvdb_index *slot)
+{
+    uint32_t mask = db->index_size - 1;
+    uint32_t hole = slot - db->index, i, home;
+
+    for (i = (hole + 1) & mask; db->index[i].addr != 0; i = (i + 1) & mask)
+    {
+        home = db->index[i].hash & mask;
+        /* move the entry when its home slot is not inside (hole, i] */
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            db->index[hole] = db->index[i];
+            hole = i;
+        }
+    }
+    db->index[hole].addr = 0;
+    db->index[hole].hash = 0;
+    db->index_used--;
+}
+
+/* =============== sector management =============== */
+
+static uint32_t kvdb_free_count(fal_kvdb_t db)
+{
+    uint32_t i, count = 0;
+
+    for (i = 0; i < db->sec_num; i++)
+    {
+        if (db->sectors[i].state == KVDB_SEC_FREE)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static int kvdb_sector_erase(fal_kvdb_t db, uint32_t idx)
+{
+    struct fal_kvdb_sector *sec = &db->sectors[idx];
+    struct kvdb_sec_hdr hdr;
+
+    sec->state = KVDB_SEC_DIRTY;
+    if (fal_partition_erase(db->part, idx * db->sec_size, db->sec_size) < 0)
+    {
+        return -RT_EIO;
+    }
+
+    sec->erase_cnt++;
+    hdr.magic = KVDB_SEC_MAGIC;
+    hdr.erase_cnt = sec->erase_cnt;
+    /* the magic is programmed last, a torn counter leaves the sector unformatted */
+    if (kvdb_write(db, idx * db->sec_size + offsetof(struct kvdb_sec_hdr, erase_cnt), &hdr.erase_cnt,
+                   sizeof(hdr.erase_cnt)) != RT_EOK ||
+            kvdb_write(db, idx * db->sec_size, &hdr.magic, sizeof(hdr.magic)) != RT_EOK)
+    {
+        return -RT_EIO;
+    }
+
+    sec->state = KVDB_SEC_FREE;
+    sec->seq = KVDB_BLANK_WORD;
+    sec->used = KVDB_SEC_HDR_SIZE;
+    sec->live = 0;
+
+    return RT_EOK;
+}
+
+static rt_bool_t kvdb_sector_blank(fal_kvdb_t db, uint32_t idx)
+{
+    uint32_t buf[KVDB_COPY_BUF_SIZE / sizeof(uint32_t)], off, len, i;
+
+    for (off = KVDB_SEC_HDR_SIZE; off < db->sec_size; off += len)
+    {
+        len = (db->sec_size - off > sizeof(buf)) ? sizeof(buf) : db->sec_size - off;
+        if (kvdb_read(db, idx * db->sec_size + off, buf, len) != RT_EOK)
+        {
+            return RT_FALSE;
+        }
+        for (i = 0; i < len / sizeof(uint32_t); i++)
+        {
+            if (buf[i] != KVDB_BLANK_WORD)
+            {
+                return RT_FALSE;
+            }
+        }
+    }
+
+    return RT_TRUE;
+}
+
+/* dynamic wear levelling: new data always goes to the least erased free sector */
+static int kvdb_pick_free(fal_kvdb_t db)
+{
+    uint32_t i;
+    int found = -1;
+
+    for (i = 0; i < db->sec_num; i++)
+    {
+        if (db->sectors[i].state == KVDB_SEC_FREE &&
+                (found < 0 || db->sectors[i].erase_cnt < db->sectors[found].erase_cnt))
+        {
+            found = i;
+        }
+    }
+
+    return found;
+}
+
+static int kvdb_pick_oldest(fal_kvdb_t db)
+{
+    uint32_t i;
+    int found = -1;
+
+    for (i = 0; i < db->sec_num; i++)
+    {
+        if (db->sectors[i].state == KVDB_SEC_USING &&
+                (found < 0 || db->sectors[i].seq < db->sectors[found].seq))
+        {
+            found = i;
+        }
+    }
+
+    return found;
+}
+
+static int kvdb_sector_open(fal_kvdb_t db, uint32_t idx)
+{
+    struct fal_kvdb_sector *sec = &db->sectors[idx];
+    struct kvdb_sec_hdr hdr;
+    int result;
+
+    /* an interrupted erase may leave a valid looking header over a dirty body */
+    if (!kvdb_sector_blank(db, idx))
+    {
+        result = kvdb_sector_erase(db, idx);
+        if (result != RT_EOK)
+        {
+            return result;
+        }
+    }
+
+    hdr.magic = KVDB_SEC_MAGIC;
+    hdr.erase_cnt = sec->erase_cnt;
+    hdr.seq = db->next_seq;
+    hdr.crc = kvdb_crc32(0, &hdr, offsetof(struct kvdb_sec_hdr, crc));
+    if (kvdb_write(db, idx * db->sec_size + offsetof(struct kvdb_sec_hdr, seq), &hdr.seq,
+                   sizeof(hdr.seq) + sizeof(hdr.crc)) != RT_EOK)
+    {
+        sec->state = KVDB_SEC_DIRTY;
+        return -RT_EIO;
+    }
+
+    sec->state = KVDB_SEC_USING;
+    sec->seq = db->next_seq++;
+    sec->used = KVDB_SEC_HDR_SIZE;
+    sec->live = 0;
+    db->cur_sec = idx;
+
+    return RT_EOK;
+}
+
+/* copy a live record into the current sector */
+static int kvdb_relocate(fal_kvdb_t db, uint32_t src, uint32_t size, uint32_t *dst)
+{
+    uint8_t buf[KVDB_COPY_BUF_SIZE];
+    uint32_t off, len;
+    int result;
+
+    result = kvdb_alloc(db, size, RT_TRUE, dst);
+    if (result != RT_EOK)
+    {
+        return result;
+    }
+
+    for (off = 0; off < size; off += len)
+    {
+        len = (size - off > sizeof(buf)) ? sizeof(buf) : size - off;
+        if (kvdb_read(db, src + off, buf, len) != RT_EOK || kvdb_write(db, *dst + off, buf, len) != RT_EOK)
+        {
+            return -RT_EIO;
+        }
+    }
+
+    return RT_EOK;
+}
+
+static int kvdb_pick_victim(fal_kvdb_t db)
+{
+    uint32_t i, min_cnt = KVDB_BLANK_WORD, max_cnt = 0, payload = db->sec_size - KVDB_SEC_HDR_SIZE;
+    int victim = -1, coldest = -1;
+
+    for (i = 0; i < db->sec_num; i++)
+    {
+        struct fal_kvdb_sector *sec = &db->sectors[i];
+
+        if (sec->erase_cnt > max_cnt)
+        {
+            max_cnt = sec->erase_cnt;
+        }
+        if (sec->erase_cnt < min_cnt)
+        {
+            min_cnt = sec->erase_cnt;
+        }
+        if (sec->state != KVDB_SEC_USING || i == db->cur_sec)
+        {
+            continue;
+        }
+        if (coldest < 0 || sec->erase_cnt < db->sectors[coldest].erase_cnt)
+        {
+            coldest = i;
+        }
+        if (sec->live < payload && (victim < 0 || sec->live < db->sectors[victim].live))
+        {
+            victim = i;
+        }
+    }
+
+    /* static wear levelling: move cold data out of a rarely erased sector */
+    if (coldest >= 0 && max_cnt - min_cnt > FAL_KVDB_WL_THRESHOLD &&
+            db->sectors[coldest].erase_cnt == min_cnt)
+    {
+        db->wl_count++;
+        return coldest;
+    }
+
+    return victim;
+}
+
+static int kvdb_gc(fal_kvdb_t db)
+{
+    struct kvdb_rec_hdr hdr;
+    struct fal_kvdb_index *slot;
+    struct fal_kvdb_sector *sec;
+    char key[FAL_KVDB_KEY_MAX];
+    uint32_t base, off, size, dst;
+    rt_bool_t oldest;
+    int victim, result;
+
+    victim = kvdb_pick_victim(db);
+    if (victim < 0)
+    {
+        return -RT_EFULL;
+    }
+
+    sec = &db->sectors[victim];
+    base = victim * db->sec_size;
+    /* tombstones in the oldest sector do not hide anything any more */
+    oldest = (kvdb_pick_oldest(db) == victim);
+
+    for (off = KVDB_SEC_HDR_SIZE; sec->live && off + KVDB_REC_HDR_SIZE <= sec->used; off += size)
+    {
+        if (kvdb_read(db, base + off, &hdr, sizeof(hdr)) != RT_EOK)
+        {
+            return -RT_EIO;
+        }
+        if (hdr.magic != KVDB_REC_MAGIC || hdr.key_len > FAL_KVDB_KEY_MAX)
+        {
+            break;
+        }
+        size = kvdb_rec_size(&hdr);
+        if (hdr.type != KVDB_REC_TYPE_KV && hdr.type != KVDB_REC_TYPE_DEL)
+        {
+            continue;
+        }
+        if (kvdb_read(db, base + off + KVDB_REC_HDR_SIZE, key, hdr.key_len) != RT_EOK)
+        {
+            return -RT_EIO;
+        }
+
+        slot = kvdb_index_find(db, key, hdr.key_len, kvdb_hash(key, hdr.key_len));
+        if (slot == NULL || (slot->addr & KVDB_ADDR_MASK) != base + off)
+        {
+            /* superseded record */
+            continue;
+        }
+
+        sec->live -= size;
+        if (oldest && hdr.type == KVDB_REC_TYPE_DEL)
+        {
+            kvdb_index_remove(db, slot);
+            continue;
+        }
+
+        result = kvdb_relocate(db, base + off, size, &dst);
+        if (result != RT_EOK)
+        {
+            return result;
+        }
+        slot->addr = dst | (slot->addr & KVDB_ADDR_DELETED);
+        kvdb_addr_to_sec(db, dst)->live += size;
+    }
+
+    db->gc_count++;
+
+    return kvdb_sector_erase(db, victim);
+}
+
+/**
+ * reserve space for a record in the current sector
+ *
+ * @param in_gc RT_TRUE when called by the garbage collection, it may use the reserved sector
+ */
+static int kvdb_alloc(fal_kvdb_t db, uint32_t len, rt_bool_t in_gc, uint32_t *addr)
+{
+    uint32_t reserve = (db->type == FAL_KVDB_TYPE_KV && !in_gc) ? KVDB_GC_RESERVE : 0, rounds = 0;
+    struct fal_kvdb_sector *sec;
+    int result, idx;
+
+    while (1)
+    {
+        sec = &db->sectors[db->cur_sec];
+        if (sec->state == KVDB_SEC_USING && sec->used + len <= db->sec_size)
+        {
+            *addr = db->cur_sec * db->sec_size + sec->used;
+            sec->used += len;
+            return RT_EOK;
+        }
+
+        if (kvdb_free_count(db) > reserve)
+        {
+            result = kvdb_sector_open(db, kvdb_pick_free(db));
+            if (result != RT_EOK)
+            {
+                return result;
+            }
+            continue;
+        }
+
+        if (in_gc || rounds++ >= db->sec_num)
+        {
+            return -RT_EFULL;
+        }
+
+        if (db->type == FAL_KVDB_TYPE_LOG)
+        {
+            /* log store is a ring, drop the oldest records */
+            idx = kvdb_pick_oldest(db);
+            if (idx < 0 || (uint32_t)idx == db->cur_sec)
+            {
+                return -RT_EFULL;
+            }
+            result = kvdb_sector_erase(db, idx);
+        }
+        else
+        {
+            result = kvdb_gc(db);
+        }
+        if (result != RT_EOK)
+        {
+            return result;
+        }
+    }
+}
+
+static int kvdb_append(fal_kvdb_t db, uint8_t type, const char *key, uint8_t key_len, const void *value,
+                       uint32_t val_len, uint32_t *addr)
+{
+    uint8_t buf[KVDB_ALIGN(KVDB_REC_HDR_SIZE + FAL_KVDB_KEY_MAX)];
+    uint32_t val_off = kvdb_val_off(key_len), body = val_len & ~(KVDB_WRITE_GRAN - 1UL);
+    struct kvdb_rec_hdr hdr;
+    int result;
+
+    hdr.magic = KVDB_REC_MAGIC;
+    hdr.type = type;
+    hdr.key_len = key_len;
+    hdr.val_len = val_len;
+    if (kvdb_rec_size(&hdr) > db->sec_size - KVDB_SEC_HDR_SIZE)
+    {
+        return -RT_EINVAL;
+    }
+    hdr.crc = kvdb_crc32(kvdb_crc32(kvdb_rec_crc(&hdr), key, key_len), value, val_len);
+
+    result = kvdb_alloc(db, kvdb_rec_size(&hdr), RT_FALSE, addr);
+    if (result != RT_EOK)
+    {
+        return result;
+    }
+
+    /* header goes first, so a torn value is caught by the CRC instead of hiding the blank area */
+    memset(buf, 0xFF, val_off);
+    memcpy(buf, &hdr, sizeof(hdr));
+    if (key_len)
+    {
+        memcpy(buf + sizeof(hdr), key, key_len);
+    }
+    if (kvdb_write(db, *addr, buf, val_off) != RT_EOK)
+    {
+        return -RT_EIO;
+    }
+    if (body && kvdb_write(db, *addr + val_off, value, body) != RT_EOK)
+    {
+        return -RT_EIO;
+    }
+    /* the tail of the value is padded to a whole write unit */
+    if (val_len > body)
+    {
+        memset(buf, 0xFF, KVDB_WRITE_GRAN);
+        memcpy(buf, (const uint8_t *)value + body, val_len - body);
+        if (kvdb_write(db, *addr + val_off + body, buf, KVDB_WRITE_GRAN) != RT_EOK)
+        {
+            return -RT_EIO;
+        }
+    }
+
+    kvdb_addr_to_sec(db, *addr)->live += kvdb_rec_size(&hdr);
+
+    return RT_EOK;
+}
+
+/* =============== mount scan =============== */
+
+static int kvdb_verify_rec(fal_kvdb_t db, uint32_t addr, const struct kvdb_rec_hdr *hdr, char *key)
+{
+    uint8_t buf[KVDB_COPY_BUF_SIZE];
+    uint32_t crc, off, len;
+
+    if (kvdb_read(db, addr + KVDB_REC_HDR_SIZE, key, hdr->key_len) != RT_EOK)
+    {
+        return -RT_EIO;
+    }
+    crc = kvdb_crc32(kvdb_rec_crc(hdr), key, hdr->key_len);
+
+    addr += kvdb_val_off(hdr->key_len);
+    for (off = 0; off < hdr->val_len; off += len)
+    {
+        len = (hdr->val_len - off > sizeof(buf)) ? sizeof(buf) : hdr->val_len - off;
+        if (kvdb_read(db, addr + off, buf, len) != RT_EOK)
+        {
+            return -RT_EIO;
+        }
+        crc = kvdb_crc32(crc, buf, len);
+    }
+
+    return (crc == hdr->crc) ? RT_EOK : -RT_ERROR;
+}
+
+static int kvdb_index_update(fal_kvdb_t db, const struct kvdb_rec_hdr *hdr, const char *key, uint32_t addr)
+{
+    uint32_t hash = kvdb_hash(key, hdr->key_len);
+    struct fal_kvdb_index *slot;
+    struct kvdb_rec_hdr old;
+
+    if (hdr->type == KVDB_REC_TYPE_DEL)
+    {
+        addr |= KVDB_ADDR_DELETED;
+    }
+
+    slot = kvdb_index_find(db, key, hdr->key_len, hash);
+    if (slot == NULL)
+    {
+        return kvdb_index_insert(db, hash, addr);
+    }
+
+    if (kvdb_read(db, slot->addr & KVDB_ADDR_MASK, &old, sizeof(old)) != RT_EOK)
+    {
+        return -RT_EIO;
+    }
+    kvdb_addr_to_sec(db, slot->addr)->live -= kvdb_rec_size(&old);
+    slot->addr = addr;
+
+    return RT_EOK;
+}
+
+static int kvdb_scan_sector(fal_kvdb_t db, uint32_t idx)
+{
+    struct fal_kvdb_sector *sec = &db->sectors[idx];
+    uint32_t base = idx * db->sec_size, off, size;
+    struct kvdb_rec_hdr hdr;
+    char key[FAL_KVDB_KEY_MAX];
+    int result;
+
+    for (off = KVDB_SEC_HDR_SIZE; off + KVDB_REC_HDR_SIZE <= db->sec_size; off += size)
+    {
+        if (kvdb_read(db, base + off, &hdr, sizeof(hdr)) != RT_EOK)
+        {
+            return -RT_EIO;
+        }
+
+        if (hdr.magic == (uint16_t)KVDB_BLANK_WORD)
+        {
+            /* a header torn after the magic makes the rest of the sector unusable */
+            if (hdr.type != 0xFF || hdr.key_len != 0xFF || hdr.val_len != KVDB_BLANK_WORD || hdr.crc != KVDB_BLANK_WORD)
+            {
+                db->recovered++;
+                off = db->sec_size;
+            }
+            break;
+        }
+
+        size = kvdb_rec_size(&hdr);
+        if (hdr.magic != KVDB_REC_MAGIC || hdr.key_len > FAL_KVDB_KEY_MAX || hdr.type < KVDB_REC_TYPE_KV ||
+                hdr.type > KVDB_REC_TYPE_LOG || hdr.val_len > db->sec_size || off + size > db->sec_size)
+        {
+            db->recovered++;
+            off = db->sec_size;
+            break;
+        }
+
+        result = kvdb_verify_rec(db, base + off, &hdr, key);
+        if (result == -RT_EIO)
+        {
+            return result;
+        }
+        else if (result != RT_EOK)
+        {
+            log_d("kvdb %s: drop damaged record at 0x%08x.", db->name, base + off);
+            db->recovered++;
+            continue;
+        }
+
+        sec->live += size;
+        if (db->type == FAL_KVDB_TYPE_KV && hdr.type != KVDB_REC_TYPE_LOG)
+        {
+            result = kvdb_index_update(db, &hdr, key, base + off);
+            if (result != RT_EOK)
+            {
+                return result;
+            }
+        }
+    }
+
+    sec->used = (off > db->sec_size) ? db->sec_size : off;
+
+    return RT_EOK;
+}
+
+/* return the in-use sector indexes ordered from the oldest to the newest */
+static uint32_t *kvdb_sorted_sectors(fal_kvdb_t db, uint32_t *num)
+{
+    uint32_t *order, i, j, tmp;
+
+    order = FAL_MALLOC(db->sec_num * sizeof(uint32_t));
+    if (order == NULL)
+    {
+        return NULL;
+    }
+
+    for (i = 0, *num = 0; i < db->sec_num; i++)
+    {
+        if (db->sectors[i].state == KVDB_SEC_USING)
+        {
+            order[(*num)++] = i;
+        }
+    }
+
+    /* insertion sort, the sector count is small and mostly ordered already */
+    for (i = 1; i < *num; i++)
+    {
+        tmp = order[i];
+        for (j = i; j > 0 && db->sectors[order[j - 1]].seq > db->sectors[tmp].seq; j--)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = tmp;
+    }
+
+    return order;
+}
+
+static int kvdb_mount(fal_kvdb_t db)
+{
+    struct kvdb_sec_hdr hdr;
+    uint32_t i, num, max_cnt = 0, *order;
+    int result = RT_EOK;
+
+    db->next_seq = 0;
+    db->recovered = 0;
+
+    for (i = 0; i < db->sec_num; i++)
+    {
+        struct fal_kvdb_sector *sec = &db->sectors[i];
+
+        if (kvdb_read(db, i * db->sec_size, &hdr, sizeof(hdr)) != RT_EOK)
+        {
+            return -RT_EIO;
+        }
+
+        sec->used = KVDB_SEC_HDR_SIZE;
+        sec->live = 0;
+        sec->seq = KVDB_BLANK_WORD;
+        sec->erase_cnt = KVDB_BLANK_WORD;
+        if (hdr.magic != KVDB_SEC_MAGIC || hdr.erase_cnt == KVDB_BLANK_WORD)
+        {
+            sec->state = KVDB_SEC_DIRTY;
+            continue;
+        }
+
+        sec->erase_cnt = hdr.erase_cnt;
+        if (hdr.erase_cnt > max_cnt)
+        {
+            max_cnt = hdr.erase_cnt;
+        }
+
+        if (hdr.seq == KVDB_BLANK_WORD && hdr.crc == KVDB_BLANK_WORD)
+        {
+            sec->state = KVDB_SEC_FREE;
+        }
+        else if (hdr.crc == kvdb_crc32(0, &hdr, offsetof(struct kvdb_sec_hdr, crc)))
+        {
+            sec->state = KVDB_SEC_USING;
+            sec->seq = hdr.seq;
+            if (hdr.seq >= db->next_seq)
+            {
+                db->next_seq = hdr.seq + 1;
+            }
+        }
+        else
+        {
+            sec->state = KVDB_SEC_DIRTY;
+        }
+    }
+
+    /* erase damaged or never formatted sectors, a lost erase counter restarts from the highest one */
+    for (i = 0; i < db->sec_num; i++)
+    {
+        if (db->sectors[i].state == KVDB_SEC_DIRTY)
+        {
+            if (db->sectors[i].erase_cnt == KVDB_BLANK_WORD)
+            {
+                db->sectors[i].erase_cnt = max_cnt;
+            }
+            else
+            {
+                db->recovered++;
+            }
+            result = kvdb_sector_erase(db, i);
+            if (result != RT_EOK)
+            {
+                return result;
+            }
+        }
+    }
+
+    order = kvdb_sorted_sectors(db, &num);
+    if (order == NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        result = kvdb_scan_sector(db, order[i]);
+        if (result != RT_EOK)
+        {
+            break;
+        }
+    }
+
+    if (result == RT_EOK)
+    {
+        if (num)
+        {
+            db->cur_sec = order[num - 1];
+        }
+        else
+        {
+            result = kvdb_sector_open(db, kvdb_pick_free(db));
+        }
+    }
+
+    FAL_FREE(order);
+
+    return result;
+}
+
+/* =============== API =============== */
+
+int fal_kvdb_init(fal_kvdb_t db, const char *name, const char *part_name, uint8_t type, uint32_t index_size)
+{
+    const struct fal_flash_dev *flash_dev;
+    int result;
+
+    assert(db);
+    assert(name);
+    assert(part_name);
+
+    if (db->init_ok)
+    {
+        return RT_EOK;
+    }
+
+    memset(db, 0, sizeof(struct fal_kvdb));
+    db->name = name;
+    db->type = type;
+
+    db->part = fal_partition_find(part_name);
+    if (db->part == NULL)
+    {
+        log_e("kvdb %s: partition (%s) not found.", name, part_name);
+        return -RT_ERROR;
+    }
+
+    flash_dev = fal_flash_device_find(db->part->flash_name);
+    if (flash_dev == NULL || flash_dev->write_gran > 32)
+    {
+        log_e("kvdb %s: flash device of partition (%s) is not supported.", name, part_name);
+        return -RT_ERROR;
+    }
+
+    db->sec_size = flash_dev->blk_size;
+    db->sec_num = db->part->len / db->sec_size;
+    if (db->sec_num < ((type == FAL_KVDB_TYPE_KV) ? 2 + KVDB_GC_RESERVE : 2) || db->part->len > KVDB_ADDR_MASK)
+    {
+        log_e("kvdb %s: partition (%s) size is not supported.", name, part_name);
+        return -RT_ERROR;
+    }
+
+    db->sectors = FAL_CALLOC(db->sec_num, sizeof(struct fal_kvdb_sector));
+    if (db->sectors == NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    if (type == FAL_KVDB_TYPE_KV)
+    {
+        for (db->index_size = 16; db->index_size < index_size; db->index_size <<= 1);
+        db->index = FAL_CALLOC(db->index_size, sizeof(struct fal_kvdb_index));
+        if (db->index == NULL)
+        {
+            FAL_FREE(db->sectors);
+            return -RT_ENOMEM;
+        }
+    }
+
+    rt_mutex_init(&db->lock, name, RT_IPC_FLAG_PRIO);
+
+    result = kvdb_mount(db);
+    if (result != RT_EOK)
+    {
+        log_e("kvdb %s: mount failed (%d).", name, result);
+        rt_mutex_detach(&db->lock);
+        FAL_FREE(db->index);
+        FAL_FREE(db->sectors);
+        return result;
+    }
+
+    if (db->recovered)
+    {
+        log_i("kvdb %s: %d damaged records or sectors were dropped.", name, db->recovered);
+    }
+
+    db->init_ok = 1;
+
+    return RT_EOK;
+}
+
+int fal_kvdb_deinit(fal_kvdb_t db)
+{
+    assert(db);
+
+    if (!db->init_ok)
+    {
+        return RT_EOK;
+    }
+
+    rt_mutex_detach(&db->lock);
+    FAL_FREE(db->index);
+    FAL_FREE(db->sectors);
+    db->index = NULL;
+    db->sectors = NULL;
+    db->init_ok = 0;
+
+    return RT_EOK;
+}
+
+int fal_kvdb_format(fal_kvdb_t db)
+{
+    uint32_t i;
+    int result = RT_EOK;
+
+    assert(db);
+    assert(db->init_ok);
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+
+    for (i = 0; i < db->sec_num && result == RT_EOK; i++)
+    {
+        result = kvdb_sector_erase(db, i);
+    }
+
+    if (db->index)
+    {
+        memset(db->index, 0, db->index_size * sizeof(struct fal_kvdb_index));
+        db->index_used = 0;
+    }
+
+    if (result == RT_EOK)
+    {
+        db->next_seq = 0;
+        result = kvdb_sector_open(db, kvdb_pick_free(db));
+    }
+
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+static int kvdb_set(fal_kvdb_t db, uint8_t type, const char *key, const void *value, uint32_t len)
+{
+    size_t key_len = strlen(key);
+    uint32_t hash, addr;
+    struct fal_kvdb_index *slot;
+    struct kvdb_rec_hdr old;
+    int result;
+
+    assert(db);
+    assert(db->init_ok);
+
+    if (db->type != FAL_KVDB_TYPE_KV || key_len == 0 || key_len > FAL_KVDB_KEY_MAX)
+    {
+        return -RT_EINVAL;
+    }
+
+    hash = kvdb_hash(key, key_len);
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+
+    if (type == KVDB_REC_TYPE_DEL)
+    {
+        slot = kvdb_index_find(db, key, key_len, hash);
+        if (slot == NULL || (slot->addr & KVDB_ADDR_DELETED))
+        {
+            result = -RT_EEMPTY;
+            goto __exit;
+        }
+    }
+
+    /* the index must be looked up after the append, the garbage collection may move records */
+    result = kvdb_append(db, type, key, key_len, value, len, &addr);
+    if (result != RT_EOK)
+    {
+        goto __exit;
+    }
+
+    if (type == KVDB_REC_TYPE_DEL)
+    {
+        addr |= KVDB_ADDR_DELETED;
+    }
+
+    slot = kvdb_index_find(db, key, key_len, hash);
+    if (slot)
+    {
+        if (kvdb_read(db, slot->addr & KVDB_ADDR_MASK, &old, sizeof(old)) != RT_EOK)
+        {
+            result = -RT_EIO;
+            goto __exit;
+        }
+        kvdb_addr_to_sec(db, slot->addr)->live -= kvdb_rec_size(&old);
+        slot->addr = addr;
+    }
+    else
+    {
+        result = kvdb_index_insert(db, hash, addr);
+    }
+
+__exit:
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+int fal_kvdb_set(fal_kvdb_t db, const char *key, const void *value, uint32_t len)
+{
+    assert(value || len == 0);
+
+    return kvdb_set(db, KVDB_REC_TYPE_KV, key, value, len);
+}
+
+int fal_kvdb_del(fal_kvdb_t db, const char *key)
+{
+    return kvdb_set(db, KVDB_REC_TYPE_DEL, key, NULL, 0);
+}
+
+int fal_kvdb_get(fal_kvdb_t db, const char *key, void *value, uint32_t len)
+{
+    size_t key_len = strlen(key);
+    struct fal_kvdb_index *slot;
+    struct kvdb_rec_hdr hdr;
+    int result;
+
+    assert(db);
+    assert(db->init_ok);
+
+    if (db->type != FAL_KVDB_TYPE_KV || key_len == 0 || key_len > FAL_KVDB_KEY_MAX)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+
+    slot = kvdb_index_find(db, key, key_len, kvdb_hash(key, key_len));
+    if (slot == NULL || (slot->addr & KVDB_ADDR_DELETED))
+    {
+        result = -RT_EEMPTY;
+    }
+    else if (kvdb_read(db, slot->addr, &hdr, sizeof(hdr)) != RT_EOK)
+    {
+        result = -RT_EIO;
+    }
+    else
+    {
+        result = hdr.val_len;
+        if (value && len)
+        {
+            if (len > hdr.val_len)
+            {
+                len = hdr.val_len;
+            }
+            if (kvdb_read(db, slot->addr + kvdb_val_off(key_len), value, len) != RT_EOK)
+            {
+                result = -RT_EIO;
+            }
+        }
+    }
+
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+int fal_kvdb_iterate(fal_kvdb_t db, fal_kvdb_kv_cb cb, void *arg)
+{
+    char key[FAL_KVDB_KEY_MAX + 1];
+    struct kvdb_rec_hdr hdr;
+    uint32_t i;
+    int result = RT_EOK;
+
+    assert(db);
+    assert(db->init_ok);
+    assert(cb);
+
+    if (db->type != FAL_KVDB_TYPE_KV)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+
+    for (i = 0; i < db->index_size; i++)
+    {
+        uint32_t addr = db->index[i].addr;
+
+        if (addr == 0 || (addr & KVDB_ADDR_DELETED))
+        {
+            continue;
+        }
+        if (kvdb_read(db, addr, &hdr, sizeof(hdr)) != RT_EOK ||
+                kvdb_read(db, addr + KVDB_REC_HDR_SIZE, key, hdr.key_len) != RT_EOK)
+        {
+            result = -RT_EIO;
+            break;
+        }
+        key[hdr.key_len] = '\0';
+        if (cb(db, key, hdr.val_len, arg))
+        {
+            break;
+        }
+    }
+
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+int fal_kvdb_log_append(fal_kvdb_t db, const void *buf, uint32_t len)
+{
+    uint32_t addr;
+    int result;
+
+    assert(db);
+    assert(db->init_ok);
+    assert(buf);
+
+    if (db->type != FAL_KVDB_TYPE_LOG)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+    result = kvdb_append(db, KVDB_REC_TYPE_LOG, NULL, 0, buf, len, &addr);
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+int fal_kvdb_log_iterate(fal_kvdb_t db, fal_kvdb_log_cb cb, void *arg)
+{
+    uint32_t *order, num, i, off, base, size;
+    struct kvdb_rec_hdr hdr;
+    uint8_t *buf;
+    int result = RT_EOK;
+
+    assert(db);
+    assert(db->init_ok);
+    assert(cb);
+
+    if (db->type != FAL_KVDB_TYPE_LOG)
+    {
+        return -RT_EINVAL;
+    }
+
+    buf = FAL_MALLOC(db->sec_size);
+    if (buf == NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+
+    order = kvdb_sorted_sectors(db, &num);
+    if (order == NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        base = order[i] * db->sec_size;
+        for (off = KVDB_SEC_HDR_SIZE; off + KVDB_REC_HDR_SIZE <= db->sectors[order[i]].used; off += size)
+        {
+            if (kvdb_read(db, base + off, &hdr, sizeof(hdr)) != RT_EOK)
+            {
+                result = -RT_EIO;
+                goto __free;
+            }
+            if (hdr.magic != KVDB_REC_MAGIC || hdr.type != KVDB_REC_TYPE_LOG)
+            {
+                break;
+            }
+            size = kvdb_rec_size(&hdr);
+            if (off + size > db->sec_size || kvdb_read(db, base + off + kvdb_val_off(0), buf, hdr.val_len) != RT_EOK)
+            {
+                break;
+            }
+            /* damaged records were kept in place by the mount scan, skip them here */
+            if (kvdb_crc32(kvdb_rec_crc(&hdr), buf, hdr.val_len) != hdr.crc)
+            {
+                continue;
+            }
+            if (cb(db, buf, hdr.val_len, arg))
+            {
+                goto __free;
+            }
+        }
+    }
+
+__free:
+    FAL_FREE(order);
+__exit:
+    rt_mutex_release(&db->lock);
+    FAL_FREE(buf);
+
+    return result;
+}
+
+void fal_kvdb_show(fal_kvdb_t db)
+{
+    uint32_t i, used = 0, live = 0, free = 0, min_cnt = KVDB_BLANK_WORD, max_cnt = 0, total_cnt = 0;
+
+    assert(db);
+
+    if (!db->init_ok)
+    {
+        rt_kprintf("kvdb is not initialized.\n");
+        return;
+    }
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+
+    for (i = 0; i < db->sec_num; i++)
+    {
+        struct fal_kvdb_sector *sec = &db->sectors[i];
+
+        if (sec->state == KVDB_SEC_FREE)
+        {
+            free++;
+        }
+        else
+        {
+            used += sec->used;
+            live += sec->live;
+        }
+        total_cnt += sec->erase_cnt;
+        if (sec->erase_cnt < min_cnt)
+        {
+            min_cnt = sec->erase_cnt;
+        }
+        if (sec->erase_cnt > max_cnt)
+        {
+            max_cnt = sec->erase_cnt;
+        }
+    }
+
+    rt_kprintf("kvdb %s on partition %s (%s)\n", db->name, db->part->name,
+               (db->type == FAL_KVDB_TYPE_KV) ? "kv" : "log");
+    rt_kprintf("  sectors : %d x %d bytes, %d free, current %d\n", db->sec_num, db->sec_size, free, db->cur_sec);
+    rt_kprintf("  data    : %d bytes appended, %d bytes live\n", used, live);
+    if (db->type == FAL_KVDB_TYPE_KV)
+    {
+        rt_kprintf("  index   : %d/%d slots\n", db->index_used, db->index_size);
+    }
+    rt_kprintf("  erase   : min %d, max %d, avg %d\n", min_cnt, max_cnt, total_cnt / db->sec_num);
+    rt_kprintf("  gc      : %d collections, %d wear levelling moves, %d recovered\n",
+               db->gc_count, db->wl_count, db->recovered);
+
+    rt_mutex_release(&db->lock);
+}
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+
+static struct fal_kvdb kvdb_obj;
+
+static int kvdb_list_cb(fal_kvdb_t db, const char *key, uint32_t value_len, void *arg)
+{
+    rt_kprintf("%-*s %d bytes\n", FAL_KVDB_KEY_MAX / 2, key, value_len);
+    return 0;
+}
+
+static int kvdb_log_cb(fal_kvdb_t db, const uint8_t *buf, uint32_t len, void *arg)
+{
+    rt_kprintf("%.*s\n", len, buf);
+    return 0;
+}
+
+static void kvdb_bench(fal_kvdb_t db, uint32_t count, uint32_t size)
+{
+    uint32_t i, start, time_cast;
+    char key[16];
+    uint8_t *buf;
+
+    buf = rt_malloc(size);
+    if (buf == NULL)
+    {
+        return;
+    }
+    memset(buf, 0x5A, size);
+
+    start = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        if (db->type == FAL_KVDB_TYPE_KV)
+        {
+            rt_snprintf(key, sizeof(key), "bench%d", i % 64);
+            if (fal_kvdb_set(db, key, buf, size) != RT_EOK)
+            {
+                break;
+            }
+        }
+        else if (fal_kvdb_log_append(db, buf, size) != RT_EOK)
+        {
+            break;
+        }
+    }
+    time_cast = rt_tick_get() - start;
+    rt_kprintf("write: %d records of %d bytes in %d ms\n", i, size, time_cast * 1000 / RT_TICK_PER_SECOND);
+
+    if (db->type == FAL_KVDB_TYPE_KV)
+    {
+        start = rt_tick_get();
+        for (i = 0; i < count; i++)
+        {
+            rt_snprintf(key, sizeof(key), "bench%d", i % 64);
+            if (fal_kvdb_get(db, key, buf, size) < 0)
+            {
+                break;
+            }
+        }
+        time_cast = rt_tick_get() - start;
+        rt_kprintf("read : %d records of %d bytes in %d ms\n", i, size, time_cast * 1000 / RT_TICK_PER_SECOND);
+    }
+
+    rt_free(buf);
+}
+
+#ifdef FAL_USING_FILE_PORT
+/*
+ * Power-cut test on the file backed flash: the flash stops after a random number
+ * of program/erase operations, the store is remounted and every acknowledged
+ * value must still be there.
+ */
+static void kvdb_powercut(fal_kvdb_t db, const char *part_name, uint32_t rounds)
+{
+#define PC_KEYS 16
+    extern void fal_file_flash_powercut(int ops);
+    extern void fal_file_flash_stat(uint32_t *program, uint32_t *erase);
+    uint32_t committed[PC_KEYS] = { 0 }, value, pending_val = 0, seed = rt_tick_get(), i, round, errors = 0;
+    uint32_t program, erase;
+    int pending = -1, result;
+    char key[16];
+
+    fal_kvdb_format(db);
+    for (round = 0; round < rounds; round++)
+    {
+        seed = seed * 1103515245 + 12345;
+        fal_file_flash_powercut(1 + (seed >> 16) % 64);
+
+        pending = -1;
+        for (i = 1; ; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            pending = (seed >> 16) % PC_KEYS;
+            pending_val = round * 0x10000 + i;
+            rt_snprintf(key, sizeof(key), "pc%d", pending);
+            if (fal_kvdb_set(db, key, &pending_val, sizeof(pending_val)) != RT_EOK)
+            {
+                break;
+            }
+            committed[pending] = pending_val;
+        }
+
+        /* power is back, remount and check */
+        fal_file_flash_powercut(0);
+        fal_kvdb_deinit(db);
+        result = fal_kvdb_init(db, db->name, part_name, FAL_KVDB_TYPE_KV, 0);
+        if (result != RT_EOK)
+        {
+            rt_kprintf("round %d: remount failed (%d)\n", round, result);
+            return;
+        }
+
+        for (i = 0; i < PC_KEYS; i++)
+        {
+            rt_snprintf(key, sizeof(key), "pc%d", i);
+            value = 0;
+            result = fal_kvdb_get(db, key, &value, sizeof(value));
+            if (result < 0 && committed[i] == 0)
+            {
+                continue;
+            }
+            if (value == committed[i] || ((int)i == pending && value == pending_val))
+            {
+                committed[i] = value;
+                continue;
+            }
+            rt_kprintf("round %d: %s is 0x%08x, expect 0x%08x\n", round, key, value, committed[i]);
+            errors++;
+        }
+    }
+
+    fal_file_flash_stat(&program, &erase);
+    rt_kprintf("power-cut test: %d rounds, %d errors, flash %d bytes programmed, %d blocks erased\n",
+               rounds, errors, program, erase);
+}
+#endif /* FAL_USING_FILE_PORT */
+
+static void kvdb(uint8_t argc, char **argv)
+{
+    const char *help_info[] =
+    {
+        "kvdb mount <part> [kv|log]       - mount the store on the partition",
+        "kvdb set <key> <value>           - set the value of the key",
+        "kvdb get <key>                   - get the value of the key",
+        "kvdb del <key>                   - delete the key",
+        "kvdb log <text>                  - append a record to the log store",
+        "kvdb list                        - list keys or log records",
+        "kvdb show                        - show the store statistics",
+        "kvdb format                      - erase the store",
+        "kvdb bench <count> <size>        - write/read throughput test",
+#ifdef FAL_USING_FILE_PORT
+        "kvdb powercut <part> <rounds>    - power-cut test on the file backed flash",
+#endif
+    };
+    fal_kvdb_t db = &kvdb_obj;
+    int result = RT_EOK;
+    size_t i;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage:\n");
+        for (i = 0; i < sizeof(help_info) / sizeof(char *); i++)
+        {
+            rt_kprintf("%s\n", help_info[i]);
+        }
+        return;
+    }
+
+    if (!strcmp(argv[1], "mount") && argc >= 3)
+    {
+        fal_kvdb_deinit(db);
+        result = fal_kvdb_init(db, "kvdb", argv[2],
+                               (argc >= 4 && !strcmp(argv[3], "log")) ? FAL_KVDB_TYPE_LOG : FAL_KVDB_TYPE_KV, 64);
+    }
+#ifdef FAL_USING_FILE_PORT
+    else if (!strcmp(argv[1], "powercut") && argc >= 4)
+    {
+        fal_kvdb_deinit(db);
+        result = fal_kvdb_init(db, "kvdb", argv[2], FAL_KVDB_TYPE_KV, 64);
+        if (result == RT_EOK)
+        {
+            kvdb_powercut(db, argv[2], strtoul(argv[3], NULL, 0));
+        }
+    }
+#endif
+    else if (!db->init_ok)
+    {
+        rt_kprintf("Please run 'kvdb mount <part>' first.\n");
+        return;
+    }
+    else if (!strcmp(argv[1], "set") && argc >= 4)
+    {
+        result = fal_kvdb_set(db, argv[2], argv[3], strlen(argv[3]));
+    }
+    else if (!strcmp(argv[1], "get") && argc >= 3)
+    {
+        char value[64];
+
+        result = fal_kvdb_get(db, argv[2], value, sizeof(value));
+        if (result >= 0)
+        {
+            rt_kprintf("%s = %.*s%s\n", argv[2], (result < (int)sizeof(value)) ? result : (int)sizeof(value), value,
+                       (result > (int)sizeof(value)) ? "..." : "");
+            result = RT_EOK;
+        }
+    }
+    else if (!strcmp(argv[1], "del") && argc >= 3)
+    {
+        result = fal_kvdb_del(db, argv[2]);
+    }
+    else if (!strcmp(argv[1], "log") && argc >= 3)
+    {
+        result = fal_kvdb_log_append(db, argv[2], strlen(argv[2]));
+    }
+    else if (!strcmp(argv[1], "list"))
+    {
+        result = (db->type == FAL_KVDB_TYPE_KV) ? fal_kvdb_iterate(db, kvdb_list_cb, NULL) :
+                 fal_kvdb_log_iterate(db, kvdb_log_cb, NULL);
+    }
+    else if (!strcmp(argv[1], "show"))
+    {
+        fal_kvdb_show(db);
+    }
+    else if (!strcmp(argv[1], "format"))
+    {
+        result = fal_kvdb_format(db);
+    }
+    else if (!strcmp(argv[1], "bench") && argc >= 4)
+    {
+        kvdb_bench(db, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0));
+    }
+    else
+    {
+        rt_kprintf("Unknown command. Please run 'kvdb' for help.\n");
+        return;
+    }
+
+    if (result != RT_EOK)
+    {
+        rt_kprintf("kvdb %s failed (%d).\n", argv[1], result);
+    }
+}
+MSH_CMD_EXPORT(kvdb, FAL key-value and log store operate.);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
+
+#endif /* FAL_USING_KVDB */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017/12/30     Bernard      The first version.
+ * 2026/10/19     RT-Thread    Add the AIO engine with the device queues and lio_listio().
  */
 
 #include <rtthread.h>
@@ -14,9 +15,441 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/errno.h>
+#include <dfs_file.h>
 #include "aio.h"
 
-struct rt_workqueue* aio_queue = NULL;
+#define DBG_TAG    "aio"
+#define DBG_LVL    DBG_WARNING
+#include <rtdbg.h>
+
+#ifndef RT_POSIX_AIO_WORKERS
+#define RT_POSIX_AIO_WORKERS            2
+#endif
+#ifndef RT_POSIX_AIO_WORKER_STACK_SIZE
+#define RT_POSIX_AIO_WORKER_STACK_SIZE  2048
+#endif
+#ifndef RT_POSIX_AIO_WORKER_PRIORITY
+#define RT_POSIX_AIO_WORKER_PRIORITY    16
+#endif
+/* the max bytes of the adjacent requests which are merged into one transfer */
+#ifndef RT_POSIX_AIO_MERGE_MAX
+#define RT_POSIX_AIO_MERGE_MAX          (16 * 1024)
+#endif
+
+#define AIO_OP_READ     LIO_READ
+#define AIO_OP_WRITE    LIO_WRITE
+#define AIO_OP_FSYNC    (LIO_NOP + 1)
+
+/* the requests of a lio_listio() call */
+struct aio_group
+{
+    int remaining;
+    int mode;
+    struct sigevent sig;
+    rt_thread_t thread;
+    struct rt_semaphore done;   /* LIO_WAIT */
+};
+
+/*
+ * The requests of the files on one device are queued together and run by one
+ * worker at a time, the other workers serve the other devices meanwhile.
+ */
+struct aio_devq
+{
+    rt_list_t list;
+    void *key;                  /* the block device, or the device behind the fd */
+    rt_list_t reqs;             /* ordered by aio_reqprio */
+    rt_list_t running;          /* the requests taken by the worker */
+    rt_bool_t busy;
+};
+
+struct aio_waiter
+{
+    rt_list_t list;
+    struct rt_semaphore sem;
+};
+
+static struct
+{
+    struct rt_mutex lock;
+    struct rt_semaphore sem;    /* released for each queued request */
+    rt_list_t devqs;
+    rt_list_t waiters;          /* threads in aio_suspend() */
+
+    rt_uint32_t submitted;
+    rt_uint32_t completed;
+    rt_uint32_t merged;         /* requests merged into the transfer of the previous one */
+    rt_uint32_t transfers;
+} _aio;
+
+static void *aio_file_key(struct dfs_fd *d)
+{
+    if (d->fs && d->fs->dev_id)
+        return d->fs->dev_id;
+
+    /* devfs, sockets and RAM file systems */
+    return d->data ? d->data : (void *)d;
+}
+
+static struct aio_devq *aio_devq_get(void *key)
+{
+    struct aio_devq *q;
+
+    rt_list_for_each_entry(q, &_aio.devqs, list)
+    {
+        if (q->key == key)
+            return q;
+    }
+
+    q = (struct aio_devq *)rt_calloc(1, sizeof(struct aio_devq));
+    if (q == RT_NULL)
+        return RT_NULL;
+
+    q->key = key;
+    rt_list_init(&q->reqs);
+    rt_list_init(&q->running);
+    rt_list_insert_before(&_aio.devqs, &q->list);
+
+    return q;
+}
+
+/* check the request and hold its file, called without the engine lock */
+static int aio_prepare(struct aiocb *cb, int op, struct aio_group *group)
+{
+    struct dfs_fd *d;
+
+    if (op != AIO_OP_FSYNC && cb->aio_offset < 0)
+        return -EINVAL;
+    if (op != AIO_OP_FSYNC && cb->aio_buf == NULL && cb->aio_nbytes)
+        return -EINVAL;
+
+    d = fd_get(cb->aio_fildes);
+    if (d == NULL)
+        return -EBADF;
+
+    if ((op == AIO_OP_READ && (d->flags & O_ACCMODE) == O_WRONLY) ||
+        (op == AIO_OP_WRITE && (d->flags & O_ACCMODE) == O_RDONLY))
+    {
+        fd_put(d);
+        return -EBADF;
+    }
+
+    cb->aio_file = d;
+    cb->aio_op = op;
+    cb->aio_lio = group;
+    cb->aio_thread = rt_thread_self();
+    cb->aio_result = -EINPROGRESS;
+    rt_list_init(&cb->aio_node);
+
+    return 0;
+}
+
+/* put a prepared request on the queue of its device, called with the engine lock */
+static int aio_enqueue(struct aiocb *cb)
+{
+    struct aio_devq *q;
+    struct aiocb *pos;
+
+    q = aio_devq_get(aio_file_key((struct dfs_fd *)cb->aio_file));
+    if (q == RT_NULL)
+        return -EAGAIN;
+
+    /* a larger aio_reqprio is a lower priority, fsync() follows all the queued requests */
+    if (cb->aio_op != AIO_OP_FSYNC)
+    {
+        rt_list_for_each_entry(pos, &q->reqs, aio_node)
+        {
+            if (pos->aio_op == AIO_OP_FSYNC || pos->aio_reqprio > cb->aio_reqprio)
+            {
+                rt_list_insert_before(&pos->aio_node, &cb->aio_node);
+                _aio.submitted++;
+                return 0;
+            }
+        }
+    }
+    rt_list_insert_before(&q->reqs, &cb->aio_node);
+    _aio.submitted++;
+
+    return 0;
+}
+
+static int aio_submit(struct aiocb *cb, int op)
+{
+    int result;
+
+    if (!cb) return -EINVAL;
+
+    result = aio_prepare(cb, op, RT_NULL);
+    if (result < 0)
+        return result;
+
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    result = aio_enqueue(cb);
+    rt_mutex_release(&_aio.lock);
+    if (result < 0)
+    {
+        fd_put((struct dfs_fd *)cb->aio_file);
+        cb->aio_result = result;
+        return result;
+    }
+    rt_sem_release(&_aio.sem);
+
+    return 0;
+}
+
+static void aio_notify(const struct sigevent *sig, rt_thread_t thread)
+{
+    switch (sig->sigev_notify)
+    {
+    case SIGEV_SIGNAL:
+#ifdef RT_USING_SIGNALS
+        if (thread)
+            rt_thread_kill(thread, sig->sigev_signo);
+#endif
+        break;
+
+    case SIGEV_THREAD:
+        /* called by the worker, the function should not block for long */
+        if (sig->sigev_notify_function)
+            sig->sigev_notify_function(sig->sigev_value);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void aio_group_put(struct aio_group *group)
+{
+    int remaining;
+
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    remaining = --group->remaining;
+    rt_mutex_release(&_aio.lock);
+
+    if (remaining)
+        return;
+
+    if (group->mode == LIO_WAIT)
+    {
+        rt_sem_release(&group->done);
+    }
+    else
+    {
+        aio_notify(&group->sig, group->thread);
+        rt_free(group);
+    }
+}
+
+static void aio_complete(struct aiocb *cb, int result)
+{
+    struct aio_group *group = (struct aio_group *)cb->aio_lio;
+    struct dfs_fd *d = (struct dfs_fd *)cb->aio_file;
+    rt_thread_t thread = cb->aio_thread;
+    struct sigevent sig = cb->aio_sigevent;
+    struct aio_waiter *waiter;
+    rt_base_t level;
+
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    rt_list_remove(&cb->aio_node);
+    _aio.completed++;
+    rt_mutex_release(&_aio.lock);
+
+    /* the control block belongs to the application again after the result is set */
+    level = rt_hw_interrupt_disable();
+    cb->aio_result = result;
+    rt_hw_interrupt_enable(level);
+
+    fd_put(d);
+    aio_notify(&sig, thread);
+    if (group)
+        aio_group_put(group);
+
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    rt_list_for_each_entry(waiter, &_aio.waiters, list)
+    {
+        rt_sem_release(&waiter->sem);
+    }
+    rt_mutex_release(&_aio.lock);
+}
+
+static int aio_transfer(struct aiocb *cb, void *buf, size_t len, off_t offset)
+{
+    struct dfs_fd *d = (struct dfs_fd *)cb->aio_file;
+
+    switch (cb->aio_op)
+    {
+    case AIO_OP_READ:
+        dfs_file_lseek(d, offset);
+        return dfs_file_read(d, buf, len);
+
+    case AIO_OP_WRITE:
+        if ((d->flags & O_APPEND) == 0)
+            dfs_file_lseek(d, offset);
+        return dfs_file_write(d, buf, len);
+
+    case AIO_OP_FSYNC:
+        return dfs_file_flush(d);
+
+    default:
+        return -EINVAL;
+    }
+}
+
+/* the next request is merged when it continues the transfer of the previous one */
+static rt_bool_t aio_mergeable(struct aiocb *prev, struct aiocb *next, size_t total)
+{
+    struct dfs_fd *d = (struct dfs_fd *)prev->aio_file;
+
+    if (next->aio_file != prev->aio_file || next->aio_op != prev->aio_op)
+        return RT_FALSE;
+    if (prev->aio_op == AIO_OP_FSYNC || d->type != FT_REGULAR)
+        return RT_FALSE;
+    if (prev->aio_op == AIO_OP_WRITE && (d->flags & O_APPEND))
+        return RT_FALSE;
+    if (next->aio_offset != prev->aio_offset + (off_t)prev->aio_nbytes)
+        return RT_FALSE;
+
+    return (total + next->aio_nbytes <= RT_POSIX_AIO_MERGE_MAX) ? RT_TRUE : RT_FALSE;
+}
+
+/* run the requests on the running list of the queue, the first n ones are one transfer */
+static void aio_run(struct aio_devq *q, int n)
+{
+    struct aiocb *first, *cb;
+    rt_bool_t contiguous = RT_TRUE;
+    uint8_t *buf, *ptr;
+    size_t total = 0, done;
+    int result, i;
+
+    first = rt_list_entry(q->running.next, struct aiocb, aio_node);
+    if (n == 1)
+    {
+        aio_complete(first, aio_transfer(first, (void *)first->aio_buf, first->aio_nbytes, first->aio_offset));
+        return;
+    }
+
+    ptr = (uint8_t *)first->aio_buf;
+    rt_list_for_each_entry(cb, &q->running, aio_node)
+    {
+        if ((uint8_t *)cb->aio_buf != ptr)
+            contiguous = RT_FALSE;
+        ptr = (uint8_t *)cb->aio_buf + cb->aio_nbytes;
+        total += cb->aio_nbytes;
+    }
+
+    /* the buffers are gathered into a bounce buffer when they are not contiguous */
+    buf = contiguous ? (uint8_t *)first->aio_buf : (uint8_t *)rt_malloc(total);
+    if (buf == RT_NULL)
+    {
+        for (i = 0; i < n; i++)
+        {
+            cb = rt_list_entry(q->running.next, struct aiocb, aio_node);
+            aio_complete(cb, aio_transfer(cb, (void *)cb->aio_buf, cb->aio_nbytes, cb->aio_offset));
+        }
+        return;
+    }
+
+    if (!contiguous && first->aio_op == AIO_OP_WRITE)
+    {
+        ptr = buf;
+        rt_list_for_each_entry(cb, &q->running, aio_node)
+        {
+            rt_memcpy(ptr, (void *)cb->aio_buf, cb->aio_nbytes);
+            ptr += cb->aio_nbytes;
+        }
+    }
+
+    result = aio_transfer(first, buf, total, first->aio_offset);
+    LOG_D("merged %d requests, %d bytes at %d: %d", n, total, first->aio_offset, result);
+
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    _aio.merged += n - 1;
+    rt_mutex_release(&_aio.lock);
+
+    /* a short transfer is shared in the order of the offsets */
+    ptr = buf;
+    done = (result > 0) ? (size_t)result : 0;
+    for (i = 0; i < n; i++)
+    {
+        int part;
+
+        cb = rt_list_entry(q->running.next, struct aiocb, aio_node);
+        part = (done > cb->aio_nbytes) ? (int)cb->aio_nbytes : (int)done;
+        done -= part;
+        if (!contiguous && first->aio_op == AIO_OP_READ && part > 0)
+            rt_memcpy((void *)cb->aio_buf, ptr, part);
+        ptr += cb->aio_nbytes;
+
+        aio_complete(cb, (result < 0) ? result : part);
+    }
+
+    if (!contiguous)
+        rt_free(buf);
+}
+
+static void aio_worker_entry(void *parameter)
+{
+    struct aio_devq *q;
+    struct aiocb *cb, *next;
+    size_t total;
+    int n;
+
+    while (1)
+    {
+        rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+        n = 0;
+        rt_list_for_each_entry(q, &_aio.devqs, list)
+        {
+            if (!q->busy && !rt_list_isempty(&q->reqs))
+            {
+                n = 1;
+                break;
+            }
+        }
+        if (n == 0)
+        {
+            rt_mutex_release(&_aio.lock);
+            rt_sem_take(&_aio.sem, RT_WAITING_FOREVER);
+            continue;
+        }
+
+        /* round robin between the devices */
+        q->busy = RT_TRUE;
+        rt_list_remove(&q->list);
+        rt_list_insert_before(&_aio.devqs, &q->list);
+
+        cb = rt_list_entry(q->reqs.next, struct aiocb, aio_node);
+        rt_list_remove(&cb->aio_node);
+        rt_list_insert_before(&q->running, &cb->aio_node);
+        total = cb->aio_nbytes;
+        while (!rt_list_isempty(&q->reqs))
+        {
+            next = rt_list_entry(q->reqs.next, struct aiocb, aio_node);
+            if (!aio_mergeable(cb, next, total))
+                break;
+
+            rt_list_remove(&next->aio_node);
+            rt_list_insert_before(&q->running, &next->aio_node);
+            total += next->aio_nbytes;
+            cb = next;
+            n++;
+        }
+        _aio.transfers++;
+        rt_mutex_release(&_aio.lock);
+
+        aio_run(q, n);
+
+        rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+        q->busy = RT_FALSE;
+        if (rt_list_isempty(&q->reqs))
+        {
+            rt_list_remove(&q->list);
+            rt_free(q);
+        }
+        rt_mutex_release(&_aio.lock);
+    }
+}
 
 /**
  * The aio_cancel() function shall attempt to cancel one or more asynchronous I/O
@@ -42,19 +475,52 @@ struct rt_workqueue* aio_queue = NULL;
  */
 int aio_cancel(int fd, struct aiocb *cb)
 {
-    rt_err_t ret;
+    struct aio_devq *q, *qtmp;
+    struct aiocb *pos, *tmp;
+    rt_list_t canceled;
+    rt_bool_t running = RT_FALSE;
 
-    if (!cb) return -EINVAL;
-    if (cb->aio_fildes != fd) return -EINVAL;
+    if (cb && cb->aio_fildes != fd) return -EINVAL;
 
-    ret = rt_workqueue_cancel_work_sync(aio_queue, &(cb->aio_work));
-    if (ret == RT_EOK)
+    rt_list_init(&canceled);
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    rt_list_for_each_entry_safe(q, qtmp, &_aio.devqs, list)
     {
-        errno = -ECANCELED;
-        return -1;
+        rt_list_for_each_entry_safe(pos, tmp, &q->reqs, aio_node)
+        {
+            if (pos->aio_fildes == fd && (cb == RT_NULL || pos == cb))
+            {
+                rt_list_remove(&pos->aio_node);
+                rt_list_insert_before(&canceled, &pos->aio_node);
+            }
+        }
+        rt_list_for_each_entry(pos, &q->running, aio_node)
+        {
+            if (pos->aio_fildes == fd && (cb == RT_NULL || pos == cb))
+                running = RT_TRUE;
+        }
+        if (!q->busy && rt_list_isempty(&q->reqs))
+        {
+            rt_list_remove(&q->list);
+            rt_free(q);
+        }
     }
+    rt_mutex_release(&_aio.lock);
 
-    return 0;
+    if (running)
+    {
+        /* the canceled ones are completed anyway */
+        while (!rt_list_isempty(&canceled))
+            aio_complete(rt_list_entry(canceled.next, struct aiocb, aio_node), -ECANCELED);
+        return AIO_NOTCANCELED;
+    }
+    if (rt_list_isempty(&canceled))
+        return AIO_ALLDONE;
+
+    while (!rt_list_isempty(&canceled))
+        aio_complete(rt_list_entry(canceled.next, struct aiocb, aio_node), -ECANCELED);
+
+    return AIO_CANCELED;
 }
 
 /**
@@ -67,7 +533,8 @@ int aio_error (const struct aiocb *cb)
 {
     if (cb)
     {
-        return cb->aio_result;
+        /* the transferred bytes are returned by aio_return() */
+        return (cb->aio_result < 0) ? cb->aio_result : 0;
     }
 
     return -EINVAL;
@@ -114,63 +581,9 @@ int aio_error (const struct aiocb *cb)
  * If the aio_fsync() function fails or aiocbp indicates an error condition,
  * data is not guaranteed to have been successfully transferred.
  */
-static void aio_fync_work(struct rt_work* work, void* work_data)
-{
-    int result;
-    rt_base_t level;
-    struct aiocb *cb = (struct aiocb*)work_data;
-
-    RT_ASSERT(cb != RT_NULL);
-
-    result = fsync(cb->aio_fildes);
-    /* modify result */
-    level = rt_hw_interrupt_disable();
-    if (result < 0)
-        cb->aio_result = errno;
-    else
-        cb->aio_result = 0;
-    rt_hw_interrupt_enable(level);
-
-    return ;
-}
-
 int aio_fsync(int op, struct aiocb *cb)
 {
-    rt_base_t level;
-    if (!cb) return -EINVAL;
-
-    level = rt_hw_interrupt_disable();
-    cb->aio_result = -EINPROGRESS;
-    rt_hw_interrupt_enable(level);
-
-    rt_work_init(&(cb->aio_work), aio_fync_work, cb);
-    rt_workqueue_dowork(aio_queue, &(cb->aio_work));
-
-    return 0;
-}
-
-static void aio_read_work(struct rt_work* work, void* work_data)
-{
-    int len;
-    rt_base_t level;
-    uint8_t *buf_ptr;
-    struct aiocb *cb = (struct aiocb*)work_data;
-
-    buf_ptr = (uint8_t*)cb->aio_buf;
-
-    /* seek to offset */
-    lseek(cb->aio_fildes, cb->aio_offset, SEEK_SET);
-    len = read(cb->aio_fildes, &buf_ptr[cb->aio_offset], cb->aio_nbytes);
-
-    /* modify result */
-    level = rt_hw_interrupt_disable();
-    if (len <= 0)
-        cb->aio_result = errno;
-    else
-        cb->aio_result = len;
-    rt_hw_interrupt_enable(level);
-
-    return ;
+    return aio_submit(cb, AIO_OP_FSYNC);
 }
 
 /**
@@ -222,20 +635,7 @@ static void aio_read_work(struct rt_work* work, void* work_data)
  */
 int aio_read(struct aiocb *cb)
 {
-    rt_base_t level;
-
-    if (!cb) return -EINVAL;
-    if (cb->aio_offset < 0) return -EINVAL;
-
-    level = rt_hw_interrupt_disable();
-    cb->aio_result = -EINPROGRESS;
-    rt_hw_interrupt_enable(level);
-
-    /* en-queue read work */
-    rt_work_init(&(cb->aio_work), aio_read_work, cb);
-    rt_workqueue_dowork(aio_queue, &(cb->aio_work));
-
-    return 0;
+    return aio_submit(cb, AIO_OP_READ);
 }
 
 /**
@@ -287,37 +687,55 @@ ssize_t  aio_return(struct aiocb *cb)
 int aio_suspend(const struct aiocb *const list[], int nent,
              const struct timespec *timeout)
 {
-    return -ENOSYS;
-}
-
-static void aio_write_work(struct rt_work* work, void* work_data)
-{
-    rt_base_t level;
-    int len, oflags;
-    uint8_t *buf_ptr;
-    struct aiocb *cb = (struct aiocb*)work_data;
+    struct aio_waiter waiter;
+    rt_int32_t tick = RT_WAITING_FOREVER;
+    rt_tick_t start = rt_tick_get();
+    int result = -EAGAIN, i;
 
-    buf_ptr = (uint8_t*)cb->aio_buf;
+    if (!list || nent <= 0) return -EINVAL;
 
-    /* whether seek offset */
-    oflags = fcntl(cb->aio_fildes, F_GETFL, 0);
-    if ((oflags & O_APPEND) == 0)
+    if (timeout)
     {
-        lseek(cb->aio_fildes, SEEK_SET, cb->aio_offset);
+        tick = rt_tick_from_millisecond(timeout->tv_sec * 1000 + timeout->tv_nsec / 1000000);
     }
 
-    /* write data */
-    len = write(cb->aio_fildes, buf_ptr, cb->aio_nbytes);
+    rt_sem_init(&waiter.sem, "aio", 0, RT_IPC_FLAG_PRIO);
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    rt_list_insert_before(&_aio.waiters, &waiter.list);
+    rt_mutex_release(&_aio.lock);
 
-    /* modify result */
-    level = rt_hw_interrupt_disable();
-    if (len <= 0)
-        cb->aio_result = errno;
-    else
-        cb->aio_result = len;
-    rt_hw_interrupt_enable(level);
+    while (1)
+    {
+        for (i = 0; i < nent; i++)
+        {
+            if (list[i] && list[i]->aio_result != -EINPROGRESS)
+            {
+                result = 0;
+                break;
+            }
+        }
+        if (result == 0)
+            break;
 
-    return;
+        if (tick != RT_WAITING_FOREVER)
+        {
+            rt_int32_t left = tick - (rt_int32_t)(rt_tick_get() - start);
+
+            if (left <= 0 || rt_sem_take(&waiter.sem, left) != RT_EOK)
+                break;
+        }
+        else
+        {
+            rt_sem_take(&waiter.sem, RT_WAITING_FOREVER);
+        }
+    }
+
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    rt_list_remove(&waiter.list);
+    rt_mutex_release(&_aio.lock);
+    rt_sem_detach(&waiter.sem);
+
+    return result;
 }
 
 /**
@@ -361,25 +779,7 @@ static void aio_write_work(struct rt_work* work, void* work_data)
  */
 int aio_write(struct aiocb *cb)
 {
-    int oflags;
-    rt_base_t level;
-
-    if (!cb || (cb->aio_buf == NULL)) return -EINVAL;
-
-    /* check access mode */
-    oflags = fcntl(cb->aio_fildes, F_GETFL, 0);
-    if ((oflags & O_ACCMODE) != O_WRONLY ||
-        (oflags & O_ACCMODE) != O_RDWR)
-        return -EINVAL;
-
-    level = rt_hw_interrupt_disable();
-    cb->aio_result = -EINPROGRESS;
-    rt_hw_interrupt_enable(level);
-
-    rt_work_init(&(cb->aio_work), aio_write_work, cb);
-    rt_workqueue_dowork(aio_queue, &(cb->aio_work));
-
-    return 0;
+    return aio_submit(cb, AIO_OP_WRITE);
 }
 
 /**
@@ -450,14 +850,314 @@ int aio_write(struct aiocb *cb)
 int lio_listio(int mode, struct aiocb * const list[], int nent,
             struct sigevent *sig)
 {
-    return -ENOSYS;
+    struct aio_group *group, wait_group;
+    struct aiocb **reqs, *cb;
+    int i, j, num = 0, error = 0, result;
+
+    if (!list || nent <= 0) return -EINVAL;
+    if (mode != LIO_WAIT && mode != LIO_NOWAIT) return -EINVAL;
+
+    reqs = (struct aiocb **)rt_malloc(nent * sizeof(struct aiocb *));
+    group = (mode == LIO_WAIT) ? &wait_group : (struct aio_group *)rt_malloc(sizeof(struct aio_group));
+    if (reqs == RT_NULL || group == RT_NULL)
+    {
+        rt_free(reqs);
+        if (group != &wait_group)
+            rt_free(group);
+        return -EAGAIN;
+    }
+
+    rt_memset(group, 0, sizeof(struct aio_group));
+    group->mode = mode;
+    group->thread = rt_thread_self();
+    if (sig && mode == LIO_NOWAIT)
+        group->sig = *sig;
+    else
+        group->sig.sigev_notify = SIGEV_NONE;
+    if (mode == LIO_WAIT)
+        rt_sem_init(&group->done, "lio", 0, RT_IPC_FLAG_PRIO);
+
+    /* sorted by the file and the offset, so the adjacent requests are merged */
+    for (i = 0; i < nent; i++)
+    {
+        cb = list[i];
+        if (cb == RT_NULL || cb->aio_lio_opcode == LIO_NOP)
+            continue;
+
+        result = -EINVAL;
+        if (cb->aio_lio_opcode == LIO_READ || cb->aio_lio_opcode == LIO_WRITE)
+            result = aio_prepare(cb, cb->aio_lio_opcode, group);
+        if (result < 0)
+        {
+            cb->aio_result = result;
+            error = -EIO;
+            continue;
+        }
+
+        for (j = num; j > 0; j--)
+        {
+            if (reqs[j - 1]->aio_fildes < cb->aio_fildes ||
+                (reqs[j - 1]->aio_fildes == cb->aio_fildes && reqs[j - 1]->aio_offset <= cb->aio_offset))
+                break;
+            reqs[j] = reqs[j - 1];
+        }
+        reqs[j] = cb;
+        num++;
+    }
+
+    /* one more reference is held until all the requests are queued */
+    group->remaining = num + 1;
+    rt_mutex_take(&_aio.lock, RT_WAITING_FOREVER);
+    for (i = 0; i < num; i++)
+    {
+        if (aio_enqueue(reqs[i]) < 0)
+        {
+            fd_put((struct dfs_fd *)reqs[i]->aio_file);
+            reqs[i]->aio_result = -EAGAIN;
+            group->remaining--;
+            error = -EIO;
+        }
+        else
+        {
+            rt_sem_release(&_aio.sem);
+        }
+    }
+    rt_mutex_release(&_aio.lock);
+    rt_free(reqs);
+
+    aio_group_put(group);
+    if (mode == LIO_WAIT)
+    {
+        rt_sem_take(&group->done, RT_WAITING_FOREVER);
+        rt_sem_detach(&group->done);
+    }
+
+    return error;
 }
 
 int aio_system_init(void)
 {
-    aio_queue = rt_workqueue_create("aio", 2048, RT_THREAD_PRIORITY_MAX/2);
-    RT_ASSERT(aio_queue != NULL);
+    char name[RT_NAME_MAX];
+    rt_thread_t tid;
+    int i;
+
+    rt_mutex_init(&_aio.lock, "aio", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&_aio.sem, "aio", 0, RT_IPC_FLAG_PRIO);
+    rt_list_init(&_aio.devqs);
+    rt_list_init(&_aio.waiters);
+
+    for (i = 0; i < RT_POSIX_AIO_WORKERS; i++)
+    {
+        rt_snprintf(name, sizeof(name), "aio%d", i);
+        tid = rt_thread_create(name, aio_worker_entry, RT_NULL,
+                               RT_POSIX_AIO_WORKER_STACK_SIZE, RT_POSIX_AIO_WORKER_PRIORITY, 10);
+        RT_ASSERT(tid != RT_NULL);
+        rt_thread_startup(tid);
+    }
 
     return 0;
 }
 INIT_COMPONENT_EXPORT(aio_system_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <stdlib.h>
+
+#define AIO_BENCH_BLOCK     4096
+#define AIO_BENCH_DEPTH     16
+#define AIO_BENCH_OPS       512
+
+static int aio_bench_prepare(const char *path, int size)
+{
+    uint8_t *buf;
+    int fd, i;
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0);
+    if (fd < 0)
+        return -1;
+
+    buf = (uint8_t *)rt_malloc(AIO_BENCH_BLOCK);
+    if (buf == RT_NULL)
+    {
+        close(fd);
+        return -1;
+    }
+    for (i = 0; i < size; i += AIO_BENCH_BLOCK)
+    {
+        rt_memset(buf, i / AIO_BENCH_BLOCK, AIO_BENCH_BLOCK);
+        if (write(fd, buf, AIO_BENCH_BLOCK) != AIO_BENCH_BLOCK)
+            break;
+    }
+    rt_free(buf);
+    close(fd);
+
+    return (i >= size) ? 0 : -1;
+}
+
+/* random block reads over the files with depth requests in flight, returns KB/s */
+static int aio_bench_depth(int *fds, int nfile, int blocks, int depth, uint8_t *bufs)
+{
+    struct aiocb cbs[AIO_BENCH_DEPTH];
+    const struct aiocb *list[AIO_BENCH_DEPTH];
+    int submitted = 0, issued = 0, done = 0, ok = 0, errors = 0, i;
+    rt_tick_t tick;
+
+    rt_memset(cbs, 0, sizeof(cbs));
+    tick = rt_tick_get();
+    for (i = 0; i < depth; i++)
+    {
+        cbs[i].aio_fildes = fds[submitted % nfile];
+        cbs[i].aio_offset = (off_t)(rand() % blocks) * AIO_BENCH_BLOCK;
+        cbs[i].aio_buf = bufs + i * AIO_BENCH_BLOCK;
+        cbs[i].aio_nbytes = AIO_BENCH_BLOCK;
+        list[i] = RT_NULL;
+        submitted++;
+        if (aio_read(&cbs[i]) == 0)
+        {
+            list[i] = &cbs[i];
+            issued++;
+        }
+        else
+        {
+            errors++;
+        }
+    }
+
+    /* only the requests which were accepted are waited for, nothing in flight ends the run */
+    while (done < issued)
+    {
+        aio_suspend(list, depth, RT_NULL);
+        for (i = 0; i < depth; i++)
+        {
+            if (list[i] == RT_NULL || aio_error(&cbs[i]) == -EINPROGRESS)
+                continue;
+
+            if (aio_return(&cbs[i]) == AIO_BENCH_BLOCK)
+                ok++;
+            else
+                errors++;
+            done++;
+            list[i] = RT_NULL;
+            if (submitted < AIO_BENCH_OPS)
+            {
+                cbs[i].aio_fildes = fds[submitted % nfile];
+                cbs[i].aio_offset = (off_t)(rand() % blocks) * AIO_BENCH_BLOCK;
+                submitted++;
+                if (aio_read(&cbs[i]) == 0)
+                {
+                    list[i] = &cbs[i];
+                    issued++;
+                }
+                else
+                {
+                    errors++;
+                }
+            }
+        }
+    }
+    tick = rt_tick_get() - tick;
+
+    if (errors)
+        rt_kprintf("%d requests failed\n", errors);
+
+    /* the failed requests moved no data, only the blocks read count */
+    return (int)((rt_uint64_t)ok * AIO_BENCH_BLOCK / 1024 * RT_TICK_PER_SECOND / (tick ? tick : 1));
+}
+
+/* read the file sequentially, the requests of one lio_listio() call are adjacent */
+static int aio_bench_listio(int fd, int blocks, uint8_t *bufs)
+{
+    struct aiocb cbs[AIO_BENCH_DEPTH];
+    struct aiocb *list[AIO_BENCH_DEPTH];
+    int block, ok = 0, i;
+    rt_tick_t tick;
+
+    rt_memset(cbs, 0, sizeof(cbs));
+    tick = rt_tick_get();
+    for (block = 0; block + AIO_BENCH_DEPTH <= blocks; block += AIO_BENCH_DEPTH)
+    {
+        for (i = 0; i < AIO_BENCH_DEPTH; i++)
+        {
+            cbs[i].aio_fildes = fd;
+            cbs[i].aio_offset = (off_t)(block + i) * AIO_BENCH_BLOCK;
+            cbs[i].aio_buf = bufs + i * AIO_BENCH_BLOCK;
+            cbs[i].aio_nbytes = AIO_BENCH_BLOCK;
+            cbs[i].aio_lio_opcode = LIO_READ;
+            list[i] = &cbs[i];
+        }
+        lio_listio(LIO_WAIT, list, AIO_BENCH_DEPTH, RT_NULL);
+        for (i = 0; i < AIO_BENCH_DEPTH; i++)
+        {
+            if (aio_return(&cbs[i]) == AIO_BENCH_BLOCK)
+                ok++;
+        }
+    }
+    tick = rt_tick_get() - tick;
+
+    if (ok < block)
+        rt_kprintf("%d requests failed\n", block - ok);
+
+    return (int)((rt_uint64_t)ok * AIO_BENCH_BLOCK / 1024 * RT_TICK_PER_SECOND / (tick ? tick : 1));
+}
+
+static void aio_bench(int argc, char **argv)
+{
+    static const int depths[] = {1, 2, 4, 8, 16};
+    int fds[2] = {-1, -1};
+    int nfile, size, blocks, i;
+    rt_uint32_t merged;
+    uint8_t *bufs;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: aio_bench <file> [file on another device] [size KB]\n");
+        return;
+    }
+    nfile = (argc > 2 && atoi(argv[2]) == 0) ? 2 : 1;
+    size = ((argc > nfile + 1) ? atoi(argv[nfile + 1]) : 1024) * 1024;
+    blocks = size / AIO_BENCH_BLOCK;
+    if (blocks < AIO_BENCH_DEPTH)
+    {
+        rt_kprintf("the size is at least %d KB\n", AIO_BENCH_DEPTH * AIO_BENCH_BLOCK / 1024);
+        return;
+    }
+
+    bufs = (uint8_t *)rt_malloc(AIO_BENCH_DEPTH * AIO_BENCH_BLOCK);
+    if (bufs == RT_NULL)
+        return;
+
+    for (i = 0; i < nfile; i++)
+    {
+        if (aio_bench_prepare(argv[i + 1], size) < 0 || (fds[i] = open(argv[i + 1], O_RDONLY, 0)) < 0)
+        {
+            rt_kprintf("prepare %s failed\n", argv[i + 1]);
+            goto __exit;
+        }
+    }
+
+    rt_kprintf("%d workers, %d files, random %d B reads\n", RT_POSIX_AIO_WORKERS, nfile, AIO_BENCH_BLOCK);
+    rt_kprintf("depth  KB/s\n");
+    for (i = 0; i < (int)(sizeof(depths) / sizeof(depths[0])); i++)
+    {
+        rt_kprintf("%-6d %d\n", depths[i], aio_bench_depth(fds, nfile, blocks, depths[i], bufs));
+    }
+
+    merged = _aio.merged;
+    i = aio_bench_listio(fds[0], blocks, bufs);
+    rt_kprintf("lio_listio sequential: %d KB/s, %d requests merged\n", i, _aio.merged - merged);
+    rt_kprintf("submitted %d, completed %d, transfers %d, merged %d\n",
+               _aio.submitted, _aio.completed, _aio.transfers, _aio.merged);
+
+__exit:
+    for (i = 0; i < nfile; i++)
+    {
+        if (fds[i] >= 0)
+        {
+            close(fds[i]);
+            unlink(argv[i + 1]);
+        }
+    }
+    rt_free(bufs);
+}
+MSH_CMD_EXPORT(aio_bench, AIO throughput with the queue depth 1-16: aio_bench <file> [file2] [size KB]);
+#endif /* RT_USING_FINSH */
@@ -15,6 +15,18 @@
 #include <sys/signal.h>
 #include <rtdevice.h>
 
+/* aio_cancel() */
+#define AIO_CANCELED    0
+#define AIO_NOTCANCELED 1
+#define AIO_ALLDONE     2
+
+/* lio_listio() */
+#define LIO_WAIT        0
+#define LIO_NOWAIT      1
+#define LIO_READ        0
+#define LIO_WRITE       1
+#define LIO_NOP         2
+
 struct aiocb
 {
     int aio_fildes;         /* File descriptor. */
@@ -27,7 +39,13 @@ struct aiocb
     int aio_lio_opcode;     /* Operation to be performed. */
 
     int aio_result;
-    struct rt_work aio_work;
+
+    /* used by the AIO engine */
+    rt_list_t aio_node;
+    void *aio_file;         /* struct dfs_fd of the request */
+    void *aio_lio;          /* lio_listio() group */
+    rt_thread_t aio_thread; /* the submitter, which receives the signal */
+    int aio_op;
 };
 
 int aio_cancel(int fd, struct aiocb *cb);
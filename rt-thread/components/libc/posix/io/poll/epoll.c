@@ -0,0 +1,865 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * epoll keeps the wait queue nodes of the registered files, so the waiting
+ * does not set up and tear down a node for each file as poll() does.
+ *
+ * The wakeup callback runs with the interrupt disabled, it puts the item on
+ * the ready list and hands one waiting thread to rt_wqueue_wakeup(), which
+ * resumes the thread and detaches the node. The detached nodes are added back
+ * when the ready list is harvested by epoll_wait().
+ */
+
+#include <stdint.h>
+#include <rthw.h>
+#include <rtthread.h>
+#include <dfs_file.h>
+#include <sys/errno.h>
+#include <sys/epoll.h>
+#include "poll.h"
+
+/* a pipe waits on both of the reader and the writer queue */
+#define EPOLL_WQ_MAX        2
+#define EPOLL_ALWAYS        (EPOLLERR | EPOLLHUP)
+#define EPOLL_PRIVATE_BITS  (EPOLLET | EPOLLONESHOT)
+
+struct rt_epoll;
+struct rt_epoll_item;
+
+struct rt_epoll_wq
+{
+    struct rt_wqueue_node wqn;
+    rt_wqueue_t *queue;
+    struct rt_epoll_item *item;
+};
+
+struct rt_epoll_item
+{
+    rt_list_t list;                 /* node of the items of the instance */
+    rt_list_t rdlink;               /* node of the ready list, empty when not ready */
+    struct rt_epoll *ep;
+    struct dfs_fd *file;
+    int fd;
+    struct epoll_event event;
+
+    rt_pollreq_t req;
+    struct rt_epoll_wq wq[EPOLL_WQ_MAX];
+    int wq_num;
+};
+
+struct rt_epoll
+{
+    rt_list_t list;                 /* node of all epoll instances */
+    struct rt_mutex lock;
+    struct dfs_fd *file;
+
+    rt_list_t items;
+    int item_num;
+    rt_list_t rdlist;               /* ready items, protected by the interrupt lock */
+
+    rt_wqueue_t waiters;            /* threads in epoll_wait() */
+    rt_wqueue_t poll_queue;         /* threads which poll the epoll fd itself */
+};
+
+static rt_list_t _epoll_list = RT_LIST_OBJECT_INIT(_epoll_list);
+static struct rt_mutex _epoll_lock;
+
+static int epoll_close(struct dfs_fd *file);
+static int epoll_poll(struct dfs_fd *file, struct rt_pollreq *req);
+
+static const struct dfs_file_ops _epoll_fops =
+{
+    RT_NULL,                        /* open */
+    epoll_close,
+    RT_NULL,                        /* ioctl */
+    RT_NULL,                        /* read */
+    RT_NULL,                        /* write */
+    RT_NULL,                        /* flush */
+    RT_NULL,                        /* lseek */
+    RT_NULL,                        /* getdents */
+    epoll_poll,
+};
+
+/* take a thread which waits for the instance, called with the interrupt disabled */
+static rt_thread_t epoll_take_waiter(struct rt_epoll *ep)
+{
+    struct rt_wqueue_node *entry;
+    rt_list_t *node;
+
+    if (!rt_list_isempty(&ep->waiters.waiting_list))
+    {
+        entry = rt_list_entry(ep->waiters.waiting_list.next, struct rt_wqueue_node, list);
+        rt_list_remove(&entry->list);
+        return entry->polling_thread;
+    }
+
+    /* the epoll fd is watched by poll() or by another epoll */
+    for (node = ep->poll_queue.waiting_list.next; node != &ep->poll_queue.waiting_list; node = node->next)
+    {
+        entry = rt_list_entry(node, struct rt_wqueue_node, list);
+        if (entry->wakeup(entry, (void *)POLLIN) == 0)
+        {
+            rt_list_remove(&entry->list);
+            return entry->polling_thread;
+        }
+    }
+
+    return RT_NULL;
+}
+
+static int epoll_wqueue_wake(struct rt_wqueue_node *wait, void *key)
+{
+    struct rt_epoll_wq *ewq = rt_container_of(wait, struct rt_epoll_wq, wqn);
+    struct rt_epoll_item *item = ewq->item;
+    struct rt_epoll *ep = item->ep;
+    rt_thread_t thread;
+
+    if (!(item->event.events & ~EPOLL_PRIVATE_BITS))
+        return -1;  /* disabled by EPOLLONESHOT */
+    if (key && !((rt_ubase_t)key & (item->event.events | EPOLL_ALWAYS)))
+        return -1;
+
+    if (rt_list_isempty(&item->rdlink))
+        rt_list_insert_before(&ep->rdlist, &item->rdlink);
+
+    thread = epoll_take_waiter(ep);
+    if (thread == RT_NULL)
+        return -1;
+
+    /* rt_wqueue_wakeup() resumes the thread and detaches this node */
+    wait->polling_thread = thread;
+    return 0;
+}
+
+static void epoll_wqueue_add(rt_wqueue_t *wq, rt_pollreq_t *req)
+{
+    struct rt_epoll_item *item = rt_container_of(req, struct rt_epoll_item, req);
+    struct rt_epoll_wq *ewq;
+
+    if (item->wq_num >= EPOLL_WQ_MAX)
+        return;
+
+    ewq = &item->wq[item->wq_num++];
+    ewq->queue = wq;
+    ewq->item = item;
+    ewq->wqn.polling_thread = RT_NULL;
+    ewq->wqn.wakeup = epoll_wqueue_wake;
+    ewq->wqn.key = req->_key;
+    rt_list_init(&ewq->wqn.list);
+    rt_wqueue_add(wq, &ewq->wqn);
+}
+
+/* add back the nodes detached by a wakeup */
+static void epoll_item_arm(struct rt_epoll_item *item)
+{
+    rt_base_t level;
+    int i;
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < item->wq_num; i++)
+    {
+        if (rt_list_isempty(&item->wq[i].wqn.list))
+            rt_list_insert_before(&item->wq[i].queue->waiting_list, &item->wq[i].wqn.list);
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/* the current events of the item, the nodes are installed when req is the one of the item */
+static int epoll_item_poll(struct rt_epoll_item *item, rt_pollreq_t *req)
+{
+    int mask = POLLMASK_DEFAULT;
+
+    if (item->file->fops->poll)
+    {
+        req->_key = item->event.events | EPOLL_ALWAYS;
+        mask = item->file->fops->poll(item->file, req);
+        if (mask < 0)
+            mask = EPOLLERR;
+    }
+
+    return mask & (item->event.events | EPOLL_ALWAYS);
+}
+
+static void epoll_item_ready(struct rt_epoll_item *item)
+{
+    struct rt_epoll *ep = item->ep;
+    rt_thread_t thread = RT_NULL;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (rt_list_isempty(&item->rdlink))
+        rt_list_insert_before(&ep->rdlist, &item->rdlink);
+    thread = epoll_take_waiter(ep);
+    if (thread)
+        rt_thread_resume(thread);
+    rt_hw_interrupt_enable(level);
+
+    if (thread)
+        rt_schedule();
+}
+
+static void epoll_item_free(struct rt_epoll_item *item)
+{
+    rt_base_t level;
+    int i;
+
+    level = rt_hw_interrupt_disable();
+    rt_list_remove(&item->rdlink);
+    for (i = 0; i < item->wq_num; i++)
+        rt_list_remove(&item->wq[i].wqn.list);
+    rt_hw_interrupt_enable(level);
+
+    rt_list_remove(&item->list);
+    item->ep->item_num--;
+    rt_free(item);
+}
+
+static struct rt_epoll_item *epoll_item_find(struct rt_epoll *ep, int fd, struct dfs_fd *file)
+{
+    struct rt_epoll_item *item;
+
+    rt_list_for_each_entry(item, &ep->items, list)
+    {
+        if (item->fd == fd && item->file == file)
+            return item;
+    }
+
+    return RT_NULL;
+}
+
+static int epoll_close(struct dfs_fd *file)
+{
+    struct rt_epoll *ep = (struct rt_epoll *)file->data;
+    struct rt_epoll_item *item, *tmp;
+
+    rt_mutex_take(&_epoll_lock, RT_WAITING_FOREVER);
+    rt_list_remove(&ep->list);
+    rt_mutex_release(&_epoll_lock);
+
+    rt_list_for_each_entry_safe(item, tmp, &ep->items, list)
+    {
+        epoll_item_free(item);
+    }
+    rt_mutex_detach(&ep->lock);
+    rt_free(ep);
+    file->data = RT_NULL;
+
+    return 0;
+}
+
+static int epoll_poll(struct dfs_fd *file, struct rt_pollreq *req)
+{
+    struct rt_epoll *ep = (struct rt_epoll *)file->data;
+
+    rt_poll_add(&ep->poll_queue, req);
+
+    return rt_list_isempty(&ep->rdlist) ? 0 : POLLIN;
+}
+
+static struct rt_epoll *epoll_get(int epfd, struct dfs_fd **file)
+{
+    struct dfs_fd *d = fd_get(epfd);
+
+    if (d == RT_NULL)
+    {
+        rt_set_errno(-EBADF);
+        return RT_NULL;
+    }
+    if (d->fops != &_epoll_fops)
+    {
+        fd_put(d);
+        rt_set_errno(-EINVAL);
+        return RT_NULL;
+    }
+    *file = d;
+
+    return (struct rt_epoll *)d->data;
+}
+
+/* harvest the ready list, the level triggered items stay on the list */
+static int epoll_harvest(struct rt_epoll *ep, struct epoll_event *events, int maxevents)
+{
+    struct rt_epoll_item *item;
+    rt_list_t txlist, again;
+    rt_pollreq_t req;
+    rt_base_t level;
+    int num = 0, mask;
+
+    req._proc = RT_NULL;
+    rt_list_init(&again);
+
+    level = rt_hw_interrupt_disable();
+    if (rt_list_isempty(&ep->rdlist))
+    {
+        rt_hw_interrupt_enable(level);
+        return 0;
+    }
+    /* the items which get ready while harvesting are left to the next call */
+    txlist = ep->rdlist;
+    txlist.next->prev = &txlist;
+    txlist.prev->next = &txlist;
+    rt_list_init(&ep->rdlist);
+
+    while (num < maxevents && !rt_list_isempty(&txlist))
+    {
+        item = rt_list_entry(txlist.next, struct rt_epoll_item, rdlink);
+        rt_list_remove(&item->rdlink);
+        rt_hw_interrupt_enable(level);
+
+        epoll_item_arm(item);
+        mask = epoll_item_poll(item, &req);
+        level = rt_hw_interrupt_disable();
+
+        if (mask == 0)
+            continue;
+
+        events[num].events = mask;
+        events[num].data = item->event.data;
+        num++;
+
+        if (item->event.events & EPOLLONESHOT)
+            item->event.events &= EPOLL_PRIVATE_BITS;
+        else if (!(item->event.events & EPOLLET) && rt_list_isempty(&item->rdlink))
+            rt_list_insert_before(&again, &item->rdlink);
+    }
+
+    /* the not harvested items are the oldest ones, the reported ones go to the tail */
+    while (!rt_list_isempty(&txlist))
+    {
+        item = rt_list_entry(txlist.prev, struct rt_epoll_item, rdlink);
+        rt_list_remove(&item->rdlink);
+        rt_list_insert_after(&ep->rdlist, &item->rdlink);
+    }
+    while (!rt_list_isempty(&again))
+    {
+        item = rt_list_entry(again.next, struct rt_epoll_item, rdlink);
+        rt_list_remove(&item->rdlink);
+        rt_list_insert_before(&ep->rdlist, &item->rdlink);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return num;
+}
+
+int epoll_create1(int flags)
+{
+    struct rt_epoll *ep;
+    struct dfs_fd *d;
+    int fd;
+
+    if (flags & ~EPOLL_CLOEXEC)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    ep = (struct rt_epoll *)rt_calloc(1, sizeof(struct rt_epoll));
+    if (ep == RT_NULL)
+    {
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+
+    fd = fd_new();
+    if (fd < 0)
+    {
+        rt_free(ep);
+        rt_set_errno(-EMFILE);
+        return -1;
+    }
+    d = fd_get(fd);
+
+    rt_mutex_init(&ep->lock, "epoll", RT_IPC_FLAG_PRIO);
+    rt_list_init(&ep->items);
+    rt_list_init(&ep->rdlist);
+    rt_wqueue_init(&ep->waiters);
+    rt_wqueue_init(&ep->poll_queue);
+    ep->file = d;
+
+    d->type = FT_USER;
+    d->path = RT_NULL;
+    d->fops = &_epoll_fops;
+    d->flags = O_RDWR;
+    d->size = 0;
+    d->pos = 0;
+    d->data = ep;
+
+    rt_mutex_take(&_epoll_lock, RT_WAITING_FOREVER);
+    rt_list_insert_before(&_epoll_list, &ep->list);
+    rt_mutex_release(&_epoll_lock);
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return fd;
+}
+RTM_EXPORT(epoll_create1);
+
+int epoll_create(int size)
+{
+    if (size <= 0)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    return epoll_create1(0);
+}
+RTM_EXPORT(epoll_create);
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+    struct rt_epoll_item *item;
+    struct dfs_fd *epfile, *file;
+    struct rt_epoll *ep;
+    rt_pollreq_t req;
+    rt_base_t level;
+    int result = 0, mask;
+
+    ep = epoll_get(epfd, &epfile);
+    if (ep == RT_NULL)
+        return -1;
+
+    file = fd_get(fd);
+    if (file == RT_NULL)
+    {
+        fd_put(epfile);
+        rt_set_errno(-EBADF);
+        return -1;
+    }
+    if (file == epfile || (op != EPOLL_CTL_DEL && event == RT_NULL))
+    {
+        result = -EINVAL;
+        goto __exit;
+    }
+
+    rt_mutex_take(&ep->lock, RT_WAITING_FOREVER);
+    item = epoll_item_find(ep, fd, file);
+    switch (op)
+    {
+    case EPOLL_CTL_ADD:
+        if (item)
+        {
+            result = -EEXIST;
+            break;
+        }
+        item = (struct rt_epoll_item *)rt_calloc(1, sizeof(struct rt_epoll_item));
+        if (item == RT_NULL)
+        {
+            result = -ENOMEM;
+            break;
+        }
+        rt_list_init(&item->rdlink);
+        item->ep = ep;
+        item->file = file;
+        item->fd = fd;
+        item->event = *event;
+        item->req._proc = epoll_wqueue_add;
+        rt_list_insert_before(&ep->items, &item->list);
+        ep->item_num++;
+
+        if (epoll_item_poll(item, &item->req))
+            epoll_item_ready(item);
+        break;
+
+    case EPOLL_CTL_MOD:
+        if (item == RT_NULL)
+        {
+            result = -ENOENT;
+            break;
+        }
+        level = rt_hw_interrupt_disable();
+        item->event = *event;
+        rt_hw_interrupt_enable(level);
+
+        if (item->wq_num == 0)
+        {
+            /* no wait queue was installed when it was added */
+            mask = epoll_item_poll(item, &item->req);
+        }
+        else
+        {
+            epoll_item_arm(item);
+            req._proc = RT_NULL;
+            mask = epoll_item_poll(item, &req);
+        }
+        if (mask)
+            epoll_item_ready(item);
+        break;
+
+    case EPOLL_CTL_DEL:
+        if (item == RT_NULL)
+        {
+            result = -ENOENT;
+            break;
+        }
+        epoll_item_free(item);
+        break;
+
+    default:
+        result = -EINVAL;
+        break;
+    }
+    rt_mutex_release(&ep->lock);
+
+__exit:
+    fd_put(file);
+    fd_put(epfile);
+    if (result < 0)
+    {
+        rt_set_errno(result);
+        return -1;
+    }
+
+    return 0;
+}
+RTM_EXPORT(epoll_ctl);
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    struct rt_wqueue_node wait;
+    struct dfs_fd *epfile;
+    struct rt_epoll *ep;
+    rt_thread_t thread;
+    rt_tick_t start;
+    rt_int32_t tick = 0;
+    rt_base_t level;
+    int num;
+
+    ep = epoll_get(epfd, &epfile);
+    if (ep == RT_NULL)
+        return -1;
+    if (events == RT_NULL || maxevents <= 0)
+    {
+        fd_put(epfile);
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    thread = rt_thread_self();
+    wait.polling_thread = thread;
+    wait.wakeup = __wqueue_default_wake;
+    wait.key = 0;
+    rt_list_init(&wait.list);
+    start = rt_tick_get();
+
+    while (1)
+    {
+        rt_mutex_take(&ep->lock, RT_WAITING_FOREVER);
+        num = epoll_harvest(ep, events, maxevents);
+        rt_mutex_release(&ep->lock);
+        if (num > 0 || timeout == 0)
+            break;
+
+        if (timeout > 0)
+        {
+            tick = rt_tick_from_millisecond(timeout) - (rt_int32_t)(rt_tick_get() - start);
+            if (tick <= 0)
+                break;
+        }
+
+        level = rt_hw_interrupt_disable();
+        if (rt_list_isempty(&ep->rdlist))
+        {
+            rt_list_insert_before(&ep->waiters.waiting_list, &wait.list);
+            rt_thread_suspend(thread);
+            if (timeout > 0)
+            {
+                rt_timer_control(&(thread->thread_timer), RT_TIMER_CTRL_SET_TIME, &tick);
+                rt_timer_start(&(thread->thread_timer));
+            }
+            rt_hw_interrupt_enable(level);
+
+            rt_schedule();
+
+            /* still queued after a timeout */
+            rt_wqueue_remove(&wait);
+        }
+        else
+        {
+            rt_hw_interrupt_enable(level);
+        }
+    }
+    fd_put(epfile);
+
+    return num;
+}
+RTM_EXPORT(epoll_wait);
+
+/* the file is closing, drop it from all epoll instances */
+void rt_epoll_fd_close(struct dfs_fd *file)
+{
+    struct rt_epoll_item *item, *tmp;
+    struct rt_epoll *ep;
+
+    if (rt_list_isempty(&_epoll_list))
+        return;
+
+    rt_mutex_take(&_epoll_lock, RT_WAITING_FOREVER);
+    rt_list_for_each_entry(ep, &_epoll_list, list)
+    {
+        rt_mutex_take(&ep->lock, RT_WAITING_FOREVER);
+        rt_list_for_each_entry_safe(item, tmp, &ep->items, list)
+        {
+            if (item->file == file)
+                epoll_item_free(item);
+        }
+        rt_mutex_release(&ep->lock);
+    }
+    rt_mutex_release(&_epoll_lock);
+}
+
+static int epoll_system_init(void)
+{
+    rt_mutex_init(&_epoll_lock, "epoll", RT_IPC_FLAG_PRIO);
+
+    return 0;
+}
+INIT_PREV_EXPORT(epoll_system_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define EPOLL_BENCH_ITERATIONS  2000
+
+/* a file which gets readable when it is signaled */
+struct epoll_bench_file
+{
+    rt_wqueue_t wq;
+    volatile int pending;
+};
+
+struct epoll_bench
+{
+    int use_epoll;
+    int nfds;
+    int epfd;
+    int iterations;
+    volatile int received;
+    struct pollfd *pfds;
+    struct epoll_bench_file **files;
+    struct rt_semaphore done;
+};
+
+static int epoll_bench_file_close(struct dfs_fd *file)
+{
+    rt_free(file->data);
+    file->data = RT_NULL;
+
+    return 0;
+}
+
+static int epoll_bench_file_poll(struct dfs_fd *file, struct rt_pollreq *req)
+{
+    struct epoll_bench_file *bf = (struct epoll_bench_file *)file->data;
+
+    rt_poll_add(&bf->wq, req);
+
+    return bf->pending ? POLLIN : 0;
+}
+
+static const struct dfs_file_ops _epoll_bench_fops =
+{
+    RT_NULL,
+    epoll_bench_file_close,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    epoll_bench_file_poll,
+};
+
+static int epoll_bench_file_open(struct epoll_bench_file **bf)
+{
+    struct dfs_fd *d;
+    int fd;
+
+    *bf = (struct epoll_bench_file *)rt_calloc(1, sizeof(struct epoll_bench_file));
+    if (*bf == RT_NULL)
+        return -1;
+
+    fd = fd_new();
+    if (fd < 0)
+    {
+        rt_free(*bf);
+        return -1;
+    }
+    d = fd_get(fd);
+    rt_wqueue_init(&(*bf)->wq);
+    d->type = FT_USER;
+    d->path = RT_NULL;
+    d->fops = &_epoll_bench_fops;
+    d->flags = O_RDWR;
+    d->data = *bf;
+    fd_put(d);
+
+    return fd;
+}
+
+static void epoll_bench_consume(struct epoll_bench *bench, struct epoll_bench_file *bf)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    bench->received += bf->pending;
+    bf->pending = 0;
+    rt_hw_interrupt_enable(level);
+}
+
+static void epoll_bench_waiter(void *parameter)
+{
+    struct epoll_bench *bench = (struct epoll_bench *)parameter;
+    struct epoll_event evs[8];
+    int i, num;
+
+    while (bench->received < bench->iterations)
+    {
+        if (bench->use_epoll)
+        {
+            num = epoll_wait(bench->epfd, evs, 8, 1000);
+            if (num <= 0)
+                break;
+            for (i = 0; i < num; i++)
+                epoll_bench_consume(bench, (struct epoll_bench_file *)evs[i].data.ptr);
+        }
+        else
+        {
+            num = poll(bench->pfds, bench->nfds, 1000);
+            if (num <= 0)
+                break;
+            for (i = 0; i < bench->nfds; i++)
+            {
+                if (bench->pfds[i].revents & POLLIN)
+                    epoll_bench_consume(bench, bench->files[i]);
+            }
+        }
+    }
+    rt_sem_release(&bench->done);
+}
+
+/* the cost of one wakeup, signaled by this thread and handled by a higher priority one */
+static int epoll_bench_run(struct epoll_bench *bench)
+{
+    rt_uint8_t priority = rt_thread_self()->current_priority;
+    struct epoll_bench_file *bf;
+    rt_thread_t tid;
+    rt_tick_t tick;
+    rt_base_t level;
+    int i;
+
+    bench->received = 0;
+    rt_sem_init(&bench->done, "ebench", 0, RT_IPC_FLAG_PRIO);
+    tid = rt_thread_create("ebench", epoll_bench_waiter, bench, 2048, priority ? priority - 1 : 0, 10);
+    if (tid == RT_NULL)
+    {
+        rt_sem_detach(&bench->done);
+        return -1;
+    }
+    rt_thread_startup(tid);
+
+    tick = rt_tick_get();
+    for (i = 0; i < bench->iterations; i++)
+    {
+        bf = bench->files[rand() % bench->nfds];
+        level = rt_hw_interrupt_disable();
+        bf->pending++;
+        rt_hw_interrupt_enable(level);
+        rt_wqueue_wakeup(&bf->wq, (void *)POLLIN);
+    }
+    rt_sem_take(&bench->done, RT_WAITING_FOREVER);
+    tick = rt_tick_get() - tick;
+    rt_sem_detach(&bench->done);
+
+    if (bench->received != bench->iterations)
+    {
+        rt_kprintf("%s lost %d events\n", bench->use_epoll ? "epoll" : "poll",
+                   bench->iterations - bench->received);
+    }
+
+    return (int)((rt_uint64_t)tick * 1000000 / RT_TICK_PER_SECOND / bench->iterations);
+}
+
+static void epoll_bench(int argc, char **argv)
+{
+    static const int nfds_list[] = {10, 50, 100};
+    struct epoll_bench bench;
+    struct epoll_event ev;
+    int i, k, fd, opened = 0;
+    int poll_us, epoll_us;
+
+    rt_memset(&bench, 0, sizeof(bench));
+    bench.iterations = (argc > 1) ? atoi(argv[1]) : EPOLL_BENCH_ITERATIONS;
+    if (bench.iterations <= 0)
+    {
+        rt_kprintf("Usage: epoll_bench [iterations]\n");
+        return;
+    }
+
+    bench.pfds = (struct pollfd *)rt_calloc(100, sizeof(struct pollfd));
+    bench.files = (struct epoll_bench_file **)rt_calloc(100, sizeof(struct epoll_bench_file *));
+    if (bench.pfds == RT_NULL || bench.files == RT_NULL)
+        goto __exit;
+
+    rt_kprintf("fds   poll(us)  epoll(us)\n");
+    for (k = 0; k < (int)(sizeof(nfds_list) / sizeof(nfds_list[0])); k++)
+    {
+        /* the bench files of the previous round are kept */
+        while (opened < nfds_list[k])
+        {
+            fd = epoll_bench_file_open(&bench.files[opened]);
+            if (fd < 0)
+                break;
+            bench.pfds[opened].fd = fd;
+            bench.pfds[opened].events = POLLIN;
+            opened++;
+        }
+        if (opened < nfds_list[k])
+        {
+            rt_kprintf("%d fds requested, only %d fds free (DFS_FD_MAX %d)\n", nfds_list[k], opened, DFS_FD_MAX);
+            if (k > 0 && opened <= nfds_list[k - 1])
+                break;
+        }
+        bench.nfds = opened;
+
+        bench.use_epoll = 0;
+        poll_us = epoll_bench_run(&bench);
+
+        bench.epfd = epoll_create1(0);
+        if (bench.epfd < 0)
+        {
+            rt_kprintf("epoll_create failed\n");
+            break;
+        }
+        for (i = 0; i < bench.nfds; i++)
+        {
+            ev.events = EPOLLIN;
+            ev.data.ptr = bench.files[i];
+            epoll_ctl(bench.epfd, EPOLL_CTL_ADD, bench.pfds[i].fd, &ev);
+        }
+        bench.use_epoll = 1;
+        epoll_us = epoll_bench_run(&bench);
+        close(bench.epfd);
+
+        rt_kprintf("%-5d %-9d %-9d\n", bench.nfds, poll_us, epoll_us);
+    }
+
+__exit:
+    for (i = 0; i < opened; i++)
+        close(bench.pfds[i].fd);
+    rt_free(bench.files);
+    rt_free(bench.pfds);
+}
+MSH_CMD_EXPORT(epoll_bench, compare the wakeup cost of poll and epoll: epoll_bench [iterations]);
+#endif /* RT_USING_FINSH */
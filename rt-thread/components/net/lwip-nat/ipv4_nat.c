@@ -31,23 +31,25 @@
  * Date           Author       Notes
  * 2015-01-26     Hichard      porting to RT-Thread
  * 2015-01-27     Bernard      code cleanup for lwIP in RT-Thread
+ * 2026-10-19     RT-Thread    hash indexed connection tracking with LRU eviction
+ * 2026-10-19     RT-Thread    the benchmark refuses to run on live NAT tables
  */
 
 /*
  * TODOS:
- *  - we should decide if we want to use static tables for NAT or a linked
- *    list.
- *  - we should allocate icmp ping id if multiple clients are sending
- *    ping requests.
- *  - maybe we could hash the identifiers for TCP, ICMP and UDP and use
- *    a single table structure. This would reduce the code amount although
- *    it will cost performance.
  *  - NAT code must check for broadcast addresses and NOT forward
  *    them.
  *
  *  - netif_remove must notify NAT code when a NAT'ed interface is removed
- *  - allocate NAT entries from a new memp pool instead of the heap
- *  - let ttl be ticks, not seconds
+ *
+ * CONNECTION TRACKING:
+ *
+ * Each protocol has a table of connections. An outgoing packet is looked up
+ * by its 5-tuple in a hash table, the translated port (the echo id for ICMP)
+ * is the port base plus the index of the connection in the table, so a reply
+ * finds its connection by index. The used connections are kept in LRU order,
+ * which is also the order of their expiry: the timer only removes from the
+ * tail, and a full table recycles its least recently used connection.
  *
  * HOWTO USE:
  *
@@ -72,6 +74,11 @@
 
 #ifdef LWIP_USING_NAT
 
+/* ip_nat_input()/ip_nat_out() are called by the IPv4 input and forward code of lwIP 1.4.1 only */
+#ifndef RT_USING_LWIP141
+#error "lwip-nat needs lwIP 1.4.1 (RT_USING_LWIP141), no other lwIP version calls it"
+#endif
+
 #include "lwip/ip.h"
 #include "lwip/inet.h"
 #include "lwip/netif.h"
@@ -92,20 +99,31 @@
 #define LWIP_NAT_DEBUG      LWIP_DBG_OFF
 #endif
 
-#define LWIP_NAT_TTL_INFINITE                    (INT_MAX)
 #define LWIP_NAT_DEFAULT_TTL_SECONDS             (128)
 #define LWIP_NAT_FORWARD_HEADER_SIZE_MIN         (sizeof(struct eth_hdr))
 
+#ifndef LWIP_NAT_DEFAULT_STATE_TABLES_ICMP
 #define LWIP_NAT_DEFAULT_STATE_TABLES_ICMP       (4)
+#endif
+#ifndef LWIP_NAT_DEFAULT_STATE_TABLES_TCP
 #define LWIP_NAT_DEFAULT_STATE_TABLES_TCP        (32)
+#endif
+#ifndef LWIP_NAT_DEFAULT_STATE_TABLES_UDP
 #define LWIP_NAT_DEFAULT_STATE_TABLES_UDP        (32)
+#endif
+
+/** Buckets of the 5-tuple hash of a table, must be a power of 2 */
+#ifndef LWIP_NAT_HASH_SIZE
+#define LWIP_NAT_HASH_SIZE                       (64)
+#endif
+
+#if (LWIP_NAT_HASH_SIZE & (LWIP_NAT_HASH_SIZE - 1)) != 0
+#error "LWIP_NAT_HASH_SIZE must be a power of 2"
+#endif
 
 #define LWIP_NAT_DEFAULT_TCP_SOURCE_PORT         (40000)
 #define LWIP_NAT_DEFAULT_UDP_SOURCE_PORT         (40000)
-
-#define IPNAT_ENTRY_RESET(x) do { \
-  (x)->ttl = 0; \
-} while(0)
+#define LWIP_NAT_DEFAULT_ICMP_ID                 (40000)
 
 typedef struct ip_nat_conf
 {
@@ -113,88 +131,96 @@ typedef struct ip_nat_conf
   ip_nat_entry_t      entry;
 } ip_nat_conf_t;
 
-typedef struct ip_nat_entry_common
-{
-  s32_t           ttl; /* @todo: do we really need this to be signed?? */
-  ip_addr_t       source;
-  ip_addr_t       dest;
-  ip_nat_conf_t   *cfg;
-} ip_nat_entry_common_t;
-
-typedef struct ip_nat_entries_icmp
-{
-  ip_nat_entry_common_t common;
-  u16_t                 id;
-  u16_t                 seqno;
-} ip_nat_entries_icmp_t;
-
-typedef struct ip_nat_entries_tcp
-{
-  ip_nat_entry_common_t common;
-  u16_t                 nport;
-  u16_t                 sport;
-  u16_t                 dport;
-} ip_nat_entries_tcp_t;
-
-typedef struct ip_nat_entries_udp
+/** A translated connection. The ports and the ICMP echo id are in network order. */
+typedef struct ip_nat_conn
 {
-  ip_nat_entry_common_t common;
-  u16_t                 nport;
-  u16_t                 sport;
-  u16_t                 dport;
-} ip_nat_entries_udp_t;
-
-typedef union u_nat_entry
+  struct ip_nat_conn *hash_next;  /* next connection in the 5-tuple bucket */
+  struct ip_nat_conn *lru_prev;   /* more recently used, free list unused */
+  struct ip_nat_conn *lru_next;   /* less recently used, or next free one */
+  ip_nat_conf_t      *cfg;
+  ip_addr_t           source;
+  ip_addr_t           dest;
+  u32_t               expire;     /* sys_now() when the connection times out */
+  u16_t               sport;      /* the echo id for ICMP */
+  u16_t               dport;      /* 0 for ICMP */
+  u16_t               nport;      /* the translated source port or echo id */
+  u8_t                used;
+} ip_nat_conn_t;
+
+typedef struct ip_nat_table
 {
-  ip_nat_entry_common_t *cmn;
-  ip_nat_entries_tcp_t  *tcp;
-  ip_nat_entries_icmp_t *icmp;
-  ip_nat_entries_udp_t  *udp;
-} nat_entry_t;
+  const char     *name;
+  ip_nat_conn_t  *conns;
+  ip_nat_conn_t **hash;
+  u16_t           size;
+  u16_t           port_base;
+
+  ip_nat_conn_t  *free;
+  ip_nat_conn_t  *lru_head;       /* the most recently used */
+  ip_nat_conn_t  *lru_tail;       /* the next to expire or to be recycled */
+
+  /* statistics */
+  u16_t           used;
+  u16_t           peak;
+  u32_t           lookups;
+  u32_t           hits;
+  u32_t           created;
+  u32_t           evicted;
+  u32_t           expired;
+} ip_nat_table_t;
 
 static ip_nat_conf_t *ip_nat_cfg = NULL;
-static ip_nat_entries_icmp_t ip_nat_icmp_table[LWIP_NAT_DEFAULT_STATE_TABLES_ICMP];
-static ip_nat_entries_tcp_t ip_nat_tcp_table[LWIP_NAT_DEFAULT_STATE_TABLES_TCP];
-static ip_nat_entries_udp_t ip_nat_udp_table[LWIP_NAT_DEFAULT_STATE_TABLES_UDP];
+
+static ip_nat_conn_t  ip_nat_icmp_conns[LWIP_NAT_DEFAULT_STATE_TABLES_ICMP];
+static ip_nat_conn_t  ip_nat_tcp_conns[LWIP_NAT_DEFAULT_STATE_TABLES_TCP];
+static ip_nat_conn_t  ip_nat_udp_conns[LWIP_NAT_DEFAULT_STATE_TABLES_UDP];
+static ip_nat_conn_t *ip_nat_icmp_hash[LWIP_NAT_HASH_SIZE];
+static ip_nat_conn_t *ip_nat_tcp_hash[LWIP_NAT_HASH_SIZE];
+static ip_nat_conn_t *ip_nat_udp_hash[LWIP_NAT_HASH_SIZE];
+
+static ip_nat_table_t ip_nat_icmp_table = {
+  "icmp", ip_nat_icmp_conns, ip_nat_icmp_hash,
+  LWIP_NAT_DEFAULT_STATE_TABLES_ICMP, LWIP_NAT_DEFAULT_ICMP_ID
+};
+static ip_nat_table_t ip_nat_tcp_table = {
+  "tcp", ip_nat_tcp_conns, ip_nat_tcp_hash,
+  LWIP_NAT_DEFAULT_STATE_TABLES_TCP, LWIP_NAT_DEFAULT_TCP_SOURCE_PORT
+};
+static ip_nat_table_t ip_nat_udp_table = {
+  "udp", ip_nat_udp_conns, ip_nat_udp_hash,
+  LWIP_NAT_DEFAULT_STATE_TABLES_UDP, LWIP_NAT_DEFAULT_UDP_SOURCE_PORT
+};
+
+static ip_nat_table_t * const ip_nat_tables[] = {
+  &ip_nat_tcp_table, &ip_nat_udp_table, &ip_nat_icmp_table
+};
+
+#define IP_NAT_TABLES_NUM     (sizeof(ip_nat_tables) / sizeof(ip_nat_tables[0]))
 
 /* ----------------------- Static functions (COMMON) --------------------*/
 static void     ip_nat_chksum_adjust(u8_t *chksum, const u8_t *optr, s16_t olen, const u8_t *nptr, s16_t nlen);
-static void     ip_nat_cmn_init(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr,
-                                 ip_nat_entry_common_t *nat_entry);
 static ip_nat_conf_t *ip_nat_shallnat(const struct ip_hdr *iphdr);
 static void     ip_nat_reset_state(ip_nat_conf_t *cfg);
+static ip_nat_conn_t *ip_nat_lookup_incoming(ip_nat_table_t *table, const struct ip_hdr *iphdr,
+                                             u16_t sport, u16_t nport);
+static ip_nat_conn_t *ip_nat_lookup_outgoing(ip_nat_table_t *table, ip_nat_conf_t *nat_config,
+                                             const struct ip_hdr *iphdr, u16_t sport, u16_t dport);
 
 /* ----------------------- Static functions (DEBUG) ---------------------*/
 #if defined(LWIP_DEBUG) && (LWIP_NAT_DEBUG & LWIP_DBG_ON)
 static void     ip_nat_dbg_dump(const char *msg, const struct ip_hdr *iphdr);
 static void     ip_nat_dbg_dump_ip(const ip_addr_t *addr);
-static void     ip_nat_dbg_dump_icmp_nat_entry(const char *msg, const ip_nat_entries_icmp_t *nat_entry);
-static void     ip_nat_dbg_dump_tcp_nat_entry(const char *msg, const ip_nat_entries_tcp_t *nat_entry);
-static void     ip_nat_dbg_dump_udp_nat_entry(const char *msg, const ip_nat_entries_udp_t *nat_entry);
+static void     ip_nat_dbg_dump_conn(const char *msg, const ip_nat_table_t *table, const ip_nat_conn_t *conn);
 static void     ip_nat_dbg_dump_init(ip_nat_conf_t *ip_nat_cfg_new);
 static void     ip_nat_dbg_dump_remove(ip_nat_conf_t *cur);
 #else /* defined(LWIP_DEBUG) && (LWIP_NAT_DEBUG & LWIP_DBG_ON) */
 #define ip_nat_dbg_dump(msg, iphdr)
 #define ip_nat_dbg_dump_ip(addr)
-#define ip_nat_dbg_dump_icmp_nat_entry(msg, nat_entry)
-#define ip_nat_dbg_dump_tcp_nat_entry(msg, nat_entry)
-#define ip_nat_dbg_dump_udp_nat_entry(msg, nat_entry)
+#define ip_nat_dbg_dump_conn(msg, table, conn)
 #define ip_nat_dbg_dump_init(ip_nat_cfg_new)
 #define ip_nat_dbg_dump_remove(cur)
 #endif /* defined(LWIP_DEBUG) && (LWIP_NAT_DEBUG & LWIP_DBG_ON) */
 
-/* ----------------------- Static functions (TCP) -----------------------*/
-static ip_nat_entries_tcp_t *ip_nat_tcp_lookup_incoming(const struct ip_hdr *iphdr, const struct tcp_hdr *tcphdr);
-static ip_nat_entries_tcp_t *ip_nat_tcp_lookup_outgoing(ip_nat_conf_t *nat_config,
-                                                         const struct ip_hdr *iphdr, const struct tcp_hdr *tcphdr,
-                                                         u8_t allocate);
-
-/* ----------------------- Static functions (UDP) -----------------------*/
-static ip_nat_entries_udp_t *ip_nat_udp_lookup_incoming(const struct ip_hdr *iphdr, const struct udp_hdr *udphdr);
-static ip_nat_entries_udp_t *ip_nat_udp_lookup_outgoing(ip_nat_conf_t *nat_config,
-                                                         const struct ip_hdr *iphdr, const struct udp_hdr *udphdr,
-                                                         u8_t allocate);
-
 /**
  * Timer callback function that calls ip_nat_tmr() and reschedules itself.
  *
@@ -210,23 +236,31 @@ nat_timer(void *arg)
   sys_timeout(LWIP_NAT_TMR_INTERVAL_SEC * 1000, nat_timer, NULL);
 }
 
+/** Put all the connections of a table on its free list */
+static void
+ip_nat_table_init(ip_nat_table_t *table)
+{
+  int i;
+
+  memset(table->conns, 0, table->size * sizeof(ip_nat_conn_t));
+  memset(table->hash, 0, LWIP_NAT_HASH_SIZE * sizeof(ip_nat_conn_t *));
+  table->free = NULL;
+  for (i = table->size - 1; i >= 0; i--) {
+    table->conns[i].lru_next = table->free;
+    table->free = &table->conns[i];
+  }
+  table->lru_head = table->lru_tail = NULL;
+  table->used = 0;
+}
+
 /** Initialize this module */
 void
 ip_nat_init(void)
 {
-  int i;
-  extern void lwip_ip_input_set_hook(int (*hook)(struct pbuf *p, struct netif *inp));
+  u32_t i;
 
-  /* @todo: this can be omitted since we trust static variables
-            to be initialized to zero */
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-    IPNAT_ENTRY_RESET(&ip_nat_icmp_table[i].common);
-  }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    IPNAT_ENTRY_RESET(&ip_nat_tcp_table[i].common);
-  }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    IPNAT_ENTRY_RESET(&ip_nat_udp_table[i].common);
+  for (i = 0; i < IP_NAT_TABLES_NUM; i++) {
+    ip_nat_table_init(ip_nat_tables[i]);
   }
 
   /* we must lock scheduler to protect following code */
@@ -330,31 +364,97 @@ ip_nat_remove(const ip_nat_entry_t *remove_entry)
   }
 }
 
+/** Hash the 5-tuple of an outgoing packet, the protocol selects the table */
+static u32_t
+ip_nat_hash(u32_t src, u32_t dest, u16_t sport, u16_t dport)
+{
+  u32_t h;
+
+  h = src ^ (dest * 0x9E3779B1UL) ^ (((u32_t)sport << 16) | dport);
+  h ^= h >> 16;
+  h *= 0x45D9F3BUL;
+  h ^= h >> 16;
+
+  return h & (LWIP_NAT_HASH_SIZE - 1);
+}
+
+static ip_nat_conn_t **
+ip_nat_bucket(ip_nat_table_t *table, const ip_nat_conn_t *conn)
+{
+  return &table->hash[ip_nat_hash(conn->source.addr, conn->dest.addr, conn->sport, conn->dport)];
+}
+
+static void
+ip_nat_lru_unlink(ip_nat_table_t *table, ip_nat_conn_t *conn)
+{
+  if (conn->lru_prev != NULL) {
+    conn->lru_prev->lru_next = conn->lru_next;
+  } else {
+    table->lru_head = conn->lru_next;
+  }
+  if (conn->lru_next != NULL) {
+    conn->lru_next->lru_prev = conn->lru_prev;
+  } else {
+    table->lru_tail = conn->lru_prev;
+  }
+}
+
+/** Refresh a connection, it becomes the most recently used one */
+static void
+ip_nat_touch(ip_nat_table_t *table, ip_nat_conn_t *conn)
+{
+  conn->expire = sys_now() + LWIP_NAT_DEFAULT_TTL_SECONDS * 1000;
+  if (table->lru_head != conn) {
+    ip_nat_lru_unlink(table, conn);
+    conn->lru_prev = NULL;
+    conn->lru_next = table->lru_head;
+    table->lru_head->lru_prev = conn;
+    table->lru_head = conn;
+  }
+}
+
+/** Take a connection out of the hash and the LRU list and give it back to the free list */
+static void
+ip_nat_release(ip_nat_table_t *table, ip_nat_conn_t *conn)
+{
+  ip_nat_conn_t **pp;
+
+  LWIP_ASSERT("conn->used", conn->used);
+  for (pp = ip_nat_bucket(table, conn); *pp != NULL; pp = &(*pp)->hash_next) {
+    if (*pp == conn) {
+      *pp = conn->hash_next;
+      break;
+    }
+  }
+  ip_nat_lru_unlink(table, conn);
+
+  conn->used = 0;
+  conn->cfg = NULL;
+  conn->lru_prev = NULL;
+  conn->lru_next = table->free;
+  table->free = conn;
+  table->used--;
+}
+
 /** Reset a NAT configured entry to be reused.
- * Effectively calls IPNAT_ENTRY_RESET() on 'cfg'.
+ * Releases the connections which were created by 'cfg'.
  *
  * @param cfg NAT entry to reset
  */
 static void
 ip_nat_reset_state(ip_nat_conf_t *cfg)
 {
-  int i;
-
-  /* @todo: optimize this!!!
-     why do we search for it anyway, if we have the pointer??? */
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-    if(ip_nat_icmp_table[i].common.cfg == cfg) {
-      IPNAT_ENTRY_RESET(&ip_nat_icmp_table[i].common);
-    }
-  }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    if(ip_nat_tcp_table[i].common.cfg == cfg) {
-      IPNAT_ENTRY_RESET(&ip_nat_tcp_table[i].common);
-    }
-  }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    if(ip_nat_udp_table[i].common.cfg == cfg) {
-      IPNAT_ENTRY_RESET(&ip_nat_udp_table[i].common);
+  ip_nat_table_t *table;
+  u32_t i;
+  int j;
+
+  /* removing a configuration is rare, a scan of the tables is good enough */
+  for (i = 0; i < IP_NAT_TABLES_NUM; i++) {
+    table = ip_nat_tables[i];
+    for (j = 0; j < table->size; j++) {
+      if (table->conns[j].used && table->conns[j].cfg == cfg) {
+        ip_nat_release(table, &table->conns[j]);
+      }
     }
   }
 }
@@ -407,6 +507,42 @@ ip_nat_check_header(struct pbuf *p, u16_t min_size)
   return ret;
 }
 
+/** Rewrite an address and a port of the packet in one pass. The IP header
+ * checksum covers the address, the transport checksum (if any) covers both
+ * through the pseudo header, an ICMP checksum only the echo id.
+ *
+ * @param iphdr the IP header
+ * @param addr the address in the IP header to rewrite
+ * @param naddr the new address
+ * @param port the port (or echo id) in the transport header to rewrite
+ * @param nport the new port in network order
+ * @param chksum the transport checksum, NULL if the packet has none
+ * @param pseudo != 0 if the transport checksum covers the address
+ */
+static void
+ip_nat_rewrite(struct ip_hdr *iphdr, void *addr, const ip_addr_t *naddr,
+               void *port, u16_t nport, void *chksum, u8_t pseudo)
+{
+  u8_t optr[6], nptr[6];
+
+  SMEMCPY(optr, addr, 4);
+  SMEMCPY(optr + 4, port, 2);
+  SMEMCPY(nptr, &naddr->addr, 4);
+  SMEMCPY(nptr + 4, &nport, 2);
+
+  if (chksum != NULL) {
+    if (pseudo) {
+      ip_nat_chksum_adjust((u8_t *)chksum, optr, 6, nptr, 6);
+    } else {
+      ip_nat_chksum_adjust((u8_t *)chksum, optr + 4, 2, nptr + 4, 2);
+    }
+  }
+  ip_nat_chksum_adjust((u8_t *)&IPH_CHKSUM(iphdr), optr, 4, nptr, 4);
+
+  SMEMCPY(addr, nptr, 4);
+  SMEMCPY(port, nptr + 4, 2);
+}
+
 /** Input processing: check if a received packet belongs to a NAT entry
  * and if so, translated it and send it on.
  *
@@ -421,13 +557,15 @@ ip_nat_input(struct pbuf *p)
   struct tcp_hdr       *tcphdr;
   struct udp_hdr       *udphdr;
   struct icmp_echo_hdr *icmphdr;
-  nat_entry_t           nat_entry;
+  ip_nat_table_t       *table = NULL;
+  ip_nat_conn_t        *conn = NULL;
+  void                 *port = NULL;
+  void                 *chksum = NULL;
+  u8_t                  pseudo = 1;
   err_t                 err;
-  u8_t                  consumed = 0;
-  int                   i;
   struct pbuf          *q = NULL;
+  struct netif         *in_if;
 
-  nat_entry.cmn = NULL;
   ip_nat_dbg_dump("ip_nat_in: checking nat for", iphdr);
 
   switch (IPH_PROTO(iphdr)) {
@@ -436,21 +574,10 @@ ip_nat_input(struct pbuf *p)
       if (tcphdr == NULL) {
         LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: short tcp packet (%" U16_F " bytes) discarded\n", p->tot_len));
       } else {
-        nat_entry.tcp = ip_nat_tcp_lookup_incoming(iphdr, tcphdr);
-        if (nat_entry.tcp != NULL) {
-          /* Refresh TCP entry */
-          nat_entry.tcp->common.ttl = LWIP_NAT_DEFAULT_TTL_SECONDS;
-          tcphdr->dest = nat_entry.tcp->sport;
-          /* Adjust TCP checksum for changed destination port */
-          ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-            (u8_t *)&(nat_entry.tcp->nport), 2, (u8_t *)&(tcphdr->dest), 2);
-          /* Adjust TCP checksum for changing dest IP address */
-          ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-            (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4,
-            (u8_t *)&(nat_entry.cmn->source.addr), 4);
-
-          consumed = 1;
-        }
+        table = &ip_nat_tcp_table;
+        conn = ip_nat_lookup_incoming(table, iphdr, tcphdr->src, tcphdr->dest);
+        port = &tcphdr->dest;
+        chksum = &tcphdr->chksum;
       }
       break;
 
@@ -461,21 +588,11 @@ ip_nat_input(struct pbuf *p)
           ("ip_nat_input: short udp packet (%" U16_F " bytes) discarded\n",
           p->tot_len));
       } else {
-        nat_entry.udp = ip_nat_udp_lookup_incoming(iphdr, udphdr);
-        if (nat_entry.udp != NULL) {
-          /* Refresh UDP entry */
-          nat_entry.udp->common.ttl = LWIP_NAT_DEFAULT_TTL_SECONDS;
-          udphdr->dest = nat_entry.udp->sport;
-          /* Adjust UDP checksum for changed destination port */
-          ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-            (u8_t *)&(nat_entry.udp->nport), 2, (u8_t *)&(udphdr->dest), 2);
-          /* Adjust UDP checksum for changing dest IP address */
-          ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-            (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4,
-            (u8_t *)&(nat_entry.cmn->source.addr), 4);
-
-          consumed = 1;
-        }
+        table = &ip_nat_udp_table;
+        conn = ip_nat_lookup_incoming(table, iphdr, udphdr->src, udphdr->dest);
+        port = &udphdr->dest;
+        /* a zero UDP checksum means there is none */
+        chksum = udphdr->chksum ? &udphdr->chksum : NULL;
       }
       break;
 
@@ -485,21 +602,12 @@ ip_nat_input(struct pbuf *p)
         LWIP_DEBUGF(LWIP_NAT_DEBUG,
           ("ip_nat_out: short icmp echo reply packet (%" U16_F " bytes) discarded\n",
           p->tot_len));
-      } else {
-        if (ICMP_ER == ICMPH_TYPE(icmphdr)) {
-          for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-            nat_entry.icmp = &ip_nat_icmp_table[i];
-            if ((nat_entry.icmp->common.ttl) &&
-                (iphdr->src.addr == nat_entry.icmp->common.dest.addr) &&
-                (nat_entry.icmp->id == icmphdr->id) &&
-                (nat_entry.icmp->seqno == icmphdr->seqno)) {
-              ip_nat_dbg_dump_icmp_nat_entry("found existing nat entry: ", nat_entry.icmp);
-              consumed = 1;
-              IPNAT_ENTRY_RESET(nat_entry.cmn);
-              break;
-            }
-          }
-        }
+      } else if (ICMP_ER == ICMPH_TYPE(icmphdr)) {
+        table = &ip_nat_icmp_table;
+        conn = ip_nat_lookup_incoming(table, iphdr, 0, icmphdr->id);
+        port = &icmphdr->id;
+        chksum = &icmphdr->chksum;
+        pseudo = 0;
       }
       break;
 
@@ -507,96 +615,80 @@ ip_nat_input(struct pbuf *p)
       break;
   }
 
-  if(consumed) {
-    /* packet consumed, send it out on in_if */
-    struct netif *in_if;
-
-    /* check if the pbuf has room for link headers */
-    if (pbuf_header(p, PBUF_LINK_HLEN)) {
-      /* pbuf has no room for link headers, allocate an extra pbuf */
-      q = pbuf_alloc(PBUF_LINK, 0, PBUF_RAM);
-      if (q == NULL) {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: no pbuf for outgoing header\n"));
-        // rt_kprintf("ip_nat_input: no pbuf for outgoing header\n");
-        /* @todo: stats? */
-        pbuf_free(p);
-        p = NULL;
-        return 1;
-      } else {
-        pbuf_cat(q, p);
-      }
+  if (conn == NULL) {
+    return 0;
+  }
+
+  /* packet consumed, send it out on in_if */
+  ip_nat_touch(table, conn);
+  ip_nat_dbg_dump_conn("ip_nat_input: found existing nat entry: ", table, conn);
+
+  /* check if the pbuf has room for link headers */
+  if (pbuf_header(p, PBUF_LINK_HLEN)) {
+    /* pbuf has no room for link headers, allocate an extra pbuf */
+    q = pbuf_alloc(PBUF_LINK, 0, PBUF_RAM);
+    if (q == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: no pbuf for outgoing header\n"));
+      /* @todo: stats? */
+      pbuf_free(p);
+      p = NULL;
+      return 1;
     } else {
-      /* restore p->payload to IP header */
-      if (pbuf_header(p, -PBUF_LINK_HLEN)) {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: restoring header failed\n"));
-        // rt_kprintf("ip_nat_input: restoring header failed\n");
-        /* @todo: stats? */
-        pbuf_free(p);
-        p = NULL;
-        return 1;
-      }
-      else q = p;
+      pbuf_cat(q, p);
     }
-    /* if we come here, q is the pbuf to send (either points to p or to a chain) */
-    in_if = nat_entry.cmn->cfg->entry.in_if;
-    iphdr->dest.addr = nat_entry.cmn->source.addr;
-    ip_nat_chksum_adjust((u8_t *) & IPH_CHKSUM(iphdr),
-      (u8_t *) & (nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4,
-      (u8_t *) & (iphdr->dest.addr), 4);
-
-    ip_nat_dbg_dump("ip_nat_input: packet back to source after nat: ", iphdr);
-    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: sending packet on interface ("));
-    ip_nat_dbg_dump_ip(&(in_if->ip_addr));
-    LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
-
-    err = in_if->output(in_if, q, (ip_addr_t *)&(iphdr->dest));
-    if(err != ERR_OK) {
-      LWIP_DEBUGF(LWIP_NAT_DEBUG,
-        ("ip_nat_input: failed to send rewritten packet. link layer returned %d\n",
-        err));
-      // rt_kprintf("ip_nat_input: failed to send rewritten packet. link layer returned %d\n", err);
+  } else {
+    /* restore p->payload to IP header */
+    if (pbuf_header(p, -PBUF_LINK_HLEN)) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: restoring header failed\n"));
+      /* @todo: stats? */
+      pbuf_free(p);
+      p = NULL;
+      return 1;
     }
-    /* now that q (and/or p) is sent (or not), give up the reference to it
-       this frees the input pbuf (p) as we have consumed it. */
-    pbuf_free(q);
+    else q = p;
   }
-  return consumed;
-}
 
-/** Check if one NAT entry timed out */
-static void
-ip_nat_check_timeout(ip_nat_entry_common_t *nat_entry)
-{
-  if(nat_entry->ttl > 0) {
-    if(nat_entry->ttl != LWIP_NAT_TTL_INFINITE) {
-      /* this is not a 'no-timeout' entry */
-      if(nat_entry->ttl > LWIP_NAT_TMR_INTERVAL_SEC) {
-        nat_entry->ttl -= LWIP_NAT_TMR_INTERVAL_SEC;
-      } else {
-        nat_entry->ttl = 0;
-      }
-    }
+  /* if we come here, q is the pbuf to send (either points to p or to a chain) */
+  in_if = conn->cfg->entry.in_if;
+  ip_nat_rewrite(iphdr, &iphdr->dest, &conn->source, port, conn->sport, chksum, pseudo);
+
+  ip_nat_dbg_dump("ip_nat_input: packet back to source after nat: ", iphdr);
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: sending packet on interface ("));
+  ip_nat_dbg_dump_ip(&(in_if->ip_addr));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
+
+  err = in_if->output(in_if, q, (ip_addr_t *)&(iphdr->dest));
+  if(err != ERR_OK) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG,
+      ("ip_nat_input: failed to send rewritten packet. link layer returned %d\n",
+      err));
   }
+  /* now that q (and/or p) is sent (or not), give up the reference to it
+     this frees the input pbuf (p) as we have consumed it. */
+  pbuf_free(q);
+
+  return 1;
 }
 
 /** The NAT timer function, to be called at an interval of
- * LWIP_NAT_TMR_INTERVAL_SEC seconds.
+ * LWIP_NAT_TMR_INTERVAL_SEC seconds. The LRU tail of a table expires first,
+ * so only the timed out connections are visited.
  */
 void
 ip_nat_tmr(void)
 {
-  int i;
+  ip_nat_table_t *table;
+  u32_t now = sys_now();
+  u32_t i;
 
   LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_tmr: removing old entries\n"));
 
-  for(i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-    ip_nat_check_timeout((ip_nat_entry_common_t *) & ip_nat_icmp_table[i]);
-  }
-  for(i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    ip_nat_check_timeout((ip_nat_entry_common_t *) & ip_nat_tcp_table[i]);
-  }
-  for(i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    ip_nat_check_timeout((ip_nat_entry_common_t *) & ip_nat_udp_table[i]);
+  for (i = 0; i < IP_NAT_TABLES_NUM; i++) {
+    table = ip_nat_tables[i];
+    while (table->lru_tail != NULL && (s32_t)(now - table->lru_tail->expire) >= 0) {
+      ip_nat_release(table, table->lru_tail);
+      table->expired++;
+    }
   }
 }
 
@@ -617,305 +709,205 @@ ip_nat_out(struct pbuf *p)
   struct tcp_hdr       *tcphdr;
   struct udp_hdr       *udphdr;
   ip_nat_conf_t        *nat_config;
-  nat_entry_t           nat_entry;
-  int             i;
-
-  nat_entry.cmn = NULL;
+  ip_nat_table_t       *table = NULL;
+  ip_nat_conn_t        *conn = NULL;
+  void                 *port = NULL;
+  void                 *chksum = NULL;
+  u8_t                  pseudo = 1;
 
   ip_nat_dbg_dump("ip_nat_out: checking nat for", iphdr);
 
   /* Check if this packet should be routed or should be translated */
   nat_config = ip_nat_shallnat(iphdr);
-  if (nat_config != NULL ) {
-    if (nat_config->entry.out_if == NULL) {
-      LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: no external interface for nat table entry\n"));
-    } else {
-      switch (IPH_PROTO(iphdr))
-      {
-      case IP_PROTO_TCP:
-        tcphdr = (struct tcp_hdr *)ip_nat_check_header(p, sizeof(struct tcp_hdr));
-        if (tcphdr == NULL) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: short tcp packet (%" U16_F " bytes) discarded\n", p->tot_len));
-        } else {
-          nat_entry.tcp = ip_nat_tcp_lookup_outgoing(nat_config, iphdr, tcphdr, 1);
-          if (nat_entry.tcp != NULL) {
-            /* Adjust TCP checksum for changing source port */
-            tcphdr->src = nat_entry.tcp->nport;
-            ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-              (u8_t *)&(nat_entry.tcp->sport), 2, (u8_t *)&(tcphdr->src), 2);
-            /* Adjust TCP checksum for changing source IP address */
-            ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-              (u8_t *)&(nat_entry.cmn->source.addr), 4,
-              (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4);
-          }
-        }
-        break;
+  if (nat_config == NULL) {
+    return 0;
+  }
+  if (nat_config->entry.out_if == NULL) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: no external interface for nat table entry\n"));
+    return 0;
+  }
 
-      case IP_PROTO_UDP:
-        udphdr = (struct udp_hdr *)ip_nat_check_header(p, sizeof(struct udp_hdr));
-        if (udphdr == NULL) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: short udp packet (%" U16_F " bytes) discarded\n", p->tot_len));
-        } else {
-          nat_entry.udp = ip_nat_udp_lookup_outgoing(nat_config, iphdr, udphdr, 1);
-          if (nat_entry.udp != NULL) {
-            /* Adjust UDP checksum for changing source port */
-            udphdr->src = nat_entry.udp->nport;
-            ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-              (u8_t *)&(nat_entry.udp->sport), 2, (u8_t *) & (udphdr->src), 2);
-            /* Adjust UDP checksum for changing source IP address */
-            ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-              (u8_t *)&(nat_entry.cmn->source.addr), 4,
-              (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4);
-          }
-        }
-        break;
+  switch (IPH_PROTO(iphdr))
+  {
+  case IP_PROTO_TCP:
+    tcphdr = (struct tcp_hdr *)ip_nat_check_header(p, sizeof(struct tcp_hdr));
+    if (tcphdr == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG,
+        ("ip_nat_out: short tcp packet (%" U16_F " bytes) discarded\n", p->tot_len));
+    } else {
+      table = &ip_nat_tcp_table;
+      conn = ip_nat_lookup_outgoing(table, nat_config, iphdr, tcphdr->src, tcphdr->dest);
+      port = &tcphdr->src;
+      chksum = &tcphdr->chksum;
+    }
+    break;
 
-      case IP_PROTO_ICMP:
-        icmphdr = (struct icmp_echo_hdr *)ip_nat_check_header(p, sizeof(struct icmp_echo_hdr));
-        if(icmphdr == NULL) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: short icmp echo packet (%" U16_F " bytes) discarded\n", p->tot_len));
-        } else {
-          if (ICMPH_TYPE(icmphdr) == ICMP_ECHO) {
-            for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-              if (!ip_nat_icmp_table[i].common.ttl) {
-                nat_entry.icmp = &ip_nat_icmp_table[i];
-                ip_nat_cmn_init(nat_config, iphdr, nat_entry.cmn);
-                nat_entry.icmp->id = icmphdr->id;
-                nat_entry.icmp->seqno = icmphdr->seqno;
-                ip_nat_dbg_dump_icmp_nat_entry(" ip_nat_out: created new NAT entry ", nat_entry.icmp);
-                break;
-              }
-            }
-            if (NULL == nat_entry.icmp)
-            {
-              LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: no more NAT entries for ICMP available\n"));
-            }
-          }
-        }
-        break;
-      default:
-        break;
-      }
+  case IP_PROTO_UDP:
+    udphdr = (struct udp_hdr *)ip_nat_check_header(p, sizeof(struct udp_hdr));
+    if (udphdr == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG,
+        ("ip_nat_out: short udp packet (%" U16_F " bytes) discarded\n", p->tot_len));
+    } else {
+      table = &ip_nat_udp_table;
+      conn = ip_nat_lookup_outgoing(table, nat_config, iphdr, udphdr->src, udphdr->dest);
+      port = &udphdr->src;
+      /* a zero UDP checksum means there is none */
+      chksum = udphdr->chksum ? &udphdr->chksum : NULL;
+    }
+    break;
 
-      if (nat_entry.cmn != NULL) {
-        struct netif *out_if = nat_entry.cmn->cfg->entry.out_if;
-        /* Exchange the IP source address with the address of the interface
-        * where the packet will be sent.
-        */
-        /* @todo: check nat_config->entry.out_if agains nat_entry.cmn->cfg->entry.out_if */
-        iphdr->src.addr = nat_config->entry.out_if->ip_addr.addr;
-        ip_nat_chksum_adjust((u8_t *) & IPH_CHKSUM(iphdr),
-          (u8_t *) & (nat_entry.cmn->source.addr), 4, (u8_t *) & iphdr->src.addr, 4);
-
-        ip_nat_dbg_dump("ip_nat_out: rewritten packet", iphdr);
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: sending packet on interface ("));
-        ip_nat_dbg_dump_ip(&(out_if->ip_addr));
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
-
-        err = out_if->output(out_if, p, (ip_addr_t *)&(iphdr->dest));
-        if (err != ERR_OK) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: failed to send rewritten packet. link layer returned %d\n", err));
-          // rt_kprintf("ip_nat_out: failed to send rewritten packet. link layer returned %d\n", err);
-        } else {
-          sent = 1;
-        }
-      }
+  case IP_PROTO_ICMP:
+    icmphdr = (struct icmp_echo_hdr *)ip_nat_check_header(p, sizeof(struct icmp_echo_hdr));
+    if(icmphdr == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG,
+        ("ip_nat_out: short icmp echo packet (%" U16_F " bytes) discarded\n", p->tot_len));
+    } else if (ICMPH_TYPE(icmphdr) == ICMP_ECHO) {
+      /* the echo id is translated like a port, so several hosts can ping at once */
+      table = &ip_nat_icmp_table;
+      conn = ip_nat_lookup_outgoing(table, nat_config, iphdr, icmphdr->id, 0);
+      port = &icmphdr->id;
+      chksum = &icmphdr->chksum;
+      pseudo = 0;
     }
+    break;
+
+  default:
+    break;
   }
 
-  return sent;
-}
+  if (conn != NULL) {
+    struct netif *out_if = conn->cfg->entry.out_if;
 
-/** Initialize common parts of a NAT entry
- *
- * @param nat_config NAT config entry
- * @param iphdr IP header from which to initialize the entry
- * @param nat_entry entry to initialize
- */
-static void
-ip_nat_cmn_init(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr, ip_nat_entry_common_t *nat_entry)
-{
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_config", NULL != nat_config);
-  LWIP_ASSERT("NULL != iphdr", NULL != iphdr);
-  nat_entry->cfg = nat_config;
-  nat_entry->dest = *((ip_addr_t *)&iphdr->dest);
-  nat_entry->source = *((ip_addr_t *)&iphdr->src);
-  nat_entry->ttl = LWIP_NAT_DEFAULT_TTL_SECONDS;
-}
+    /* Exchange the IP source address with the address of the interface
+     * where the packet will be sent, and the source port with the
+     * translated one.
+     */
+    ip_nat_rewrite(iphdr, &iphdr->src, &out_if->ip_addr, port, conn->nport, chksum, pseudo);
 
-/**
- * This function checks for incoming packets if we already have a NAT entry.
- * If yes a pointer to the NAT entry is returned. Otherwise NULL.
- *
- * @param nat_config NAT configuration.
- * @param iphdr The IP header.
- * @param udphdr The UDP header.
- * @return A pointer to an existing NAT entry or
- *         NULL if none is found.
- */
-static ip_nat_entries_udp_t *
-ip_nat_udp_lookup_incoming(const struct ip_hdr *iphdr, const struct udp_hdr *udphdr)
-{
-  int i;
-  ip_nat_entries_udp_t *nat_entry = NULL;
-
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    if (ip_nat_udp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_udp_table[i].common.dest.addr) &&
-          (udphdr->src == ip_nat_udp_table[i].dport) &&
-          (udphdr->dest == ip_nat_udp_table[i].nport)) {
-        nat_entry = &ip_nat_udp_table[i];
-        ip_nat_dbg_dump_udp_nat_entry("ip_nat_udp_lookup_incoming: found existing nat entry: ",
-                                      nat_entry);
-        break;
-      }
-    }
-  }
-  return nat_entry;
-}
+    ip_nat_dbg_dump("ip_nat_out: rewritten packet", iphdr);
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: sending packet on interface ("));
+    ip_nat_dbg_dump_ip(&(out_if->ip_addr));
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
 
-/**
- * This function checks if we already have a NAT entry for this UDP connection.
- * If yes the a pointer to this NAT entry is returned.
- *
- * @param iphdr The IP header.
- * @param udphdr The UDP header.
- * @param allocate If no existing NAT entry is found and this flag is true
- *        a NAT entry is allocated.
- */
-static ip_nat_entries_udp_t *
-ip_nat_udp_lookup_outgoing(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr,
-                           const struct udp_hdr *udphdr, u8_t allocate)
-{
-  int i;
-  nat_entry_t nat_entry;
-  int last_free = -1;
-
-  nat_entry.cmn = NULL;
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    if (ip_nat_udp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_udp_table[i].common.source.addr) &&
-          (iphdr->dest.addr == ip_nat_udp_table[i].common.dest.addr) &&
-          (udphdr->src == ip_nat_udp_table[i].sport) &&
-          (udphdr->dest == ip_nat_udp_table[i].dport)) {
-        nat_entry.udp = &ip_nat_udp_table[i];
-
-        ip_nat_dbg_dump_udp_nat_entry("ip_nat_udp_lookup_outgoing: found existing nat entry: ",
-                                      nat_entry.udp);
-        break;
-      }
+    err = out_if->output(out_if, p, (ip_addr_t *)&(iphdr->dest));
+    if (err != ERR_OK) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG,
+        ("ip_nat_out: failed to send rewritten packet. link layer returned %d\n", err));
     } else {
-        last_free = i;
+      sent = 1;
     }
   }
-  if (nat_entry.cmn == NULL) {
-    if (allocate) {
-      if (last_free != -1) {
-        nat_entry.udp = &ip_nat_udp_table[last_free];
-        nat_entry.udp->nport = htons((u16_t) (LWIP_NAT_DEFAULT_UDP_SOURCE_PORT + i));
-        nat_entry.udp->sport = udphdr->src;
-        nat_entry.udp->dport = udphdr->dest;
-        ip_nat_cmn_init(nat_config, iphdr, nat_entry.cmn);
-
-        ip_nat_dbg_dump_udp_nat_entry("ip_nat_udp_lookup_outgoing: created new nat entry: ",
-                                      nat_entry.udp);
-      } else {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_udp_lookup_outgoing: no more NAT entries available\n"));
-        // rt_kprintf("ip_nat_udp_lookup_outgoing: no more NAT entries available\n");
-      }
-    }
-  }
-  return nat_entry.udp;
+
+  return sent;
 }
 
 /**
  * This function checks for incoming packets if we already have a NAT entry.
- * If yes a pointer to the NAT entry is returned. Otherwise NULL.
+ * The translated port is the port base plus the index of the connection,
+ * so the lookup is direct.
  *
- * @param nat_config NAT configuration.
+ * @param table the table of the protocol.
  * @param iphdr The IP header.
- * @param tcphdr The TCP header.
+ * @param sport the source port of the packet, 0 for ICMP.
+ * @param nport the destination port of the packet, the echo id for ICMP.
  * @return A pointer to an existing NAT entry or NULL if none is found.
  */
-static ip_nat_entries_tcp_t *
-ip_nat_tcp_lookup_incoming(const struct ip_hdr *iphdr, const struct tcp_hdr *tcphdr)
+static ip_nat_conn_t *
+ip_nat_lookup_incoming(ip_nat_table_t *table, const struct ip_hdr *iphdr, u16_t sport, u16_t nport)
 {
-  int i;
-  ip_nat_entries_tcp_t *nat_entry = NULL;
+  ip_nat_conn_t *conn;
+  u16_t index = (u16_t)(ntohs(nport) - table->port_base);
 
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    if (ip_nat_tcp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_tcp_table[i].common.dest.addr) &&
-          (tcphdr->src == ip_nat_tcp_table[i].dport) &&
-          (tcphdr->dest == ip_nat_tcp_table[i].nport)) {
-        nat_entry = &ip_nat_tcp_table[i];
+  table->lookups++;
+  if (index >= table->size) {
+    return NULL;
+  }
 
-        ip_nat_dbg_dump_tcp_nat_entry("ip_nat_tcp_lookup_incoming: found existing nat entry: ",
-                                      nat_entry);
-        break;
-      }
-    }
+  conn = &table->conns[index];
+  if (!conn->used ||
+      (iphdr->src.addr != conn->dest.addr) ||
+      (sport != conn->dport) ||
+      ((s32_t)(sys_now() - conn->expire) >= 0)) {
+    return NULL;
   }
-  return nat_entry;
+
+  table->hits++;
+  return conn;
 }
 
 /**
- * This function checks if we already have a NAT entry for this TCP connection.
- * If yes the a pointer to this NAT entry is returned.
+ * This function checks if we already have a NAT entry for this connection.
+ * If not, a free one is taken, or the least recently used one is recycled
+ * when the table is full.
  *
+ * @param table the table of the protocol.
+ * @param nat_config NAT configuration.
  * @param iphdr The IP header.
- * @param tcphdr The TCP header.
- * @param allocate If no existing NAT entry is found and this flag is true
- *   a NAT entry is allocated.
+ * @param sport the source port, the echo id for ICMP.
+ * @param dport the destination port, 0 for ICMP.
+ * @return A pointer to the NAT entry.
  */
-static ip_nat_entries_tcp_t *
-ip_nat_tcp_lookup_outgoing(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr,
-                           const struct tcp_hdr *tcphdr, u8_t allocate)
+static ip_nat_conn_t *
+ip_nat_lookup_outgoing(ip_nat_table_t *table, ip_nat_conf_t *nat_config,
+                       const struct ip_hdr *iphdr, u16_t sport, u16_t dport)
 {
-  int i;
-  nat_entry_t nat_entry;
-  int last_free = -1;
-
-  nat_entry.cmn = NULL;
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    if (ip_nat_tcp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_tcp_table[i].common.source.addr) &&
-          (iphdr->dest.addr == ip_nat_tcp_table[i].common.dest.addr) &&
-          (tcphdr->src == ip_nat_tcp_table[i].sport) &&
-          (tcphdr->dest == ip_nat_tcp_table[i].dport)) {
-        nat_entry.tcp = &ip_nat_tcp_table[i];
-
-        ip_nat_dbg_dump_tcp_nat_entry("ip_nat_tcp_lookup_outgoing: found existing nat entry: ",
-                                      nat_entry.tcp);
-        break;
-      }
-    } else {
-        last_free = i;
+  ip_nat_conn_t **bucket;
+  ip_nat_conn_t *conn;
+
+  table->lookups++;
+  bucket = &table->hash[ip_nat_hash(iphdr->src.addr, iphdr->dest.addr, sport, dport)];
+  for (conn = *bucket; conn != NULL; conn = conn->hash_next) {
+    if ((iphdr->src.addr == conn->source.addr) &&
+        (iphdr->dest.addr == conn->dest.addr) &&
+        (sport == conn->sport) &&
+        (dport == conn->dport)) {
+      table->hits++;
+      ip_nat_touch(table, conn);
+      return conn;
     }
   }
-  if (nat_entry.cmn == NULL) {
-    if (allocate) {
-      if (last_free != -1) {
-        nat_entry.tcp = &ip_nat_tcp_table[last_free];
-        nat_entry.tcp->nport = htons((u16_t) (LWIP_NAT_DEFAULT_TCP_SOURCE_PORT + i));
-        nat_entry.tcp->sport = tcphdr->src;
-        nat_entry.tcp->dport = tcphdr->dest;
-        ip_nat_cmn_init(nat_config, iphdr, nat_entry.cmn);
-
-        ip_nat_dbg_dump_tcp_nat_entry("ip_nat_tcp_lookup_outgoing: created new nat entry: ",
-                                      nat_entry.tcp);
-      } else {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_udp_lookup_outgoing: no more NAT entries available\n"));
-        // rt_kprintf("ip_nat_udp_lookup_outgoing: no more NAT entries available\n");
-      }
-    }
+
+  if (table->free != NULL) {
+    conn = table->free;
+    table->free = conn->lru_next;
+  } else if (table->lru_tail != NULL) {
+    conn = table->lru_tail;
+    ip_nat_dbg_dump_conn("ip_nat_lookup_outgoing: recycled nat entry: ", table, conn);
+    ip_nat_release(table, conn);
+    table->free = conn->lru_next;
+    table->evicted++;
+  } else {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_lookup_outgoing: no NAT entries available\n"));
+    return NULL;
   }
-  return nat_entry.tcp;
+
+  conn->used = 1;
+  conn->cfg = nat_config;
+  conn->source.addr = iphdr->src.addr;
+  conn->dest.addr = iphdr->dest.addr;
+  conn->sport = sport;
+  conn->dport = dport;
+  conn->nport = htons((u16_t)(table->port_base + (conn - table->conns)));
+
+  conn->hash_next = *bucket;
+  *bucket = conn;
+  conn->lru_prev = NULL;
+  conn->lru_next = table->lru_head;
+  if (table->lru_head != NULL) {
+    table->lru_head->lru_prev = conn;
+  } else {
+    table->lru_tail = conn;
+  }
+  table->lru_head = conn;
+  conn->expire = sys_now() + LWIP_NAT_DEFAULT_TTL_SECONDS * 1000;
+
+  table->created++;
+  if (++table->used > table->peak) {
+    table->peak = table->used;
+  }
+
+  ip_nat_dbg_dump_conn("ip_nat_lookup_outgoing: created new nat entry: ", table, conn);
+  return conn;
 }
 
 /** Adjusts the checksum of a NAT'ed packet without having to completely recalculate it
@@ -999,92 +991,32 @@ ip_nat_dbg_dump(const char *msg, const struct ip_hdr *iphdr)
 }
 
 /**
- * This function dumps an ICMP echo reply/recho request nat entry.
+ * This function dumps a NAT connection.
  *
  * @param msg a message to print
- * @param nat_entry the ICMP NAT entry to print
+ * @param table the table of the connection
+ * @param conn the connection to print
  */
 static void
-ip_nat_dbg_dump_icmp_nat_entry(const char *msg, const ip_nat_entries_icmp_t *nat_entry)
+ip_nat_dbg_dump_conn(const char *msg, const ip_nat_table_t *table, const ip_nat_conn_t *conn)
 {
   LWIP_ASSERT("NULL != msg", NULL != msg);
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg", NULL != nat_entry->common.cfg);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg->entry.out_if",
-    NULL != nat_entry->common.cfg->entry.out_if);
+  LWIP_ASSERT("NULL != conn", NULL != conn);
+  LWIP_ASSERT("NULL != conn->cfg", NULL != conn->cfg);
+  LWIP_ASSERT("NULL != conn->cfg->entry.out_if", NULL != conn->cfg->entry.out_if);
   LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s", msg));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ICMP : ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.source));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s : (", table->name));
+  ip_nat_dbg_dump_ip(&(conn->source));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->sport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" id=%" U16_F, ntohs(nat_entry->id)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (", seq=%" U16_F, ntohs(nat_entry->seqno)));
+  ip_nat_dbg_dump_ip(&(conn->dest));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->dport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (") mapped at ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.cfg->entry.out_if->ip_addr));
+  ip_nat_dbg_dump_ip(&(conn->cfg->entry.out_if->ip_addr));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->nport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" id=%" U16_F, ntohs(nat_entry->id)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (", seq=%" U16_F, ntohs(nat_entry->seqno)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
-}
-
-/**
- * This function dumps an TCP nat entry.
- *
- * @param msg a message to print
- * @param nat_entry the TCP NAT entry to print
- */
-static void
-ip_nat_dbg_dump_tcp_nat_entry(const char *msg, const ip_nat_entries_tcp_t *nat_entry)
-{
-  LWIP_ASSERT("NULL != msg", NULL != msg);
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg", NULL != nat_entry->common.cfg);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg->entry.out_if",
-    NULL != nat_entry->common.cfg->entry.out_if);
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s", msg));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("TCP : ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.source));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->sport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (") mapped at ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.cfg->entry.out_if->ip_addr));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->nport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
-}
-
-/**
- * This function dumps a UDP NAT entry.
- *
- * @param msg a message to print
- * @param nat_entry the UDP NAT entry to print
- */
-static void
-ip_nat_dbg_dump_udp_nat_entry(const char *msg, const ip_nat_entries_udp_t *nat_entry)
-{
-  LWIP_ASSERT("NULL != msg", NULL != msg);
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg", NULL != nat_entry->common.cfg);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg->entry.out_if",
-    NULL != nat_entry->common.cfg->entry.out_if);
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s", msg));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("UDP : ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.source));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->sport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (") mapped at ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.cfg->entry.out_if->ip_addr));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->nport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
+  ip_nat_dbg_dump_ip(&(conn->dest));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->dport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
 }
 
@@ -1129,4 +1061,249 @@ ip_nat_dbg_dump_remove(ip_nat_conf_t *cur)
 }
 #endif /* defined(LWIP_DEBUG) && (LWIP_NAT_DEBUG & LWIP_DBG_ON) */
 
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <stdlib.h>
+#include "lwip/tcpip.h"
+#include "lwip/inet_chksum.h"
+
+static void
+nat_stat(void)
+{
+  ip_nat_table_t *table;
+  u32_t i;
+
+  rt_kprintf("table entries used  peak  lookups    hits       created    evicted    expired\n");
+  for (i = 0; i < IP_NAT_TABLES_NUM; i++) {
+    table = ip_nat_tables[i];
+    rt_kprintf("%-5s %-7d %-5d %-5d %-10u %-10u %-10u %-10u %u\n", table->name, table->size,
+               table->used, table->peak, table->lookups, table->hits, table->created,
+               table->evicted, table->expired);
+  }
+}
+MSH_CMD_EXPORT(nat_stat, show the NAT connection table statistics);
+
+/* the benchmark translates between two networks of the RFC 2544 range */
+#define IP_NAT_BENCH_INSIDE       PP_HTONL(0xC6120000UL) /* 198.18.0.0/16 */
+#define IP_NAT_BENCH_OUTSIDE      PP_HTONL(0xC6130000UL) /* 198.19.0.0/16 */
+#define IP_NAT_BENCH_NETMASK      PP_HTONL(0xFFFF0000UL)
+#define IP_NAT_BENCH_SERVER       (IP_NAT_BENCH_OUTSIDE | PP_HTONL(1))
+#define IP_NAT_BENCH_PORT         (1024)
+#define IP_NAT_BENCH_SERVER_PORT  (80)
+
+struct ip_nat_bench
+{
+  u8_t proto;
+  int flows;
+  int packets;
+  u32_t gen_ticks;
+  u32_t out_ticks;
+  u32_t in_ticks;
+  int out_sent;
+  int in_sent;
+  int busy;                 /* NAT was configured, nothing was run */
+  struct rt_semaphore done;
+};
+
+static struct netif ip_nat_bench_in_if;
+static struct netif ip_nat_bench_out_if;
+
+/* the benchmark interfaces drop what they send */
+static err_t
+ip_nat_bench_output(struct netif *netif, struct pbuf *p, ip_addr_t *ipaddr)
+{
+  LWIP_UNUSED_ARG(netif);
+  LWIP_UNUSED_ARG(p);
+  LWIP_UNUSED_ARG(ipaddr);
+  return ERR_OK;
+}
+
+/** Build a synthetic packet of the flow, sport is the echo id for ICMP */
+static void
+ip_nat_bench_packet(struct pbuf *p, u8_t proto, u8_t reply, u32_t src, u32_t dest, u16_t sport, u16_t dport)
+{
+  struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
+  struct tcp_hdr *tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + IP_HLEN);
+  struct udp_hdr *udphdr = (struct udp_hdr *)tcphdr;
+  struct icmp_echo_hdr *icmphdr = (struct icmp_echo_hdr *)tcphdr;
+
+  memset(p->payload, 0, p->len);
+  IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+  IPH_LEN_SET(iphdr, htons(p->tot_len));
+  IPH_TTL_SET(iphdr, 64);
+  IPH_PROTO_SET(iphdr, proto);
+  iphdr->src.addr = src;
+  iphdr->dest.addr = dest;
+  IPH_CHKSUM_SET(iphdr, inet_chksum(iphdr, IP_HLEN));
+
+  switch (proto) {
+    case IP_PROTO_TCP:
+      tcphdr->src = sport;
+      tcphdr->dest = dport;
+      TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, TCP_ACK);
+      tcphdr->chksum = PP_HTONS(0x1234);
+      break;
+    case IP_PROTO_UDP:
+      udphdr->src = sport;
+      udphdr->dest = dport;
+      udphdr->len = htons(p->tot_len - IP_HLEN);
+      udphdr->chksum = PP_HTONS(0x1234);
+      break;
+    default:
+      ICMPH_TYPE_SET(icmphdr, reply ? ICMP_ER : ICMP_ECHO);
+      icmphdr->id = sport;
+      icmphdr->chksum = PP_HTONS(0x1234);
+      break;
+  }
+}
+
+/* runs in the tcpip thread, which owns the NAT tables */
+static void
+ip_nat_bench_run(void *arg)
+{
+  struct ip_nat_bench *bench = (struct ip_nat_bench *)arg;
+  struct tcp_hdr *tcphdr;
+  ip_nat_entry_t entry;
+  struct pbuf *p = NULL;
+  u16_t *nports = NULL;
+  u16_t dport = (bench->proto == IP_PROTO_ICMP) ? 0 : PP_HTONS(IP_NAT_BENCH_SERVER_PORT);
+  u32_t inside;
+  rt_tick_t start;
+  int i, flow;
+
+  ip_nat_bench_in_if.output = ip_nat_bench_output;
+  ip_nat_bench_in_if.ip_addr.addr = IP_NAT_BENCH_INSIDE | PP_HTONL(1);
+  ip_nat_bench_out_if.output = ip_nat_bench_output;
+  ip_nat_bench_out_if.ip_addr.addr = IP_NAT_BENCH_OUTSIDE | PP_HTONL(2);
+
+  entry.source_net.addr = IP_NAT_BENCH_INSIDE;
+  entry.source_netmask.addr = IP_NAT_BENCH_NETMASK;
+  entry.dest_net.addr = IP_NAT_BENCH_OUTSIDE;
+  entry.dest_netmask.addr = IP_NAT_BENCH_NETMASK;
+  entry.in_if = &ip_nat_bench_in_if;
+  entry.out_if = &ip_nat_bench_out_if;
+
+  /*
+   * The synthetic flows would take the entries of live connections through the
+   * LRU, the tables are only used while no other NAT entry is configured. The
+   * removal of the benchmark entry then leaves them empty again.
+   */
+  if (ip_nat_cfg != NULL) {
+    bench->busy = 1;
+    goto __exit;
+  }
+
+  p = pbuf_alloc(PBUF_IP, IP_HLEN + TCP_HLEN, PBUF_RAM);
+  nports = (u16_t *)mem_malloc(bench->flows * sizeof(u16_t));
+  if (p == NULL || nports == NULL || ip_nat_add(&entry) != ERR_OK) {
+    goto __exit;
+  }
+  tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + IP_HLEN);
+
+  /* open the flows and learn their translated ports */
+  for (flow = 0; flow < bench->flows; flow++) {
+    inside = IP_NAT_BENCH_INSIDE | htonl(2 + flow % 250);
+    ip_nat_bench_packet(p, bench->proto, 0, inside, IP_NAT_BENCH_SERVER, htons(IP_NAT_BENCH_PORT + flow), dport);
+    ip_nat_out(p);
+    /* the port and the echo id are the first field of the transport header */
+    nports[flow] = tcphdr->src;
+  }
+
+  /* the cost of building the packets */
+  start = rt_tick_get();
+  for (i = 0; i < bench->packets; i++) {
+    flow = i % bench->flows;
+    inside = IP_NAT_BENCH_INSIDE | htonl(2 + flow % 250);
+    ip_nat_bench_packet(p, bench->proto, 0, inside, IP_NAT_BENCH_SERVER, htons(IP_NAT_BENCH_PORT + flow), dport);
+  }
+  bench->gen_ticks = rt_tick_get() - start;
+
+  start = rt_tick_get();
+  for (i = 0; i < bench->packets; i++) {
+    flow = i % bench->flows;
+    inside = IP_NAT_BENCH_INSIDE | htonl(2 + flow % 250);
+    ip_nat_bench_packet(p, bench->proto, 0, inside, IP_NAT_BENCH_SERVER, htons(IP_NAT_BENCH_PORT + flow), dport);
+    bench->out_sent += ip_nat_out(p);
+  }
+  bench->out_ticks = rt_tick_get() - start;
+
+  start = rt_tick_get();
+  for (i = 0; i < bench->packets; i++) {
+    flow = i % bench->flows;
+    ip_nat_bench_packet(p, bench->proto, 1, IP_NAT_BENCH_SERVER, ip_nat_bench_out_if.ip_addr.addr, dport, nports[flow]);
+    /* the input path frees a consumed packet */
+    pbuf_ref(p);
+    if (ip_nat_input(p)) {
+      bench->in_sent++;
+    } else {
+      pbuf_free(p);
+    }
+  }
+  bench->in_ticks = rt_tick_get() - start;
+
+  ip_nat_remove(&entry);
+
+__exit:
+  if (p != NULL) {
+    pbuf_free(p);
+  }
+  if (nports != NULL) {
+    mem_free(nports);
+  }
+  rt_sem_release(&bench->done);
+}
+
+/* nanoseconds per packet of the ticks, without the cost of building the packets */
+static u32_t
+ip_nat_bench_ns(const struct ip_nat_bench *bench, u32_t ticks)
+{
+  ticks = (ticks > bench->gen_ticks) ? ticks - bench->gen_ticks : 0;
+  return (u32_t)((rt_uint64_t)ticks * (1000000000UL / RT_TICK_PER_SECOND) / bench->packets);
+}
+
+/* translate synthetic packets of 1, 2, 4 ... flows both ways, while no NAT entry is configured */
+static void
+nat_bench(int argc, char **argv)
+{
+  struct ip_nat_bench bench;
+  int max_flows, flows;
+
+  memset(&bench, 0, sizeof(bench));
+  max_flows = (argc > 1) ? atoi(argv[1]) : LWIP_NAT_DEFAULT_STATE_TABLES_TCP;
+  bench.packets = (argc > 2) ? atoi(argv[2]) : 100000;
+  bench.proto = IP_PROTO_TCP;
+  if (argc > 3) {
+    if (!strcmp(argv[3], "udp")) {
+      bench.proto = IP_PROTO_UDP;
+    } else if (!strcmp(argv[3], "icmp")) {
+      bench.proto = IP_PROTO_ICMP;
+    }
+  }
+  if (max_flows < 1 || max_flows > 4096 || bench.packets < 1) {
+    rt_kprintf("Usage: nat_bench [flows] [packets] [tcp|udp|icmp]\n");
+    return;
+  }
+
+  rt_sem_init(&bench.done, "nat_b", 0, RT_IPC_FLAG_PRIO);
+  rt_kprintf("flows  out ns/pkt  in ns/pkt  out sent  in sent\n");
+  for (flows = 1; flows <= max_flows; flows *= 2) {
+    bench.flows = flows;
+    bench.out_sent = bench.in_sent = 0;
+    if (tcpip_callback(ip_nat_bench_run, &bench) != ERR_OK) {
+      break;
+    }
+    rt_sem_take(&bench.done, RT_WAITING_FOREVER);
+    if (bench.busy) {
+      rt_kprintf("NAT is configured, remove the NAT entries before the benchmark\n");
+      break;
+    }
+    rt_kprintf("%-6d %-11u %-10u %-9d %d\n", flows, ip_nat_bench_ns(&bench, bench.out_ticks),
+               ip_nat_bench_ns(&bench, bench.in_ticks), bench.out_sent, bench.in_sent);
+  }
+  rt_sem_detach(&bench.done);
+  nat_stat();
+}
+MSH_CMD_EXPORT(nat_bench, NAT translation cost of synthetic packets: nat_bench [flows] [packets] [tcp|udp|icmp]);
+#endif /* RT_USING_FINSH */
+
 #endif /* IP_NAT */
@@ -15,6 +15,10 @@
  * 2018-11-02     MurphyZhao   port to lwIP 2.1.0
  * 2021-09-07     Grissiom     fix eth_tx_msg ack bug
  * 2022-02-22     xiangxistu   integrate v1.4.1 v2.0.3 and v2.1.2 porting layer
+ * 2026-10-19     RT-Thread    per-netif hardware checksum, queued Tx frames
+ * 2026-10-19     RT-Thread    UDP fast path and input statistics of Rx thread
+ * 2026-10-19     RT-Thread    show the memory high-water marks in netstat
+ * 2026-10-19     RT-Thread    hand the new devices to the bonding netif
  */
 
 /*
@@ -65,6 +69,9 @@
 #include <lwip/inet.h>
 #include <netif/etharp.h>
 #include <netif/ethernetif.h>
+#ifdef RT_LWIP_USING_BOND
+#include <netif/bond.h>
+#endif
 
 #include <ipc/completion.h>
 
@@ -101,6 +108,15 @@ static char eth_tx_thread_stack[512];
 static char eth_tx_thread_mb_pool[RT_LWIP_ETHTHREAD_MBOX_SIZE * sizeof(rt_ubase_t)];
 static char eth_tx_thread_stack[RT_LWIP_ETHTHREAD_STACKSIZE];
 #endif
+
+#if defined(RT_USING_MEMPOOL) && defined(RT_LWIP_ETHTHREAD_TX_QUEUE) && (RT_LWIP_ETHTHREAD_TX_QUEUE > 0) && defined(PBUF_NEEDS_COPY)
+#define ETH_TX_QUEUE_SIZE   RT_LWIP_ETHTHREAD_TX_QUEUE
+#define ETH_TX_MSG_SIZE     RT_ALIGN(sizeof(struct eth_tx_msg), RT_ALIGN_SIZE)
+
+/* queued frames, the Tx thread frees the pbuf and the message */
+static struct rt_mempool eth_tx_thread_mp;
+static char eth_tx_thread_mp_pool[ETH_TX_QUEUE_SIZE * (ETH_TX_MSG_SIZE + sizeof(rt_uint8_t *))];
+#endif
 #endif
 
 #ifndef LWIP_NO_RX_THREAD
@@ -113,6 +129,14 @@ static char eth_rx_thread_stack[1024];
 static char eth_rx_thread_mb_pool[RT_LWIP_ETHTHREAD_MBOX_SIZE * sizeof(rt_ubase_t)];
 static char eth_rx_thread_stack[RT_LWIP_ETHTHREAD_STACKSIZE];
 #endif
+
+#if defined(RT_LWIP_USING_UDP_FASTPATH) && LWIP_TCPIP_CORE_LOCKING && LWIP_IPV4 && LWIP_UDP
+#define ETH_UDP_FASTPATH
+#endif
+#endif
+
+#if defined(RT_USING_FINSH) && LWIP_STATS && LWIP_STATS_DISPLAY && MEM_STATS && MEMP_STATS && (LWIP_VERSION_MAJOR >= 2U)
+#define ETH_LIST_MEM
 #endif
 
 #ifdef RT_USING_NETDEV
@@ -285,6 +309,9 @@ void lwip_netdev_netstat(struct netdev *netif)
 {
     extern void list_tcps(void);
     extern void list_udps(void);
+#ifdef ETH_LIST_MEM
+    extern void list_lwip_mem(void);
+#endif
 
 #ifdef RT_LWIP_TCP
     list_tcps();
@@ -292,6 +319,9 @@ void lwip_netdev_netstat(struct netdev *netif)
 #ifdef RT_LWIP_UDP
     list_udps();
 #endif
+#ifdef ETH_LIST_MEM
+    list_lwip_mem();
+#endif
 }
 #endif /* RT_LWIP_TCP || RT_LWIP_UDP */
 #endif /* RT_USING_FINSH */
@@ -427,11 +457,56 @@ static void netdev_del(struct netif *lwip_netif)
     netdev_unregister(netdev);
     rt_free(netdev);
 }
+
+#ifdef RT_LWIP_USING_BOND
+int eth_bond_netdev_add(struct netif *netif)
+{
+    return netdev_add(netif);
+}
+#endif /* RT_LWIP_USING_BOND */
 #endif /* RT_USING_NETDEV */
 
 static err_t ethernetif_linkoutput(struct netif *netif, struct pbuf *p)
 {
-#ifndef LWIP_NO_TX_THREAD
+#if defined(ETH_TX_QUEUE_SIZE)
+    struct eth_tx_msg *msg;
+    struct pbuf *q;
+
+    RT_ASSERT(netif != RT_NULL);
+
+    /* the Tx thread sends it later, so keep the frame: TCP does not touch
+     * a referenced segment, a chain with a volatile (PBUF_REF/ROM) part is copied */
+    for (q = p; q != RT_NULL; q = q->next)
+    {
+        if (PBUF_NEEDS_COPY(q))
+        {
+            break;
+        }
+    }
+    if (q != RT_NULL)
+    {
+        p = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+        if (p == RT_NULL)
+        {
+            return ERR_MEM;
+        }
+    }
+    else
+    {
+        pbuf_ref(p);
+    }
+
+    /* a full queue holds off the tcpip thread until the driver catches up */
+    msg = (struct eth_tx_msg *)rt_mp_alloc(&eth_tx_thread_mp, RT_WAITING_FOREVER);
+    msg->netif = netif;
+    msg->buf   = p;
+    if (rt_mb_send(&eth_tx_thread_mb, (rt_ubase_t) msg) != RT_EOK)
+    {
+        rt_mp_free(msg);
+        pbuf_free(p);
+        return ERR_MEM;
+    }
+#elif !defined(LWIP_NO_TX_THREAD)
     struct eth_tx_msg msg;
 
     RT_ASSERT(netif != RT_NULL);
@@ -488,6 +563,11 @@ static err_t eth_netif_device_init(struct netif *netif)
         netif->flags = (ethif->flags & 0xff);
         netif->mtu = ETHERNET_MTU;
 
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+        /* skip only the checksums this device does in hardware */
+        NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_ENABLE_ALL & ~ethif->hw_checksum);
+#endif
+
         /* set output */
         netif->output       = etharp_output;
 
@@ -612,6 +692,9 @@ rt_err_t eth_device_init_with_flag(struct eth_device *dev, const char *name, rt_
         IP4_ADDR(&netmask, 0, 0, 0, 0);
 #endif
         netifapi_netif_add(netif, &ipaddr, &netmask, &gw, dev, eth_netif_device_init, tcpip_input);
+#ifdef RT_LWIP_USING_BOND
+        eth_bond_device_ready(dev);
+#endif
     }
 
     return RT_EOK;
@@ -720,13 +803,235 @@ static void eth_tx_thread_entry(void* parameter)
                 }
             }
 
+#ifdef ETH_TX_QUEUE_SIZE
+            pbuf_free(msg->buf);
+            rt_mp_free(msg);
+#else
             /* send ACK */
             rt_completion_done(&msg->ack);
+#endif
         }
     }
 }
 #endif
 
+#ifdef ETH_UDP_FASTPATH
+#include <lwip/ip.h>
+#include <lwip/prot/ip4.h>
+#include <lwip/prot/udp.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define ETH_RX_CLOCK()          ((rt_uint32_t)clock_cpu_gettime())
+#define ETH_RX_CLOCK_US(t)      clock_cpu_microsecond(t)
+#else
+#define ETH_RX_CLOCK()          ((rt_uint32_t)rt_tick_get())
+#define ETH_RX_CLOCK_US(t)      ((t) * (1000000 / RT_TICK_PER_SECOND))
+#endif
+
+enum
+{
+    ETH_RX_PATH_MBOX,
+    ETH_RX_PATH_FAST,
+    ETH_RX_PATH_NUM
+};
+
+struct eth_rx_path_stat
+{
+    rt_uint32_t frames;
+    rt_uint32_t drops;          /* tcpip mailbox full */
+    rt_uint32_t samples;
+    rt_uint32_t clock_sum;      /* from the Rx thread to the stack done */
+    rt_uint32_t clock_max;
+};
+
+static rt_uint16_t eth_udp_fastpath_port[RT_LWIP_UDP_FASTPATH_PORTS];
+static struct eth_rx_path_stat eth_rx_stat[ETH_RX_PATH_NUM];
+
+/* one frame of the mailbox path at a time is timed */
+static struct pbuf *volatile eth_rx_probe;
+static rt_uint32_t eth_rx_probe_clock;
+
+static void eth_rx_stat_sample(struct eth_rx_path_stat *stat, rt_uint32_t start)
+{
+    rt_uint32_t clock = ETH_RX_CLOCK() - start;
+
+    stat->samples++;
+    stat->clock_sum += clock;
+    if (clock > stat->clock_max)
+    {
+        stat->clock_max = clock;
+    }
+}
+
+rt_err_t eth_udp_fastpath_add(rt_uint16_t port)
+{
+    rt_base_t level;
+    int i, slot = -1;
+
+    if (port == 0)
+    {
+        return -RT_EINVAL;
+    }
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < RT_LWIP_UDP_FASTPATH_PORTS; i++)
+    {
+        if (eth_udp_fastpath_port[i] == port)
+        {
+            rt_hw_interrupt_enable(level);
+            return RT_EOK;
+        }
+        if (eth_udp_fastpath_port[i] == 0 && slot < 0)
+        {
+            slot = i;
+        }
+    }
+    if (slot >= 0)
+    {
+        eth_udp_fastpath_port[slot] = port;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return (slot >= 0) ? RT_EOK : -RT_EFULL;
+}
+
+rt_err_t eth_udp_fastpath_del(rt_uint16_t port)
+{
+    rt_base_t level;
+    int i;
+
+    if (port == 0)
+    {
+        return -RT_EINVAL;
+    }
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < RT_LWIP_UDP_FASTPATH_PORTS; i++)
+    {
+        if (eth_udp_fastpath_port[i] == port)
+        {
+            eth_udp_fastpath_port[i] = 0;
+            rt_hw_interrupt_enable(level);
+            return RT_EOK;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    return -RT_ERROR;
+}
+
+/* an unfragmented IPv4 UDP frame to a registered port, the headers in the first pbuf */
+static rt_bool_t eth_udp_fastpath_match(struct netif *netif, struct pbuf *p)
+{
+    const struct eth_hdr *ethhdr;
+    const struct ip_hdr *iphdr;
+    const struct udp_hdr *udphdr;
+    u16_t iphdr_len, port;
+    int i;
+
+    if (!(netif->flags & NETIF_FLAG_ETHARP) || p->len < SIZEOF_ETH_HDR + IP_HLEN + UDP_HLEN)
+    {
+        return RT_FALSE;
+    }
+
+    ethhdr = (const struct eth_hdr *)p->payload;
+    if (ethhdr->type != PP_HTONS(ETHTYPE_IP))
+    {
+        return RT_FALSE;
+    }
+
+    iphdr = (const struct ip_hdr *)((const u8_t *)p->payload + SIZEOF_ETH_HDR);
+    iphdr_len = IPH_HL(iphdr) * 4;
+    if (IPH_V(iphdr) != 4 || IPH_PROTO(iphdr) != IP_PROTO_UDP ||
+        (IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF)) != 0 ||
+        p->len < SIZEOF_ETH_HDR + iphdr_len + UDP_HLEN)
+    {
+        return RT_FALSE;
+    }
+
+    udphdr = (const struct udp_hdr *)((const u8_t *)iphdr + iphdr_len);
+    port = lwip_ntohs(udphdr->dest);
+    for (i = 0; i < RT_LWIP_UDP_FASTPATH_PORTS; i++)
+    {
+        if (eth_udp_fastpath_port[i] == port)
+        {
+            return RT_TRUE;
+        }
+    }
+
+    return RT_FALSE;
+}
+
+/* tcpip_input() of the mailbox path, it times the probed frame */
+static err_t eth_rx_mbox_input(struct pbuf *p, struct netif *netif)
+{
+    rt_bool_t probed = (p == eth_rx_probe);
+    err_t err;
+
+#if LWIP_ETHERNET
+    if (netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET))
+    {
+        err = ethernet_input(p, netif);
+    }
+    else
+#endif /* LWIP_ETHERNET */
+    {
+        err = ip_input(p, netif);
+    }
+
+    if (probed)
+    {
+        eth_rx_stat_sample(&eth_rx_stat[ETH_RX_PATH_MBOX], eth_rx_probe_clock);
+        eth_rx_probe = RT_NULL;
+    }
+
+    return err;
+}
+
+static err_t eth_rx_input(struct netif *netif, struct pbuf *p)
+{
+    rt_uint32_t start = ETH_RX_CLOCK();
+    err_t err;
+
+    /* the frames of a bonded slave go through its input */
+    if (netif->input == tcpip_input && eth_udp_fastpath_match(netif, p))
+    {
+        /* no mailbox hop, the frame is done when the core lock is released */
+        LOCK_TCPIP_CORE();
+        ethernet_input(p, netif);
+        UNLOCK_TCPIP_CORE();
+
+        eth_rx_stat[ETH_RX_PATH_FAST].frames++;
+        eth_rx_stat_sample(&eth_rx_stat[ETH_RX_PATH_FAST], start);
+        return ERR_OK;
+    }
+
+    eth_rx_stat[ETH_RX_PATH_MBOX].frames++;
+    if (netif->input != tcpip_input)
+    {
+        return netif->input(p, netif);
+    }
+
+    if (eth_rx_probe == RT_NULL)
+    {
+        eth_rx_probe_clock = start;
+        eth_rx_probe = p;
+    }
+    err = tcpip_inpkt(p, netif, eth_rx_mbox_input);
+    if (err != ERR_OK)
+    {
+        if (eth_rx_probe == p)
+        {
+            eth_rx_probe = RT_NULL;
+        }
+        eth_rx_stat[ETH_RX_PATH_MBOX].drops++;
+    }
+
+    return err;
+}
+#endif /* ETH_UDP_FASTPATH */
+
 #ifndef LWIP_NO_RX_THREAD
 /* Ethernet Rx Thread */
 static void eth_rx_thread_entry(void* parameter)
@@ -770,7 +1075,11 @@ static void eth_rx_thread_entry(void* parameter)
                 if (p != RT_NULL)
                 {
                     /* notify to upper layer */
+#ifdef ETH_UDP_FASTPATH
+                    if( eth_rx_input(device->netif, p) != ERR_OK )
+#else
                     if( device->netif->input(p, device->netif) != ERR_OK )
+#endif
                     {
                         LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: Input error\n"));
                         pbuf_free(p);
@@ -825,6 +1134,13 @@ int eth_system_device_init_private(void)
                         RT_IPC_FLAG_FIFO);
     RT_ASSERT(result == RT_EOK);
 
+#ifdef ETH_TX_QUEUE_SIZE
+    result = rt_mp_init(&eth_tx_thread_mp, "etxmp",
+                        &eth_tx_thread_mp_pool[0], sizeof(eth_tx_thread_mp_pool),
+                        ETH_TX_MSG_SIZE);
+    RT_ASSERT(result == RT_EOK);
+#endif
+
     result = rt_thread_init(&eth_tx_thread, "etx", eth_tx_thread_entry, RT_NULL,
                             &eth_tx_thread_stack[0], sizeof(eth_tx_thread_stack),
                             RT_ETHERNETIF_THREAD_PREORITY, 16);
@@ -1094,4 +1410,67 @@ void list_udps(void)
 FINSH_FUNCTION_EXPORT(list_udps, list all of udp connections);
 #endif /* LWIP_UDP */
 
+#ifdef ETH_LIST_MEM
+#include <lwip/memp.h>
+#include <lwip/stats.h>
+void list_lwip_mem(void)
+{
+    struct stats_mem stat;
+    int i;
+
+    rt_kprintf("lwIP memory (heap in bytes, pools in elements):\n");
+    rt_kprintf("%-16s %8s %8s %8s %8s\n", "name", "used", "max", "avail", "err");
+
+    rt_enter_critical();
+    stat = lwip_stats.mem;
+    rt_exit_critical();
+    rt_kprintf("%-16s %8u %8u %8s %8u\n", "HEAP",
+               (unsigned int)stat.used, (unsigned int)stat.max, "-", (unsigned int)stat.err);
+
+    for (i = 0; i < MEMP_MAX; i++)
+    {
+        rt_enter_critical();
+        stat = *lwip_stats.memp[i];
+        rt_exit_critical();
+
+        rt_kprintf("%-16s %8u %8u %8u %8u\n", stat.name,
+                   (unsigned int)stat.used, (unsigned int)stat.max,
+                   (unsigned int)stat.avail, (unsigned int)stat.err);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_lwip_mem, list lwIP heap and pool high-water marks);
+#endif /* ETH_LIST_MEM */
+
+#ifdef ETH_UDP_FASTPATH
+void list_eth_rx(void)
+{
+    static const char *path_name[ETH_RX_PATH_NUM] = {"mailbox", "fastpath"};
+    struct eth_rx_path_stat stat;
+    int i;
+
+    rt_kprintf("UDP fast path ports:");
+    for (i = 0; i < RT_LWIP_UDP_FASTPATH_PORTS; i++)
+    {
+        if (eth_udp_fastpath_port[i] != 0)
+        {
+            rt_kprintf(" %d", eth_udp_fastpath_port[i]);
+        }
+    }
+    rt_kprintf("\n%-8s %10s %10s %8s %12s %12s\n", "path", "frames", "drops", "samples", "avg(us)", "max(us)");
+
+    for (i = 0; i < ETH_RX_PATH_NUM; i++)
+    {
+        rt_enter_critical();
+        stat = eth_rx_stat[i];
+        rt_exit_critical();
+
+        rt_kprintf("%-8s %10u %10u %8u %12u %12u\n", path_name[i],
+                   stat.frames, stat.drops, stat.samples,
+                   stat.samples ? ETH_RX_CLOCK_US(stat.clock_sum / stat.samples) : 0,
+                   ETH_RX_CLOCK_US(stat.clock_max));
+    }
+}
+FINSH_FUNCTION_EXPORT(list_eth_rx, list input paths of the ethernet rx thread);
+#endif /* ETH_UDP_FASTPATH */
+
 #endif
@@ -284,12 +284,31 @@
 //#define MEMP_USE_CUSTOM_POOLS       1
 //#define MEM_SIZE                    (1024*64)
 
+/* mem_malloc() takes the RT-Thread heap (sys_arch.c), MEM_SIZE only widens
+   mem_size_t so the heap accounting does not wrap at 64KB */
+#if defined(RT_LWIP_MEM_32BIT_SIZE) || defined(RT_LWIP_USING_HIGH_THROUGHPUT)
+#define MEM_SIZE                    (1024*1024)
+#endif
+
+/* ---------- Large-window TCP profile ---------- */
+#ifdef RT_LWIP_USING_HIGH_THROUGHPUT
+#define LWIP_WND_SCALE              1
+#define TCP_RCV_SCALE               2
+/* segments in flight each way for one stream */
+#define LWIP_HT_WND_SEGS            64
+#define LWIP_HT_STREAMS             RT_LWIP_HIGH_THROUGHPUT_STREAMS
+#endif
+
 #define MEMP_MEM_MALLOC             0
 
 /* MEMP_NUM_PBUF: the number of memp struct pbufs. If the application
    sends a lot of data out of ROM (or other static memory), this
    should be set high. */
+#ifdef RT_LWIP_USING_HIGH_THROUGHPUT
+#define MEMP_NUM_PBUF               (TCP_SND_QUEUELEN * LWIP_HT_STREAMS)
+#else
 #define MEMP_NUM_PBUF               32 //16
+#endif
 
 /* the number of struct netconns */
 #ifdef RT_MEMP_NUM_NETCONN
@@ -312,7 +331,10 @@
 #endif
 
 /* the number of simultaneously queued TCP */
-#ifdef RT_LWIP_TCP_SEG_NUM
+#if defined(RT_LWIP_USING_HIGH_THROUGHPUT)
+/* the send queue and the out-of-sequence queue of each stream */
+#define MEMP_NUM_TCP_SEG            ((TCP_SND_QUEUELEN + LWIP_HT_WND_SEGS) * LWIP_HT_STREAMS)
+#elif defined(RT_LWIP_TCP_SEG_NUM)
 #define MEMP_NUM_TCP_SEG            RT_LWIP_TCP_SEG_NUM
 #else
 #define MEMP_NUM_TCP_SEG            TCP_SND_QUEUELEN
@@ -332,10 +354,16 @@
    src/api/tcpip.c. */
 // #define MEMP_NUM_TCPIP_MSG_API      16
 // #define MEMP_NUM_TCPIP_MSG_INPKT    16
+#ifdef RT_LWIP_USING_HIGH_THROUGHPUT
+/* a window of frames may wait in the tcpip mailbox */
+#define MEMP_NUM_TCPIP_MSG_INPKT    (LWIP_HT_WND_SEGS * LWIP_HT_STREAMS)
+#endif
 
 /* ---------- Pbuf options ---------- */
 /* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. */
-#ifdef RT_LWIP_PBUF_NUM
+#if defined(RT_LWIP_USING_HIGH_THROUGHPUT)
+#define PBUF_POOL_SIZE               (LWIP_HT_WND_SEGS * LWIP_HT_STREAMS + 32)
+#elif defined(RT_LWIP_PBUF_NUM)
 #define PBUF_POOL_SIZE               RT_LWIP_PBUF_NUM
 #endif
 
@@ -375,7 +403,9 @@
 #define TCP_MSS                     1460
 
 /* TCP sender buffer space (bytes). */
-#ifdef RT_LWIP_TCP_SND_BUF
+#if defined(RT_LWIP_USING_HIGH_THROUGHPUT)
+#define TCP_SND_BUF                 (TCP_MSS * LWIP_HT_WND_SEGS)
+#elif defined(RT_LWIP_TCP_SND_BUF)
 #define TCP_SND_BUF                 RT_LWIP_TCP_SND_BUF
 #else
 #define TCP_SND_BUF                 (TCP_MSS * 2)
@@ -392,7 +422,9 @@
 #define TCP_SNDQUEUELOWAT           TCP_SND_QUEUELEN/2
 
 /* TCP receive window. */
-#ifdef RT_LWIP_TCP_WND
+#if defined(RT_LWIP_USING_HIGH_THROUGHPUT)
+#define TCP_WND                     (TCP_MSS * LWIP_HT_WND_SEGS)
+#elif defined(RT_LWIP_TCP_WND)
 #define TCP_WND                     RT_LWIP_TCP_WND
 #else
 #define TCP_WND                     (TCP_MSS * 2)
@@ -415,7 +447,11 @@
 #define TCPIP_THREAD_STACKSIZE      4096
 #endif
 #define TCPIP_THREAD_NAME           "tcpip"
+#ifdef RT_LWIP_USING_HIGH_THROUGHPUT
+#define DEFAULT_TCP_RECVMBOX_SIZE   LWIP_HT_WND_SEGS
+#else
 #define DEFAULT_TCP_RECVMBOX_SIZE   10
+#endif
 
 /* ---------- ARP options ---------- */
 #define LWIP_ARP                    1
@@ -424,6 +460,7 @@
 
 /* ---------- Checksum options ---------- */
 #ifdef RT_LWIP_USING_HW_CHECKSUM
+#ifdef RT_USING_LWIP141
 #define CHECKSUM_GEN_IP                 0
 #define CHECKSUM_GEN_UDP                0
 #define CHECKSUM_GEN_TCP                0
@@ -432,7 +469,12 @@
 #define CHECKSUM_CHECK_UDP              0
 #define CHECKSUM_CHECK_TCP              0
 #define CHECKSUM_CHECK_ICMP             0
-#endif
+#else
+/* the checksums are skipped per netif, as told by eth_device.hw_checksum,
+   so a netif without offload still gets correct checksums */
+#define LWIP_CHECKSUM_CTRL_PER_NETIF    1
+#endif /* RT_USING_LWIP141 */
+#endif /* RT_LWIP_USING_HW_CHECKSUM */
 
 /* ---------- IP options ---------- */
 /* Define IP_FORWARD to 1 if you wish to have the ability to forward
@@ -452,6 +494,11 @@
 #define IP_FRAG                     0
 #endif
 
+#ifdef SAL_USING_ZEROCOPY
+/* sal_buf_ref() wraps the memory of the application in custom pbufs */
+#define LWIP_SUPPORT_CUSTOM_PBUF    1
+#endif
+
 /* ---------- ICMP options ---------- */
 #define ICMP_TTL                    255
 
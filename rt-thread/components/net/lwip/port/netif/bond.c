@@ -0,0 +1,903 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+/*
+ * Bonding network interface.
+ *
+ * The bond is an Ethernet netif of its own with the address configuration,
+ * the slaves keep their driver but lose their address and DHCP. All slaves
+ * use the MAC address of the bond. The slave input is redirected to the
+ * bond, the bond output goes to the slave picked by the mode:
+ *
+ * - active-backup: the active slave sends and receives, the frames of the
+ *   backup slaves are dropped. When the link of the active slave goes down
+ *   the next slave with link takes over and a gratuitous ARP moves the MAC
+ *   address on the switch. The failover time is the link poll period of the
+ *   driver.
+ * - balance-xor: the MAC addresses, the IPv4 addresses and the TCP/UDP ports
+ *   are hashed on the slaves with link, a flow stays on one slave. The
+ *   switch ports need a static link aggregation group.
+ */
+
+#include <string.h>
+
+#include <rtthread.h>
+#include <lwip/opt.h>
+#include <lwip/netif.h>
+#include <lwip/tcpip.h>
+#include <lwip/dhcp.h>
+#include <lwip/inet.h>
+#include <lwip/stats.h>
+#include <lwip/prot/ip4.h>
+#include <lwip/prot/udp.h>
+#include <lwip/priv/tcpip_priv.h>
+#include <netif/etharp.h>
+#include <netif/ethernetif.h>
+#include <netif/bond.h>
+
+#if LWIP_IPV6
+#include "lwip/ethip6.h"
+#endif /* LWIP_IPV6 */
+
+#ifdef RT_USING_NETDEV
+#include <netdev.h>
+#endif
+
+#define DBG_TAG "lwip.bond"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#if !LWIP_NETIF_LINK_CALLBACK
+#error "the bonding netif needs LWIP_NETIF_LINK_CALLBACK"
+#endif
+
+struct bond_api_msg
+{
+    struct tcpip_api_call_data call;
+    struct eth_bond *bond;
+    struct netif *slave;
+    struct eth_device *dev;
+    netif_input_fn input;
+    rt_bool_t system;       /* default netif with netdev and DHCP */
+};
+
+static struct eth_bond *bond_list = RT_NULL;
+
+static struct eth_bond_slave *bond_slave_of(struct netif *netif, struct eth_bond **bond)
+{
+    struct eth_bond *b;
+    int i;
+
+    for (b = bond_list; b != RT_NULL; b = b->next)
+    {
+        for (i = 0; i < b->slave_num; i++)
+        {
+            if (b->slave[i].netif == netif)
+            {
+                *bond = b;
+                return &b->slave[i];
+            }
+        }
+    }
+
+    return RT_NULL;
+}
+
+/* layer 2 hash, with layer 3+4 of unfragmented IPv4 on top */
+static u32_t bond_hash(struct pbuf *p)
+{
+    const struct eth_hdr *ethhdr = (const struct eth_hdr *)p->payload;
+    const struct ip_hdr *iphdr;
+    const u8_t *ports;
+    u16_t iphdr_len;
+    u32_t hash;
+
+    if (p->len < SIZEOF_ETH_HDR)
+    {
+        return 0;
+    }
+
+    hash = (u32_t)ethhdr->dest.addr[5] ^ ethhdr->src.addr[5] ^ ethhdr->type;
+    if (ethhdr->type != PP_HTONS(ETHTYPE_IP) || p->len < SIZEOF_ETH_HDR + IP_HLEN)
+    {
+        return hash;
+    }
+
+    iphdr = (const struct ip_hdr *)((const u8_t *)p->payload + SIZEOF_ETH_HDR);
+    hash ^= ip4_addr_get_u32(&iphdr->src) ^ ip4_addr_get_u32(&iphdr->dest);
+
+    iphdr_len = IPH_HL(iphdr) * 4;
+    if ((IPH_PROTO(iphdr) == IP_PROTO_TCP || IPH_PROTO(iphdr) == IP_PROTO_UDP) &&
+        (IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF)) == 0 &&
+        p->len >= SIZEOF_ETH_HDR + iphdr_len + 4)
+    {
+        /* source and destination port */
+        ports = (const u8_t *)iphdr + iphdr_len;
+        hash ^= ((u32_t)ports[0] << 24) | ((u32_t)ports[1] << 16) | ((u32_t)ports[2] << 8) | ports[3];
+    }
+
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return hash;
+}
+
+static struct eth_bond_slave *bond_tx_slave(struct eth_bond *bond, struct pbuf *p)
+{
+    int i, up = 0;
+
+    if (bond->mode == ETH_BOND_ACTIVE_BACKUP)
+    {
+        return (bond->active >= 0) ? &bond->slave[bond->active] : RT_NULL;
+    }
+
+    for (i = 0; i < bond->slave_num; i++)
+    {
+        if (netif_is_link_up(bond->slave[i].netif))
+        {
+            up++;
+        }
+    }
+    if (up == 0)
+    {
+        return RT_NULL;
+    }
+
+    up = bond_hash(p) % up;
+    for (i = 0; i < bond->slave_num; i++)
+    {
+        if (netif_is_link_up(bond->slave[i].netif) && up-- == 0)
+        {
+            break;
+        }
+    }
+
+    return &bond->slave[i];
+}
+
+static err_t bond_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    struct eth_bond *bond = (struct eth_bond *)netif->state;
+    struct eth_bond_slave *slave;
+
+    slave = bond_tx_slave(bond, p);
+    if (slave == RT_NULL)
+    {
+        LINK_STATS_INC(link.drop);
+        return ERR_IF;
+    }
+
+    slave->tx_frames++;
+    return slave->netif->linkoutput(slave->netif, p);
+}
+
+/* input of the slaves, runs in the Rx thread */
+static err_t bond_slave_input(struct pbuf *p, struct netif *inp)
+{
+    struct eth_bond *bond = RT_NULL;
+    struct eth_bond_slave *slave;
+    int active;
+
+    slave = bond_slave_of(inp, &bond);
+    if (slave == RT_NULL)
+    {
+        return tcpip_input(p, inp);
+    }
+
+    active = bond->active;
+    if (bond->mode == ETH_BOND_ACTIVE_BACKUP && (active < 0 || slave != &bond->slave[active]))
+    {
+        slave->rx_drops++;
+        pbuf_free(p);
+        return ERR_OK;
+    }
+
+    slave->rx_frames++;
+    return bond->netif.input(p, &bond->netif);
+}
+
+/* pick the active slave and follow the link of the slaves, in tcpip thread */
+static void bond_update(struct eth_bond *bond)
+{
+    int i, active, up = 0;
+
+    for (i = 0; i < bond->slave_num; i++)
+    {
+        if (netif_is_link_up(bond->slave[i].netif))
+        {
+            up++;
+        }
+    }
+
+    if (bond->mode == ETH_BOND_ACTIVE_BACKUP)
+    {
+        active = bond->active;
+        if (active < 0 || !netif_is_link_up(bond->slave[active].netif))
+        {
+            active = -1;
+            for (i = 0; i < bond->slave_num; i++)
+            {
+                if (netif_is_link_up(bond->slave[i].netif))
+                {
+                    active = i;
+                    break;
+                }
+            }
+        }
+
+        if (active != bond->active)
+        {
+            if (bond->active >= 0 && active >= 0)
+            {
+                bond->failovers++;
+                LOG_I("%c%c: failover from %c%c to %c%c", bond->netif.name[0], bond->netif.name[1],
+                      bond->slave[bond->active].netif->name[0], bond->slave[bond->active].netif->name[1],
+                      bond->slave[active].netif->name[0], bond->slave[active].netif->name[1]);
+            }
+            bond->active = active;
+            bond->failover_tick = rt_tick_get();
+
+            /* let the switch learn the MAC address on the new port */
+            if (active >= 0 && netif_is_up(&bond->netif) && !ip4_addr_isany_val(*netif_ip4_addr(&bond->netif)))
+            {
+                etharp_gratuitous(&bond->netif);
+            }
+        }
+    }
+
+    if (up > 0 && !netif_is_link_up(&bond->netif))
+    {
+        netif_set_link_up(&bond->netif);
+    }
+    else if (up == 0 && netif_is_link_up(&bond->netif))
+    {
+        netif_set_link_down(&bond->netif);
+    }
+}
+
+static void bond_slave_link_changed(struct netif *netif)
+{
+    struct eth_bond *bond = RT_NULL;
+
+    if (bond_slave_of(netif, &bond) != RT_NULL)
+    {
+        bond_update(bond);
+    }
+}
+
+#if LWIP_IPV4 && LWIP_IGMP
+static err_t bond_igmp_mac_filter(struct netif *netif, const ip4_addr_t *group, enum netif_mac_filter_action action)
+{
+    struct eth_bond *bond = (struct eth_bond *)netif->state;
+    int i;
+
+    for (i = 0; i < bond->slave_num; i++)
+    {
+        struct netif *slave = bond->slave[i].netif;
+
+        if (slave->igmp_mac_filter != RT_NULL)
+        {
+            slave->igmp_mac_filter(slave, group, action);
+        }
+    }
+
+    return ERR_OK;
+}
+#endif /* LWIP_IPV4 && LWIP_IGMP */
+
+static err_t bond_netif_init(struct netif *netif)
+{
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+    netif->mtu        = ETHERNET_MTU;
+    netif->flags      = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+    netif->output     = etharp_output;
+    netif->linkoutput = bond_linkoutput;
+#if LWIP_IPV6
+    netif->output_ip6 = ethip6_output;
+#endif /* LWIP_IPV6 */
+#if LWIP_IPV4 && LWIP_IGMP
+    netif->flags     |= NETIF_FLAG_IGMP;
+    netif_set_igmp_mac_filter(netif, bond_igmp_mac_filter);
+#endif /* LWIP_IPV4 && LWIP_IGMP */
+
+    return ERR_OK;
+}
+
+static err_t bond_create_fn(struct tcpip_api_call_data *call)
+{
+    struct bond_api_msg *msg = (struct bond_api_msg *)call;
+    struct eth_bond *bond = msg->bond;
+    ip4_addr_t ipaddr, netmask, gw;
+
+    IP4_ADDR(&ipaddr, 0, 0, 0, 0);
+    IP4_ADDR(&gw, 0, 0, 0, 0);
+    IP4_ADDR(&netmask, 0, 0, 0, 0);
+#if !LWIP_DHCP && defined(RT_LWIP_IPADDR)
+    if (msg->system)
+    {
+        ipaddr.addr = inet_addr(RT_LWIP_IPADDR);
+        gw.addr = inet_addr(RT_LWIP_GWADDR);
+        netmask.addr = inet_addr(RT_LWIP_MSKADDR);
+    }
+#endif
+
+    if (netif_add(&bond->netif, &ipaddr, &netmask, &gw, bond, bond_netif_init, msg->input) == RT_NULL)
+    {
+        return ERR_IF;
+    }
+
+    bond->next = bond_list;
+    bond_list = bond;
+
+    if (msg->system)
+    {
+#ifdef RT_USING_NETDEV
+        eth_bond_netdev_add(&bond->netif);
+        netdev_set_default(netdev_get_by_name(bond->netif.name));
+#endif /* RT_USING_NETDEV */
+        netif_set_default(&bond->netif);
+        netif_set_up(&bond->netif);
+#if LWIP_DHCP
+        dhcp_start(&bond->netif);
+#endif
+    }
+    else
+    {
+        netif_set_up(&bond->netif);
+    }
+
+    return ERR_OK;
+}
+
+static struct eth_bond *bond_create(const char *name, enum eth_bond_mode mode, netif_input_fn input, rt_bool_t system)
+{
+    struct bond_api_msg msg;
+    struct eth_bond *bond;
+
+    bond = (struct eth_bond *)rt_calloc(1, sizeof(struct eth_bond));
+    if (bond == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    bond->netif.name[0] = name[0];
+    bond->netif.name[1] = name[1];
+    bond->mode   = mode;
+    bond->active = -1;
+
+    msg.bond   = bond;
+    msg.input  = input;
+    msg.system = system;
+    if (tcpip_api_call(bond_create_fn, &msg.call) != ERR_OK)
+    {
+        rt_free(bond);
+        return RT_NULL;
+    }
+
+    return bond;
+}
+
+struct eth_bond *eth_bond_create(const char *name, enum eth_bond_mode mode)
+{
+    RT_ASSERT(name != RT_NULL);
+
+    if (rt_strlen(name) < 2 || eth_bond_find(name) != RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    return bond_create(name, mode, tcpip_input, RT_TRUE);
+}
+
+struct eth_bond *eth_bond_find(const char *name)
+{
+    struct eth_bond *bond;
+
+    for (bond = bond_list; bond != RT_NULL; bond = bond->next)
+    {
+        if (rt_strncmp(bond->netif.name, name, sizeof(bond->netif.name)) == 0)
+        {
+            break;
+        }
+    }
+
+    return bond;
+}
+
+static err_t bond_enslave_fn(struct tcpip_api_call_data *call)
+{
+    struct bond_api_msg *msg = (struct bond_api_msg *)call;
+    struct eth_bond *bond = msg->bond;
+    struct netif *slave = msg->slave;
+    struct eth_bond *other;
+
+    if (bond->slave_num >= ETH_BOND_SLAVE_MAX || slave->hwaddr_len != ETH_HWADDR_LEN ||
+        slave == &bond->netif || bond_slave_of(slave, &other) != RT_NULL)
+    {
+        return ERR_ARG;
+    }
+
+    if (bond->slave_num == 0)
+    {
+        /* the first slave gives its MAC address to the bond */
+        SMEMCPY(bond->netif.hwaddr, slave->hwaddr, ETH_HWADDR_LEN);
+#if LWIP_IPV6
+        netif_create_ip6_linklocal_address(&bond->netif, 1);
+#endif /* LWIP_IPV6 */
+    }
+    else if (memcmp(slave->hwaddr, bond->netif.hwaddr, ETH_HWADDR_LEN) != 0)
+    {
+        if (msg->dev != RT_NULL)
+        {
+            rt_device_control(&msg->dev->parent, NIOCTL_SADDR, bond->netif.hwaddr);
+        }
+        SMEMCPY(slave->hwaddr, bond->netif.hwaddr, ETH_HWADDR_LEN);
+    }
+
+    /* the address configuration is on the bond */
+#if LWIP_DHCP
+    dhcp_stop(slave);
+#endif
+    netif_set_addr(slave, IP4_ADDR_ANY4, IP4_ADDR_ANY4, IP4_ADDR_ANY4);
+    if (netif_default == slave)
+    {
+        netif_set_default(&bond->netif);
+    }
+
+    bond->slave[bond->slave_num].netif = slave;
+    bond->slave[bond->slave_num].tx_frames = 0;
+    bond->slave[bond->slave_num].rx_frames = 0;
+    bond->slave[bond->slave_num].rx_drops = 0;
+    bond->slave_num++;
+
+    slave->input = bond_slave_input;
+    netif_set_link_callback(slave, bond_slave_link_changed);
+    bond_update(bond);
+
+    return ERR_OK;
+}
+
+static rt_err_t bond_enslave(struct eth_bond *bond, struct netif *slave, struct eth_device *dev)
+{
+    struct bond_api_msg msg;
+
+    msg.bond  = bond;
+    msg.slave = slave;
+    msg.dev   = dev;
+
+    return (tcpip_api_call(bond_enslave_fn, &msg.call) == ERR_OK) ? RT_EOK : -RT_ERROR;
+}
+
+rt_err_t eth_bond_enslave(struct eth_bond *bond, const char *dev_name)
+{
+    struct eth_device *dev;
+
+    RT_ASSERT(bond != RT_NULL);
+
+    dev = (struct eth_device *)rt_device_find(dev_name);
+    if (dev == RT_NULL || dev->parent.type != RT_Device_Class_NetIf || dev->netif == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    if (bond_enslave(bond, dev->netif, dev) != RT_EOK)
+    {
+        LOG_E("%c%c: failed to enslave %s", bond->netif.name[0], bond->netif.name[1], dev_name);
+        return -RT_ERROR;
+    }
+
+    LOG_I("%c%c: enslaved %s", bond->netif.name[0], bond->netif.name[1], dev_name);
+    return RT_EOK;
+}
+
+void eth_bond_device_ready(struct eth_device *dev)
+{
+#ifdef RT_LWIP_BOND_SLAVES
+    const char *slaves = RT_LWIP_BOND_SLAVES;
+    const char *name = dev->parent.parent.name;
+    rt_size_t len = rt_strlen(name);
+    struct eth_bond *bond;
+
+    /* look for the device in the space separated list */
+    while (*slaves != '\0')
+    {
+        while (*slaves == ' ')
+        {
+            slaves++;
+        }
+        if (rt_strncmp(slaves, name, len) == 0 && (slaves[len] == ' ' || slaves[len] == '\0'))
+        {
+            break;
+        }
+        while (*slaves != ' ' && *slaves != '\0')
+        {
+            slaves++;
+        }
+    }
+    if (*slaves == '\0')
+    {
+        return;
+    }
+
+    bond = eth_bond_find(RT_LWIP_BOND_NAME);
+    if (bond == RT_NULL)
+    {
+#ifdef RT_LWIP_BOND_MODE_BALANCE_XOR
+        bond = eth_bond_create(RT_LWIP_BOND_NAME, ETH_BOND_BALANCE_XOR);
+#else
+        bond = eth_bond_create(RT_LWIP_BOND_NAME, ETH_BOND_ACTIVE_BACKUP);
+#endif
+        if (bond == RT_NULL)
+        {
+            LOG_E("failed to create %s", RT_LWIP_BOND_NAME);
+            return;
+        }
+    }
+
+    eth_bond_enslave(bond, name);
+#else
+    RT_UNUSED(dev);
+#endif /* RT_LWIP_BOND_SLAVES */
+}
+
+#ifdef RT_USING_FINSH
+#include <stdlib.h>
+
+static const char *bond_mode_name[] = {"active-backup", "balance-xor"};
+
+static void bond_list_show(void)
+{
+    struct eth_bond *bond;
+    int i;
+
+    for (bond = bond_list; bond != RT_NULL; bond = bond->next)
+    {
+        rt_kprintf("%c%c: %s, link %s, failovers %u",
+                   bond->netif.name[0], bond->netif.name[1], bond_mode_name[bond->mode],
+                   netif_is_link_up(&bond->netif) ? "up" : "down", bond->failovers);
+        if (bond->mode == ETH_BOND_ACTIVE_BACKUP && bond->active >= 0)
+        {
+            rt_kprintf(", active %c%c since tick %u", bond->slave[bond->active].netif->name[0],
+                       bond->slave[bond->active].netif->name[1], bond->failover_tick);
+        }
+        rt_kprintf("\n");
+
+        for (i = 0; i < bond->slave_num; i++)
+        {
+            struct eth_bond_slave *slave = &bond->slave[i];
+
+            rt_kprintf("  %c%c: link %-4s tx %10u rx %10u rx drops %10u\n",
+                       slave->netif->name[0], slave->netif->name[1],
+                       netif_is_link_up(slave->netif) ? "up" : "down",
+                       slave->tx_frames, slave->rx_frames, slave->rx_drops);
+        }
+    }
+}
+
+/*
+ * Self test on two stand-in slaves in place of the EMACs: the slaves count
+ * what the bond sends, the frames they receive are fed to their input.
+ */
+struct bond_test
+{
+    struct tcpip_api_call_data call;
+    struct netif slave[2];
+    struct eth_bond *bond;
+    rt_uint32_t sent[2];
+    rt_uint32_t received;
+    int last;
+    int failed;
+};
+
+static struct bond_test *bond_test_ctx;
+
+static err_t bond_test_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    int i = (netif == &bond_test_ctx->slave[0]) ? 0 : 1;
+
+    bond_test_ctx->sent[i]++;
+    bond_test_ctx->last = i;
+    return ERR_OK;
+}
+
+static err_t bond_test_input(struct pbuf *p, struct netif *inp)
+{
+    bond_test_ctx->received++;
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+static err_t bond_test_slave_init(struct netif *netif)
+{
+    int i = (netif == &bond_test_ctx->slave[0]) ? 0 : 1;
+
+    netif->name[0]    = 'v';
+    netif->name[1]    = '0' + i;
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+    netif->hwaddr[0]  = 0x02;
+    netif->hwaddr[5]  = 0x10 + i;
+    netif->mtu        = ETHERNET_MTU;
+    netif->flags      = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET | NETIF_FLAG_LINK_UP;
+    netif->linkoutput = bond_test_linkoutput;
+
+    return ERR_OK;
+}
+
+/* an UDP frame of the flow sport -> 502 */
+static struct pbuf *bond_test_frame(u16_t sport)
+{
+    struct pbuf *p;
+    struct eth_hdr *ethhdr;
+    struct ip_hdr *iphdr;
+    struct udp_hdr *udphdr;
+    ip4_addr_t src, dest;
+
+    p = pbuf_alloc(PBUF_RAW, SIZEOF_ETH_HDR + IP_HLEN + UDP_HLEN, PBUF_RAM);
+    if (p == RT_NULL)
+    {
+        return RT_NULL;
+    }
+    rt_memset(p->payload, 0, p->len);
+
+    ethhdr = (struct eth_hdr *)p->payload;
+    ethhdr->dest.addr[0] = 0x02;
+    ethhdr->dest.addr[5] = 0x20;
+    ethhdr->src.addr[0]  = 0x02;
+    ethhdr->src.addr[5]  = 0x10;
+    ethhdr->type = PP_HTONS(ETHTYPE_IP);
+
+    iphdr = (struct ip_hdr *)((u8_t *)p->payload + SIZEOF_ETH_HDR);
+    IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+    IPH_PROTO_SET(iphdr, IP_PROTO_UDP);
+    IP4_ADDR(&src, 192, 0, 2, 1);
+    IP4_ADDR(&dest, 192, 0, 2, 2);
+    ip4_addr_copy(iphdr->src, src);
+    ip4_addr_copy(iphdr->dest, dest);
+
+    udphdr = (struct udp_hdr *)((u8_t *)iphdr + IP_HLEN);
+    udphdr->src  = lwip_htons(sport);
+    udphdr->dest = PP_HTONS(502);
+
+    return p;
+}
+
+/* send the flow, returns the slave it went out on or -1 */
+static int bond_test_send(struct bond_test *test, u16_t sport)
+{
+    struct pbuf *p = bond_test_frame(sport);
+    err_t err;
+
+    if (p == RT_NULL)
+    {
+        return -1;
+    }
+
+    test->last = -1;
+    err = test->bond->netif.linkoutput(&test->bond->netif, p);
+    pbuf_free(p);
+
+    return (err == ERR_OK) ? test->last : -1;
+}
+
+static void bond_test_check(struct bond_test *test, int ok, const char *what)
+{
+    rt_kprintf("  %-48s %s\n", what, ok ? "pass" : "FAIL");
+    if (!ok)
+    {
+        test->failed++;
+    }
+}
+
+static err_t bond_test_fn(struct tcpip_api_call_data *call)
+{
+    struct bond_test *test = (struct bond_test *)call;
+    struct eth_bond *bond = test->bond;
+    struct pbuf *p;
+    int i, slave, stable = 1;
+    rt_uint32_t received;
+
+    /* balance-xor: every flow stays on a slave, the flows use both */
+    bond->mode = ETH_BOND_BALANCE_XOR;
+    rt_memset(test->sent, 0, sizeof(test->sent));
+    for (i = 0; i < 64; i++)
+    {
+        slave = bond_test_send(test, 1024 + i);
+        if (slave < 0 || bond_test_send(test, 1024 + i) != slave)
+        {
+            stable = 0;
+        }
+    }
+    rt_kprintf("balance-xor: 64 flows, %u frames on v0, %u frames on v1\n", test->sent[0], test->sent[1]);
+    bond_test_check(test, stable, "a flow stays on one slave");
+    bond_test_check(test, test->sent[0] > 0 && test->sent[1] > 0, "the flows use both slaves");
+
+    netif_set_link_down(&test->slave[1]);
+    rt_memset(test->sent, 0, sizeof(test->sent));
+    for (i = 0; i < 64; i++)
+    {
+        bond_test_send(test, 1024 + i);
+    }
+    bond_test_check(test, test->sent[0] == 64 && test->sent[1] == 0, "a slave without link gets no flow");
+    netif_set_link_up(&test->slave[1]);
+
+    /* active-backup: v0 carries the traffic until its link goes down */
+    rt_kprintf("active-backup:\n");
+    bond->mode = ETH_BOND_ACTIVE_BACKUP;
+    bond->active = -1;
+    bond_update(bond);
+    bond_test_check(test, bond->active == 0 && bond_test_send(test, 1) == 0, "the first slave with link is active");
+
+    received = test->received;
+    p = bond_test_frame(1);
+    if (p != RT_NULL && test->slave[1].input(p, &test->slave[1]) != ERR_OK)
+    {
+        pbuf_free(p);
+    }
+    p = bond_test_frame(1);
+    if (p != RT_NULL && test->slave[0].input(p, &test->slave[0]) != ERR_OK)
+    {
+        pbuf_free(p);
+    }
+    bond_test_check(test, test->received == received + 1 && bond->slave[1].rx_drops == 1,
+                    "only the active slave receives");
+
+    netif_set_link_down(&test->slave[0]);
+    bond_test_check(test, bond->active == 1 && bond->failovers == 1 && bond_test_send(test, 1) == 1,
+                    "the backup takes over when the link goes down");
+
+    netif_set_link_up(&test->slave[0]);
+    bond_test_check(test, bond->active == 1, "the active slave stays when the link comes back");
+
+    netif_set_link_down(&test->slave[0]);
+    netif_set_link_down(&test->slave[1]);
+    bond_test_check(test, !netif_is_link_up(&bond->netif) && bond_test_send(test, 1) < 0,
+                    "the bond link follows the slaves");
+
+    return ERR_OK;
+}
+
+static err_t bond_test_setup_fn(struct tcpip_api_call_data *call)
+{
+    struct bond_test *test = (struct bond_test *)call;
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (netif_add(&test->slave[i], IP4_ADDR_ANY4, IP4_ADDR_ANY4, IP4_ADDR_ANY4,
+                      RT_NULL, bond_test_slave_init, bond_test_input) == RT_NULL)
+        {
+            return ERR_IF;
+        }
+        netif_set_up(&test->slave[i]);
+    }
+
+    return ERR_OK;
+}
+
+static err_t bond_test_cleanup_fn(struct tcpip_api_call_data *call)
+{
+    struct bond_test *test = (struct bond_test *)call;
+    struct eth_bond **prev;
+
+    if (test->bond != RT_NULL)
+    {
+        for (prev = &bond_list; *prev != RT_NULL; prev = &(*prev)->next)
+        {
+            if (*prev == test->bond)
+            {
+                *prev = test->bond->next;
+                break;
+            }
+        }
+        netif_remove(&test->bond->netif);
+    }
+    netif_remove(&test->slave[0]);
+    netif_remove(&test->slave[1]);
+
+    return ERR_OK;
+}
+
+static void bond_test(void)
+{
+    struct bond_test *test;
+
+    test = (struct bond_test *)rt_calloc(1, sizeof(struct bond_test));
+    if (test == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return;
+    }
+    bond_test_ctx = test;
+
+    if (tcpip_api_call(bond_test_setup_fn, &test->call) == ERR_OK)
+    {
+        test->bond = bond_create("bt", ETH_BOND_BALANCE_XOR, bond_test_input, RT_FALSE);
+        if (test->bond != RT_NULL &&
+            bond_enslave(test->bond, &test->slave[0], RT_NULL) == RT_EOK &&
+            bond_enslave(test->bond, &test->slave[1], RT_NULL) == RT_EOK)
+        {
+            tcpip_api_call(bond_test_fn, &test->call);
+            rt_kprintf("%s\n", test->failed ? "bond test failed" : "bond test passed");
+        }
+        else
+        {
+            rt_kprintf("failed to set up the test bond\n");
+        }
+    }
+    else
+    {
+        rt_kprintf("failed to add the stand-in slaves\n");
+    }
+
+    tcpip_api_call(bond_test_cleanup_fn, &test->call);
+    bond_test_ctx = RT_NULL;
+    rt_free(test->bond);
+    rt_free(test);
+}
+
+static int bond(int argc, char **argv)
+{
+    struct eth_bond *bond;
+    enum eth_bond_mode mode;
+    int i;
+
+    if (argc == 1)
+    {
+        bond_list_show();
+        return 0;
+    }
+
+    if (argc == 2 && rt_strcmp(argv[1], "test") == 0)
+    {
+        bond_test();
+        return 0;
+    }
+
+    if (argc >= 4)
+    {
+        if (rt_strcmp(argv[2], "active-backup") == 0)
+        {
+            mode = ETH_BOND_ACTIVE_BACKUP;
+        }
+        else if (rt_strcmp(argv[2], "balance-xor") == 0)
+        {
+            mode = ETH_BOND_BALANCE_XOR;
+        }
+        else
+        {
+            goto __usage;
+        }
+
+        bond = eth_bond_find(argv[1]);
+        if (bond == RT_NULL)
+        {
+            bond = eth_bond_create(argv[1], mode);
+            if (bond == RT_NULL)
+            {
+                rt_kprintf("failed to create %s\n", argv[1]);
+                return -RT_ERROR;
+            }
+        }
+
+        for (i = 3; i < argc; i++)
+        {
+            eth_bond_enslave(bond, argv[i]);
+        }
+        return 0;
+    }
+
+__usage:
+    rt_kprintf("Usage:\n");
+    rt_kprintf("bond                                                 - list the bonds\n");
+    rt_kprintf("bond <name> <active-backup|balance-xor> <device> ... - create a bond and enslave the devices\n");
+    rt_kprintf("bond test                                            - run the self test on two stand-in slaves\n");
+    return -RT_EINVAL;
+}
+MSH_CMD_EXPORT(bond, bonding network interface);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef __NETIF_BOND_H__
+#define __NETIF_BOND_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lwip/netif.h"
+#include <rtthread.h>
+#include <netif/ethernetif.h>
+
+#ifndef ETH_BOND_SLAVE_MAX
+#define ETH_BOND_SLAVE_MAX  4
+#endif
+
+enum eth_bond_mode
+{
+    ETH_BOND_ACTIVE_BACKUP = 0,     /* one slave carries the traffic, the next one with link takes over */
+    ETH_BOND_BALANCE_XOR,           /* the flows are hashed on the slaves with link */
+};
+
+struct eth_bond_slave
+{
+    struct netif *netif;
+    rt_uint32_t tx_frames;
+    rt_uint32_t rx_frames;
+    rt_uint32_t rx_drops;           /* received on a backup slave */
+};
+
+struct eth_bond
+{
+    /* network interface of the bond, its state is the bond */
+    struct netif netif;
+    struct eth_bond *next;
+
+    enum eth_bond_mode mode;
+    int slave_num;
+    int active;                     /* active slave of active-backup, -1 without link */
+    rt_uint32_t failovers;
+    rt_tick_t failover_tick;        /* when the active slave changed last */
+
+    struct eth_bond_slave slave[ETH_BOND_SLAVE_MAX];
+};
+
+struct eth_bond *eth_bond_create(const char *name, enum eth_bond_mode mode);
+struct eth_bond *eth_bond_find(const char *name);
+rt_err_t eth_bond_enslave(struct eth_bond *bond, const char *dev_name);
+
+/* called by ethernetif for every new device, enslaves the ones of RT_LWIP_BOND_SLAVES */
+void eth_bond_device_ready(struct eth_device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NETIF_BOND_H__ */
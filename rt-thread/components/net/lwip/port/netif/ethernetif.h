@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2022-02-22     xiangxistu integrate v1.4.1 v2.0.3 and v2.1.2 porting layer
+ * 2026-10-19     RT-Thread    add per-device hardware checksum capability
+ * 2026-10-19     RT-Thread    add UDP fast path of the Rx thread
+ * 2026-10-19     RT-Thread    add the netdev registration of the bond
  */
 
 #ifndef __NETIF_ETHERNETIF_H__
@@ -19,6 +22,7 @@ extern "C" {
 #include <rtthread.h>
 
 #define NIOCTL_GADDR        0x01
+#define NIOCTL_SADDR        0x02
 #ifndef RT_LWIP_ETH_MTU
 #define ETHERNET_MTU        1500
 #else
@@ -42,6 +46,11 @@ struct eth_device
     rt_uint8_t  link_status;
     rt_uint8_t  rx_notice;
 
+    /* NETIF_CHECKSUM_* done by the hardware, set by the driver before
+     * eth_device_init(). It needs RT_LWIP_USING_HW_CHECKSUM and lwIP 2.x,
+     * only set the CHECK bits when the hardware drops every bad frame. */
+    rt_uint16_t hw_checksum;
+
     /* eth device interface */
     struct pbuf* (*eth_rx)(rt_device_t dev);
     rt_err_t (*eth_tx)(rt_device_t dev, struct pbuf* p);
@@ -54,6 +63,17 @@ rt_err_t eth_device_init(struct eth_device * dev, const char *name);
 rt_err_t eth_device_init_with_flag(struct eth_device *dev, const char *name, rt_uint16_t flag);
 rt_err_t eth_device_linkchange(struct eth_device* dev, rt_bool_t up);
 
+#if defined(RT_USING_NETDEV) && defined(RT_LWIP_USING_BOND)
+/* register the netdev of a bond, its netif is not added by eth_device_init() */
+int eth_bond_netdev_add(struct netif *netif);
+#endif
+
+#ifdef RT_LWIP_USING_UDP_FASTPATH
+/* process the UDP frames to this local port in the Rx thread */
+rt_err_t eth_udp_fastpath_add(rt_uint16_t port);
+rt_err_t eth_udp_fastpath_del(rt_uint16_t port);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@
  * 2021-06-25     liuxianliang port to v2.0.3
  * 2022-01-18     Meco Man     remove v2.0.2
  * 2022-02-20     Meco Man     integrate v1.4.1 v2.0.3 and v2.1.2 porting layer
+ * 2026-10-19     RT-Thread    account the heap in lwip_stats.mem
  */
 
 #include <rtthread.h>
@@ -531,10 +532,26 @@ RT_WEAK void mem_init(void)
 {
 }
 
+#if MEM_STATS
+/* the RT-Thread heap does not tell the size of a block, keep it in front */
+#define MEM_STATS_HDR_SIZE  LWIP_MEM_ALIGN_SIZE(sizeof(mem_size_t))
+
+void *mem_calloc(mem_size_t count, mem_size_t size)
+{
+    void *mem = mem_malloc(count * size);
+
+    if (mem != RT_NULL)
+    {
+        rt_memset(mem, 0, count * size);
+    }
+    return mem;
+}
+#else
 void *mem_calloc(mem_size_t count, mem_size_t size)
 {
     return rt_calloc(count, size);
 }
+#endif /* MEM_STATS */
 
 void *mem_trim(void *mem, mem_size_t size)
 {
@@ -545,11 +562,45 @@ void *mem_trim(void *mem, mem_size_t size)
 
 void *mem_malloc(mem_size_t size)
 {
+#if MEM_STATS
+    rt_uint8_t *mem;
+    SYS_ARCH_DECL_PROTECT(level);
+
+    mem = (rt_uint8_t *)rt_malloc(MEM_STATS_HDR_SIZE + size);
+    SYS_ARCH_PROTECT(level);
+    if (mem == RT_NULL)
+    {
+        MEM_STATS_INC(err);
+    }
+    else
+    {
+        *(mem_size_t *)mem = size;
+        mem += MEM_STATS_HDR_SIZE;
+        MEM_STATS_INC_USED(used, size);
+    }
+    SYS_ARCH_UNPROTECT(level);
+
+    return mem;
+#else
     return rt_malloc(size);
+#endif /* MEM_STATS */
 }
 
 void  mem_free(void *mem)
 {
+#if MEM_STATS
+    SYS_ARCH_DECL_PROTECT(level);
+
+    if (mem == RT_NULL)
+    {
+        return;
+    }
+
+    mem = (rt_uint8_t *)mem - MEM_STATS_HDR_SIZE;
+    SYS_ARCH_PROTECT(level);
+    MEM_STATS_DEC_USED(used, *(mem_size_t *)mem);
+    SYS_ARCH_UNPROTECT(level);
+#endif /* MEM_STATS */
     rt_free(mem);
 }
 
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-05-17     ChenYong     First version
+ * 2026-10-19     RT-Thread    Add zero-copy pbuf send and receive
  */
 
 #include <rtthread.h>
@@ -23,6 +24,11 @@
 #include <sal_low_lvl.h>
 #include <af_inet.h>
 
+#ifdef SAL_USING_ZEROCOPY
+#include <lwip/tcpip.h>
+#include <lwip/priv/tcp_priv.h>
+#endif
+
 #include <netdev.h>
 
 #if (LWIP_VERSION < 0x2000000) && NETDEV_IPV6
@@ -81,6 +87,77 @@ struct lwip_sock {
 
 extern struct lwip_sock *lwip_tryget_socket(int s);
 
+#ifdef SAL_USING_ZEROCOPY
+#if !LWIP_TCPIP_CORE_LOCKING
+#error "The zero-copy socket extension needs LWIP_TCPIP_CORE_LOCKING."
+#endif
+
+#ifndef SAL_ZEROCOPY_LINGER_MS
+#define SAL_ZEROCOPY_LINGER_MS  2000
+#endif
+
+/* the pbufs of a chain which are passed by one netconn write */
+#define INET_ZC_VECTORS         8
+
+/* a zero-copy TCP buffer is referenced by the stack until its last byte is acknowledged */
+struct inet_zc_buf
+{
+    struct inet_zc_buf *next;
+    struct pbuf *p;
+    u32_t seq_end;
+};
+
+/* the zero-copy buffers in flight of a socket, protected by the tcpip core lock */
+struct inet_zc_sock
+{
+    struct netconn *conn;
+    struct inet_zc_buf *head;
+    struct inet_zc_buf *tail;
+};
+
+static struct inet_zc_sock inet_zc_socks[MEMP_NUM_NETCONN];
+
+static struct inet_zc_sock *inet_zc_get(int s)
+{
+    s -= LWIP_SOCKET_OFFSET;
+    if (s < 0 || s >= MEMP_NUM_NETCONN)
+    {
+        return RT_NULL;
+    }
+
+    return &inet_zc_socks[s];
+}
+
+/* release the acknowledged buffers of the connection, all of them when its pcb is gone */
+static void inet_zc_release(struct inet_zc_sock *zc, struct netconn *conn)
+{
+    struct inet_zc_buf *buf;
+    struct tcp_pcb *pcb;
+
+    if (zc == RT_NULL || zc->conn != conn)
+    {
+        return;
+    }
+
+    pcb = conn->pcb.tcp;
+    while ((buf = zc->head) != RT_NULL)
+    {
+        /* the buffers are queued in sequence order */
+        if (pcb != RT_NULL && TCP_SEQ_LT(pcb->lastack, buf->seq_end))
+        {
+            break;
+        }
+        zc->head = buf->next;
+        pbuf_free(buf->p);
+        rt_free(buf);
+    }
+    if (zc->head == RT_NULL)
+    {
+        zc->tail = RT_NULL;
+    }
+}
+#endif /* SAL_USING_ZEROCOPY */
+
 static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len)
 {
     int s;
@@ -126,6 +203,14 @@ static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len
         return;
     }
 
+#ifdef SAL_USING_ZEROCOPY
+    if (evt == NETCONN_EVT_SENDPLUS)
+    {
+        /* acknowledged data, the tcpip core is locked by every sender of this event */
+        inet_zc_release(inet_zc_get(s), conn);
+    }
+#endif
+
     SYS_ARCH_PROTECT(lev);
     /* Set event as required */
     switch (evt)
@@ -283,10 +368,386 @@ static int inet_poll(struct dfs_fd *file, struct rt_pollreq *req)
 }
 #endif
 
+#ifdef SAL_USING_ZEROCOPY
+struct inet_zc_ref
+{
+    struct pbuf_custom pc;             /* must be the first member */
+    void *data;
+    void (*release)(void *data, void *arg);
+    void *arg;
+};
+
+static void inet_zc_ref_free(struct pbuf *p)
+{
+    struct inet_zc_ref *ref = (struct inet_zc_ref *) p;
+
+    if (ref->release)
+    {
+        ref->release(ref->data, ref->arg);
+    }
+    rt_free(ref);
+}
+
+struct pbuf *sal_buf_alloc(size_t size)
+{
+    if (size > 0xFFFF)
+    {
+        return RT_NULL;
+    }
+
+    /* room is kept for the headers, so the stack sends it in place */
+    return pbuf_alloc(PBUF_TRANSPORT, (u16_t) size, PBUF_RAM);
+}
+
+struct pbuf *sal_buf_ref(void *data, size_t size, void (*release)(void *data, void *arg), void *arg)
+{
+    struct inet_zc_ref *ref;
+    struct pbuf *p;
+
+    if (data == RT_NULL || size > 0xFFFF)
+    {
+        return RT_NULL;
+    }
+
+    ref = (struct inet_zc_ref *) rt_malloc(sizeof(struct inet_zc_ref));
+    if (ref == RT_NULL)
+    {
+        return RT_NULL;
+    }
+    ref->pc.custom_free_function = inet_zc_ref_free;
+    ref->data = data;
+    ref->release = release;
+    ref->arg = arg;
+
+    p = pbuf_alloced_custom(PBUF_RAW, (u16_t) size, PBUF_REF, &ref->pc, data, (u16_t) size);
+    if (p == RT_NULL)
+    {
+        rt_free(ref);
+    }
+
+    return p;
+}
+
+void sal_buf_free(struct pbuf *p)
+{
+    if (p)
+    {
+        pbuf_free(p);
+    }
+}
+
+static void inet_zc_sockaddr(const ip_addr_t *addr, u16_t port, struct sockaddr *from, socklen_t *fromlen)
+{
+    struct sockaddr_in sin;
+
+    if (from == RT_NULL || fromlen == RT_NULL)
+    {
+        return;
+    }
+
+    rt_memset(&sin, 0x00, sizeof(sin));
+    sin.sin_len = sizeof(sin);
+    sin.sin_family = AF_INET;
+    sin.sin_port = lwip_htons(port);
+    if (IP_IS_V4(addr))
+    {
+        sin.sin_addr.s_addr = ip4_addr_get_u32(ip_2_ip4(addr));
+    }
+
+    rt_memcpy(from, &sin, (*fromlen < sizeof(sin)) ? *fromlen : sizeof(sin));
+    *fromlen = sizeof(sin);
+}
+
+static int inet_sendbuf_dgram(struct netconn *conn, struct pbuf *p, const struct sockaddr *to, socklen_t tolen)
+{
+    const struct sockaddr_in *sin = (const struct sockaddr_in *) to;
+    struct netbuf buf;
+    int size = p->tot_len;
+    err_t err;
+
+    rt_memset(&buf, 0x00, sizeof(buf));
+    buf.p = buf.ptr = p;
+    if (to != RT_NULL)
+    {
+        if (tolen < sizeof(struct sockaddr_in) || to->sa_family != AF_INET)
+        {
+            pbuf_free(p);
+            set_errno(EAFNOSUPPORT);
+            return -1;
+        }
+        ip_addr_set_ip4_u32_val(buf.addr, sin->sin_addr.s_addr);
+        err = netconn_sendto(conn, &buf, &buf.addr, lwip_ntohs(sin->sin_port));
+    }
+    else
+    {
+        err = netconn_send(conn, &buf);
+    }
+
+    /* the stack has queued or copied what it still needs */
+    pbuf_free(p);
+    if (err != ERR_OK)
+    {
+        set_errno(err_to_errno(err));
+        return -1;
+    }
+
+    return size;
+}
+
+/*
+ * The TCP write API queues references to the payload (NETCONN_NOCOPY), the
+ * pbuf is kept until the peer acknowledges its last byte and released from
+ * the event callback of the acknowledge.
+ */
+static int inet_sendbuf_tcp(int s, struct netconn *conn, struct pbuf *p, int flags)
+{
+    struct netvector vectors[INET_ZC_VECTORS];
+    struct inet_zc_sock *zc = inet_zc_get(s);
+    struct inet_zc_buf *buf;
+    struct pbuf *q;
+    size_t written, sent = 0, len;
+    u16_t count;
+    u8_t apiflags = NETCONN_NOCOPY;
+    err_t err = ERR_OK;
+
+    if (flags & MSG_MORE)
+    {
+        apiflags |= NETCONN_MORE;
+    }
+    if (flags & MSG_DONTWAIT)
+    {
+        apiflags |= NETCONN_DONTBLOCK;
+    }
+
+    /* the record is there before the stack references the payload */
+    buf = (struct inet_zc_buf *) rt_malloc(sizeof(struct inet_zc_buf));
+    if (buf == RT_NULL || zc == RT_NULL)
+    {
+        rt_free(buf);
+        pbuf_free(p);
+        set_errno(ENOMEM);
+        return -1;
+    }
+
+    for (q = p; q != RT_NULL && err == ERR_OK;)
+    {
+        for (count = 0, len = 0; q != RT_NULL && count < INET_ZC_VECTORS; q = q->next)
+        {
+            if (q->len)
+            {
+                vectors[count].ptr = q->payload;
+                vectors[count].len = q->len;
+                len += q->len;
+                count++;
+            }
+        }
+        if (count == 0)
+        {
+            break;
+        }
+
+        written = 0;
+        err = netconn_write_vectors_partly(conn, vectors, count, apiflags, &written);
+        sent += written;
+        if (written < len)
+        {
+            break;
+        }
+    }
+
+    LOCK_TCPIP_CORE();
+    if (zc->conn != conn)
+    {
+        /* the buffers of the previous connection in the slot are released by its close */
+        zc->conn = conn;
+        zc->head = zc->tail = RT_NULL;
+    }
+    if (sent > 0 && conn->pcb.tcp != RT_NULL)
+    {
+        buf->next = RT_NULL;
+        buf->p = p;
+        buf->seq_end = conn->pcb.tcp->snd_lbb;
+        if (zc->tail)
+        {
+            zc->tail->next = buf;
+        }
+        else
+        {
+            zc->head = buf;
+        }
+        zc->tail = buf;
+        p = RT_NULL;
+        buf = RT_NULL;
+    }
+    inet_zc_release(zc, conn);
+    UNLOCK_TCPIP_CORE();
+
+    /* nothing is queued, or the connection is gone with its segments */
+    if (p)
+    {
+        pbuf_free(p);
+    }
+    rt_free(buf);
+
+    if (sent == 0 && err != ERR_OK)
+    {
+        set_errno(err_to_errno(err));
+        return -1;
+    }
+
+    return (int) sent;
+}
+
+static int inet_sendbuf(int s, struct pbuf *p, int flags, const struct sockaddr *to, socklen_t tolen)
+{
+    struct lwip_sock *sock;
+
+    sock = lwip_tryget_socket(s);
+    if (sock == NULL)
+    {
+        pbuf_free(p);
+        set_errno(EBADF);
+        return -1;
+    }
+
+    if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP)
+    {
+        return inet_sendbuf_tcp(s, sock->conn, p, flags);
+    }
+
+    return inet_sendbuf_dgram(sock->conn, p, to, tolen);
+}
+
+static int inet_recvbuf(int s, struct pbuf **p, int flags, struct sockaddr *from, socklen_t *fromlen)
+{
+    struct lwip_sock *sock;
+    struct netconn *conn;
+    struct netbuf *buf;
+    ip_addr_t addr;
+    u16_t port = 0;
+    u8_t apiflags = (flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0;
+    err_t err;
+
+    *p = RT_NULL;
+    sock = lwip_tryget_socket(s);
+    if (sock == NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+    conn = sock->conn;
+    ip_addr_set_zero(&addr);
+
+    if (NETCONNTYPE_GROUP(netconn_type(conn)) == NETCONN_TCP)
+    {
+        /* the rest of a partial recv() comes first, recv() credited the window only for what it copied */
+        if (sock->lastdata.pbuf != NULL)
+        {
+            *p = sock->lastdata.pbuf;
+            sock->lastdata.pbuf = NULL;
+            netconn_tcp_recvd(conn, (*p)->tot_len);
+        }
+        else
+        {
+            err = netconn_recv_tcp_pbuf_flags(conn, p, apiflags);
+            if (err != ERR_OK)
+            {
+                *p = RT_NULL;
+                if (err == ERR_CLSD)
+                {
+                    return 0;
+                }
+                set_errno(err_to_errno(err));
+                return -1;
+            }
+        }
+        if (from != RT_NULL)
+        {
+            netconn_peer(conn, &addr, &port);
+        }
+    }
+    else
+    {
+        buf = sock->lastdata.netbuf;
+        if (buf != NULL)
+        {
+            sock->lastdata.netbuf = NULL;
+        }
+        else
+        {
+            err = netconn_recv_udp_raw_netbuf_flags(conn, &buf, apiflags);
+            if (err != ERR_OK)
+            {
+                set_errno(err_to_errno(err));
+                return -1;
+            }
+        }
+
+        /* keep the pbuf chain, free only the netbuf */
+        *p = buf->p;
+        ip_addr_copy(addr, *netbuf_fromaddr(buf));
+        port = netbuf_fromport(buf);
+        buf->p = buf->ptr = NULL;
+        netbuf_delete(buf);
+    }
+
+    inet_zc_sockaddr(&addr, port, from, fromlen);
+
+    return (*p)->tot_len;
+}
+
+/* the zero-copy payload must stay until the peer acknowledges it, then the socket closes */
+static int inet_closesocket(int s)
+{
+    struct inet_zc_sock *zc = inet_zc_get(s);
+    struct lwip_sock *sock = lwip_tryget_socket(s);
+    struct netconn *conn;
+    rt_tick_t start = rt_tick_get();
+    rt_bool_t pending = RT_TRUE;
+
+    if (zc != RT_NULL && sock != NULL && zc->conn == sock->conn)
+    {
+        conn = sock->conn;
+        while (pending)
+        {
+            LOCK_TCPIP_CORE();
+            inet_zc_release(zc, conn);
+            pending = (zc->head != RT_NULL);
+            if (pending && rt_tick_get() - start >= rt_tick_from_millisecond(SAL_ZEROCOPY_LINGER_MS))
+            {
+                /* the peer does not acknowledge, drop the connection to take the buffers back */
+                if (conn->pcb.tcp != RT_NULL)
+                {
+                    tcp_abort(conn->pcb.tcp);
+                }
+                inet_zc_release(zc, conn);
+                pending = RT_FALSE;
+            }
+            if (!pending)
+            {
+                zc->conn = RT_NULL;
+            }
+            UNLOCK_TCPIP_CORE();
+
+            if (pending)
+            {
+                rt_thread_mdelay(10);
+            }
+        }
+    }
+
+    return lwip_close(s);
+}
+#endif /* SAL_USING_ZEROCOPY */
+
 static const struct sal_socket_ops lwip_socket_ops =
 {
     inet_socket,
+#ifdef SAL_USING_ZEROCOPY
+    inet_closesocket,
+#else
     lwip_close,
+#endif
     lwip_bind,
     lwip_listen,
     lwip_connect,
@@ -303,6 +764,10 @@ static const struct sal_socket_ops lwip_socket_ops =
 #ifdef SAL_USING_POSIX
     inet_poll,
 #endif
+#ifdef SAL_USING_ZEROCOPY
+    inet_sendbuf,
+    inet_recvbuf,
+#endif
 };
 
 static const struct sal_netdb_ops lwip_netdb_ops =
@@ -8,6 +8,7 @@
  * 2018-05-17     ChenYong     First version
  * 2022-05-15     Meco Man     rename sal.h as sal_low_lvl.h to avoid conflicts
  *                             with Microsoft Visual Studio header file
+ * 2026-10-19     RT-Thread    Add zero-copy buffer operations
  */
 
 #ifndef SAL_LOW_LEVEL_H__
@@ -60,8 +61,14 @@ struct sal_socket
 #ifdef SAL_USING_TLS
     void *user_data_tls;               /* user-specific TLS data */
 #endif
+
+    struct rt_mutex lock;              /* serializes close, shutdown and bind of the socket */
 };
 
+#ifdef SAL_USING_ZEROCOPY
+struct pbuf;
+#endif
+
 /* network interface socket opreations */
 struct sal_socket_ops
 {
@@ -82,6 +89,11 @@ struct sal_socket_ops
 #ifdef SAL_USING_POSIX
     int (*poll)       (struct dfs_fd *file, struct rt_pollreq *req);
 #endif
+#ifdef SAL_USING_ZEROCOPY
+    /* optional, the buffer is the protocol stack packet buffer */
+    int (*sendbuf)    (int s, struct pbuf *p, int flags, const struct sockaddr *to, socklen_t tolen);
+    int (*recvbuf)    (int s, struct pbuf **p, int flags, struct sockaddr *from, socklen_t *fromlen);
+#endif
 };
 
 /* sal network database name resolving */
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    the first version
+ */
+
+#ifndef SAL_ZEROCOPY_H__
+#define SAL_ZEROCOPY_H__
+
+#include <stddef.h>
+#include <sal_socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Zero-copy socket extension.
+ *
+ * The buffers are lwIP pbufs. A buffer from sal_buf_alloc() is stack memory
+ * with room for the protocol headers, sal_buf_ref() wraps memory of the
+ * application, which is given back by the release callback once the stack
+ * has done with it (the callback mostly runs in the tcpip thread).
+ *
+ * sal_sendbuf() always takes the buffer, also on failure. On TCP the stack
+ * references the payload until the peer acknowledges it, so the data must
+ * not be changed after the call, a close waits SAL_ZEROCOPY_LINGER_MS for the
+ * acknowledge and aborts the connection after it. A partial send consumes the
+ * whole buffer, the return value tells how many bytes were queued.
+ *
+ * sal_recvbuf() returns the received pbuf chain by reference, the caller
+ * walks p->next and releases the chain with sal_buf_free(). The chain is
+ * taken from the receive pool, so it should not be held for long. It returns
+ * 0 when the peer closed the connection.
+ *
+ * The socket is the descriptor returned by socket().
+ */
+
+struct pbuf;
+
+struct pbuf *sal_buf_alloc(size_t size);
+struct pbuf *sal_buf_ref(void *data, size_t size, void (*release)(void *data, void *arg), void *arg);
+void sal_buf_free(struct pbuf *p);
+
+int sal_sendbuf(int s, struct pbuf *p, int flags, const struct sockaddr *to, socklen_t tolen);
+int sal_recvbuf(int s, struct pbuf **p, int flags, struct sockaddr *from, socklen_t *fromlen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAL_ZEROCOPY_H__ */
@@ -266,6 +266,10 @@ int closesocket(int s)
         return -1;
     }
 
+#ifdef RT_USING_POSIX_EPOLL
+    rt_epoll_fd_close(d);
+#endif
+
     if (sal_closesocket(socket) == 0)
     {
         error = 0;
@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2018-05-23     ChenYong     First version
  * 2018-11-12     ChenYong     Add TLS support
+ * 2026-10-19     RT-Thread    Lock-free socket lookup and per-socket locks
+ * 2026-10-19     RT-Thread    Add zero-copy sal_sendbuf/sal_recvbuf
  */
 
 #include <rtthread.h>
@@ -20,6 +22,10 @@
 #endif
 #include <sal_low_lvl.h>
 #include <netdev.h>
+#ifdef SAL_USING_ZEROCOPY
+#include <sal_zerocopy.h>
+#include <dfs_net.h>
+#endif
 
 #ifdef SAL_INTERNET_CHECK
 #include <ipc/workqueue.h>
@@ -34,13 +40,32 @@
 #define DBG_LVL                        DBG_INFO
 #include <rtdbg.h>
 
-#define SOCKET_TABLE_STEP_LEN          4
+/*
+ * A socket descriptor is the table index, and with SAL_USING_POSIX, where
+ * the descriptor is only kept by the dfs fd, the generation of the slot in
+ * the upper bits. The socket objects are kept for reuse after close, so the
+ * lookup never meets a freed object and takes no lock, a stale descriptor
+ * fails the magic or the generation check.
+ */
+#define SAL_SOCKET_IDX_BITS            10
+#define SAL_SOCKET_IDX(s)              ((s) & ((1 << SAL_SOCKET_IDX_BITS) - 1))
+#ifdef SAL_USING_POSIX
+#define SAL_SOCKET_GEN_MAX             0xFFFFF
+#else
+#define SAL_SOCKET_GEN_MAX             0
+#endif
+
+#if SAL_SOCKETS_NUM > (1 << SAL_SOCKET_IDX_BITS)
+#error "SAL_SOCKETS_NUM is too large for the socket descriptor"
+#endif
 
 /* the socket table used to dynamic allocate sockets */
 struct sal_socket_table
 {
     uint32_t max_socket;
     struct sal_socket **sockets;
+    uint16_t *free_slots;       /* stack of the free indexes */
+    uint32_t free_num;
 };
 
 /* record the netdev and res table*/
@@ -113,7 +138,7 @@ do {
  */
 int sal_init(void)
 {
-    int cn;
+    int idx;
 
     if (init_ok)
     {
@@ -121,15 +146,23 @@ int sal_init(void)
         return 0;
     }
 
-    /* init sal socket table */
-    cn = SOCKET_TABLE_STEP_LEN < SAL_SOCKETS_NUM ? SOCKET_TABLE_STEP_LEN : SAL_SOCKETS_NUM;
-    socket_table.max_socket = cn;
-    socket_table.sockets = rt_calloc(1, cn * sizeof(struct sal_socket *));
-    if (socket_table.sockets == RT_NULL)
+    /* init sal socket table, the lookup needs it never reallocated */
+    socket_table.max_socket = SAL_SOCKETS_NUM;
+    socket_table.sockets = rt_calloc(1, SAL_SOCKETS_NUM * sizeof(struct sal_socket *));
+    socket_table.free_slots = rt_calloc(1, SAL_SOCKETS_NUM * sizeof(uint16_t));
+    if (socket_table.sockets == RT_NULL || socket_table.free_slots == RT_NULL)
     {
+        rt_free(socket_table.sockets);
+        rt_free(socket_table.free_slots);
         LOG_E("No memory for socket table.\n");
         return -1;
     }
+    /* the lowest index is allocated first */
+    for (idx = 0; idx < SAL_SOCKETS_NUM; idx++)
+    {
+        socket_table.free_slots[idx] = SAL_SOCKETS_NUM - 1 - idx;
+    }
+    socket_table.free_num = SAL_SOCKETS_NUM;
 
     /*init the dev_res table */
     rt_memset(sal_dev_res_tbl,  0, sizeof(sal_dev_res_tbl));
@@ -330,18 +363,51 @@ int sal_proto_tls_register(const struct sal_proto_tls *pt)
 struct sal_socket *sal_get_socket(int socket)
 {
     struct sal_socket_table *st = &socket_table;
+    struct sal_socket *sock;
+    int idx;
+
+    idx = socket - SAL_SOCKET_OFFSET;
+    if (idx < 0)
+    {
+        return RT_NULL;
+    }
 
-    socket = socket - SAL_SOCKET_OFFSET;
+    idx = SAL_SOCKET_IDX(idx);
+    if (idx >= (int) st->max_socket)
+    {
+        return RT_NULL;
+    }
 
-    if (socket < 0 || socket >= (int) st->max_socket)
+    /* the slot is closed or reused */
+    sock = st->sockets[idx];
+    if (sock == RT_NULL || sock->magic != SAL_SOCKET_MAGIC || sock->socket != socket)
     {
         return RT_NULL;
     }
 
-    /* check socket structure valid or not */
-    RT_ASSERT(st->sockets[socket]->magic == SAL_SOCKET_MAGIC);
+    return sock;
+}
 
-    return st->sockets[socket];
+/**
+ * This function will lock the state of a sal socket.
+ *
+ * @return -RT_ERROR when the socket is closed by another thread meanwhile.
+ */
+static rt_err_t socket_lock(struct sal_socket *sock, int socket)
+{
+    rt_mutex_take(&sock->lock, RT_WAITING_FOREVER);
+    if (sock->magic != SAL_SOCKET_MAGIC || sock->socket != socket)
+    {
+        rt_mutex_release(&sock->lock);
+        return -RT_ERROR;
+    }
+
+    return RT_EOK;
+}
+
+static void socket_unlock(struct sal_socket *sock)
+{
+    rt_mutex_release(&sock->lock);
 }
 
 /**
@@ -386,7 +452,8 @@ int sal_netdev_cleanup(struct netdev *netdev)
         sal_lock();
         for (idx = 0; idx < socket_table.max_socket; idx++)
         {
-            if (socket_table.sockets[idx] && socket_table.sockets[idx]->netdev == netdev)
+            if (socket_table.sockets[idx] && socket_table.sockets[idx]->magic == SAL_SOCKET_MAGIC &&
+                    socket_table.sockets[idx]->netdev == netdev)
             {
                 find_dev = 1;
                 break;
@@ -467,115 +534,75 @@ static int socket_init(int family, int type, int protocol, struct sal_socket **r
     return 0;
 }
 
-static int socket_alloc(struct sal_socket_table *st, int f_socket)
+static int socket_new(void)
 {
+    struct sal_socket *sock;
+    struct sal_socket_table *st = &socket_table;
+    uint32_t gen = 0;
     int idx;
 
-    /* find an empty socket entry */
-    for (idx = f_socket; idx < (int) st->max_socket; idx++)
-    {
-        if (st->sockets[idx] == RT_NULL)
-        {
-            break;
-        }
-    }
+    sal_lock();
 
-    /* allocate a larger sockte container */
-    if (idx == (int) st->max_socket &&  st->max_socket < SAL_SOCKETS_NUM)
+    /* can't find an empty sal socket entry */
+    if (st->free_num == 0)
     {
-        int cnt, index;
-        struct sal_socket **sockets;
-
-        /* increase the number of socket with 4 step length */
-        cnt = st->max_socket + SOCKET_TABLE_STEP_LEN;
-        cnt = cnt > SAL_SOCKETS_NUM ? SAL_SOCKETS_NUM : cnt;
-
-        sockets = rt_realloc(st->sockets, cnt * sizeof(struct sal_socket *));
-        if (sockets == RT_NULL)
-            goto __result; /* return st->max_socket */
-
-        /* clean the new allocated fds */
-        for (index = st->max_socket; index < cnt; index++)
-        {
-            sockets[index] = RT_NULL;
-        }
-
-        st->sockets = sockets;
-        st->max_socket = cnt;
+        sal_unlock();
+        return -1;
     }
+    idx = st->free_slots[st->free_num - 1];
 
-    /* allocate  'struct sal_socket' */
-    if (idx < (int) st->max_socket && st->sockets[idx] == RT_NULL)
+    sock = st->sockets[idx];
+    if (sock == RT_NULL)
     {
-        st->sockets[idx] = rt_calloc(1, sizeof(struct sal_socket));
-        if (st->sockets[idx] == RT_NULL)
+        /* the object is kept after close, the lookup never meets a freed one */
+        sock = rt_calloc(1, sizeof(struct sal_socket));
+        if (sock == RT_NULL)
         {
-            idx = st->max_socket;
+            sal_unlock();
+            return -1;
         }
+        rt_mutex_init(&sock->lock, "sal_skt", RT_IPC_FLAG_PRIO);
+        st->sockets[idx] = sock;
     }
-
-__result:
-    return idx;
-}
-
-static void socket_free(struct sal_socket_table *st, int idx)
-{
-    struct sal_socket *sock;
-
-    sock = st->sockets[idx];
-    st->sockets[idx] = RT_NULL;
-    rt_free(sock);
-}
-
-static int socket_new(void)
-{
-    struct sal_socket *sock;
-    struct sal_socket_table *st = &socket_table;
-    int idx;
-
-    sal_lock();
-
-    /* find an empty sal socket entry */
-    idx = socket_alloc(st, 0);
-
-    /* can't find an empty sal socket entry */
-    if (idx == (int) st->max_socket)
+    else
     {
-        idx = -(1 + SAL_SOCKET_OFFSET);
-        goto __result;
+        gen = (uint32_t)(sock->socket - SAL_SOCKET_OFFSET) >> SAL_SOCKET_IDX_BITS;
+        gen = (gen >= SAL_SOCKET_GEN_MAX) ? 0 : gen + 1;
     }
+    st->free_num--;
 
-    sock = st->sockets[idx];
-    sock->socket = idx + SAL_SOCKET_OFFSET;
-    sock->magic = SAL_SOCKET_MAGIC;
+    sock->socket = (int)((gen << SAL_SOCKET_IDX_BITS) | idx) + SAL_SOCKET_OFFSET;
     sock->netdev = RT_NULL;
     sock->user_data = RT_NULL;
 #ifdef SAL_USING_TLS
     sock->user_data_tls = RT_NULL;
 #endif
+    sock->magic = SAL_SOCKET_MAGIC;
 
-__result:
     sal_unlock();
-    return idx + SAL_SOCKET_OFFSET;
+    return sock->socket;
 }
 
 static void socket_delete(int socket)
 {
     struct sal_socket *sock;
     struct sal_socket_table *st = &socket_table;
-    int idx;
 
-    idx = socket - SAL_SOCKET_OFFSET;
-    if (idx < 0 || idx >= (int) st->max_socket)
+    sock = sal_get_socket(socket);
+    if (sock == RT_NULL)
     {
         return;
     }
+
     sal_lock();
-    sock = sal_get_socket(socket);
-    RT_ASSERT(sock != RT_NULL);
-    sock->magic = 0;
-    sock->netdev = RT_NULL;
-    socket_free(st, idx);
+    /* closed by another thread */
+    if (sock->magic == SAL_SOCKET_MAGIC && sock->socket == socket)
+    {
+        sock->magic = 0;
+        sock->netdev = RT_NULL;
+        sock->user_data = RT_NULL;
+        st->free_slots[st->free_num++] = SAL_SOCKET_IDX(socket - SAL_SOCKET_OFFSET);
+    }
     sal_unlock();
 }
 
@@ -614,7 +641,6 @@ int sal_accept(int socket, struct sockaddr *addr, socklen_t *addrlen)
         if (retval < 0)
         {
             pf->skt_ops->closesocket(new_socket);
-            rt_memset(new_sock, 0x00, sizeof(struct sal_socket));
             /* socket init failed, delete socket */
             socket_delete(new_sal_socket);
             LOG_E("New socket registered failed, return error %d.", retval);
@@ -681,16 +707,24 @@ int sal_bind(int socket, const struct sockaddr *name, socklen_t namelen)
         {
             int new_socket = -1;
 
+            /* the protocol socket is replaced under the socket lock */
+            if (socket_lock(sock, socket) != RT_EOK)
+            {
+                return -1;
+            }
+
             /* protocol family is different, close old socket and create new socket by input ip address */
-            local_pf->skt_ops->closesocket(socket);
+            local_pf->skt_ops->closesocket((int) sock->user_data);
 
             new_socket = input_pf->skt_ops->socket(input_pf->family, sock->type, sock->protocol);
             if (new_socket < 0)
             {
+                socket_unlock(sock);
                 return -1;
             }
             sock->netdev = new_netdev;
             sock->user_data = (void *) new_socket;
+            socket_unlock(sock);
         }
     }
 
@@ -712,6 +746,11 @@ int sal_shutdown(int socket, int how)
     /* check the network interface socket opreation */
     SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, shutdown);
 
+    if (socket_lock(sock, socket) != RT_EOK)
+    {
+        return -1;
+    }
+
     if (pf->skt_ops->shutdown((int) sock->user_data, how) == 0)
     {
 #ifdef SAL_USING_TLS
@@ -719,17 +758,16 @@ int sal_shutdown(int socket, int how)
         {
             if (proto_tls->ops->closesocket(sock->user_data_tls) < 0)
             {
-                return -1;
+                error = -1;
             }
         }
 #endif
-        error = 0;
     }
     else
     {
         error = -1;
     }
-
+    socket_unlock(sock);
 
     return error;
 }
@@ -1003,6 +1041,12 @@ int sal_closesocket(int socket)
     /* valid the network interface socket opreation */
     SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, closesocket);
 
+    /* a concurrent close or bind is finished first */
+    if (socket_lock(sock, socket) != RT_EOK)
+    {
+        return -1;
+    }
+
     if (pf->skt_ops->closesocket((int) sock->user_data) == 0)
     {
 #ifdef SAL_USING_TLS
@@ -1010,11 +1054,10 @@ int sal_closesocket(int socket)
         {
             if (proto_tls->ops->closesocket(sock->user_data_tls) < 0)
             {
-                return -1;
+                error = -1;
             }
         }
 #endif
-        error = 0;
     }
     else
     {
@@ -1023,6 +1066,7 @@ int sal_closesocket(int socket)
 
     /* delete socket */
     socket_delete(socket);
+    socket_unlock(sock);
 
     return error;
 }
@@ -1060,6 +1104,85 @@ int sal_poll(struct dfs_fd *file, struct rt_pollreq *req)
 }
 #endif
 
+#ifdef SAL_USING_ZEROCOPY
+/* get the zero-copy capable socket object of the file descriptor, errno is set on failure */
+static struct sal_socket *sal_zerocopy_socket(int s, struct sal_proto_family **pf)
+{
+    struct sal_socket *sock;
+
+    sock = sal_get_socket(dfs_net_getsocket(s));
+    if (sock == RT_NULL)
+    {
+        rt_set_errno(-EBADF);
+        return RT_NULL;
+    }
+    if (!netdev_is_up(sock->netdev))
+    {
+        rt_set_errno(-ENETDOWN);
+        return RT_NULL;
+    }
+#ifdef SAL_USING_TLS
+    if (IS_SOCKET_PROTO_TLS(sock))
+    {
+        rt_set_errno(-EOPNOTSUPP);
+        return RT_NULL;
+    }
+#endif
+
+    *pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+    if ((*pf)->skt_ops->sendbuf == RT_NULL || (*pf)->skt_ops->recvbuf == RT_NULL)
+    {
+        rt_set_errno(-EOPNOTSUPP);
+        return RT_NULL;
+    }
+
+    return sock;
+}
+
+int sal_sendbuf(int s, struct pbuf *p, int flags, const struct sockaddr *to, socklen_t tolen)
+{
+    struct sal_socket *sock;
+    struct sal_proto_family *pf;
+
+    if (p == RT_NULL)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    sock = sal_zerocopy_socket(s, &pf);
+    if (sock == RT_NULL)
+    {
+        /* the buffer is consumed also on failure */
+        sal_buf_free(p);
+        return -1;
+    }
+
+    return pf->skt_ops->sendbuf((int) sock->user_data, p, flags, to, tolen);
+}
+
+int sal_recvbuf(int s, struct pbuf **p, int flags, struct sockaddr *from, socklen_t *fromlen)
+{
+    struct sal_socket *sock;
+    struct sal_proto_family *pf;
+
+    if (p == RT_NULL)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+    *p = RT_NULL;
+
+    sock = sal_zerocopy_socket(s, &pf);
+    if (sock == RT_NULL)
+    {
+        return -1;
+    }
+
+    return pf->skt_ops->recvbuf((int) sock->user_data, p, flags, from, fromlen);
+}
+#endif /* SAL_USING_ZEROCOPY */
+
 struct hostent *sal_gethostbyname(const char *name)
 {
     struct netdev *netdev = netdev_default;
@@ -1177,3 +1300,415 @@ void sal_freeaddrinfo(struct addrinfo *ai)
         pf->netdb_ops->freeaddrinfo(ai);
     }
 }
+
+#if defined(RT_USING_FINSH) && defined(SAL_USING_POSIX)
+#include <finsh.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+
+#define SAL_ECHO_BENCH_PORT         7777
+#define SAL_ECHO_BENCH_MSG_SIZE     64
+#define SAL_ECHO_BENCH_THREADS_MAX  8
+#define SAL_ECHO_BENCH_STACK_SIZE   2048
+#define SAL_ECHO_BENCH_PRIORITY     20
+
+struct sal_echo_bench
+{
+    struct sockaddr_in addr;
+    int listen_fd;
+    volatile rt_bool_t stop;
+    volatile rt_uint32_t round_trips;
+    struct rt_semaphore done;
+};
+
+static void sal_echo_bench_session(void *parameter)
+{
+    char buf[SAL_ECHO_BENCH_MSG_SIZE];
+    int fd = (int)(rt_ubase_t) parameter;
+    int len;
+
+    while ((len = recv(fd, buf, sizeof(buf), 0)) > 0)
+    {
+        if (send(fd, buf, len, 0) != len)
+        {
+            break;
+        }
+    }
+    closesocket(fd);
+}
+
+static void sal_echo_bench_server(void *parameter)
+{
+    struct sal_echo_bench *bench = (struct sal_echo_bench *) parameter;
+    rt_thread_t tid;
+    int fd;
+
+    while (!bench->stop)
+    {
+        /* the accept times out to check the stop flag */
+        fd = accept(bench->listen_fd, RT_NULL, RT_NULL);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        tid = rt_thread_create("echo_s", sal_echo_bench_session, (void *)(rt_ubase_t) fd,
+                               SAL_ECHO_BENCH_STACK_SIZE, SAL_ECHO_BENCH_PRIORITY, 10);
+        if (tid == RT_NULL)
+        {
+            closesocket(fd);
+            continue;
+        }
+        rt_thread_startup(tid);
+    }
+    rt_sem_release(&bench->done);
+}
+
+static void sal_echo_bench_client(void *parameter)
+{
+    struct sal_echo_bench *bench = (struct sal_echo_bench *) parameter;
+    char buf[SAL_ECHO_BENCH_MSG_SIZE];
+    rt_uint32_t round_trips = 0;
+    int fd, len, got, opt = 1;
+    rt_base_t level;
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        goto __exit;
+    }
+    if (connect(fd, (struct sockaddr *) &bench->addr, sizeof(bench->addr)) < 0)
+    {
+        LOG_E("echo bench connect failed.");
+        closesocket(fd);
+        goto __exit;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+    rt_memset(buf, 0x5A, sizeof(buf));
+    while (!bench->stop)
+    {
+        if (send(fd, buf, sizeof(buf), 0) != sizeof(buf))
+        {
+            break;
+        }
+        for (got = 0; got < (int) sizeof(buf); got += len)
+        {
+            len = recv(fd, buf + got, sizeof(buf) - got, 0);
+            if (len <= 0)
+            {
+                break;
+            }
+        }
+        if (got < (int) sizeof(buf))
+        {
+            break;
+        }
+        round_trips++;
+    }
+    closesocket(fd);
+
+    level = rt_hw_interrupt_disable();
+    bench->round_trips += round_trips;
+    rt_hw_interrupt_enable(level);
+
+__exit:
+    rt_sem_release(&bench->done);
+}
+
+/* echo round trips of 1, 2, 4 ... client threads, each socket call looks up its sal socket */
+static void sal_echo_bench(int argc, char **argv)
+{
+    struct sal_echo_bench bench;
+    struct timeval timeout = {0, 100 * 1000};
+    int max_threads, seconds, threads, i, opt = 1;
+    rt_thread_t tid;
+
+    max_threads = (argc > 1) ? atoi(argv[1]) : 4;
+    seconds = (argc > 2) ? atoi(argv[2]) : 3;
+    if (max_threads < 1 || max_threads > SAL_ECHO_BENCH_THREADS_MAX || seconds < 1)
+    {
+        rt_kprintf("Usage: sal_echo_bench [threads 1-%d] [seconds] [echo server ip]\n", SAL_ECHO_BENCH_THREADS_MAX);
+        return;
+    }
+
+    rt_memset(&bench, 0, sizeof(bench));
+    rt_sem_init(&bench.done, "echo_b", 0, RT_IPC_FLAG_PRIO);
+    bench.addr.sin_family = AF_INET;
+    bench.addr.sin_port = htons(SAL_ECHO_BENCH_PORT);
+    bench.listen_fd = -1;
+
+    if (argc > 3)
+    {
+        /* a remote echo server listens on the port */
+        bench.addr.sin_addr.s_addr = inet_addr(argv[3]);
+    }
+    else
+    {
+        bench.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (bench.listen_fd < 0)
+        {
+            goto __exit;
+        }
+        setsockopt(bench.listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        setsockopt(bench.listen_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if (bind(bench.listen_fd, (struct sockaddr *) &bench.addr, sizeof(bench.addr)) < 0 ||
+                listen(bench.listen_fd, SAL_ECHO_BENCH_THREADS_MAX) < 0)
+        {
+            rt_kprintf("echo server listen failed\n");
+            goto __exit;
+        }
+
+        tid = rt_thread_create("echo_l", sal_echo_bench_server, &bench,
+                               SAL_ECHO_BENCH_STACK_SIZE, SAL_ECHO_BENCH_PRIORITY, 10);
+        if (tid == RT_NULL)
+        {
+            goto __exit;
+        }
+        rt_thread_startup(tid);
+        bench.addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    }
+
+    rt_kprintf("threads  round trips/s\n");
+    for (threads = 1; threads <= max_threads; threads *= 2)
+    {
+        bench.stop = RT_FALSE;
+        bench.round_trips = 0;
+        for (i = 0; i < threads; i++)
+        {
+            tid = rt_thread_create("echo_c", sal_echo_bench_client, &bench,
+                                   SAL_ECHO_BENCH_STACK_SIZE, SAL_ECHO_BENCH_PRIORITY, 10);
+            if (tid == RT_NULL)
+            {
+                break;
+            }
+            rt_thread_startup(tid);
+        }
+
+        rt_thread_mdelay(seconds * 1000);
+        bench.stop = RT_TRUE;
+        while (i--)
+        {
+            rt_sem_take(&bench.done, RT_WAITING_FOREVER);
+        }
+        rt_kprintf("%-8d %d\n", threads, bench.round_trips / seconds);
+    }
+
+    if (bench.listen_fd >= 0)
+    {
+        /* wait the accept loop */
+        bench.stop = RT_TRUE;
+        rt_sem_take(&bench.done, RT_WAITING_FOREVER);
+    }
+
+__exit:
+    if (bench.listen_fd >= 0)
+    {
+        closesocket(bench.listen_fd);
+    }
+    rt_sem_detach(&bench.done);
+}
+MSH_CMD_EXPORT(sal_echo_bench, TCP echo throughput with concurrent clients: sal_echo_bench [threads] [seconds] [server ip]);
+
+#ifdef SAL_USING_ZEROCOPY
+#define SAL_ZC_BENCH_PORT           7778
+#define SAL_ZC_BENCH_IPERF_PORT     5001
+#define SAL_ZC_BENCH_BLOCK_SIZE     4096
+
+struct sal_zc_bench
+{
+    struct sockaddr_in addr;
+    int listen_fd;
+    rt_bool_t zerocopy;
+    int block_size;
+    volatile rt_uint32_t received;
+    struct rt_semaphore done;
+};
+
+/* the local receiver, recv() copies the data out, sal_recvbuf() takes the pbufs */
+static void sal_zc_bench_sink(void *parameter)
+{
+    struct sal_zc_bench *bench = (struct sal_zc_bench *) parameter;
+    struct pbuf *p;
+    char *buf = RT_NULL;
+    int fd, len;
+
+    fd = accept(bench->listen_fd, RT_NULL, RT_NULL);
+    if (fd < 0)
+    {
+        goto __exit;
+    }
+    if (!bench->zerocopy && (buf = (char *) rt_malloc(bench->block_size)) == RT_NULL)
+    {
+        closesocket(fd);
+        goto __exit;
+    }
+
+    while (1)
+    {
+        if (bench->zerocopy)
+        {
+            len = sal_recvbuf(fd, &p, 0, RT_NULL, RT_NULL);
+            if (len > 0)
+            {
+                sal_buf_free(p);
+            }
+        }
+        else
+        {
+            len = recv(fd, buf, bench->block_size, 0);
+        }
+        if (len <= 0)
+        {
+            break;
+        }
+        bench->received += len;
+    }
+    rt_free(buf);
+    closesocket(fd);
+
+__exit:
+    rt_sem_release(&bench->done);
+}
+
+/* send blocks for the time, the payload is not filled in either mode */
+static rt_uint32_t sal_zc_bench_source(struct sal_zc_bench *bench, int seconds)
+{
+    rt_uint32_t sent = 0;
+    rt_tick_t end;
+    struct pbuf *p;
+    char *buf = RT_NULL;
+    int fd, len;
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    if (connect(fd, (struct sockaddr *) &bench->addr, sizeof(bench->addr)) < 0)
+    {
+        rt_kprintf("zero-copy bench connect failed\n");
+        goto __exit;
+    }
+    if (!bench->zerocopy && (buf = (char *) rt_malloc(bench->block_size)) == RT_NULL)
+    {
+        goto __exit;
+    }
+
+    end = rt_tick_get() + rt_tick_from_millisecond(seconds * 1000);
+    while ((rt_int32_t)(end - rt_tick_get()) > 0)
+    {
+        if (bench->zerocopy)
+        {
+            /* the stack holds the blocks until they are acknowledged */
+            p = sal_buf_alloc(bench->block_size);
+            if (p == RT_NULL)
+            {
+                rt_thread_mdelay(1);
+                continue;
+            }
+            len = sal_sendbuf(fd, p, 0, RT_NULL, 0);
+        }
+        else
+        {
+            len = send(fd, buf, bench->block_size, 0);
+        }
+        if (len <= 0)
+        {
+            break;
+        }
+        sent += len;
+    }
+
+__exit:
+    rt_free(buf);
+    closesocket(fd);
+
+    return sent;
+}
+
+/* TCP throughput of send()/recv() against sal_sendbuf()/sal_recvbuf(), through loopback or to an iperf server */
+static void sal_zc_bench(int argc, char **argv)
+{
+    struct sal_zc_bench bench;
+    struct timeval timeout = {1, 0};
+    rt_uint32_t sent;
+    rt_thread_t tid;
+    int seconds, mode, opt = 1;
+
+    seconds = (argc > 1) ? atoi(argv[1]) : 3;
+    rt_memset(&bench, 0, sizeof(bench));
+    bench.block_size = (argc > 2) ? atoi(argv[2]) : SAL_ZC_BENCH_BLOCK_SIZE;
+    if (seconds < 1 || bench.block_size < 1 || bench.block_size > 0xFFFF)
+    {
+        rt_kprintf("Usage: sal_zc_bench [seconds] [block size] [iperf server ip]\n");
+        return;
+    }
+
+    rt_sem_init(&bench.done, "zc_b", 0, RT_IPC_FLAG_PRIO);
+    bench.addr.sin_family = AF_INET;
+    bench.listen_fd = -1;
+
+    if (argc > 3)
+    {
+        /* the remote side only receives, e.g. iperf -s */
+        bench.addr.sin_port = htons(SAL_ZC_BENCH_IPERF_PORT);
+        bench.addr.sin_addr.s_addr = inet_addr(argv[3]);
+    }
+    else
+    {
+        bench.addr.sin_port = htons(SAL_ZC_BENCH_PORT);
+        bench.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (bench.listen_fd < 0)
+        {
+            goto __exit;
+        }
+        setsockopt(bench.listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        /* the sink does not wait forever for a failed connect */
+        setsockopt(bench.listen_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if (bind(bench.listen_fd, (struct sockaddr *) &bench.addr, sizeof(bench.addr)) < 0 ||
+                listen(bench.listen_fd, 1) < 0)
+        {
+            rt_kprintf("zero-copy bench listen failed\n");
+            goto __exit;
+        }
+        bench.addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    }
+
+    rt_kprintf("mode       sent KB/s  received KB/s\n");
+    for (mode = 0; mode < 2; mode++)
+    {
+        bench.zerocopy = (mode == 1);
+        bench.received = 0;
+        if (bench.listen_fd >= 0)
+        {
+            tid = rt_thread_create("zc_sink", sal_zc_bench_sink, &bench,
+                                   SAL_ECHO_BENCH_STACK_SIZE, SAL_ECHO_BENCH_PRIORITY, 10);
+            if (tid == RT_NULL)
+            {
+                break;
+            }
+            rt_thread_startup(tid);
+        }
+
+        sent = sal_zc_bench_source(&bench, seconds);
+        if (bench.listen_fd >= 0)
+        {
+            /* the sink ends on the close of the connection */
+            rt_sem_take(&bench.done, RT_WAITING_FOREVER);
+        }
+        rt_kprintf("%-10s %-10d %d\n", bench.zerocopy ? "zero-copy" : "copy",
+                   sent / 1024 / seconds, bench.received / 1024 / seconds);
+    }
+
+__exit:
+    if (bench.listen_fd >= 0)
+    {
+        closesocket(bench.listen_fd);
+    }
+    rt_sem_detach(&bench.done);
+}
+MSH_CMD_EXPORT(sal_zc_bench, TCP throughput of copy and zero-copy sockets: sal_zc_bench [seconds] [block size] [server ip]);
+#endif /* SAL_USING_ZEROCOPY */
+#endif /* RT_USING_FINSH && SAL_USING_POSIX */
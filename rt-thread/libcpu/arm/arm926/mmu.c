@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2015-04-15     ArdaFu     Add code for IAR
+ * 2026-10-19     RT-Thread  Add D-cache maintenance of rectangles and of the whole cache
  */
 
 #include "mmu.h"
@@ -134,6 +135,20 @@ void mmu_clean_invalidated_cache_index(int index)
     __asm volatile { mcr p15, 0, index, c7, c14, 2 }
 }
 
+void mmu_clean_cache_index(int index)
+{
+    __asm volatile { mcr p15, 0, index, c7, c10, 2 }
+}
+
+rt_uint32_t mmu_get_cache_type(void)
+{
+    register rt_uint32_t value;
+
+    __asm volatile { mrc p15, 0, value, c0, c0, 1 }
+
+    return value;
+}
+
 void mmu_clean_invalidated_dcache(rt_uint32_t buffer, rt_uint32_t size)
 {
     unsigned int ptr;
@@ -324,6 +339,20 @@ void mmu_clean_invalidated_cache_index(int index)
     asm volatile("mcr p15, 0, %0, c7, c14, 2": :"r"(index));
 }
 
+void mmu_clean_cache_index(int index)
+{
+    asm volatile("mcr p15, 0, %0, c7, c10, 2": :"r"(index));
+}
+
+rt_uint32_t mmu_get_cache_type(void)
+{
+    rt_uint32_t value;
+
+    asm volatile("mrc p15, 0, %0, c0, c0, 1":"=r"(value));
+
+    return value;
+}
+
 void mmu_clean_invalidated_dcache(rt_uint32_t buffer, rt_uint32_t size)
 {
     unsigned int ptr;
@@ -386,6 +415,101 @@ void mmu_invalidate_dcache_all()
 }
 #endif
 
+/* D-cache size in bytes and associativity, from the cache type register */
+static void mmu_get_dcache_geometry(rt_uint32_t *size, rt_uint32_t *ways)
+{
+    rt_uint32_t dsize = (mmu_get_cache_type() >> 12) & 0xfff;
+    rt_uint32_t m = (dsize >> 2) & 0x1;
+
+    *size = (m ? 768 : 512) << ((dsize >> 6) & 0xf);
+    *ways = ((m ? 3 : 2) << ((dsize >> 3) & 0x7)) >> 1;
+}
+
+rt_uint32_t mmu_dcache_size(void)
+{
+    static rt_uint32_t dcache_size = 0;
+    rt_uint32_t ways;
+
+    if (dcache_size == 0)
+        mmu_get_dcache_geometry(&dcache_size, &ways);
+
+    return dcache_size;
+}
+
+static void mmu_dcache_index_all(void (*index_op)(int index))
+{
+    rt_uint32_t size, ways, sets, way_shift, set, way;
+
+    mmu_get_dcache_geometry(&size, &ways);
+    sets = size / (ways * CACHE_LINE_SIZE);
+
+    /* the way number is kept in the top bits of the index */
+    for (way_shift = 32; (1UL << (32 - way_shift)) < ways; way_shift--);
+
+    for (way = 0; way < ways; way++)
+    {
+        for (set = 0; set < sets; set++)
+        {
+            index_op((int)(((way_shift < 32) ? (way << way_shift) : 0) | (set * CACHE_LINE_SIZE)));
+        }
+    }
+}
+
+void mmu_clean_dcache_all(void)
+{
+    mmu_dcache_index_all(mmu_clean_cache_index);
+}
+
+void mmu_clean_invalidated_dcache_all(void)
+{
+    mmu_dcache_index_all(mmu_clean_invalidated_cache_index);
+}
+
+/*
+ * Rectangles of a frame buffer: height rows of width bytes, stride bytes
+ * apart. Only the lines of the rows are maintained; when they are more
+ * than the cache holds, the whole cache is maintained by index, which
+ * costs one operation per cache line instead of one per buffer line.
+ */
+static void mmu_dcache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height,
+                            void (*range_op)(rt_uint32_t buffer, rt_uint32_t size), void (*all_op)(void))
+{
+    rt_uint32_t row_lines;
+
+    if ((width == 0) || (height == 0))
+        return;
+
+    /* rows closer than a cache line share lines, take them as one range */
+    if (width + CACHE_LINE_SIZE >= stride)
+    {
+        width = stride * (height - 1) + width;
+        height = 1;
+    }
+
+    row_lines = ((buffer % CACHE_LINE_SIZE) + width + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE;
+    if (row_lines * CACHE_LINE_SIZE * height > mmu_dcache_size())
+    {
+        all_op();
+        return;
+    }
+
+    for (; height > 0; height--)
+    {
+        range_op(buffer, width);
+        buffer += stride;
+    }
+}
+
+void mmu_clean_dcache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height)
+{
+    mmu_dcache_rect(buffer, stride, width, height, mmu_clean_dcache, mmu_clean_dcache_all);
+}
+
+void mmu_clean_invalidated_dcache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height)
+{
+    mmu_dcache_rect(buffer, stride, width, height, mmu_clean_invalidated_dcache, mmu_clean_invalidated_dcache_all);
+}
+
 /* level1 page table */
 #if defined(__ICCARM__)
 #pragma data_alignment=(16*1024)
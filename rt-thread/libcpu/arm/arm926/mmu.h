@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-02-08     RT-Thread    the first version
+ * 2026-10-19     RT-Thread    add D-cache maintenance of rectangles
  */
 
 #ifndef __MMU_H__
@@ -49,4 +50,9 @@ void rt_hw_mmu_init(struct mem_desc *mdesc, rt_uint32_t size);
 void mmu_clean_invalidated_dcache(rt_uint32_t buffer, rt_uint32_t size);
 void mmu_clean_dcache(rt_uint32_t buffer, rt_uint32_t size);
 void mmu_invalidate_dcache(rt_uint32_t buffer, rt_uint32_t size);
+rt_uint32_t mmu_dcache_size(void);
+void mmu_clean_dcache_all(void);
+void mmu_clean_invalidated_dcache_all(void);
+void mmu_clean_dcache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height);
+void mmu_clean_invalidated_dcache_rect(rt_uint32_t buffer, rt_uint32_t stride, rt_uint32_t width, rt_uint32_t height);
 #endif
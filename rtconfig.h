@@ -428,6 +428,9 @@
 #define BSP_LCD_WIDTH 800
 #define BSP_LCD_HEIGHT 480
 #define BSP_USING_VPOST_OSD
+#define BSP_USING_LVGL_MEMPOOL
+#define BSP_LVGL_MEMPOOL_SIZE 4096
+#define BSP_LVGL_MEMPOOL_SLAB_SIZE 1024
 #define BSP_USING_USBD
 #define BSP_USING_USBH
 